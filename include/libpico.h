@@ -27,6 +27,7 @@ typedef struct libpico_http_response_t libpico_http_response_t;
 typedef struct libpico_mainwnd_t libpico_mainwnd_t;
 typedef struct libpico_menu_t libpico_menu_t;
 typedef struct libpico_menuitem_t libpico_menuitem_t;
+typedef struct libpico_metrics_t libpico_metrics_t;
 typedef struct libpico_param_t libpico_param_t;
 typedef struct libpico_plugin_t libpico_plugin_t;
 typedef struct libpico_torrent_t libpico_torrent_t;
@@ -51,6 +52,12 @@ enum libpico_menu_id_t
     libpico_menu_help
 };
 
+enum libpico_metric_type_t
+{
+    libpico_metric_counter,
+    libpico_metric_gauge
+};
+
 enum libpico_result_t
 {
     libpico_ok,
@@ -65,6 +72,14 @@ typedef struct libpico_torrent_stats_t
     int32_t upload_payload_rate;
 } libpico_torrent_stats_t;
 
+typedef struct libpico_metric_t
+{
+    libpico_metric_type_t type;
+    int64_t value;
+    /* change per second between the two latest samples */
+    double rate;
+} libpico_metric_t;
+
 typedef libpico_result_t(*libpico_http_callback_t)(libpico_http_response_t*, libpico_http_status_t, libpico_param_t*);
 typedef libpico_result_t(*libpico_init_t)(int, libpico_plugin_t*);
 typedef libpico_result_t(*libpico_hook_callback_t)(libpico_event_t, libpico_param_t*, libpico_param_t*);
@@ -96,6 +111,16 @@ LIBPICO_API_FUNCTION libpico_result_t libpico_menu_get(libpico_mainwnd_t* wnd, l
 LIBPICO_API_FUNCTION libpico_result_t libpico_menu_insert_item(libpico_menu_t* menu, uint32_t pos, const wchar_t* label, size_t len, libpico_menuitem_callback_t cb, libpico_param_t* param, libpico_menuitem_t** item);
 LIBPICO_API_FUNCTION libpico_result_t libpico_menu_insert_separator(libpico_menu_t* menu, uint32_t pos);
 
+/*
+Session metrics. The index of a metric stays the same while PicoTorrent runs.
+*/
+LIBPICO_API_FUNCTION libpico_result_t libpico_metrics_get(libpico_mainwnd_t* wnd, libpico_metrics_t** metrics);
+LIBPICO_API_FUNCTION libpico_result_t libpico_metrics_count(libpico_metrics_t* metrics, size_t* count);
+LIBPICO_API_FUNCTION libpico_result_t libpico_metrics_find(libpico_metrics_t* metrics, const char* name, int32_t* index);
+LIBPICO_API_FUNCTION libpico_result_t libpico_metrics_name(libpico_metrics_t* metrics, int32_t index, char* name, size_t* len);
+LIBPICO_API_FUNCTION libpico_result_t libpico_metrics_value(libpico_metrics_t* metrics, int32_t index, libpico_metric_t* metric);
+LIBPICO_API_FUNCTION libpico_result_t libpico_metrics_history(libpico_metrics_t* metrics, int32_t index, int64_t* values, size_t* len);
+
 /*
 String functions
 */
@@ -0,0 +1,13 @@
+/* Size and mtime of each file when a torrent completed, used for incremental rechecks */
+CREATE TABLE torrent_file_journal (
+    info_hash   TEXT    PRIMARY KEY,
+    save_path   TEXT    NOT NULL,
+    files       BLOB    NOT NULL,
+    pieces      BLOB    NOT NULL,
+    num_pieces  INTEGER NOT NULL,
+
+    FOREIGN KEY(info_hash) REFERENCES torrent(info_hash)
+);
+
+INSERT INTO setting (key, value, default_value)
+VALUES ('file_journal.enabled', NULL, 'true');
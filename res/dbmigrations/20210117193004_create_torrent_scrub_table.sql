@@ -0,0 +1,14 @@
+/* Where the background scrub of each seeding torrent is, and when it last went through all pieces */
+CREATE TABLE torrent_scrub (
+    info_hash      TEXT    PRIMARY KEY,
+    next_piece     INTEGER NOT NULL,
+    last_completed INTEGER,
+
+    FOREIGN KEY(info_hash) REFERENCES torrent(info_hash)
+);
+
+INSERT INTO setting (key, value, default_value)
+VALUES
+('scrub.enabled',       NULL, 'false'),
+('scrub.rate_limit',    NULL, '10'),
+('scrub.interval_days', NULL, '30');
@@ -0,0 +1,7 @@
+/* Limits for the storage move queue */
+INSERT INTO setting (key, value, default_value)
+VALUES
+('move_queue.per_source',      NULL, '1'),
+('move_queue.per_destination', NULL, '1'),
+('move_queue.retries',         NULL, '3'),
+('move_queue.retry_delay',     NULL, '30');
@@ -0,0 +1,7 @@
+/* Where the torrents of a label go once they complete, and how full the disk
+   they were downloaded to may get before the oldest completed ones move */
+ALTER TABLE label ADD COLUMN completed_path TEXT;
+ALTER TABLE label ADD COLUMN completed_path_enabled INTEGER NOT NULL DEFAULT 0;
+ALTER TABLE label ADD COLUMN watermarks_enabled INTEGER NOT NULL DEFAULT 0;
+ALTER TABLE label ADD COLUMN high_watermark INTEGER NOT NULL DEFAULT 90;
+ALTER TABLE label ADD COLUMN low_watermark INTEGER NOT NULL DEFAULT 75;
@@ -0,0 +1,348 @@
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <libtorrent/bencode.hpp>
+#include <nlohmann/json.hpp>
+
+#include "../picotorrent/bittorrent/torrentcreator.hpp"
+#include "../picotorrent/buildinfo.hpp"
+
+namespace fs = std::filesystem;
+namespace lt = libtorrent;
+using nlohmann::json;
+using pt::BitTorrent::PieceHasher;
+using pt::BitTorrent::TorrentCreator;
+
+static std::atomic<bool> cancelled{ false };
+
+struct Job
+{
+    TorrentCreator::Params params;
+    fs::path output;
+};
+
+struct Options
+{
+    TorrentCreator::Params defaults;
+    std::optional<fs::path> manifest;
+    std::vector<std::string> positional;
+    bool quiet = false;
+};
+
+void print_usage()
+{
+    std::cout << "usage: picotorrent-create [options] <path> <output.torrent>" << std::endl;
+    std::cout << "       picotorrent-create [options] --manifest <file.json>" << std::endl;
+    std::cout << std::endl;
+    std::cout << "options:" << std::endl;
+    std::cout << "  --mode <v1|hybrid|v2>  torrent format, defaults to hybrid" << std::endl;
+    std::cout << "  --private              set the private flag" << std::endl;
+    std::cout << "  --comment <text>       torrent comment" << std::endl;
+    std::cout << "  --creator <text>       torrent creator" << std::endl;
+    std::cout << "  --tracker <url>        add a tracker, one tier each, may be repeated" << std::endl;
+    std::cout << "  --url-seed <url>       add a url seed, may be repeated" << std::endl;
+    std::cout << "  --piece-size <kib>     piece size, picked from the total size by default" << std::endl;
+    std::cout << "  --threads <n>          hashing threads, one per core by default" << std::endl;
+    std::cout << "  --hash-cache <file>    reuse the hashes of files which did not change" << std::endl;
+    std::cout << "  --quiet                only print errors" << std::endl;
+    std::cout << std::endl;
+    std::cout << "a manifest holds optional \"defaults\" and a list of \"torrents\", each with" << std::endl;
+    std::cout << "a \"path\" and an \"output\" and any of mode, private, comment, creator," << std::endl;
+    std::cout << "trackers, url_seeds, piece_size (in kib) and hash_cache. relative paths are resolved" << std::endl;
+    std::cout << "against the manifest directory." << std::endl;
+}
+
+std::string format_size(double bytes)
+{
+    static const char* units[] = { "B", "KiB", "MiB", "GiB", "TiB" };
+    int unit = 0;
+
+    while (bytes >= 1024 && unit < 4)
+    {
+        bytes /= 1024;
+        unit++;
+    }
+
+    char buf[64];
+    std::snprintf(buf, sizeof(buf), unit == 0 ? "%.0f %s" : "%.1f %s", bytes, units[unit]);
+    return buf;
+}
+
+std::optional<TorrentCreator::Mode> parse_mode(std::string const& mode)
+{
+    if (mode == "v1") { return TorrentCreator::Mode::v1; }
+    if (mode == "hybrid") { return TorrentCreator::Mode::Hybrid; }
+    if (mode == "v2") { return TorrentCreator::Mode::v2; }
+    return std::nullopt;
+}
+
+// piece sizes are given in KiB and must be a power of two of at least 16 KiB
+bool set_piece_size(TorrentCreator::Params& params, long long kib)
+{
+    if (kib == 0)
+    {
+        params.pieceSize = 0;
+        return true;
+    }
+
+    if (kib < 16 || kib > 256 * 1024 || (kib & (kib - 1)) != 0)
+    {
+        return false;
+    }
+
+    params.pieceSize = static_cast<int>(kib * 1024);
+    return true;
+}
+
+// applies the keys present in obj on top of params
+void apply_json(json const& obj, fs::path const& dir, TorrentCreator::Params& params)
+{
+    if (obj.contains("mode"))
+    {
+        auto mode = parse_mode(obj["mode"].get<std::string>());
+        if (!mode) { throw std::invalid_argument("invalid mode: " + obj["mode"].get<std::string>()); }
+        params.mode = *mode;
+    }
+
+    if (obj.contains("private")) { params.priv = obj["private"].get<bool>(); }
+    if (obj.contains("comment")) { params.comment = obj["comment"].get<std::string>(); }
+    if (obj.contains("creator")) { params.creator = obj["creator"].get<std::string>(); }
+    if (obj.contains("trackers")) { params.trackers = obj["trackers"].get<std::vector<std::string>>(); }
+    if (obj.contains("url_seeds")) { params.urlSeeds = obj["url_seeds"].get<std::vector<std::string>>(); }
+    if (obj.contains("hash_cache")) { params.hashCache = dir / fs::u8path(obj["hash_cache"].get<std::string>()); }
+
+    if (obj.contains("piece_size") && !set_piece_size(params, obj["piece_size"].get<long long>()))
+    {
+        throw std::invalid_argument("invalid piece size: " + obj["piece_size"].dump());
+    }
+}
+
+std::vector<Job> load_manifest(fs::path const& file, TorrentCreator::Params const& defaults)
+{
+    std::ifstream in(file);
+
+    if (!in)
+    {
+        throw std::runtime_error("could not open manifest " + file.string());
+    }
+
+    json j;
+    in >> j;
+
+    fs::path dir = fs::absolute(file).parent_path();
+    TorrentCreator::Params base = defaults;
+
+    if (j.contains("defaults"))
+    {
+        apply_json(j["defaults"], dir, base);
+    }
+
+    std::vector<Job> jobs;
+
+    for (auto const& item : j.at("torrents"))
+    {
+        Job job;
+        job.params = base;
+
+        apply_json(item, dir, job.params);
+
+        job.params.path = (dir / fs::u8path(item.at("path").get<std::string>())).lexically_normal().u8string();
+        job.output = dir / fs::u8path(item.at("output").get<std::string>());
+
+        jobs.push_back(std::move(job));
+    }
+
+    return jobs;
+}
+
+// returns the number of bytes hashed, or nothing if the torrent was not created
+std::optional<std::int64_t> create(Job const& job, bool quiet)
+{
+    if (!fs::exists(fs::u8path(job.params.path)))
+    {
+        std::cerr << job.params.path << ": no such file or directory" << std::endl;
+        return std::nullopt;
+    }
+
+    auto begin = std::chrono::steady_clock::now();
+    PieceHasher::Progress last{};
+
+    lt::error_code ec;
+    lt::entry e;
+
+    try
+    {
+        e = TorrentCreator::Create(
+            job.params,
+            [&](PieceHasher::Progress const& p)
+            {
+                last = p;
+
+                if (quiet) { return; }
+
+                std::cerr << "\r" << job.output.filename().string() << ": "
+                    << p.piecesHashed << "/" << p.totalPieces << " pieces, "
+                    << format_size(p.bytesPerSecond) << "/s   " << std::flush;
+            },
+            cancelled,
+            ec);
+    }
+    catch (std::exception const& ex)
+    {
+        if (!quiet) { std::cerr << std::endl; }
+        std::cerr << job.params.path << ": " << ex.what() << std::endl;
+        return std::nullopt;
+    }
+
+    if (!quiet) { std::cerr << "\r" << std::string(79, ' ') << "\r" << std::flush; }
+
+    if (ec)
+    {
+        std::cerr << job.params.path << ": " << ec.message() << std::endl;
+        return std::nullopt;
+    }
+
+    if (job.output.has_parent_path())
+    {
+        fs::create_directories(job.output.parent_path());
+    }
+
+    {
+        std::ofstream out(job.output, std::ios_base::binary | std::ios_base::trunc);
+        lt::bencode(std::ostream_iterator<char>(out), e);
+
+        if (!out)
+        {
+            std::cerr << job.output.string() << ": failed to write torrent" << std::endl;
+            return std::nullopt;
+        }
+    }
+
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+    if (!quiet)
+    {
+        std::cout << job.output.string() << ": "
+            << last.totalPieces << " pieces of " << format_size(static_cast<double>(e["info"]["piece length"].integer())) << ", "
+            << format_size(static_cast<double>(last.totalBytes)) << " in " << elapsed << " s ("
+            << format_size(elapsed > 0 ? last.totalBytes / elapsed : 0) << "/s)" << std::endl;
+    }
+
+    return last.totalBytes;
+}
+
+int main(int argc, char* argv[])
+{
+    Options opts;
+    opts.defaults.creator = std::string("picotorrent-create ") + pt::BuildInfo::version();
+
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+
+        auto value = [&]() -> std::string
+        {
+            if (i + 1 >= argc) { throw std::invalid_argument("missing value for " + arg); }
+            return argv[++i];
+        };
+
+        try
+        {
+            if (arg == "-h" || arg == "--help") { print_usage(); return 0; }
+            else if (arg == "--manifest") { opts.manifest = fs::u8path(value()); }
+            else if (arg == "--private") { opts.defaults.priv = true; }
+            else if (arg == "--comment") { opts.defaults.comment = value(); }
+            else if (arg == "--creator") { opts.defaults.creator = value(); }
+            else if (arg == "--tracker") { opts.defaults.trackers.push_back(value()); }
+            else if (arg == "--url-seed") { opts.defaults.urlSeeds.push_back(value()); }
+            else if (arg == "--threads") { opts.defaults.threads = std::stoi(value()); }
+            else if (arg == "--hash-cache") { opts.defaults.hashCache = fs::u8path(value()); }
+            else if (arg == "--quiet") { opts.quiet = true; }
+            else if (arg == "--mode")
+            {
+                std::string v = value();
+                auto mode = parse_mode(v);
+                if (!mode) { throw std::invalid_argument("invalid mode: " + v); }
+                opts.defaults.mode = *mode;
+            }
+            else if (arg == "--piece-size")
+            {
+                std::string v = value();
+                if (!set_piece_size(opts.defaults, std::stoll(v))) { throw std::invalid_argument("invalid piece size: " + v); }
+            }
+            else if (arg.size() > 1 && arg[0] == '-') { throw std::invalid_argument("unknown option " + arg); }
+            else { opts.positional.push_back(arg); }
+        }
+        catch (std::exception const& ex)
+        {
+            std::cerr << ex.what() << std::endl;
+            return 1;
+        }
+    }
+
+    std::vector<Job> jobs;
+
+    if (opts.manifest && opts.positional.empty())
+    {
+        try
+        {
+            jobs = load_manifest(*opts.manifest, opts.defaults);
+        }
+        catch (std::exception const& ex)
+        {
+            std::cerr << opts.manifest->string() << ": " << ex.what() << std::endl;
+            return 1;
+        }
+    }
+    else if (!opts.manifest && opts.positional.size() == 2)
+    {
+        Job job;
+        job.params = opts.defaults;
+        job.params.path = opts.positional[0];
+        job.output = fs::u8path(opts.positional[1]);
+        jobs.push_back(std::move(job));
+    }
+    else
+    {
+        print_usage();
+        return 1;
+    }
+
+    std::signal(SIGINT, [](int) { cancelled = true; });
+
+    auto begin = std::chrono::steady_clock::now();
+    std::int64_t totalBytes = 0;
+    size_t created = 0;
+
+    for (auto const& job : jobs)
+    {
+        if (cancelled) { break; }
+
+        if (auto bytes = create(job, opts.quiet))
+        {
+            totalBytes += *bytes;
+            created++;
+        }
+    }
+
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+    if (!opts.quiet && jobs.size() > 1)
+    {
+        std::cout << "created " << created << " of " << jobs.size() << " torrent(s), "
+            << format_size(static_cast<double>(totalBytes)) << " in " << elapsed << " s ("
+            << format_size(elapsed > 0 ? totalBytes / elapsed : 0) << "/s)" << std::endl;
+    }
+
+    return created == jobs.size() ? 0 : 1;
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstdint>
+
+// Layout of the translation catalogue written by PicoTorrent-coredb and
+// memory mapped by the translator. Offsets are relative to the start of the
+// file and all integers are little endian.
+//
+//   CatalogueHeader
+//   CatalogueString[keyCount]       keys, UTF-8, sorted
+//   CatalogueLocale[localeCount]    locales, sorted by name
+//
+// followed by the string data and one CatalogueString[keyCount] table of
+// UTF-16 values per locale. A value with a length of zero is missing from
+// that locale.
+
+namespace pt::L10n
+{
+    static const uint32_t CatalogueMagic = 0x434c5450; // PTLC
+    static const uint32_t CatalogueVersion = 1;
+
+    struct CatalogueHeader
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t keyCount;
+        uint32_t localeCount;
+        uint32_t keysOffset;
+        uint32_t localesOffset;
+    };
+
+    struct CatalogueString
+    {
+        uint32_t offset;
+        uint32_t length;
+    };
+
+    struct CatalogueLocale
+    {
+        CatalogueString name;
+        uint32_t valuesOffset;
+    };
+}
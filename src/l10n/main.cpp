@@ -1,53 +1,200 @@
+#include <algorithm>
+#include <cstring>
 #include <fstream>
 #include <filesystem>
 #include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
 
 #include <nlohmann/json.hpp>
-#include <sqlite3.h>
+
+#include "catalogue.hpp"
 
 namespace fs = std::filesystem;
 using nlohmann::json;
+using pt::L10n::CatalogueHeader;
+using pt::L10n::CatalogueLocale;
+using pt::L10n::CatalogueString;
 
-const char* translations_table_sql = "CREATE TABLE translations (id INTEGER PRIMARY KEY, locale TEXT NOT NULL, key TEXT NOT NULL, value TEXT, UNIQUE(locale, key));";
-const char* insert_translation_sql = "INSERT INTO translations (locale, key, value) VALUES (?, ?, ?);";
-
-int main(int argc, char* argv[])
+// writes a header with every key from the given (en-US) translation file,
+// sorted so the translator can resolve keys to ids at compile time
+int generate_keys(fs::path const& input_file, fs::path const& output_file)
 {
-    std::cout << "generating l10n database" << std::endl;
+    std::ifstream in(input_file);
+    json j;
+    in >> j;
 
-    for (int i = 0; i < argc; i++)
+    std::vector<std::string> keys;
+
+    for (auto const& line : j.items())
     {
-        std::cout << argv[i] << std::endl;
+        keys.push_back(line.key());
     }
 
-    if (argc < 3)
+    std::sort(keys.begin(), keys.end());
+
+    std::stringstream out;
+    out << "// generated by PicoTorrent-coredb from " << input_file.filename().string() << ", do not edit" << std::endl;
+    out << "#pragma once" << std::endl;
+    out << std::endl;
+    out << "#include <cstdint>" << std::endl;
+    out << "#include <string_view>" << std::endl;
+    out << std::endl;
+    out << "namespace pt::UI::I18n" << std::endl;
+    out << "{" << std::endl;
+    out << "    constexpr std::string_view Keys[] =" << std::endl;
+    out << "    {" << std::endl;
+
+    for (auto const& key : keys)
     {
-        std::cerr << "incorrect number of arguments" << std::endl;
-        return 1;
+        out << "        \"" << key << "\"," << std::endl;
     }
 
-    fs::path input_dir = argv[1];
-    fs::path output_file = fs::path(argv[2]) / "coredb.sqlite";
+    out << "    };" << std::endl;
+    out << std::endl;
+    out << "    constexpr uint32_t KeyCount = " << keys.size() << ";" << std::endl;
+    out << "}" << std::endl;
 
+    // only touch the header if it changed, otherwise every translation unit
+    // including it would be rebuilt
     if (fs::exists(output_file))
     {
-        std::cout << "removing existing database... rebuilding" << std::endl;
-        fs::remove(output_file);
+        std::ifstream existing(output_file);
+        std::stringstream current;
+        current << existing.rdbuf();
+
+        if (current.str() == out.str())
+        {
+            std::cout << "keys are up to date" << std::endl;
+            return 0;
+        }
     }
 
-    sqlite3* db;
-    sqlite3_open(output_file.string().c_str(), &db);
+    fs::create_directories(output_file.parent_path());
+
+    std::ofstream header(output_file, std::ios::trunc);
+    header << out.str();
+
+    std::cout << "wrote " << keys.size() << " keys to " << output_file.string() << std::endl;
+
+    return 0;
+}
 
-    if (sqlite3_exec(db, translations_table_sql, nullptr, nullptr, nullptr) != SQLITE_OK)
+static std::u16string to_utf16(std::string const& str)
+{
+    std::u16string result;
+    result.reserve(str.size());
+
+    for (size_t i = 0; i < str.size();)
     {
-        std::cerr << "could not create translations table" << std::endl;
+        unsigned char c = static_cast<unsigned char>(str[i]);
+        uint32_t cp = 0;
+        size_t len = 1;
+
+        if (c < 0x80)                { cp = c; }
+        else if ((c & 0xe0) == 0xc0) { cp = c & 0x1f; len = 2; }
+        else if ((c & 0xf0) == 0xe0) { cp = c & 0x0f; len = 3; }
+        else                         { cp = c & 0x07; len = 4; }
+
+        for (size_t j = 1; j < len && i + j < str.size(); j++)
+        {
+            cp = (cp << 6) | (static_cast<unsigned char>(str[i + j]) & 0x3f);
+        }
+
+        if (cp >= 0x10000)
+        {
+            cp -= 0x10000;
+            result.push_back(static_cast<char16_t>(0xd800 + (cp >> 10)));
+            result.push_back(static_cast<char16_t>(0xdc00 + (cp & 0x3ff)));
+        }
+        else
+        {
+            result.push_back(static_cast<char16_t>(cp));
+        }
+
+        i += len;
+    }
+
+    return result;
+}
+
+class catalogue_writer
+{
+public:
+    uint32_t reserve(size_t size)
+    {
+        align(4);
+        uint32_t offset = static_cast<uint32_t>(m_data.size());
+        m_data.resize(m_data.size() + size);
+        return offset;
+    }
+
+    template<typename T>
+    void put(uint32_t offset, T const& value)
+    {
+        std::memcpy(m_data.data() + offset, &value, sizeof(T));
+    }
+
+    CatalogueString append(std::string const& str)
+    {
+        CatalogueString cs{ static_cast<uint32_t>(m_data.size()), static_cast<uint32_t>(str.size()) };
+        m_data.insert(m_data.end(), str.begin(), str.end());
+        return cs;
+    }
+
+    CatalogueString append(std::u16string const& str)
+    {
+        align(2);
+
+        CatalogueString cs{ static_cast<uint32_t>(m_data.size()), static_cast<uint32_t>(str.size()) };
+
+        for (char16_t c : str)
+        {
+            m_data.push_back(static_cast<char>(c & 0xff));
+            m_data.push_back(static_cast<char>(c >> 8));
+        }
+
+        return cs;
+    }
+
+    std::vector<char> const& data() { return m_data; }
+
+private:
+    void align(size_t alignment)
+    {
+        while (m_data.size() % alignment != 0) { m_data.push_back(0); }
+    }
+
+    std::vector<char> m_data;
+};
+
+int main(int argc, char* argv[])
+{
+    if (argc == 4 && std::string(argv[1]) == "--keys")
+    {
+        std::cout << "generating l10n keys" << std::endl;
+        return generate_keys(argv[2], argv[3]);
+    }
+
+    std::cout << "generating l10n catalogue" << std::endl;
+
+    for (int i = 0; i < argc; i++)
+    {
+        std::cout << argv[i] << std::endl;
+    }
+
+    if (argc < 3)
+    {
+        std::cerr << "incorrect number of arguments" << std::endl;
         return 1;
     }
 
-    sqlite3_stmt* stmt;
-    sqlite3_prepare_v2(db, insert_translation_sql, -1, &stmt, nullptr);
+    fs::path input_dir = argv[1];
+    fs::path output_file = fs::path(argv[2]) / "coredb.bin";
 
-    sqlite3_exec(db, "BEGIN TRANSACTION", nullptr, nullptr, nullptr);
+    std::map<std::string, json> locales;
 
     for (fs::path p : fs::directory_iterator(input_dir))
     {
@@ -63,35 +210,90 @@ int main(int argc, char* argv[])
         json j;
         in >> j;
 
-        std::cout << "inserting " << j.size() << " items for " << loc << std::endl;
+        locales.insert({ loc, j });
+    }
 
-        for (auto const& line : j.items())
-        {
-            std::string const& key = line.key();
-            std::string const& val = line.value().get<std::string>();
+    if (locales.find("en-US") == locales.end())
+    {
+        std::cerr << "en-US translations are missing" << std::endl;
+        return 1;
+    }
+
+    // en-US decides which keys exist, same as the generated key header
+    std::vector<std::string> keys;
+
+    for (auto const& line : locales.at("en-US").items())
+    {
+        keys.push_back(line.key());
+    }
 
-            sqlite3_bind_text(stmt, 1, loc.c_str(), static_cast<int>(loc.size()), SQLITE_TRANSIENT);
-            sqlite3_bind_text(stmt, 2, key.c_str(), static_cast<int>(key.size()), SQLITE_TRANSIENT);
-            sqlite3_bind_text(stmt, 3, val.c_str(), static_cast<int>(val.size()), SQLITE_TRANSIENT);
+    std::sort(keys.begin(), keys.end());
 
-            int res = sqlite3_step(stmt);
+    catalogue_writer writer;
+
+    uint32_t header_offset = writer.reserve(sizeof(CatalogueHeader));
+    uint32_t keys_offset = writer.reserve(sizeof(CatalogueString) * keys.size());
+    uint32_t locales_offset = writer.reserve(sizeof(CatalogueLocale) * locales.size());
+
+    CatalogueHeader header{};
+    header.magic = pt::L10n::CatalogueMagic;
+    header.version = pt::L10n::CatalogueVersion;
+    header.keyCount = static_cast<uint32_t>(keys.size());
+    header.localeCount = static_cast<uint32_t>(locales.size());
+    header.keysOffset = keys_offset;
+    header.localesOffset = locales_offset;
+
+    writer.put(header_offset, header);
+
+    for (size_t i = 0; i < keys.size(); i++)
+    {
+        writer.put(
+            static_cast<uint32_t>(keys_offset + i * sizeof(CatalogueString)),
+            writer.append(keys[i]));
+    }
 
-            if (res != SQLITE_ROW && res != SQLITE_DONE)
+    size_t locale_index = 0;
+
+    for (auto const& [loc, j] : locales)
+    {
+        std::cout << "writing " << j.size() << " items for " << loc << std::endl;
+
+        CatalogueLocale cl{};
+        cl.name = writer.append(loc);
+        cl.valuesOffset = writer.reserve(sizeof(CatalogueString) * keys.size());
+
+        for (size_t i = 0; i < keys.size(); i++)
+        {
+            CatalogueString value{ 0, 0 };
+            auto it = j.find(keys[i]);
+
+            if (it != j.end() && it->is_string())
             {
-                std::cerr << "error when inserting translation data: " << sqlite3_errmsg(sqlite3_db_handle(stmt)) << std::endl;
-                std::cerr << " - " << loc << std::endl << " - " << key << std::endl;
-                return 1;
+                value = writer.append(to_utf16(it->get<std::string>()));
             }
 
-            sqlite3_reset(stmt);
+            writer.put(
+                static_cast<uint32_t>(cl.valuesOffset + i * sizeof(CatalogueString)),
+                value);
         }
+
+        writer.put(
+            static_cast<uint32_t>(locales_offset + locale_index * sizeof(CatalogueLocale)),
+            cl);
+
+        locale_index++;
     }
 
-    sqlite3_exec(db, "END TRANSACTION", nullptr, nullptr, nullptr);
-    sqlite3_exec(db, "VACUUM", nullptr, nullptr, nullptr);
+    std::ofstream out(output_file, std::ios::binary | std::ios::trunc);
+    out.write(writer.data().data(), writer.data().size());
+
+    if (!out)
+    {
+        std::cerr << "could not write catalogue to " << output_file.string() << std::endl;
+        return 1;
+    }
 
-    sqlite3_finalize(stmt);
-    sqlite3_close(db);
+    std::cout << "wrote " << writer.data().size() << " bytes to " << output_file.string() << std::endl;
 
     return 0;
 }
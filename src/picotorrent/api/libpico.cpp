@@ -4,6 +4,7 @@
 
 #include <vector>
 
+#include "../bittorrent/sessionmetrics.hpp"
 #include "../bittorrent/torrenthandle.hpp"
 #include "../bittorrent/torrentstatus.hpp"
 #include "../buildinfo.hpp"
@@ -213,6 +214,91 @@ libpico_result_t libpico_menu_insert_separator(libpico_menu_t* menu, uint32_t po
     return libpico_ok;
 }
 
+libpico_result_t libpico_metrics_get(libpico_mainwnd_t* wnd, libpico_metrics_t** metrics)
+{
+    auto mf = reinterpret_cast<pt::UI::MainFrame*>(wnd);
+    *metrics = reinterpret_cast<libpico_metrics_t*>(const_cast<pt::BitTorrent::SessionMetrics*>(&mf->Metrics()));
+    return libpico_ok;
+}
+
+libpico_result_t libpico_metrics_count(libpico_metrics_t* metrics, size_t* count)
+{
+    *count = reinterpret_cast<pt::BitTorrent::SessionMetrics*>(metrics)->Metrics().size();
+    return libpico_ok;
+}
+
+libpico_result_t libpico_metrics_find(libpico_metrics_t* metrics, const char* name, int32_t* index)
+{
+    *index = reinterpret_cast<pt::BitTorrent::SessionMetrics*>(metrics)->Find(name);
+    return *index < 0 ? libpico_err : libpico_ok;
+}
+
+libpico_result_t libpico_metrics_name(libpico_metrics_t* metrics, int32_t index, char* name, size_t* len)
+{
+    auto m = reinterpret_cast<pt::BitTorrent::SessionMetrics*>(metrics);
+
+    if (index < 0 || index >= static_cast<int32_t>(m->Metrics().size()))
+    {
+        return libpico_err;
+    }
+
+    std::string const& n = m->Metrics().at(index).name;
+    size_t ll = *len;
+
+    *len = n.size();
+
+    if (n.size() >= ll || name == nullptr)
+    {
+        return libpico_insufficient_buffer;
+    }
+
+    strncpy(name, n.c_str(), ll);
+
+    return libpico_ok;
+}
+
+libpico_result_t libpico_metrics_value(libpico_metrics_t* metrics, int32_t index, libpico_metric_t* metric)
+{
+    auto m = reinterpret_cast<pt::BitTorrent::SessionMetrics*>(metrics);
+
+    if (index < 0 || index >= static_cast<int32_t>(m->Metrics().size()))
+    {
+        return libpico_err;
+    }
+
+    metric->type = m->Metrics().at(index).type == pt::BitTorrent::SessionMetrics::Type::Gauge
+        ? libpico_metric_gauge
+        : libpico_metric_counter;
+    metric->value = m->Value(index);
+    metric->rate = m->Rate(index);
+
+    return libpico_ok;
+}
+
+libpico_result_t libpico_metrics_history(libpico_metrics_t* metrics, int32_t index, int64_t* values, size_t* len)
+{
+    auto m = reinterpret_cast<pt::BitTorrent::SessionMetrics*>(metrics);
+
+    if (index < 0 || index >= static_cast<int32_t>(m->Metrics().size()))
+    {
+        return libpico_err;
+    }
+
+    std::vector<int64_t> history = m->History(index);
+    size_t ll = *len;
+
+    *len = history.size();
+
+    if (history.size() > ll || values == nullptr)
+    {
+        return libpico_insufficient_buffer;
+    }
+
+    std::copy(history.begin(), history.end(), values);
+
+    return libpico_ok;
+}
+
 libpico_result_t libpico_register_hook(libpico_plugin_t* plugin, libpico_hook_callback_t cb, libpico_param_t* user)
 {
     reinterpret_cast<Plugin*>(plugin)->AddHook(cb, user);
@@ -1,5 +1,7 @@
 #include "application.hpp"
 
+#include <psapi.h>
+
 #include <boost/log/trivial.hpp>
 #include <nlohmann/json.hpp>
 #include <wx/cmdline.h>
@@ -173,6 +175,12 @@ bool Application::OnInit()
 
     mainFrame->HandleParams(m_options);
 
+    // waiting for the previous instance would skew the numbers
+    if (m_options.pid <= 0)
+    {
+        LogStartupMetrics();
+    }
+
     return true;
 }
 
@@ -212,6 +220,36 @@ void Application::ActivateOtherInstance()
     }
 }
 
+// Logs the time from process creation until the main window is up, and the
+// memory that is resident at that point, so builds can be compared from
+// their log files.
+void Application::LogStartupMetrics()
+{
+    FILETIME creation, exit, kernel, user, now;
+    PROCESS_MEMORY_COUNTERS memory = { sizeof(memory) };
+
+    if (!GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user)
+        || !GetProcessMemoryInfo(GetCurrentProcess(), &memory, sizeof(memory)))
+    {
+        BOOST_LOG_TRIVIAL(warning) << "Failed to read startup metrics: " << GetLastError();
+        return;
+    }
+
+    GetSystemTimeAsFileTime(&now);
+
+    // FILETIME counts 100ns intervals
+    auto ticks = [](FILETIME const& ft)
+    {
+        return (static_cast<uint64_t>(ft.dwHighDateTime) << 32) | ft.dwLowDateTime;
+    };
+
+    BOOST_LOG_TRIVIAL(info) << "Started in " << (ticks(now) - ticks(creation)) / 10000 << " ms"
+        << " (cpu " << (ticks(kernel) + ticks(user)) / 10000 << " ms)"
+        << ", working set " << memory.WorkingSetSize / 1024 << " KB"
+        << " (peak " << memory.PeakWorkingSetSize / 1024 << " KB)"
+        << ", private " << memory.PagefileUsage / 1024 << " KB";
+}
+
 void Application::WaitForPreviousInstance(long pid)
 {
     HANDLE hProc = OpenProcess(SYNCHRONIZE, FALSE, pid);
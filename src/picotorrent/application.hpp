@@ -31,6 +31,7 @@ namespace API
 
     private:
         void ActivateOtherInstance();
+        void LogStartupMetrics();
         void WaitForPreviousInstance(long pid);
 
         pt::CommandLineOptions m_options;
@@ -0,0 +1,90 @@
+#include "filejournal.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <system_error>
+
+#include <libtorrent/file_storage.hpp>
+
+namespace fs = std::filesystem;
+namespace lt = libtorrent;
+using pt::BitTorrent::FileJournal;
+
+FileJournal FileJournal::Create(
+    lt::file_storage const& files,
+    std::string const& savePath,
+    lt::typed_bitfield<lt::piece_index_t> const& verified)
+{
+    FileJournal journal;
+    journal.m_savePath = savePath;
+    journal.m_verified = verified;
+    journal.m_files.reserve(files.num_files());
+
+    for (lt::file_index_t i : files.file_range())
+    {
+        journal.m_files.push_back(Stat(files, i, savePath));
+    }
+
+    return journal;
+}
+
+std::vector<lt::piece_index_t> FileJournal::ChangedPieces(lt::file_storage const& files) const
+{
+    std::vector<lt::piece_index_t> pieces;
+
+    for (lt::file_index_t i : files.file_range())
+    {
+        int const idx = static_cast<int>(i);
+
+        if (files.pad_file_at(i) || files.file_size(i) == 0)
+        {
+            continue;
+        }
+
+        File const current = Stat(files, i, m_savePath);
+
+        if (idx < static_cast<int>(m_files.size())
+            && current.size == m_files[idx].size
+            && current.mtime == m_files[idx].mtime)
+        {
+            continue;
+        }
+
+        lt::peer_request const first = files.map_file(i, 0, 1);
+        lt::peer_request const last = files.map_file(i, files.file_size(i) - 1, 1);
+
+        for (lt::piece_index_t p = first.piece; p <= last.piece; ++p)
+        {
+            pieces.push_back(p);
+        }
+    }
+
+    // adjacent files share their boundary pieces
+    std::sort(pieces.begin(), pieces.end());
+    pieces.erase(std::unique(pieces.begin(), pieces.end()), pieces.end());
+
+    return pieces;
+}
+
+FileJournal::File FileJournal::Stat(lt::file_storage const& files, lt::file_index_t index, std::string const& savePath)
+{
+    if (files.pad_file_at(index))
+    {
+        return { 0, 0 };
+    }
+
+    fs::path path = fs::u8path(files.file_path(index, savePath));
+    std::error_code ec;
+
+    auto size = fs::file_size(path, ec);
+    if (ec) { return { -1, -1 }; }
+
+    auto mtime = fs::last_write_time(path, ec);
+    if (ec) { return { -1, -1 }; }
+
+    return {
+        static_cast<std::int64_t>(size),
+        std::chrono::duration_cast<std::chrono::nanoseconds>(mtime.time_since_epoch()).count()
+    };
+}
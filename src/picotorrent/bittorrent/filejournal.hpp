@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <libtorrent/bitfield.hpp>
+#include <libtorrent/fwd.hpp>
+#include <libtorrent/units.hpp>
+
+namespace pt
+{
+namespace Core
+{
+    class Database;
+}
+namespace BitTorrent
+{
+    // The size and mtime of each file of a torrent at the time all its
+    // pieces were verified. An incremental recheck compares the files on disk
+    // against it and only verifies the pieces of files that changed.
+    class FileJournal
+    {
+    public:
+        struct File
+        {
+            std::int64_t size;
+            std::int64_t mtime;
+        };
+
+        static FileJournal Create(
+            libtorrent::file_storage const& files,
+            std::string const& savePath,
+            libtorrent::typed_bitfield<libtorrent::piece_index_t> const& verified);
+
+        static std::optional<FileJournal> Load(std::shared_ptr<Core::Database> db, std::string const& infoHash);
+        static void Remove(std::shared_ptr<Core::Database> db, std::string const& infoHash);
+
+        void Save(std::shared_ptr<Core::Database> db, std::string const& infoHash) const;
+
+        // the pieces which overlap a file that differs from the journal,
+        // sorted and without duplicates
+        std::vector<libtorrent::piece_index_t> ChangedPieces(libtorrent::file_storage const& files) const;
+
+        std::string const& SavePath() const { return m_savePath; }
+        libtorrent::typed_bitfield<libtorrent::piece_index_t> const& Verified() const { return m_verified; }
+
+    private:
+        static File Stat(libtorrent::file_storage const& files, libtorrent::file_index_t index, std::string const& savePath);
+
+        std::string m_savePath;
+        std::vector<File> m_files;
+        libtorrent::typed_bitfield<libtorrent::piece_index_t> m_verified;
+    };
+}
+}
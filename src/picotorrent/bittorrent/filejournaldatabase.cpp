@@ -0,0 +1,67 @@
+#include "filejournal.hpp"
+
+#include <cstring>
+
+#include "../core/database.hpp"
+
+using pt::BitTorrent::FileJournal;
+
+// the journal is kept in the torrent_file_journal table. this is apart from
+// the rest of FileJournal so that it can be used without the database
+
+std::optional<FileJournal> FileJournal::Load(std::shared_ptr<pt::Core::Database> db, std::string const& infoHash)
+{
+    auto stmt = db->CreateStatement("SELECT save_path, files, pieces, num_pieces FROM torrent_file_journal WHERE info_hash = $1");
+    stmt->Bind(1, infoHash);
+
+    if (!stmt->Read())
+    {
+        return std::nullopt;
+    }
+
+    std::vector<char> files;
+    std::vector<char> pieces;
+
+    FileJournal journal;
+    journal.m_savePath = stmt->GetString(0);
+    stmt->GetBlob(1, files);
+    stmt->GetBlob(2, pieces);
+
+    int const numPieces = stmt->GetInt(3);
+
+    if (files.size() % sizeof(File) != 0
+        || numPieces < 0
+        || pieces.size() != static_cast<size_t>((numPieces + 7) / 8))
+    {
+        return std::nullopt;
+    }
+
+    journal.m_files.resize(files.size() / sizeof(File));
+    std::memcpy(journal.m_files.data(), files.data(), files.size());
+    journal.m_verified.assign(pieces.data(), numPieces);
+
+    return journal;
+}
+
+void FileJournal::Remove(std::shared_ptr<pt::Core::Database> db, std::string const& infoHash)
+{
+    auto stmt = db->CreateStatement("DELETE FROM torrent_file_journal WHERE info_hash = $1");
+    stmt->Bind(1, infoHash);
+    stmt->Execute();
+}
+
+void FileJournal::Save(std::shared_ptr<pt::Core::Database> db, std::string const& infoHash) const
+{
+    std::vector<char> files(m_files.size() * sizeof(File));
+    std::memcpy(files.data(), m_files.data(), files.size());
+
+    std::vector<char> pieces(m_verified.data(), m_verified.data() + (m_verified.size() + 7) / 8);
+
+    auto stmt = db->CreateStatement("REPLACE INTO torrent_file_journal (info_hash, save_path, files, pieces, num_pieces) VALUES ($1, $2, $3, $4, $5)");
+    stmt->Bind(1, infoHash);
+    stmt->Bind(2, m_savePath);
+    stmt->Bind(3, files);
+    stmt->Bind(4, pieces);
+    stmt->Bind(5, m_verified.size());
+    stmt->Execute();
+}
@@ -0,0 +1,139 @@
+#include "filereader.hpp"
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <filesystem>
+
+namespace fs = std::filesystem;
+namespace lt = libtorrent;
+using pt::BitTorrent::FileReader;
+
+FileReader::FileReader()
+#ifdef _WIN32
+    : m_handle(INVALID_HANDLE_VALUE)
+#else
+    : m_fd(-1)
+#endif
+{
+}
+
+FileReader::~FileReader()
+{
+    Close();
+}
+
+bool FileReader::IsOpen() const
+{
+#ifdef _WIN32
+    return m_handle != INVALID_HANDLE_VALUE;
+#else
+    return m_fd >= 0;
+#endif
+}
+
+bool FileReader::Open(std::string const& path, lt::error_code& ec)
+{
+    Close();
+
+#ifdef _WIN32
+    m_handle = CreateFileW(
+        fs::u8path(path).wstring().c_str(),
+        GENERIC_READ,
+        FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+        NULL,
+        OPEN_EXISTING,
+        FILE_FLAG_SEQUENTIAL_SCAN,
+        NULL);
+
+    if (m_handle == INVALID_HANDLE_VALUE)
+    {
+        ec.assign(static_cast<int>(GetLastError()), boost::system::system_category());
+        return false;
+    }
+#else
+    m_fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+
+    if (m_fd < 0)
+    {
+        ec.assign(errno, boost::system::system_category());
+        return false;
+    }
+
+#ifdef POSIX_FADV_SEQUENTIAL
+    posix_fadvise(m_fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+#endif
+
+    m_path = path;
+
+    return true;
+}
+
+void FileReader::Close()
+{
+#ifdef _WIN32
+    if (m_handle != INVALID_HANDLE_VALUE) { CloseHandle(m_handle); }
+    m_handle = INVALID_HANDLE_VALUE;
+#else
+    if (m_fd >= 0) { ::close(m_fd); }
+    m_fd = -1;
+#endif
+
+    m_path.clear();
+}
+
+bool FileReader::Read(std::int64_t offset, char* dst, std::int64_t size, lt::error_code& ec)
+{
+    while (size > 0)
+    {
+        std::int64_t read = 0;
+
+#ifdef _WIN32
+        // positional reads, so there is no file pointer to keep track of
+        OVERLAPPED overlapped = {};
+        overlapped.Offset = static_cast<DWORD>(offset);
+        overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+
+        DWORD bytes = 0;
+
+        if (!ReadFile(m_handle, dst, static_cast<DWORD>(std::min<std::int64_t>(size, 1 << 30)), &bytes, &overlapped)
+            && GetLastError() != ERROR_HANDLE_EOF)
+        {
+            ec.assign(static_cast<int>(GetLastError()), boost::system::system_category());
+            return false;
+        }
+
+        read = bytes;
+#else
+        read = ::pread(m_fd, dst, static_cast<size_t>(std::min<std::int64_t>(size, 1 << 30)), offset);
+
+        if (read < 0)
+        {
+            if (errno == EINTR) { continue; }
+
+            ec.assign(errno, boost::system::system_category());
+            return false;
+        }
+#endif
+
+        // the file is shorter than the torrent says it is
+        if (read == 0)
+        {
+            ec = boost::system::errc::make_error_code(boost::system::errc::io_error);
+            return false;
+        }
+
+        offset += read;
+        dst += read;
+        size -= read;
+    }
+
+    return true;
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include <libtorrent/error_code.hpp>
+
+namespace pt
+{
+namespace BitTorrent
+{
+    // Reads file ranges with the OS read calls, straight into the caller's
+    // buffer. There is no stream or CRT buffer in between, which would only
+    // add a copy for reads as large as a piece. Reads still go through the
+    // OS page cache.
+    class FileReader
+    {
+    public:
+        FileReader();
+        ~FileReader();
+
+        FileReader(FileReader const&) = delete;
+        FileReader& operator=(FileReader const&) = delete;
+
+        bool IsOpen() const;
+        std::string const& Path() const { return m_path; }
+
+        // path is UTF-8, files are opened for sequential reading
+        bool Open(std::string const& path, libtorrent::error_code& ec);
+        void Close();
+
+        // reads exactly size bytes at offset, running into the end of the file
+        // is an error
+        bool Read(std::int64_t offset, char* dst, std::int64_t size, libtorrent::error_code& ec);
+
+    private:
+        std::string m_path;
+#ifdef _WIN32
+        void* m_handle;
+#else
+        int m_fd;
+#endif
+    };
+}
+}
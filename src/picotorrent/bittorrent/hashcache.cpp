@@ -0,0 +1,219 @@
+#include "hashcache.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <system_error>
+
+#include <boost/log/trivial.hpp>
+
+namespace fs = std::filesystem;
+using pt::BitTorrent::HashCache;
+
+// 'PTHC'
+static const uint32_t Magic = 0x43485450;
+static const uint32_t Version = 1;
+
+namespace
+{
+    template<typename T>
+    bool read(std::istream& in, T& value)
+    {
+        return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(T)));
+    }
+
+    template<typename T>
+    void write(std::ostream& out, T const& value)
+    {
+        out.write(reinterpret_cast<char const*>(&value), sizeof(T));
+    }
+
+    // the bytes left after the read position, which bound every count read
+    // from the file so that a corrupt one is not allocated for
+    std::uint64_t remaining(std::istream& in, std::uint64_t fileSize)
+    {
+        auto const pos = in.tellg();
+        return pos < 0 ? 0 : fileSize - std::min(fileSize, static_cast<std::uint64_t>(pos));
+    }
+
+    template<typename Hash>
+    bool readHashes(std::istream& in, std::uint64_t fileSize, std::vector<Hash>& hashes)
+    {
+        uint32_t count = 0;
+        if (!read(in, count)) { return false; }
+        if (count > remaining(in, fileSize) / Hash::size()) { return false; }
+
+        hashes.resize(count);
+
+        for (auto& hash : hashes)
+        {
+            if (!in.read(hash.data(), static_cast<std::streamsize>(hash.size()))) { return false; }
+        }
+
+        return true;
+    }
+
+    template<typename Hash>
+    void writeHashes(std::ostream& out, std::vector<Hash> const& hashes)
+    {
+        write(out, static_cast<uint32_t>(hashes.size()));
+
+        for (auto const& hash : hashes)
+        {
+            out.write(hash.data(), static_cast<std::streamsize>(hash.size()));
+        }
+    }
+}
+
+HashCache::HashCache(fs::path const& file)
+    : m_file(file)
+{
+}
+
+HashCache::Entry const* HashCache::Find(std::string const& path, std::int64_t size, std::int64_t mtime, int pieceLength) const
+{
+    auto it = m_entries.find(path);
+
+    if (it == m_entries.end()
+        || it->second.size != size
+        || it->second.mtime != mtime
+        || it->second.pieceLength != pieceLength)
+    {
+        return nullptr;
+    }
+
+    return &it->second;
+}
+
+void HashCache::Store(std::string const& path, Entry entry)
+{
+    m_entries[path] = std::move(entry);
+}
+
+void HashCache::Load()
+{
+    m_entries.clear();
+
+    std::ifstream in(m_file, std::ios::binary);
+
+    if (!in)
+    {
+        return;
+    }
+
+    std::error_code ec;
+    std::uint64_t const fileSize = fs::file_size(m_file, ec);
+
+    if (ec)
+    {
+        return;
+    }
+
+    uint32_t magic = 0;
+    uint32_t version = 0;
+    uint32_t count = 0;
+
+    if (!read(in, magic) || !read(in, version) || !read(in, count)
+        || magic != Magic
+        || version != Version)
+    {
+        BOOST_LOG_TRIVIAL(warning) << "Ignoring invalid hash cache " << m_file;
+        return;
+    }
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        uint32_t pathLength = 0;
+        std::string path;
+        Entry entry;
+
+        bool ok = read(in, pathLength)
+            && pathLength <= remaining(in, fileSize);
+
+        if (ok)
+        {
+            path.resize(pathLength);
+            ok = static_cast<bool>(in.read(path.data(), pathLength));
+        }
+
+        ok = ok
+            && read(in, entry.size)
+            && read(in, entry.mtime)
+            && read(in, entry.pieceLength)
+            && read(in, entry.alignment)
+            && read(in, entry.tailPadding)
+            && readHashes(in, fileSize, entry.v1)
+            && readHashes(in, fileSize, entry.v2);
+
+        if (!ok)
+        {
+            BOOST_LOG_TRIVIAL(warning) << "Hash cache " << m_file << " is truncated or corrupt, ignoring it";
+            m_entries.clear();
+            return;
+        }
+
+        m_entries.insert({ std::move(path), std::move(entry) });
+    }
+
+    BOOST_LOG_TRIVIAL(info) << "Loaded " << m_entries.size() << " file(s) from hash cache";
+}
+
+bool HashCache::Save()
+{
+    // write to a temporary file first so an interrupted save never leaves a
+    // truncated cache behind
+    fs::path tmp = m_file;
+    tmp += ".tmp";
+
+    {
+        std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+
+        write(out, Magic);
+        write(out, Version);
+        write(out, static_cast<uint32_t>(m_entries.size()));
+
+        for (auto const& [path, entry] : m_entries)
+        {
+            write(out, static_cast<uint32_t>(path.size()));
+            out.write(path.data(), static_cast<std::streamsize>(path.size()));
+
+            write(out, entry.size);
+            write(out, entry.mtime);
+            write(out, entry.pieceLength);
+            write(out, entry.alignment);
+            write(out, entry.tailPadding);
+            writeHashes(out, entry.v1);
+            writeHashes(out, entry.v2);
+        }
+
+        if (!out)
+        {
+            BOOST_LOG_TRIVIAL(error) << "Failed to write hash cache " << tmp;
+            return false;
+        }
+    }
+
+    std::error_code ec;
+    fs::rename(tmp, m_file, ec);
+
+    if (ec)
+    {
+        BOOST_LOG_TRIVIAL(error) << "Failed to replace hash cache " << m_file << ": " << ec.message();
+        return false;
+    }
+
+    return true;
+}
+
+std::int64_t HashCache::LastWriteTime(fs::path const& path)
+{
+    std::error_code ec;
+    auto time = fs::last_write_time(path, ec);
+
+    if (ec)
+    {
+        return -1;
+    }
+
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+}
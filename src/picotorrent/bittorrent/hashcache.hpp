@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <libtorrent/sha1_hash.hpp>
+
+namespace pt
+{
+namespace BitTorrent
+{
+    // Remembers the piece hashes of files that were part of a created torrent,
+    // so creating a torrent from mostly the same files again only has to hash
+    // what changed. A file is considered unchanged when its size and mtime
+    // match.
+    class HashCache
+    {
+    public:
+        struct Entry
+        {
+            std::int64_t size;
+            std::int64_t mtime;
+            int pieceLength;
+
+            // where the file starts relative to a piece boundary, and the
+            // amount of padding after it. the v1 hashes are only valid for
+            // the same layout
+            int alignment;
+            int tailPadding;
+
+            // v1 hashes of the pieces which start in this file and contain
+            // nothing but this file and its padding
+            std::vector<libtorrent::sha1_hash> v1;
+
+            // v2 piece roots, these only depend on the file itself
+            std::vector<libtorrent::sha256_hash> v2;
+        };
+
+        explicit HashCache(std::filesystem::path const& file);
+
+        Entry const* Find(std::string const& path, std::int64_t size, std::int64_t mtime, int pieceLength) const;
+        void Store(std::string const& path, Entry entry);
+
+        void Load();
+        bool Save();
+
+        // the mtime as stored in the cache, or -1 if the file is missing
+        static std::int64_t LastWriteTime(std::filesystem::path const& path);
+
+    private:
+        std::filesystem::path m_file;
+        std::unordered_map<std::string, Entry> m_entries;
+    };
+}
+}
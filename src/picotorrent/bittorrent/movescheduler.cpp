@@ -0,0 +1,208 @@
+#include "movescheduler.hpp"
+
+#include <algorithm>
+
+#include <boost/log/trivial.hpp>
+
+namespace lt = libtorrent;
+using pt::BitTorrent::MoveScheduler;
+using pt::BitTorrent::MoveStatistics;
+
+MoveScheduler::MoveScheduler(std::function<std::string(std::string const&)> volumeOf)
+    : m_volumeOf(volumeOf),
+    m_limits{ 1, 1, 3, std::chrono::seconds(30) },
+    m_finished(0),
+    m_failed(0)
+{
+}
+
+void MoveScheduler::Enqueue(lt::info_hash_t const& hash, std::string const& source, std::string const& destination, std::int64_t size)
+{
+    if (this->Empty())
+    {
+        m_finished = 0;
+        m_failed = 0;
+    }
+
+    // a newer destination replaces one that has not started yet
+    m_queued.erase(
+        std::remove_if(m_queued.begin(), m_queued.end(), [&](Move const& move) { return move.infoHash == hash; }),
+        m_queued.end());
+
+    Move move;
+    move.infoHash = hash;
+    move.source = source;
+    move.destination = destination;
+    move.sourceVolume = this->VolumeOf(source);
+    move.destinationVolume = this->VolumeOf(destination);
+    move.size = size;
+    move.attempts = 0;
+
+    this->Insert(std::move(move));
+}
+
+void MoveScheduler::Remove(lt::info_hash_t const& hash)
+{
+    m_queued.erase(
+        std::remove_if(m_queued.begin(), m_queued.end(), [&](Move const& move) { return move.infoHash == hash; }),
+        m_queued.end());
+
+    auto active = m_active.find(hash);
+
+    if (active != m_active.end())
+    {
+        this->Deactivate(active);
+    }
+}
+
+void MoveScheduler::SetLimits(Limits const& limits)
+{
+    m_limits = limits;
+}
+
+std::vector<MoveScheduler::Move> MoveScheduler::Next(std::chrono::steady_clock::time_point now)
+{
+    std::vector<Move> ready;
+
+    for (auto it = m_queued.begin(); it != m_queued.end();)
+    {
+        // paths that were new when the move was queued may be known by now
+        it->sourceVolume = this->VolumeOf(it->source);
+        it->destinationVolume = this->VolumeOf(it->destination);
+
+        // a move within a volume is a rename and does not count
+        bool const rename = it->sourceVolume == it->destinationVolume;
+
+        if (it->notBefore > now
+            || m_active.count(it->infoHash) > 0
+            || (!rename && m_activeSources[it->sourceVolume] >= m_limits.perSource)
+            || (!rename && m_activeDestinations[it->destinationVolume] >= m_limits.perDestination))
+        {
+            ++it;
+            continue;
+        }
+
+        if (!rename)
+        {
+            m_activeSources[it->sourceVolume]++;
+            m_activeDestinations[it->destinationVolume]++;
+        }
+
+        m_active.insert({ it->infoHash, *it });
+        ready.push_back(*it);
+
+        it = m_queued.erase(it);
+    }
+
+    return ready;
+}
+
+void MoveScheduler::Finished(lt::info_hash_t const& hash)
+{
+    auto active = m_active.find(hash);
+
+    if (active == m_active.end())
+    {
+        return;
+    }
+
+    this->Deactivate(active);
+    m_finished++;
+}
+
+bool MoveScheduler::Failed(lt::info_hash_t const& hash, std::chrono::steady_clock::time_point now)
+{
+    auto active = m_active.find(hash);
+
+    if (active == m_active.end())
+    {
+        return false;
+    }
+
+    Move move = active->second;
+    this->Deactivate(active);
+
+    if (move.attempts >= m_limits.retries)
+    {
+        m_failed++;
+        return false;
+    }
+
+    // wait a bit longer after each failure, the files may be in use
+    move.attempts++;
+    move.notBefore = now + m_limits.retryDelay * move.attempts;
+
+    this->Insert(std::move(move));
+
+    return true;
+}
+
+void MoveScheduler::Defer(lt::info_hash_t const& hash, std::chrono::steady_clock::time_point notBefore)
+{
+    auto active = m_active.find(hash);
+
+    if (active == m_active.end())
+    {
+        return;
+    }
+
+    Move move = active->second;
+    this->Deactivate(active);
+
+    move.notBefore = notBefore;
+
+    this->Insert(std::move(move));
+}
+
+bool MoveScheduler::Contains(lt::info_hash_t const& hash) const
+{
+    return m_active.count(hash) > 0
+        || std::any_of(m_queued.begin(), m_queued.end(), [&](Move const& move) { return move.infoHash == hash; });
+}
+
+bool MoveScheduler::Empty() const
+{
+    return m_queued.empty() && m_active.empty();
+}
+
+MoveStatistics MoveScheduler::Statistics() const
+{
+    MoveStatistics stats = { 0 };
+    stats.active = static_cast<int>(m_active.size());
+    stats.queued = static_cast<int>(m_queued.size());
+    stats.finished = m_finished;
+    stats.failed = m_failed;
+
+    for (Move const& move : m_queued) { stats.bytesRemaining += move.size; }
+    for (auto const& [hash, move] : m_active) { stats.bytesRemaining += move.size; }
+
+    return stats;
+}
+
+void MoveScheduler::Deactivate(std::map<lt::info_hash_t, Move>::iterator it)
+{
+    if (it->second.sourceVolume != it->second.destinationVolume)
+    {
+        m_activeSources[it->second.sourceVolume]--;
+        m_activeDestinations[it->second.destinationVolume]--;
+    }
+
+    m_active.erase(it);
+}
+
+void MoveScheduler::Insert(Move move)
+{
+    auto pos = std::upper_bound(
+        m_queued.begin(),
+        m_queued.end(),
+        move,
+        [](Move const& lhs, Move const& rhs) { return lhs.size < rhs.size; });
+
+    m_queued.insert(pos, std::move(move));
+}
+
+std::string MoveScheduler::VolumeOf(std::string const& path) const
+{
+    std::string root = m_volumeOf(path);
+    return root.empty() ? path : root;
+}
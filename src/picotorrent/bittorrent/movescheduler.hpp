@@ -0,0 +1,87 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <libtorrent/info_hash.hpp>
+
+#include "movestatistics.hpp"
+
+namespace pt
+{
+namespace BitTorrent
+{
+    // Queues storage moves and decides when each may start, so that only a
+    // few moves read from or write to the same volume at once. Smaller
+    // torrents go first, failed moves are tried again after a delay.
+    class MoveScheduler
+    {
+    public:
+        struct Limits
+        {
+            int perSource;
+            int perDestination;
+            int retries;
+            std::chrono::seconds retryDelay;
+        };
+
+        struct Move
+        {
+            libtorrent::info_hash_t infoHash;
+            std::string source;
+            std::string destination;
+            std::string sourceVolume;
+            std::string destinationVolume;
+            std::int64_t size;
+            int attempts;
+            std::chrono::steady_clock::time_point notBefore;
+        };
+
+        // volumeOf returns the root of the volume a path is on, or an empty
+        // string if it is not known yet. it is asked again until the move
+        // starts, and the path itself stands in for the volume until then
+        explicit MoveScheduler(std::function<std::string(std::string const&)> volumeOf);
+
+        void Enqueue(libtorrent::info_hash_t const& hash, std::string const& source, std::string const& destination, std::int64_t size);
+        void Remove(libtorrent::info_hash_t const& hash);
+        void SetLimits(Limits const& limits);
+
+        // the moves that can start now, which count as active until they
+        // either finish or fail
+        std::vector<Move> Next(std::chrono::steady_clock::time_point now);
+
+        void Finished(libtorrent::info_hash_t const& hash);
+        // returns true if the move is queued again
+        bool Failed(libtorrent::info_hash_t const& hash, std::chrono::steady_clock::time_point now);
+        // queues an active move again without counting it as an attempt,
+        // for when the torrent cannot be moved right now
+        void Defer(libtorrent::info_hash_t const& hash, std::chrono::steady_clock::time_point notBefore);
+
+        bool Contains(libtorrent::info_hash_t const& hash) const;
+        bool Empty() const;
+        MoveStatistics Statistics() const;
+
+    private:
+        void Deactivate(std::map<libtorrent::info_hash_t, Move>::iterator it);
+        void Insert(Move move);
+        std::string VolumeOf(std::string const& path) const;
+
+        std::function<std::string(std::string const&)> m_volumeOf;
+        Limits m_limits;
+
+        // sorted by size
+        std::vector<Move> m_queued;
+        std::map<libtorrent::info_hash_t, Move> m_active;
+        std::map<std::string, int> m_activeSources;
+        std::map<std::string, int> m_activeDestinations;
+
+        // since the queue was last empty
+        int m_finished;
+        int m_failed;
+    };
+}
+}
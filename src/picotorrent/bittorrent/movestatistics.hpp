@@ -0,0 +1,18 @@
+#pragma once
+
+#include <stdint.h>
+
+namespace pt
+{
+namespace BitTorrent
+{
+    struct MoveStatistics
+    {
+        int active;
+        int queued;
+        int finished;
+        int failed;
+        int64_t bytesRemaining;
+    };
+}
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+namespace pt
+{
+namespace BitTorrent
+{
+    // Seeds and leeches per peer source, counted once for each peer info
+    // snapshot so the views do not have to walk the peer list themselves.
+    struct PeerSources
+    {
+        struct Count
+        {
+            int seeds;
+            int leeches;
+        };
+
+        Count dht;
+        Count lsd;
+        Count pex;
+    };
+}
+}
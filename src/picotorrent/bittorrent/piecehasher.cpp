@@ -0,0 +1,494 @@
+#include "piecehasher.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <boost/log/trivial.hpp>
+#include <libtorrent/create_torrent.hpp>
+#include <libtorrent/file_storage.hpp>
+#include <libtorrent/hasher.hpp>
+
+#include "filereader.hpp"
+#include "hashcache.hpp"
+
+namespace fs = std::filesystem;
+namespace lt = libtorrent;
+using pt::BitTorrent::FileReader;
+using pt::BitTorrent::HashCache;
+using pt::BitTorrent::PieceHasher;
+
+// v2 hashes each file in blocks of this size
+static const int BlockSize = 0x4000;
+
+// upper bound for the piece buffers handed to the hashing threads
+static const std::int64_t MaxBufferMemory = 256 * 1024 * 1024;
+
+static const std::chrono::milliseconds ProgressInterval(250);
+
+namespace
+{
+    struct Job
+    {
+        lt::piece_index_t piece;
+        lt::file_index_t file;
+        int v1Size;
+        int v2Size;
+        std::vector<char> buffer;
+    };
+
+    struct CachedFile
+    {
+        std::string path;
+        std::int64_t mtime = -1;
+        int alignment = 0;
+        int tailPadding = 0;
+        HashCache::Entry const* entry = nullptr;
+    };
+
+    // the file a piece belongs to when it starts in that file and holds
+    // nothing else but padding
+    lt::file_index_t owningFile(lt::file_storage const& files, std::vector<lt::file_slice> const& slices)
+    {
+        lt::file_index_t owner{ -1 };
+
+        for (auto const& slice : slices)
+        {
+            if (files.pad_file_at(slice.file_index)) { continue; }
+            if (owner != lt::file_index_t{ -1 } && owner != slice.file_index) { return lt::file_index_t{ -1 }; }
+            owner = slice.file_index;
+        }
+
+        if (slices.empty() || slices.front().file_index != owner)
+        {
+            return lt::file_index_t{ -1 };
+        }
+
+        return owner;
+    }
+
+    int nextPowerOfTwo(int n)
+    {
+        int p = 1;
+        while (p < n) { p <<= 1; }
+        return p;
+    }
+
+    // the number of leaves is always a power of two here, so every layer
+    // is exactly half of the one below it
+    lt::sha256_hash merkleRoot(std::vector<lt::sha256_hash>& layer)
+    {
+        while (layer.size() > 1)
+        {
+            for (size_t i = 0; i < layer.size() / 2; i++)
+            {
+                lt::hasher256 h;
+                h.update(layer[i * 2].data(), static_cast<int>(layer[i * 2].size()));
+                h.update(layer[i * 2 + 1].data(), static_cast<int>(layer[i * 2 + 1].size()));
+                layer[i] = h.final();
+            }
+
+            layer.resize(layer.size() / 2);
+        }
+
+        return layer[0];
+    }
+}
+
+PieceHasher::PieceHasher(int threads, HashCache* cache)
+    : m_threads(threads),
+    m_cache(cache)
+{
+    if (m_threads <= 0)
+    {
+        m_threads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    }
+}
+
+lt::sha256_hash PieceHasher::PieceRoot(char const* data, int size, std::int64_t fileSize, int pieceLength)
+{
+    // files smaller than a piece are padded to the next power of two
+    // instead of to the piece boundary
+    int const fileBlocks = static_cast<int>((fileSize + BlockSize - 1) / BlockSize);
+    int const leaves = fileSize < pieceLength
+        ? nextPowerOfTwo(fileBlocks)
+        : pieceLength / BlockSize;
+
+    std::vector<lt::sha256_hash> layer(leaves);
+
+    for (int offset = 0, i = 0; offset < size; offset += BlockSize, i++)
+    {
+        layer[i] = lt::hasher256(data + offset, std::min(BlockSize, size - offset)).final();
+    }
+
+    return merkleRoot(layer);
+}
+
+void PieceHasher::Hash(
+    lt::create_torrent& ct,
+    std::string const& basePath,
+    std::function<void(Progress const&)> const& progress,
+    std::atomic<bool> const& cancelled,
+    lt::error_code& ec)
+{
+    lt::file_storage const& files = ct.files();
+
+    bool const hashV1 = !ct.is_v2_only();
+    bool const hashV2 = !ct.is_v1_only();
+    int const numPieces = ct.num_pieces();
+    int const pieceLength = ct.piece_length();
+
+    std::vector<lt::sha1_hash> v1(hashV1 ? numPieces : 0);
+    std::vector<lt::sha256_hash> v2(hashV2 ? numPieces : 0);
+    std::vector<lt::file_index_t> v2Files(hashV2 ? numPieces : 0, lt::file_index_t{ -1 });
+    std::vector<lt::file_index_t> owners(m_cache ? numPieces : 0, lt::file_index_t{ -1 });
+    std::vector<CachedFile> cached(m_cache ? files.num_files() : 0);
+    int piecesCached = 0;
+
+    for (lt::file_index_t f(0); m_cache && f < files.end_file(); ++f)
+    {
+        if (files.pad_file_at(f))
+        {
+            continue;
+        }
+
+        lt::file_index_t const next(static_cast<int>(f) + 1);
+        std::error_code fec;
+
+        CachedFile& c = cached[static_cast<int>(f)];
+        c.path = fs::absolute(fs::u8path(files.file_path(f, basePath)), fec).lexically_normal().u8string();
+        c.mtime = HashCache::LastWriteTime(fs::u8path(c.path));
+        c.alignment = static_cast<int>(files.file_offset(f) % pieceLength);
+        c.tailPadding = next < files.end_file() && files.pad_file_at(next)
+            ? static_cast<int>(files.file_size(next))
+            : 0;
+
+        if (c.mtime < 0)
+        {
+            continue;
+        }
+
+        c.entry = m_cache->Find(c.path, files.file_size(f), c.mtime, pieceLength);
+    }
+
+    std::mutex mutex;
+    std::condition_variable workAvailable;
+    std::condition_variable bufferAvailable;
+    std::deque<Job> pending;
+    std::vector<std::vector<char>> buffers;
+    bool done = false;
+
+    std::atomic<std::int64_t> bytesHashed{ 0 };
+    std::atomic<int> piecesHashed{ 0 };
+
+    int const numBuffers = static_cast<int>(std::clamp<std::int64_t>(
+        MaxBufferMemory / pieceLength,
+        2,
+        m_threads * 2));
+
+    for (int i = 0; i < numBuffers; i++)
+    {
+        buffers.emplace_back(pieceLength);
+    }
+
+    auto hashPiece = [&](Job& job)
+    {
+        int const idx = static_cast<int>(job.piece);
+
+        if (hashV1)
+        {
+            v1[idx] = lt::hasher(job.buffer.data(), job.v1Size).final();
+        }
+
+        if (hashV2 && job.file != lt::file_index_t{ -1 })
+        {
+            v2[idx] = PieceRoot(job.buffer.data(), job.v2Size, files.file_size(job.file), pieceLength);
+        }
+    };
+
+    std::vector<std::thread> workers;
+
+    for (int i = 0; i < m_threads; i++)
+    {
+        workers.emplace_back(
+            [&]()
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+
+                for (;;)
+                {
+                    workAvailable.wait(lock, [&]() { return done || !pending.empty(); });
+
+                    if (pending.empty())
+                    {
+                        return;
+                    }
+
+                    Job job = std::move(pending.front());
+                    pending.pop_front();
+
+                    lock.unlock();
+                    hashPiece(job);
+                    lock.lock();
+
+                    bytesHashed += job.v1Size;
+                    piecesHashed++;
+
+                    buffers.push_back(std::move(job.buffer));
+                    bufferAvailable.notify_one();
+                }
+            });
+    }
+
+    auto begin = std::chrono::steady_clock::now();
+    auto lastReport = begin;
+
+    auto report = [&](bool force)
+    {
+        auto now = std::chrono::steady_clock::now();
+
+        if (!progress || (!force && now - lastReport < ProgressInterval))
+        {
+            return;
+        }
+
+        lastReport = now;
+
+        double const elapsed = std::chrono::duration<double>(now - begin).count();
+
+        Progress p;
+        p.bytesHashed = bytesHashed;
+        p.totalBytes = files.total_size();
+        p.piecesHashed = piecesHashed;
+        p.totalPieces = numPieces;
+        p.bytesPerSecond = elapsed > 0 ? p.bytesHashed / elapsed : 0;
+
+        progress(p);
+    };
+
+    // the files are read in piece order, which is the order they are laid out
+    // in, so each file is opened once and read front to back, straight into
+    // the piece buffers
+    FileReader file;
+    lt::file_index_t openFile{ -1 };
+
+    auto read = [&](lt::file_slice const& slice, char* dst) -> bool
+    {
+        if (openFile != slice.file_index)
+        {
+            openFile = slice.file_index;
+
+            if (!file.Open(files.file_path(slice.file_index, basePath), ec))
+            {
+                return false;
+            }
+        }
+
+        return file.Read(slice.offset, dst, slice.size, ec);
+    };
+
+    for (lt::piece_index_t piece(0); piece < lt::piece_index_t(numPieces); ++piece)
+    {
+        Job job;
+        job.piece = piece;
+        job.file = lt::file_index_t{ -1 };
+        job.v1Size = files.piece_size(piece);
+        job.v2Size = 0;
+
+        int const idx = static_cast<int>(piece);
+        std::vector<lt::file_slice> const slices = files.map_block(piece, 0, job.v1Size);
+
+        if (m_cache)
+        {
+            lt::file_index_t const owner = owningFile(files, slices);
+            owners[idx] = owner;
+
+            CachedFile const* c = owner != lt::file_index_t{ -1 }
+                ? &cached[static_cast<int>(owner)]
+                : nullptr;
+
+            if (c && c->entry)
+            {
+                std::int64_t const offset = slices.front().offset;
+                std::int64_t const first = (pieceLength - c->alignment) % pieceLength;
+                size_t const v1Index = static_cast<size_t>((offset - first) / pieceLength);
+                size_t const v2Index = static_cast<size_t>(offset / pieceLength);
+
+                // the v1 hashes can only be reused if the file sits at the same
+                // place relative to the piece boundaries as when it was cached,
+                // and the last one only if it is padded the same way
+                bool const isTail = offset + pieceLength >= files.file_size(owner);
+                bool const v1Hit = !hashV1
+                    || (c->entry->alignment == c->alignment
+                        && (!isTail || c->entry->tailPadding == c->tailPadding)
+                        && v1Index < c->entry->v1.size());
+                bool const v2Hit = !hashV2 || v2Index < c->entry->v2.size();
+
+                if (v1Hit && v2Hit)
+                {
+                    if (hashV1) { v1[idx] = c->entry->v1[v1Index]; }
+                    if (hashV2) { v2[idx] = c->entry->v2[v2Index]; v2Files[idx] = owner; }
+
+                    bytesHashed += job.v1Size;
+                    piecesHashed++;
+                    piecesCached++;
+
+                    report(false);
+                    continue;
+                }
+            }
+        }
+
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+
+            while (buffers.empty() && !cancelled)
+            {
+                bufferAvailable.wait_for(lock, ProgressInterval);
+                lock.unlock();
+                report(false);
+                lock.lock();
+            }
+
+            if (cancelled)
+            {
+                ec = boost::system::errc::make_error_code(boost::system::errc::operation_canceled);
+                break;
+            }
+
+            job.buffer = std::move(buffers.back());
+            buffers.pop_back();
+        }
+
+        int offset = 0;
+
+        for (lt::file_slice const& slice : slices)
+        {
+            char* dst = job.buffer.data() + offset;
+            offset += static_cast<int>(slice.size);
+
+            // pad files only exist to align pieces to files, they are all zeros
+            if (files.pad_file_at(slice.file_index))
+            {
+                std::memset(dst, 0, static_cast<size_t>(slice.size));
+                continue;
+            }
+
+            if (!read(slice, dst))
+            {
+                break;
+            }
+
+            // with v2 a piece never spans more than one file, any remaining
+            // slices are padding
+            job.file = slice.file_index;
+            job.v2Size += static_cast<int>(slice.size);
+        }
+
+        if (ec)
+        {
+            BOOST_LOG_TRIVIAL(error) << "Failed to read piece " << static_cast<int>(piece) << " from " << files.file_path(openFile, basePath) << ": " << ec.message();
+            break;
+        }
+
+        if (hashV2)
+        {
+            v2Files[idx] = job.file;
+        }
+
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            pending.push_back(std::move(job));
+        }
+
+        workAvailable.notify_one();
+        report(false);
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        done = true;
+
+        // on errors there is no point hashing what is left
+        if (ec) { pending.clear(); }
+    }
+
+    workAvailable.notify_all();
+
+    for (auto& worker : workers)
+    {
+        worker.join();
+    }
+
+    if (ec)
+    {
+        return;
+    }
+
+    report(true);
+
+    for (lt::piece_index_t piece(0); piece < lt::piece_index_t(numPieces); ++piece)
+    {
+        int const idx = static_cast<int>(piece);
+
+        if (hashV1)
+        {
+            ct.set_hash(piece, v1[idx]);
+        }
+
+        if (hashV2 && v2Files[idx] != lt::file_index_t{ -1 })
+        {
+            ct.set_hash2(
+                v2Files[idx],
+                piece - files.piece_index_at_file(v2Files[idx]),
+                v2[idx]);
+        }
+    }
+
+    if (m_cache)
+    {
+        std::vector<HashCache::Entry> entries(cached.size());
+
+        for (int idx = 0; idx < numPieces; idx++)
+        {
+            if (hashV1 && owners[idx] != lt::file_index_t{ -1 })
+            {
+                entries[static_cast<int>(owners[idx])].v1.push_back(v1[idx]);
+            }
+
+            if (hashV2 && v2Files[idx] != lt::file_index_t{ -1 })
+            {
+                entries[static_cast<int>(v2Files[idx])].v2.push_back(v2[idx]);
+            }
+        }
+
+        for (lt::file_index_t f(0); f < files.end_file(); ++f)
+        {
+            CachedFile const& c = cached[static_cast<int>(f)];
+
+            if (files.pad_file_at(f) || c.mtime < 0)
+            {
+                continue;
+            }
+
+            HashCache::Entry& entry = entries[static_cast<int>(f)];
+            entry.size = files.file_size(f);
+            entry.mtime = c.mtime;
+            entry.pieceLength = pieceLength;
+            entry.alignment = c.alignment;
+            entry.tailPadding = c.tailPadding;
+
+            m_cache->Store(c.path, std::move(entry));
+        }
+    }
+
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+    BOOST_LOG_TRIVIAL(info) << "Hashed " << numPieces << " piece(s) on " << m_threads << " thread(s) in " << elapsed << " s, " << piecesCached << " from cache";
+}
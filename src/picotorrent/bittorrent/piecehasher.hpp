@@ -0,0 +1,57 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+#include <libtorrent/error_code.hpp>
+#include <libtorrent/fwd.hpp>
+#include <libtorrent/sha1_hash.hpp>
+
+namespace pt
+{
+namespace BitTorrent
+{
+    class HashCache;
+
+    // Computes the piece hashes for a create_torrent. One thread reads the
+    // pieces sequentially in large reads while a pool of threads hashes them.
+    // v1 SHA-1 piece hashes and v2 SHA-256 piece roots are computed in the
+    // same pass for hybrid torrents.
+    class PieceHasher
+    {
+    public:
+        struct Progress
+        {
+            std::int64_t bytesHashed;
+            std::int64_t totalBytes;
+            int piecesHashed;
+            int totalPieces;
+            double bytesPerSecond;
+        };
+
+        // threads <= 0 uses one thread per core. with a cache, pieces of
+        // files that did not change since they were last hashed are taken
+        // from it, and the cache is updated with the new hashes
+        explicit PieceHasher(int threads = 0, HashCache* cache = nullptr);
+
+        // the v2 hash of a piece of a file, size is the part of the piece
+        // that holds file data
+        static libtorrent::sha256_hash PieceRoot(char const* data, int size, std::int64_t fileSize, int pieceLength);
+
+        // progress is called on the reading thread at most a few times per
+        // second, and once more when all pieces are hashed
+        void Hash(
+            libtorrent::create_torrent& ct,
+            std::string const& basePath,
+            std::function<void(Progress const&)> const& progress,
+            std::atomic<bool> const& cancelled,
+            libtorrent::error_code& ec);
+
+    private:
+        int m_threads;
+        HashCache* m_cache;
+    };
+}
+}
@@ -0,0 +1,333 @@
+#include "scrubber.hpp"
+
+#ifdef _WIN32
+#include <Windows.h>
+#elif defined(__linux__)
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include <chrono>
+#include <cstring>
+
+#include <boost/log/trivial.hpp>
+#include <libtorrent/file_storage.hpp>
+#include <libtorrent/hasher.hpp>
+#include <libtorrent/torrent_info.hpp>
+#include <libtorrent/torrent_status.hpp>
+
+#include "filereader.hpp"
+#include "piecehasher.hpp"
+
+namespace lt = libtorrent;
+using pt::BitTorrent::Scrubber;
+
+// how often progress is reported, and with it persisted
+static const int ReportInterval = 64;
+
+namespace
+{
+    void lowerIoPriority()
+    {
+#ifdef _WIN32
+        // background mode lowers both the CPU and the I/O priority
+        SetThreadPriority(GetCurrentThread(), THREAD_MODE_BACKGROUND_BEGIN);
+#elif defined(__linux__)
+        // IOPRIO_CLASS_IDLE for the calling thread, glibc has no wrapper
+        syscall(SYS_ioprio_set, 1, 0, 3 << 13);
+#endif
+    }
+
+    bool verify(lt::torrent_info const& ti, lt::piece_index_t piece, std::vector<char> const& buffer)
+    {
+        lt::file_storage const& files = ti.files();
+
+        if (ti.info_hashes().has_v1())
+        {
+            return lt::hasher(buffer.data(), static_cast<int>(buffer.size())).final() == ti.hash_for_piece(piece);
+        }
+
+        // v2 pieces never span files, anything after the first slice is padding
+        lt::file_slice const slice = files.map_block(piece, 0, static_cast<int>(buffer.size())).front();
+        std::int64_t const fileSize = files.file_size(slice.file_index);
+
+        lt::sha256_hash const root = pt::BitTorrent::PieceHasher::PieceRoot(
+            buffer.data(),
+            static_cast<int>(slice.size),
+            fileSize,
+            ti.piece_length());
+
+        if (fileSize <= ti.piece_length())
+        {
+            return root == files.root(slice.file_index);
+        }
+
+        auto layer = ti.piece_layer(slice.file_index);
+        std::ptrdiff_t const hashSize = static_cast<std::ptrdiff_t>(lt::sha256_hash::size());
+        std::ptrdiff_t const offset = static_cast<int>(piece - files.piece_index_at_file(slice.file_index)) * hashSize;
+
+        // without the piece layer there is nothing to compare with
+        if (layer.size() < offset + hashSize)
+        {
+            return true;
+        }
+
+        return std::memcmp(layer.data() + offset, root.data(), root.size()) == 0;
+    }
+}
+
+Scrubber::Scrubber(std::function<void(Progress)> report)
+    : m_report(report),
+    m_rate(0),
+    m_paused(false),
+    m_stop(false)
+{
+    m_thread = std::thread(&Scrubber::Run, this);
+}
+
+Scrubber::~Scrubber()
+{
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+
+    m_wake.notify_all();
+    m_thread.join();
+}
+
+void Scrubber::SetTargets(std::vector<Target> targets)
+{
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_targets = std::move(targets);
+    }
+
+    m_wake.notify_all();
+}
+
+void Scrubber::SetPaused(bool paused)
+{
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (m_paused == paused) { return; }
+        m_paused = paused;
+    }
+
+    m_wake.notify_all();
+}
+
+void Scrubber::SetRate(std::int64_t bytesPerSecond)
+{
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_rate = bytesPerSecond;
+    }
+
+    m_wake.notify_all();
+}
+
+bool Scrubber::ReadPiece(
+    lt::file_storage const& files,
+    std::string const& savePath,
+    lt::piece_index_t piece,
+    std::vector<char>& buffer,
+    FileReader& file,
+    lt::error_code& ec)
+{
+    int const size = files.piece_size(piece);
+    int offset = 0;
+
+    buffer.assign(size, 0);
+
+    for (lt::file_slice const& slice : files.map_block(piece, 0, size))
+    {
+        if (!files.pad_file_at(slice.file_index))
+        {
+            std::string const path = files.file_path(slice.file_index, savePath);
+
+            if ((!file.IsOpen() || file.Path() != path)
+                && !file.Open(path, ec))
+            {
+                return false;
+            }
+
+            if (!file.Read(slice.offset, buffer.data() + offset, slice.size, ec))
+            {
+                return false;
+            }
+        }
+
+        offset += static_cast<int>(slice.size);
+    }
+
+    return true;
+}
+
+bool Scrubber::Idle() const
+{
+    return m_paused || m_rate <= 0 || m_targets.empty();
+}
+
+void Scrubber::Run()
+{
+    lowerIoPriority();
+
+    for (;;)
+    {
+        Target target;
+
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [this]() { return m_stop || !Idle(); });
+
+            if (m_stop)
+            {
+                return;
+            }
+
+            target = m_targets.front();
+        }
+
+        Scrub(target);
+    }
+}
+
+void Scrubber::Scrub(Target target)
+{
+    std::shared_ptr<const lt::torrent_info> ti;
+    lt::torrent_status status;
+
+    try
+    {
+        ti = target.handle.torrent_file_with_hashes();
+        status = target.handle.status(lt::torrent_handle::query_save_path);
+    }
+    catch (lt::system_error const&)
+    {
+    }
+
+    auto dropTarget = [&]()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+
+        if (!m_targets.empty() && m_targets.front().handle == target.handle)
+        {
+            m_targets.erase(m_targets.begin());
+        }
+    };
+
+    // the torrent went away, it is gone from the next list of targets too.
+    // the files of a torrent in error or being moved are left alone
+    if (!ti || status.errc || status.moving_storage)
+    {
+        dropTarget();
+        return;
+    }
+
+    Progress progress;
+    progress.infoHash = status.info_hashes;
+    progress.next = target.next;
+    progress.finished = false;
+
+    std::vector<char> buffer;
+    FileReader file;
+    auto windowStart = std::chrono::steady_clock::now();
+    std::int64_t windowBytes = 0;
+    int sinceReport = 0;
+
+    auto current = [&]()
+    {
+        return !m_stop
+            && !Idle()
+            && m_targets.front().handle == target.handle;
+    };
+
+    while (progress.next < ti->end_piece())
+    {
+        std::int64_t rate;
+
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+
+            if (!current())
+            {
+                break;
+            }
+
+            rate = m_rate;
+        }
+
+        lt::piece_index_t const piece = progress.next;
+
+        try
+        {
+            // pieces we do not have yet are verified when they are downloaded
+            if (target.handle.have_piece(piece))
+            {
+                // a file that cannot be read says nothing about the data,
+                // the torrent is left until the session tries it again
+                if (!ReadPiece(ti->files(), status.save_path, piece, buffer, file, progress.error))
+                {
+                    BOOST_LOG_TRIVIAL(warning) << "Scrub could not read piece " << static_cast<int>(piece) << " of " << ti->name() << ": " << progress.error.message();
+                    dropTarget();
+                    m_report(progress);
+                    return;
+                }
+
+                if (!verify(*ti, piece, buffer))
+                {
+                    BOOST_LOG_TRIVIAL(warning) << "Scrub found corrupt piece " << static_cast<int>(piece) << " in " << ti->name();
+                    progress.corrupt.push_back(piece);
+                }
+
+                windowBytes += ti->piece_size(piece);
+            }
+        }
+        catch (lt::system_error const&)
+        {
+            dropTarget();
+            return;
+        }
+
+        ++progress.next;
+
+        if (++sinceReport >= ReportInterval)
+        {
+            m_report(progress);
+            progress.corrupt.clear();
+            sinceReport = 0;
+        }
+
+        // stay within the rate budget, but wake up early when paused or
+        // when there is something more important to scrub
+        auto const budget = std::chrono::duration<double>(static_cast<double>(windowBytes) / rate);
+        auto const elapsed = std::chrono::steady_clock::now() - windowStart;
+
+        if (budget > elapsed)
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait_for(
+                lock,
+                std::chrono::duration_cast<std::chrono::milliseconds>(budget - elapsed),
+                [&]() { return !current(); });
+        }
+
+        // a long window would allow bursts after a pause
+        if (elapsed > std::chrono::seconds(10))
+        {
+            windowStart = std::chrono::steady_clock::now();
+            windowBytes = 0;
+        }
+    }
+
+    if (progress.next >= ti->end_piece())
+    {
+        progress.finished = true;
+
+        BOOST_LOG_TRIVIAL(info) << "Finished scrubbing " << ti->name();
+        dropTarget();
+    }
+
+    m_report(progress);
+}
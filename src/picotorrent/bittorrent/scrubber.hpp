@@ -0,0 +1,85 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <libtorrent/error_code.hpp>
+#include <libtorrent/fwd.hpp>
+#include <libtorrent/info_hash.hpp>
+#include <libtorrent/torrent_handle.hpp>
+#include <libtorrent/units.hpp>
+
+namespace pt
+{
+namespace BitTorrent
+{
+    class FileReader;
+
+    // Verifies the pieces of seeding torrents in the background, one torrent
+    // at a time, on a thread with lowered I/O priority and within a byte rate
+    // budget. Seeding continues while a torrent is being scrubbed.
+    class Scrubber
+    {
+    public:
+        struct Target
+        {
+            libtorrent::torrent_handle handle;
+            libtorrent::piece_index_t next;
+        };
+
+        struct Progress
+        {
+            libtorrent::info_hash_t infoHash;
+            libtorrent::piece_index_t next;
+            bool finished;
+            std::vector<libtorrent::piece_index_t> corrupt;
+            // the files could not be read, scrubbing stopped at next
+            libtorrent::error_code error;
+        };
+
+        // report is called on the scrubber thread
+        explicit Scrubber(std::function<void(Progress)> report);
+        ~Scrubber();
+
+        // the torrents to scrub, in order. the current torrent is left as soon
+        // as it is not first in the list anymore
+        void SetTargets(std::vector<Target> targets);
+
+        // pausing takes effect after the piece being read
+        void SetPaused(bool paused);
+        void SetRate(std::int64_t bytesPerSecond);
+
+        // reads a whole piece, with pad files as zeros. the last file read is
+        // kept open in file for the next piece. returns false and sets ec if
+        // any part of it could not be read
+        static bool ReadPiece(
+            libtorrent::file_storage const& files,
+            std::string const& savePath,
+            libtorrent::piece_index_t piece,
+            std::vector<char>& buffer,
+            FileReader& file,
+            libtorrent::error_code& ec);
+
+    private:
+        bool Idle() const;
+        void Run();
+        void Scrub(Target target);
+
+        std::function<void(Progress)> m_report;
+
+        mutable std::mutex m_mutex;
+        std::condition_variable m_wake;
+        std::vector<Target> m_targets;
+        std::int64_t m_rate;
+        bool m_paused;
+        bool m_stop;
+
+        std::thread m_thread;
+    };
+}
+}
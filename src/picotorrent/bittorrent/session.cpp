@@ -1,6 +1,10 @@
 #include "session.hpp"
 
+#include <algorithm>
+#include <chrono>
+#include <deque>
 #include <filesystem>
+#include <optional>
 #include <queue>
 
 #include <boost/log/trivial.hpp>
@@ -28,28 +32,45 @@
 
 #include "../core/configuration.hpp"
 #include "../core/database.hpp"
+#include "../core/diskspacemonitor.hpp"
 #include "../core/environment.hpp"
 #include "../core/utils.hpp"
 #include "../buildinfo.hpp"
 #include "addparams.hpp"
+#include "filejournal.hpp"
+#include "filereader.hpp"
+#include "movescheduler.hpp"
+#include "scrubber.hpp"
 #include "semver.hpp"
+#include "sessionmetrics.hpp"
 #include "sessionstatistics.hpp"
 #include "torrenthandle.hpp"
 #include "torrentstatistics.hpp"
+#include "torrentstatus.hpp"
 
 namespace fs = std::filesystem;
 namespace lt = libtorrent;
+using pt::BitTorrent::Scrubber;
 using pt::BitTorrent::Session;
 
+wxDEFINE_EVENT(ptEVT_DISK_SPACE_LOW, wxCommandEvent);
+wxDEFINE_EVENT(ptEVT_MOVE_STATISTICS, pt::BitTorrent::MoveStatisticsEvent);
 wxDEFINE_EVENT(ptEVT_SESSION_DEBUG_MESSAGE, wxCommandEvent);
 wxDEFINE_EVENT(ptEVT_SESSION_STATISTICS, pt::BitTorrent::SessionStatisticsEvent);
 wxDEFINE_EVENT(ptEVT_TORRENT_ADDED, wxCommandEvent);
+wxDEFINE_EVENT(ptEVT_TORRENT_CORRUPT_PIECES, wxCommandEvent);
+wxDEFINE_EVENT(ptEVT_TORRENT_FILE_PROGRESS, wxCommandEvent);
 wxDEFINE_EVENT(ptEVT_TORRENT_FINISHED, wxCommandEvent);
 wxDEFINE_EVENT(ptEVT_TORRENT_METADATA_FOUND, pt::BitTorrent::MetadataFoundEvent);
+wxDEFINE_EVENT(ptEVT_TORRENT_PEER_INFO, wxCommandEvent);
+wxDEFINE_EVENT(ptEVT_TORRENT_PIECE_AVAILABILITY, wxCommandEvent);
 wxDEFINE_EVENT(ptEVT_TORRENT_REMOVED, pt::BitTorrent::InfoHashEvent);
 wxDEFINE_EVENT(ptEVT_TORRENT_STATISTICS, pt::BitTorrent::TorrentStatisticsEvent);
+wxDEFINE_EVENT(ptEVT_TORRENT_TRACKERS, wxCommandEvent);
 wxDEFINE_EVENT(ptEVT_TORRENTS_UPDATED, pt::BitTorrent::TorrentsUpdatedEvent);
 wxDEFINE_EVENT(ptEVT_IPFILTER_UPDATED, wxThreadEvent);
+wxDEFINE_EVENT(ptEVT_SCRUB_PROGRESS, wxThreadEvent);
+wxDEFINE_EVENT(ptEVT_DISK_SPACE_CHANGED, wxThreadEvent);
 
 static std::string str(lt::info_hash_t ih)
 {
@@ -67,6 +88,145 @@ static std::string str(lt::info_hash_t ih)
     return ss.str();
 }
 
+// true if path is dir or somewhere below it. trailing separators and, on
+// Windows, the case and the kind of separator do not matter
+static bool isPathUnder(std::string const& path, std::string const& dir)
+{
+    fs::path const p = fs::u8path(path).lexically_normal();
+    fs::path const d = fs::u8path(dir).lexically_normal();
+    auto part = p.begin();
+
+    for (fs::path const& expected : d)
+    {
+        // the empty element after a trailing separator
+        if (expected.empty())
+        {
+            continue;
+        }
+
+        if (part == p.end())
+        {
+            return false;
+        }
+
+#ifdef _WIN32
+        if (_wcsicmp(part->c_str(), expected.c_str()) != 0)
+#else
+        if (*part != expected)
+#endif
+        {
+            return false;
+        }
+
+        ++part;
+    }
+
+    return true;
+}
+
+// pieces handed to libtorrent by an incremental recheck that may be waiting
+// to be hashed at once
+static const size_t MaxRestoreQueue = 16;
+
+// how often the list of torrents to scrub is rebuilt
+static const int ScrubTargetsInterval = 60 * 1000;
+// how long a move waits when its torrent is resetting pieces
+static const std::chrono::seconds MoveDeferDelay(5);
+
+// a torrent whose files could not be read is left alone this long
+static const std::time_t ScrubRetryDelay = 60 * 60;
+
+// how often the disk usage of each label's save path is checked
+static const int StorageTiersInterval = 60 * 1000;
+
+// session stats are posted every second, keep ten minutes of them
+static const size_t MetricsHistory = 600;
+
+// makes libtorrent forget that it has some pieces, for an incremental recheck
+// or after the scrubber found them corrupt
+struct Session::PieceResetState
+{
+    enum class Stage
+    {
+        // waiting for the resume data
+        Saving,
+        // waiting for the torrent to be removed from the session
+        Removing,
+        // waiting for it to be added again
+        Adding
+    };
+
+    Stage stage;
+    TorrentHandle* handle;
+    std::vector<lt::piece_index_t> pieces;
+    // the pieces we have, if the resume data does not say
+    lt::typed_bitfield<lt::piece_index_t> fallback;
+    // read the pieces from disk again instead of downloading them
+    bool restore;
+    lt::add_torrent_params params;
+};
+
+// reads the pieces from disk and hands them to libtorrent, which hashes them
+// and marks the ones that pass as have. the others are downloaded again like
+// any other missing piece
+static void restorePieces(
+    lt::torrent_handle th,
+    std::shared_ptr<const lt::torrent_info> ti,
+    std::string savePath,
+    std::vector<lt::piece_index_t> pieces,
+    std::atomic<bool> const& cancelled)
+{
+    lt::file_storage const& files = ti->files();
+    std::deque<lt::piece_index_t> queued;
+    std::vector<char> buffer;
+    FileReader file;
+    int restored = 0;
+
+    try
+    {
+        for (lt::piece_index_t piece : pieces)
+        {
+            // wait for the oldest queued piece, it never turns up if it failed
+            while (queued.size() >= MaxRestoreQueue && !cancelled)
+            {
+                auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+
+                while (!cancelled
+                    && !th.have_piece(queued.front())
+                    && std::chrono::steady_clock::now() < deadline)
+                {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+                }
+
+                queued.pop_front();
+            }
+
+            if (cancelled)
+            {
+                return;
+            }
+
+            lt::error_code ec;
+
+            if (!Scrubber::ReadPiece(files, savePath, piece, buffer, file, ec))
+            {
+                continue;
+            }
+
+            th.add_piece(piece, buffer.data());
+            queued.push_back(piece);
+            restored++;
+        }
+    }
+    catch (lt::system_error const& ex)
+    {
+        BOOST_LOG_TRIVIAL(warning) << "Incremental recheck stopped: " << ex.what();
+        return;
+    }
+
+    BOOST_LOG_TRIVIAL(info) << "Incremental recheck read " << restored << " of " << pieces.size() << " piece(s) from disk";
+}
+
 static lt::session_params getSessionParams(std::shared_ptr<pt::Core::Database> db)
 {
     lt::session_params sp;
@@ -204,6 +364,53 @@ static lt::settings_pack getSettingsPack(std::shared_ptr<pt::Core::Configuration
     return settings;
 }
 
+static std::optional<pt::Core::Configuration::Label> getLabel(std::shared_ptr<pt::Core::Configuration> cfg, int id)
+{
+    if (id < 0)
+    {
+        return std::nullopt;
+    }
+
+    for (auto const& label : cfg->GetLabels())
+    {
+        if (label.id == id)
+        {
+            return label;
+        }
+    }
+
+    return std::nullopt;
+}
+
+// a label with storage tiers seeds from its save path, the fast tier, until
+// the volume runs full and only then moves torrents to the completed path
+static bool hasStorageTiers(pt::Core::Configuration::Label const& label)
+{
+    return label.completedPathEnabled
+        && !label.completedPath.empty()
+        && label.watermarksEnabled
+        && label.savePathEnabled
+        && !label.savePath.empty();
+}
+
+static int getDiskSpaceLimit(std::shared_ptr<pt::Core::Configuration> cfg)
+{
+    return cfg->Get<bool>("pause_on_low_disk_space").value()
+        ? cfg->Get<int>("pause_on_low_disk_space_limit").value()
+        : 0;
+}
+
+static pt::BitTorrent::MoveScheduler::Limits getMoveLimits(std::shared_ptr<pt::Core::Configuration> cfg)
+{
+    pt::BitTorrent::MoveScheduler::Limits limits;
+    limits.perSource = std::max(1, cfg->Get<int>("move_queue.per_source").value_or(1));
+    limits.perDestination = std::max(1, cfg->Get<int>("move_queue.per_destination").value_or(1));
+    limits.retries = cfg->Get<int>("move_queue.retries").value_or(3);
+    limits.retryDelay = std::chrono::seconds(cfg->Get<int>("move_queue.retry_delay").value_or(30));
+
+    return limits;
+}
+
 bool ParseIPv4Address(std::string const& input, lt::address& output)
 {
     // make 001.002.123.020 -> 1.2.123.20
@@ -244,9 +451,13 @@ Session::Session(wxEvtHandler* parent, std::shared_ptr<pt::Core::Database> db, s
     : m_parent(parent),
     m_timer(new wxTimer(this, ptID_TIMER_SESSION)),
     m_resumeDataTimer(new wxTimer(this, ptID_TIMER_RESUME_DATA)),
+    m_scrubTimer(new wxTimer(this, ptID_TIMER_SCRUB)),
+    m_storageTiersTimer(new wxTimer(this, ptID_TIMER_STORAGE_TIERS)),
     m_cfg(cfg),
     m_db(db),
-    m_env(env)
+    m_env(env),
+    m_closing(false),
+    m_diskSpacePathsDirty(false)
 {
     lt::ip_filter ipf;
 
@@ -290,9 +501,43 @@ Session::Session(wxEvtHandler* parent, std::shared_ptr<pt::Core::Database> db, s
             this->CallAfter(std::bind(&Session::OnAlert, this));
         });
 
+    m_scrubber = std::make_unique<Scrubber>(
+        [this](Scrubber::Progress progress)
+        {
+            auto evt = new wxThreadEvent(ptEVT_SCRUB_PROGRESS);
+            evt->SetPayload(progress);
+            wxQueueEvent(this, evt);
+        });
+
+    m_diskSpaceMonitor = std::make_unique<Core::DiskSpaceMonitor>(
+        [this](Core::DiskSpaceMonitor::Volume const& volume)
+        {
+            auto evt = new wxThreadEvent(ptEVT_DISK_SPACE_CHANGED);
+            evt->SetPayload(volume);
+            wxQueueEvent(this, evt);
+        });
+
+    m_diskSpaceMonitor->SetLimit(getDiskSpaceLimit(cfg));
+
+    m_metrics = std::make_unique<SessionMetrics>(MetricsHistory);
+    m_dhtNodesMetric = m_metrics->Find("dht.dht_nodes");
+
+    // volumes are resolved on the monitor thread, which watches the move
+    // destinations too
+    m_moveScheduler = std::make_unique<MoveScheduler>(
+        [this](std::string const& path)
+        {
+            Core::DiskSpaceMonitor::Volume volume;
+            return m_diskSpaceMonitor && m_diskSpaceMonitor->Find(path, volume) ? volume.root : std::string();
+        });
+    m_moveScheduler->SetLimits(getMoveLimits(cfg));
+
+    this->LoadScrubRecords();
     this->LoadTorrents();
 
     m_timer->Start(1000, wxTIMER_CONTINUOUS);
+    m_scrubTimer->Start(ScrubTargetsInterval, wxTIMER_CONTINUOUS);
+    m_storageTiersTimer->Start(StorageTiersInterval, wxTIMER_CONTINUOUS);
 
     if (auto saveInterval = m_cfg->Get<int>("save_resume_data_interval"))
     {
@@ -306,6 +551,12 @@ Session::Session(wxEvtHandler* parent, std::shared_ptr<pt::Core::Database> db, s
             m_session->post_dht_stats();
             m_session->post_session_stats();
             m_session->post_torrent_updates();
+
+            // moves waiting to be tried again
+            if (!m_moveScheduler->Empty())
+            {
+                this->ScheduleMoves();
+            }
         },
         ptID_TIMER_SESSION);
 
@@ -318,12 +569,28 @@ Session::Session(wxEvtHandler* parent, std::shared_ptr<pt::Core::Database> db, s
         });
 
     this->Bind(wxEVT_TIMER, &Session::OnSaveResumeDataTimer, this, ptID_TIMER_RESUME_DATA);
+    this->Bind(wxEVT_TIMER, [this](wxTimerEvent&) { UpdateScrubTargets(); }, ptID_TIMER_SCRUB);
+    this->Bind(wxEVT_TIMER, [this](wxTimerEvent&) { UpdateStorageTiers(); }, ptID_TIMER_STORAGE_TIERS);
+    this->Bind(ptEVT_SCRUB_PROGRESS, &Session::OnScrubProgress, this);
+    this->Bind(ptEVT_DISK_SPACE_CHANGED, &Session::OnDiskSpaceChanged, this);
 }
 
 Session::~Session()
 {
     if (m_filterLoader.joinable()) m_filterLoader.join();
 
+    m_scrubTimer->Stop();
+    m_storageTiersTimer->Stop();
+    m_scrubber.reset();
+    m_diskSpaceMonitor.reset();
+
+    m_closing = true;
+
+    for (auto& worker : m_recheckWorkers)
+    {
+        worker.thread.join();
+    }
+
     m_session->set_alert_notify([] {});
     m_timer->Stop();
     m_resumeDataTimer->Stop();
@@ -423,9 +690,20 @@ void Session::RemoveMetadataSearch(std::vector<lt::info_hash_t> const& hashes)
 
 void Session::RemoveTorrent(pt::BitTorrent::TorrentHandle* torrent, lt::remove_flags_t flags)
 {
+    if (torrent->IsResetting())
+    {
+        BOOST_LOG_TRIVIAL(warning) << "Torrent is resetting pieces, not removing it (" << str(torrent->InfoHash()) << ")";
+        return;
+    }
+
     m_session->remove_torrent(torrent->WrappedHandle(), flags);
 }
 
+pt::BitTorrent::SessionMetrics const& Session::Metrics() const
+{
+    return *m_metrics;
+}
+
 void Session::ReloadSettings()
 {
     lt::settings_pack settings = getSettingsPack(m_cfg);
@@ -467,6 +745,15 @@ void Session::ReloadSettings()
             saveInterval.value_or(300) * 1000);
     }
 
+    this->UpdateScrubTargets();
+
+    m_diskSpaceMonitor->SetLimit(getDiskSpaceLimit(m_cfg));
+    m_diskSpacePathsDirty = true;
+
+    m_moveScheduler->SetLimits(getMoveLimits(m_cfg));
+    this->ScheduleMoves();
+    this->UpdateStorageTiers();
+
     // reload ipfilters
 }
 
@@ -482,6 +769,67 @@ void Session::OnAlert()
         case lt::add_torrent_alert::alert_type:
         {
             lt::add_torrent_alert* ata = lt::alert_cast<lt::add_torrent_alert>(alert);
+            auto reset = m_pieceResets.find(ata->params.ti
+                ? ata->params.ti->info_hashes()
+                : ata->params.info_hashes);
+
+            if (reset != m_pieceResets.end()
+                && reset->second->stage == PieceResetState::Stage::Adding)
+            {
+                TorrentHandle* handle = reset->second->handle;
+
+                if (ata->error)
+                {
+                    // the torrent is still in the database and comes back on
+                    // the next start
+                    BOOST_LOG_TRIVIAL(error) << "Failed to add torrent after resetting pieces: " << ata->error;
+
+                    InfoHashEvent evt(ptEVT_TORRENT_REMOVED);
+                    evt.SetData(handle->InfoHash());
+                    wxPostEvent(m_parent, evt);
+
+                    m_torrents.erase(handle->InfoHash());
+                    m_pieceResets.erase(reset);
+                    delete handle;
+                    continue;
+                }
+
+                // the same TorrentHandle lives on, so the UI never sees the
+                // torrent go away
+                *handle->m_th = ata->handle;
+                handle->m_resetting.reset();
+
+                if (reset->second->restore)
+                {
+                    // only the workers of running resets are kept around
+                    m_recheckWorkers.erase(
+                        std::remove_if(
+                            m_recheckWorkers.begin(),
+                            m_recheckWorkers.end(),
+                            [](RecheckWorker& worker)
+                            {
+                                if (!*worker.done) { return false; }
+                                worker.thread.join();
+                                return true;
+                            }),
+                        m_recheckWorkers.end());
+
+                    auto done = std::make_shared<std::atomic<bool>>(false);
+
+                    m_recheckWorkers.push_back({
+                        std::thread(
+                            [this, done, th = ata->handle, savePath = reset->second->params.save_path, pieces = std::move(reset->second->pieces)]() mutable
+                            {
+                                restorePieces(th, th.torrent_file(), savePath, std::move(pieces), m_closing);
+                                *done = true;
+                            }),
+                        done
+                    });
+                }
+
+                m_pieceResets.erase(reset);
+                continue;
+            }
 
             if (ata->error)
             {
@@ -548,6 +896,25 @@ void Session::OnAlert()
             break;
         }
 
+        case lt::file_progress_alert::alert_type:
+        {
+            lt::file_progress_alert* fpa = lt::alert_cast<lt::file_progress_alert>(alert);
+            auto handle = m_torrents.find(fpa->handle.info_hashes());
+
+            if (handle == m_torrents.end())
+            {
+                break;
+            }
+
+            handle->second->m_fileProgress.assign(fpa->files.begin(), fpa->files.end());
+
+            wxCommandEvent evt(ptEVT_TORRENT_FILE_PROGRESS);
+            evt.SetClientData(handle->second);
+            wxPostEvent(m_parent, evt);
+
+            break;
+        }
+
         case lt::listen_failed_alert::alert_type:
         {
             BOOST_LOG_TRIVIAL(warning) << alert->message();
@@ -595,6 +962,44 @@ void Session::OnAlert()
             break;
         }
 
+        case lt::peer_info_alert::alert_type:
+        {
+            lt::peer_info_alert* pia = lt::alert_cast<lt::peer_info_alert>(alert);
+            auto handle = m_torrents.find(pia->handle.info_hashes());
+
+            if (handle == m_torrents.end())
+            {
+                break;
+            }
+
+            handle->second->SetPeerInfo(std::move(pia->peer_info));
+
+            wxCommandEvent evt(ptEVT_TORRENT_PEER_INFO);
+            evt.SetClientData(handle->second);
+            wxPostEvent(m_parent, evt);
+
+            break;
+        }
+
+        case lt::piece_availability_alert::alert_type:
+        {
+            lt::piece_availability_alert* paa = lt::alert_cast<lt::piece_availability_alert>(alert);
+            auto handle = m_torrents.find(paa->handle.info_hashes());
+
+            if (handle == m_torrents.end())
+            {
+                break;
+            }
+
+            handle->second->m_pieceAvailability = std::move(paa->piece_availability);
+
+            wxCommandEvent evt(ptEVT_TORRENT_PIECE_AVAILABILITY);
+            evt.SetClientData(handle->second);
+            wxPostEvent(m_parent, evt);
+
+            break;
+        }
+
         case lt::save_resume_data_alert::alert_type:
         {
             lt::save_resume_data_alert* srda = lt::alert_cast<lt::save_resume_data_alert>(alert);
@@ -615,22 +1020,71 @@ void Session::OnAlert()
                 stmt->Execute();
             }
 
+            if (m_journalPending.erase(srda->handle.info_hashes()) > 0 && srda->params.ti)
+            {
+                FileJournal::Create(srda->params.ti->files(), srda->params.save_path, srda->params.have_pieces)
+                    .Save(m_db, str(srda->handle.info_hashes()));
+            }
+
+            auto reset = m_pieceResets.find(srda->handle.info_hashes());
+
+            if (reset != m_pieceResets.end()
+                && reset->second->stage == PieceResetState::Stage::Saving)
+            {
+                // add the torrent again with the pieces missing, which is the
+                // only way to make libtorrent forget about them without
+                // checking everything
+                lt::add_torrent_params& params = reset->second->params;
+                params = std::move(srda->params);
+
+                if (params.have_pieces.size() != params.ti->num_pieces())
+                {
+                    params.have_pieces = reset->second->fallback;
+                }
+
+                for (lt::piece_index_t piece : reset->second->pieces)
+                {
+                    params.have_pieces.clear_bit(piece);
+                }
+
+                params.verified_pieces.clear();
+                params.flags &= ~lt::torrent_flags::seed_mode;
+
+                // the wrapped handle is invalid until the torrent is added
+                // again
+                reset->second->stage = PieceResetState::Stage::Removing;
+                reset->second->handle->m_resetting = srda->handle.info_hashes();
+                m_session->remove_torrent(srda->handle);
+            }
+
             break;
         }
 
-        case lt::session_stats_alert::alert_type:
+        case lt::save_resume_data_failed_alert::alert_type:
         {
-            lt::session_stats_alert* ssa = lt::alert_cast<lt::session_stats_alert>(alert);
-            lt::span<const int64_t> counters = ssa->counters();
-            int idx = -1;
+            lt::save_resume_data_failed_alert* srdfa = lt::alert_cast<lt::save_resume_data_failed_alert>(alert);
+            auto reset = m_pieceResets.find(srdfa->handle.info_hashes());
 
-            SessionStatistics stats;
+            m_journalPending.erase(srdfa->handle.info_hashes());
 
-            if ((idx = lt::find_metric_idx("dht.dht_nodes")) >= 0)
+            if (reset != m_pieceResets.end()
+                && reset->second->stage == PieceResetState::Stage::Saving)
             {
-                stats.dhtNodes = counters[idx];
+                BOOST_LOG_TRIVIAL(error) << "Failed to save resume data before resetting pieces: " << srdfa->error;
+                m_pieceResets.erase(reset);
             }
 
+            break;
+        }
+
+        case lt::session_stats_alert::alert_type:
+        {
+            lt::session_stats_alert* ssa = lt::alert_cast<lt::session_stats_alert>(alert);
+            m_metrics->Push(ssa->timestamp(), ssa->counters());
+
+            SessionStatistics stats;
+            stats.dhtNodes = static_cast<int>(m_metrics->Value(m_dhtNodesMetric));
+
             SessionStatisticsEvent evt(ptEVT_SESSION_STATISTICS);
             evt.SetData(stats);
             wxPostEvent(m_parent, evt);
@@ -668,6 +1122,28 @@ void Session::OnAlert()
                 handles.push_back(handle);
             }
 
+            // scrubbing waits while the disk is busy with downloads and checks
+            bool busy = std::any_of(
+                m_torrents.begin(),
+                m_torrents.end(),
+                [](auto const& torrent)
+                {
+                    switch (torrent.second->Status().state)
+                    {
+                    case TorrentStatus::CheckingFiles:
+                    case TorrentStatus::CheckingResumeData:
+                    case TorrentStatus::Downloading:
+                    case TorrentStatus::DownloadingChecking:
+                        return true;
+                    default:
+                        return false;
+                    }
+                });
+
+            m_scrubber->SetPaused(busy);
+
+            this->CheckDiskSpace(handles);
+
             TorrentStatisticsEvent evt(ptEVT_TORRENT_STATISTICS);
             evt.SetData(stats);
             wxPostEvent(m_parent, evt);
@@ -679,10 +1155,43 @@ void Session::OnAlert()
             break;
         }
 
+        case lt::storage_moved_alert::alert_type:
+        {
+            lt::storage_moved_alert* sma = lt::alert_cast<lt::storage_moved_alert>(alert);
+            BOOST_LOG_TRIVIAL(info) << "Moved " << str(sma->handle.info_hashes()) << " to " << sma->storage_path();
+
+            // the journal names the old save path, and a copy to another
+            // volume changes the mtimes. it is written again like after
+            // finishing, from the files at the new path
+            if (FileJournal::Load(m_db, str(sma->handle.info_hashes())))
+            {
+                m_journalPending.insert(sma->handle.info_hashes());
+                sma->handle.save_resume_data(
+                    lt::torrent_handle::flush_disk_cache
+                    | lt::torrent_handle::save_info_dict);
+            }
+
+            m_moveScheduler->Finished(sma->handle.info_hashes());
+            this->ScheduleMoves();
+
+            break;
+        }
+
         case lt::storage_moved_failed_alert::alert_type:
         {
             lt::storage_moved_failed_alert* smfa = lt::alert_cast<lt::storage_moved_failed_alert>(alert);
-            BOOST_LOG_TRIVIAL(error) << "Error when moving torrent storage: " << smfa->error;
+
+            if (m_moveScheduler->Failed(smfa->handle.info_hashes(), std::chrono::steady_clock::now()))
+            {
+                BOOST_LOG_TRIVIAL(warning) << "Error when moving torrent storage, trying again later: " << smfa->error;
+            }
+            else
+            {
+                BOOST_LOG_TRIVIAL(error) << "Error when moving torrent storage: " << smfa->error;
+            }
+
+            this->ScheduleMoves();
+
             break;
         }
 
@@ -712,6 +1221,16 @@ void Session::OnAlert()
             lt::torrent_finished_alert* tfa = lt::alert_cast<lt::torrent_finished_alert>(alert);
             lt::torrent_status const& ts = tfa->handle.status();
 
+            if (m_cfg->Get<bool>("file_journal.enabled").value_or(false))
+            {
+                // the journal is written with the resume data, after the
+                // disk cache is flushed and the mtimes have settled
+                m_journalPending.insert(tfa->handle.info_hashes());
+                tfa->handle.save_resume_data(
+                    lt::torrent_handle::flush_disk_cache
+                    | lt::torrent_handle::save_info_dict);
+            }
+
             // Only move from completed path if we have downloaded any payload
             // bytes, otherwise it's most likely a newly added torrent which we
             // had already downloaded.
@@ -721,10 +1240,29 @@ void Session::OnAlert()
                 break;
             }
 
+            TorrentHandle* torrent = m_torrents.at(ts.info_hashes);
+
             wxCommandEvent evt(ptEVT_TORRENT_FINISHED);
-            evt.SetClientData(m_torrents.at(ts.info_hashes));
+            evt.SetClientData(torrent);
             wxPostEvent(m_parent, evt);
 
+            // a label with a completed path takes precedence. with storage
+            // tiers the torrent seeds from the save path until it runs full,
+            // the tier mover only looks at torrents below it
+            if (auto label = getLabel(m_cfg, torrent->Label());
+                label.has_value()
+                && label->completedPathEnabled
+                && !label->completedPath.empty())
+            {
+                if (!hasStorageTiers(*label)
+                    || !isPathUnder(ts.save_path, label->savePath))
+                {
+                    this->MoveStorage(torrent, label->completedPath);
+                }
+
+                break;
+            }
+
             if (auto shouldMove = m_cfg->Get<bool>("move_completed_downloads"))
             {
                 if (shouldMove.value())
@@ -741,7 +1279,7 @@ void Session::OnAlert()
 
                     if (movePath.has_value())
                     {
-                        tfa->handle.move_storage(movePath.value());
+                        this->MoveStorage(torrent, movePath.value());
                     }
                 }
             }
@@ -749,6 +1287,25 @@ void Session::OnAlert()
             break;
         }
 
+        case lt::tracker_list_alert::alert_type:
+        {
+            lt::tracker_list_alert* tla = lt::alert_cast<lt::tracker_list_alert>(alert);
+            auto handle = m_torrents.find(tla->handle.info_hashes());
+
+            if (handle == m_torrents.end())
+            {
+                break;
+            }
+
+            handle->second->m_trackerList = std::move(tla->trackers);
+
+            wxCommandEvent evt(ptEVT_TORRENT_TRACKERS);
+            evt.SetClientData(handle->second);
+            wxPostEvent(m_parent, evt);
+
+            break;
+        }
+
         case lt::torrent_removed_alert::alert_type:
         {
             lt::torrent_removed_alert* tra = lt::alert_cast<lt::torrent_removed_alert>(alert);
@@ -762,6 +1319,16 @@ void Session::OnAlert()
                 break;
             }
 
+            auto reset = m_pieceResets.find(tra->info_hashes);
+
+            if (reset != m_pieceResets.end()
+                && reset->second->stage == PieceResetState::Stage::Removing)
+            {
+                reset->second->stage = PieceResetState::Stage::Adding;
+                m_session->async_add_torrent(reset->second->params);
+                break;
+            }
+
             auto handle = m_torrents.at(tra->info_hashes);
 
             InfoHashEvent evt(ptEVT_TORRENT_REMOVED);
@@ -769,12 +1336,25 @@ void Session::OnAlert()
             wxPostEvent(m_parent, evt);
 
             m_torrents.erase(tra->info_hashes);
+            m_scrubRecords.erase(str(tra->info_hashes));
+            m_pausedForDiskSpace.erase(tra->info_hashes);
+            m_diskSpacePathsDirty = true;
+
+            if (!m_moveScheduler->Empty())
+            {
+                m_moveScheduler->Remove(tra->info_hashes);
+                this->ScheduleMoves();
+            }
+
+            // before the torrent row, which the journal refers to
+            FileJournal::Remove(m_db, str(tra->info_hashes));
 
             std::vector<std::string> statements =
             {
-                "DELETE FROM torrent_resume_data WHERE info_hash = ?;",
-                "DELETE FROM torrent_magnet_uri  WHERE info_hash = ?;",
-                "DELETE FROM torrent             WHERE info_hash = ?;",
+                "DELETE FROM torrent_resume_data  WHERE info_hash = ?;",
+                "DELETE FROM torrent_magnet_uri   WHERE info_hash = ?;",
+                "DELETE FROM torrent_scrub        WHERE info_hash = ?;",
+                "DELETE FROM torrent              WHERE info_hash = ?;",
             };
 
             for (std::string const& sql : statements)
@@ -800,6 +1380,11 @@ void Session::OnSaveResumeDataTimer(wxTimerEvent&)
 
     for (auto const& [hash, torrent] : m_torrents)
     {
+        if (torrent->IsResetting())
+        {
+            continue;
+        }
+
         lt::torrent_handle& th = torrent->WrappedHandle();
         if (th.need_save_resume_data())
         {
@@ -814,6 +1399,81 @@ void Session::OnSaveResumeDataTimer(wxTimerEvent&)
     BOOST_LOG_TRIVIAL(info) << saved << " torrent(s) needed to save resume data";
 }
 
+void Session::CheckDiskSpace(std::vector<pt::BitTorrent::TorrentHandle*> const& torrents)
+{
+    bool dirty = m_diskSpacePathsDirty;
+
+    for (TorrentHandle* torrent : torrents)
+    {
+        if (m_diskSpacePaths.count(torrent->Status().savePath) == 0)
+        {
+            dirty = true;
+        }
+
+        this->PauseOnLowDiskSpace(torrent);
+    }
+
+    // the monitor resolves each new save path to its volume once, and polls
+    // every volume on its own thread
+    if (dirty)
+    {
+        m_diskSpacePaths.clear();
+
+        for (auto const& [hash, torrent] : m_torrents)
+        {
+            m_diskSpacePaths.insert(torrent->Status().savePath);
+        }
+
+        // the storage tiers and the move scheduler look these up
+        for (auto const& label : m_cfg->GetLabels())
+        {
+            if (label.savePathEnabled && !label.savePath.empty()) { m_diskSpacePaths.insert(label.savePath); }
+            if (label.completedPathEnabled && !label.completedPath.empty()) { m_diskSpacePaths.insert(label.completedPath); }
+        }
+
+        m_diskSpaceMonitor->SetPaths({ m_diskSpacePaths.begin(), m_diskSpacePaths.end() });
+        m_diskSpacePathsDirty = false;
+    }
+}
+
+void Session::IncrementalRecheck(pt::BitTorrent::TorrentHandle* torrent)
+{
+    lt::torrent_handle& th = torrent->WrappedHandle();
+    lt::info_hash_t hash = torrent->InfoHash();
+
+    if (m_pieceResets.find(hash) != m_pieceResets.end())
+    {
+        BOOST_LOG_TRIVIAL(warning) << "Torrent already rechecking (" << str(hash) << ")";
+        return;
+    }
+
+    auto ti = th.torrent_file();
+    auto journal = FileJournal::Load(m_db, str(hash));
+
+    if (!ti
+        || !journal
+        || journal->Verified().size() != ti->num_pieces()
+        || journal->SavePath() != th.status(lt::torrent_handle::query_save_path).save_path)
+    {
+        BOOST_LOG_TRIVIAL(info) << "No usable file journal for " << str(hash) << ", rechecking all files";
+        torrent->ForceRecheck();
+        return;
+    }
+
+    std::vector<lt::piece_index_t> pieces = journal->ChangedPieces(ti->files());
+
+    if (pieces.empty())
+    {
+        BOOST_LOG_TRIVIAL(info) << "No files changed since " << str(hash) << " was verified";
+        th.clear_error();
+        return;
+    }
+
+    BOOST_LOG_TRIVIAL(info) << "Incremental recheck of " << str(hash) << ", " << pieces.size() << " of " << ti->num_pieces() << " piece(s) to verify";
+
+    this->ResetPieces(torrent, std::move(pieces), journal->Verified(), true);
+}
+
 bool Session::IsSearching(lt::info_hash_t hash)
 {
     lt::info_hash_t t;
@@ -914,6 +1574,16 @@ void Session::LoadIPFilter(std::string const& path)
     wxQueueEvent(this, evt);
 }
 
+void Session::LoadScrubRecords()
+{
+    auto stmt = m_db->CreateStatement("SELECT info_hash, next_piece, IFNULL(last_completed, 0) FROM torrent_scrub");
+
+    while (stmt->Read())
+    {
+        m_scrubRecords.insert({ stmt->GetString(0), { stmt->GetInt(1), static_cast<std::time_t>(stmt->GetInt(2)), 0 } });
+    }
+}
+
 void Session::LoadTorrents()
 {
     auto stmt = m_db->CreateStatement("SELECT t.info_hash, tmu.magnet_uri, trd.resume_data, tmu.save_path, IFNULL(t.label_id, -1), lbl.name AS label_name FROM torrent t\n"
@@ -974,6 +1644,147 @@ void Session::LoadTorrents()
     }
 }
 
+void Session::MoveStorage(pt::BitTorrent::TorrentHandle* torrent, std::string const& path)
+{
+    TorrentStatus const& status = torrent->Status();
+
+    if (m_diskSpacePaths.insert(path).second)
+    {
+        m_diskSpaceMonitor->SetPaths({ m_diskSpacePaths.begin(), m_diskSpacePaths.end() });
+    }
+
+    m_moveScheduler->Enqueue(
+        torrent->InfoHash(),
+        status.savePath,
+        path,
+        status.totalWanted - status.totalWantedRemaining);
+
+    this->ScheduleMoves();
+}
+
+void Session::OnDiskSpaceChanged(wxThreadEvent& evt)
+{
+    auto volume = evt.GetPayload<Core::DiskSpaceMonitor::Volume>();
+
+    if (volume.low)
+    {
+        bool const wasLow = m_lowDiskSpaceVolumes.count(volume.root) > 0;
+        m_lowDiskSpaceVolumes[volume.root] = { volume.paths.begin(), volume.paths.end() };
+
+        for (auto const& [hash, torrent] : m_torrents)
+        {
+            this->PauseOnLowDiskSpace(torrent);
+        }
+
+        if (!wasLow)
+        {
+            wxCommandEvent lowEvt(ptEVT_DISK_SPACE_LOW);
+            lowEvt.SetString(wxString::FromUTF8(volume.root));
+            wxPostEvent(m_parent, lowEvt);
+        }
+
+        return;
+    }
+
+    auto low = m_lowDiskSpaceVolumes.find(volume.root);
+
+    if (low == m_lowDiskSpaceVolumes.end())
+    {
+        return;
+    }
+
+    std::unordered_set<std::string> paths = std::move(low->second);
+    m_lowDiskSpaceVolumes.erase(low);
+
+    for (auto it = m_pausedForDiskSpace.begin(); it != m_pausedForDiskSpace.end();)
+    {
+        auto torrent = m_torrents.find(*it);
+
+        if (torrent == m_torrents.end())
+        {
+            it = m_pausedForDiskSpace.erase(it);
+            continue;
+        }
+
+        if (paths.count(torrent->second->Status().savePath) == 0)
+        {
+            ++it;
+            continue;
+        }
+
+        BOOST_LOG_TRIVIAL(info) << "Resuming torrent " << str(*it) << ", disk space available again";
+
+        torrent->second->Resume();
+        it = m_pausedForDiskSpace.erase(it);
+    }
+}
+
+void Session::OnScrubProgress(wxThreadEvent& evt)
+{
+    Scrubber::Progress progress = evt.GetPayload<Scrubber::Progress>();
+    auto torrent = m_torrents.find(progress.infoHash);
+
+    if (torrent == m_torrents.end())
+    {
+        return;
+    }
+
+    std::string infoHash = str(progress.infoHash);
+    ScrubRecord& record = m_scrubRecords[infoHash];
+
+    if (progress.error)
+    {
+        BOOST_LOG_TRIVIAL(warning) << "Scrub could not read the files of " << infoHash << ", trying again later: " << progress.error.message();
+        record.lastFailed = std::time(nullptr);
+    }
+
+    if (progress.finished)
+    {
+        record.next = 0;
+        record.lastCompleted = std::time(nullptr);
+
+        auto stmt = m_db->CreateStatement("REPLACE INTO torrent_scrub (info_hash, next_piece, last_completed) VALUES ($1, 0, strftime('%s'))");
+        stmt->Bind(1, infoHash);
+        stmt->Execute();
+    }
+    else
+    {
+        record.next = static_cast<int>(progress.next);
+
+        auto stmt = m_db->CreateStatement("INSERT INTO torrent_scrub (info_hash, next_piece) VALUES ($1, $2)\n"
+            "ON CONFLICT (info_hash) DO UPDATE SET next_piece = excluded.next_piece");
+        stmt->Bind(1, infoHash);
+        stmt->Bind(2, record.next);
+        stmt->Execute();
+    }
+
+    if (progress.corrupt.empty())
+    {
+        return;
+    }
+
+    auto ti = torrent->second->WrappedHandle().torrent_file();
+
+    if (!ti)
+    {
+        return;
+    }
+
+    BOOST_LOG_TRIVIAL(warning) << "Scrub found " << progress.corrupt.size() << " corrupt piece(s) in " << infoHash << ", downloading them again";
+
+    wxCommandEvent corrupt(ptEVT_TORRENT_CORRUPT_PIECES);
+    corrupt.SetClientData(torrent->second);
+    corrupt.SetInt(static_cast<int>(progress.corrupt.size()));
+    wxPostEvent(m_parent, corrupt);
+
+    // the torrent was seeding, so every other piece is still good
+    this->ResetPieces(
+        torrent->second,
+        std::move(progress.corrupt),
+        lt::typed_bitfield<lt::piece_index_t>(ti->num_pieces(), true),
+        false);
+}
+
 void Session::PauseAfterRecheck(pt::BitTorrent::TorrentHandle* th)
 {
     if (m_pauseAfterRecheck.find(th->InfoHash()) != m_pauseAfterRecheck.end())
@@ -985,6 +1796,72 @@ void Session::PauseAfterRecheck(pt::BitTorrent::TorrentHandle* th)
     m_pauseAfterRecheck.insert({ th->InfoHash(), th });
 }
 
+void Session::PauseOnLowDiskSpace(pt::BitTorrent::TorrentHandle* torrent)
+{
+    TorrentStatus const& status = torrent->Status();
+
+    // only torrents that write to the disk are paused
+    if (m_lowDiskSpaceVolumes.empty()
+        || torrent->IsResetting()
+        || (status.state != TorrentStatus::Downloading
+            && status.state != TorrentStatus::DownloadingQueued))
+    {
+        return;
+    }
+
+    for (auto const& [root, paths] : m_lowDiskSpaceVolumes)
+    {
+        if (paths.count(status.savePath) == 0)
+        {
+            continue;
+        }
+
+        BOOST_LOG_TRIVIAL(info) << "Pausing torrent " << str(torrent->InfoHash()) << " due to disk space too low on " << root;
+
+        torrent->Pause();
+        m_pausedForDiskSpace.insert(torrent->InfoHash());
+
+        break;
+    }
+}
+
+void Session::ResetPieces(
+    pt::BitTorrent::TorrentHandle* torrent,
+    std::vector<lt::piece_index_t> pieces,
+    lt::typed_bitfield<lt::piece_index_t> fallback,
+    bool restore)
+{
+    lt::info_hash_t hash = torrent->InfoHash();
+    auto existing = m_pieceResets.find(hash);
+
+    if (existing != m_pieceResets.end())
+    {
+        // until the resume data arrives more pieces can join in
+        if (existing->second->stage == PieceResetState::Stage::Saving
+            && existing->second->restore == restore)
+        {
+            existing->second->pieces.insert(existing->second->pieces.end(), pieces.begin(), pieces.end());
+            return;
+        }
+
+        BOOST_LOG_TRIVIAL(warning) << "Torrent already resetting pieces (" << str(hash) << ")";
+        return;
+    }
+
+    auto state = std::make_unique<PieceResetState>();
+    state->stage = PieceResetState::Stage::Saving;
+    state->handle = torrent;
+    state->pieces = std::move(pieces);
+    state->fallback = std::move(fallback);
+    state->restore = restore;
+
+    m_pieceResets.insert({ hash, std::move(state) });
+
+    torrent->WrappedHandle().save_resume_data(
+        lt::torrent_handle::flush_disk_cache
+        | lt::torrent_handle::save_info_dict);
+}
+
 void Session::SaveState()
 {
     std::vector<char> stateBuffer = lt::write_session_params_buf(
@@ -1103,6 +1980,45 @@ void Session::SaveTorrents()
     }
 }
 
+void Session::ScheduleMoves()
+{
+    bool started = false;
+
+    for (MoveScheduler::Move const& move : m_moveScheduler->Next(std::chrono::steady_clock::now()))
+    {
+        auto torrent = m_torrents.find(move.infoHash);
+
+        if (torrent == m_torrents.end())
+        {
+            m_moveScheduler->Remove(move.infoHash);
+            continue;
+        }
+
+        // the reset is no reason to give up on the move
+        if (torrent->second->IsResetting())
+        {
+            m_moveScheduler->Defer(move.infoHash, std::chrono::steady_clock::now() + MoveDeferDelay);
+            continue;
+        }
+
+        BOOST_LOG_TRIVIAL(info) << "Moving " << str(move.infoHash) << " to " << move.destination
+            << (move.attempts > 0 ? " (retry " + std::to_string(move.attempts) + ")" : "");
+
+        torrent->second->WrappedHandle().move_storage(move.destination);
+        started = true;
+    }
+
+    // the scrubber leaves a torrent as soon as it is not a target anymore
+    if (started)
+    {
+        this->UpdateScrubTargets();
+    }
+
+    MoveStatisticsEvent evt(ptEVT_MOVE_STATISTICS);
+    evt.SetData(m_moveScheduler->Statistics());
+    wxPostEvent(m_parent, evt);
+}
+
 void Session::RemoveMetadataHandle(lt::info_hash_t hash)
 {
     lt::info_hash_t v1(hash.v1);
@@ -1136,6 +2052,172 @@ void Session::UpdateMetadataHandle(lt::info_hash_t hash, lt::torrent_handle hand
     }
 }
 
+void Session::UpdateScrubTargets()
+{
+    bool const enabled = m_cfg->Get<bool>("scrub.enabled").value_or(false);
+    int const rateLimit = m_cfg->Get<int>("scrub.rate_limit").value_or(10);
+    std::time_t const interval = static_cast<std::time_t>(m_cfg->Get<int>("scrub.interval_days").value_or(30)) * 24 * 60 * 60;
+    std::time_t const now = std::time(nullptr);
+
+    m_scrubber->SetRate(enabled
+        ? static_cast<std::int64_t>(rateLimit) * 1024 * 1024
+        : 0);
+
+    std::vector<std::pair<ScrubRecord, Scrubber::Target>> candidates;
+
+    for (auto const& [hash, torrent] : m_torrents)
+    {
+        // torrents which are not seeding are verified as they download, and
+        // the files of torrents in error or about to move are left alone
+        if (!enabled
+            || torrent->Status().state != TorrentStatus::Uploading
+            || !torrent->Status().error.empty()
+            || torrent->IsResetting()
+            || m_pieceResets.count(hash) > 0
+            || m_moveScheduler->Contains(hash))
+        {
+            continue;
+        }
+
+        ScrubRecord record = { 0, 0, 0 };
+
+        if (auto it = m_scrubRecords.find(str(hash)); it != m_scrubRecords.end())
+        {
+            record = it->second;
+        }
+
+        if ((record.next == 0 && now - record.lastCompleted < interval)
+            || now - record.lastFailed < ScrubRetryDelay)
+        {
+            continue;
+        }
+
+        candidates.push_back({ record, { torrent->WrappedHandle(), lt::piece_index_t(record.next) } });
+    }
+
+    // finish what was started, then the ones verified the longest ago
+    std::stable_sort(
+        candidates.begin(),
+        candidates.end(),
+        [](auto const& lhs, auto const& rhs)
+        {
+            if ((lhs.first.next > 0) != (rhs.first.next > 0))
+            {
+                return lhs.first.next > 0;
+            }
+
+            return lhs.first.lastCompleted < rhs.first.lastCompleted;
+        });
+
+    std::vector<Scrubber::Target> targets;
+
+    for (auto const& [record, target] : candidates)
+    {
+        targets.push_back(target);
+    }
+
+    m_scrubber->SetTargets(std::move(targets));
+}
+
+void Session::UpdateStorageTiers()
+{
+    for (auto const& label : m_cfg->GetLabels())
+    {
+        if (!hasStorageTiers(label))
+        {
+            continue;
+        }
+
+        // the save path is watched by the disk space monitor, until it has
+        // been polled the label waits for the next round
+        Core::DiskSpaceMonitor::Volume volume;
+
+        if (!m_diskSpaceMonitor->Find(label.savePath, volume)
+            || volume.total == 0)
+        {
+            continue;
+        }
+
+        std::uint64_t const total = volume.total;
+        std::uint64_t const used = total - std::min(volume.available, total);
+
+        if (used * 100 < total * static_cast<std::uint64_t>(label.highWatermark))
+        {
+            continue;
+        }
+
+        // moves that are already queued count towards getting below the
+        // low watermark
+        std::int64_t toFree = static_cast<std::int64_t>(used - std::min(used, total / 100 * static_cast<std::uint64_t>(label.lowWatermark)));
+        std::vector<TorrentHandle*> completed;
+
+        for (auto const& [hash, torrent] : m_torrents)
+        {
+            TorrentStatus const& status = torrent->Status();
+            std::int64_t const size = status.totalWanted - status.totalWantedRemaining;
+
+            // the completed path may be below the save path
+            if (torrent->Label() != label.id
+                || torrent->IsResetting()
+                || !isPathUnder(status.savePath, label.savePath)
+                || isPathUnder(status.savePath, label.completedPath)
+                || (status.state != TorrentStatus::Uploading
+                    && status.state != TorrentStatus::UploadingPaused
+                    && status.state != TorrentStatus::UploadingQueued))
+            {
+                continue;
+            }
+
+            if (m_moveScheduler->Contains(hash))
+            {
+                toFree -= size;
+                continue;
+            }
+
+            completed.push_back(torrent);
+        }
+
+        // the oldest completed torrents are the least likely to be in demand
+        std::sort(
+            completed.begin(),
+            completed.end(),
+            [](TorrentHandle* lhs, TorrentHandle* rhs)
+            {
+                wxDateTime const& l = lhs->Status().completedOn;
+                wxDateTime const& r = rhs->Status().completedOn;
+
+                if (!l.IsValid() || !r.IsValid())
+                {
+                    return !l.IsValid() && r.IsValid();
+                }
+
+                return l.IsEarlierThan(r);
+            });
+
+        int moved = 0;
+
+        for (TorrentHandle* torrent : completed)
+        {
+            if (toFree <= 0)
+            {
+                break;
+            }
+
+            TorrentStatus const& status = torrent->Status();
+            toFree -= status.totalWanted - status.totalWantedRemaining;
+
+            this->MoveStorage(torrent, label.completedPath);
+            moved++;
+        }
+
+        if (moved > 0)
+        {
+            BOOST_LOG_TRIVIAL(info) << "Disk usage of " << volume.root << " is above " << label.highWatermark
+                << "%, moving " << moved << " torrent(s) with label " << label.name << " to " << label.completedPath;
+        }
+    }
+}
+
 void Session::UpdateTorrentLabel(pt::BitTorrent::TorrentHandle* torrent)
 {
     int labelId = torrent->Label();
@@ -5,15 +5,22 @@
 #include <wx/wx.h>
 #endif
 
+#include <atomic>
+#include <ctime>
 #include <map>
 #include <memory>
+#include <string>
 #include <thread>
 #include <unordered_set>
+#include <vector>
 
+#include <libtorrent/bitfield.hpp>
 #include <libtorrent/fwd.hpp>
 #include <libtorrent/info_hash.hpp>
 #include <libtorrent/session_types.hpp>
+#include <libtorrent/units.hpp>
 
+#include "movestatistics.hpp"
 #include "sessionstatistics.hpp"
 #include "torrentstatistics.hpp"
 
@@ -42,19 +49,27 @@ private:
 
 namespace pt { namespace BitTorrent { class TorrentHandle; } }
 
+namespace pt { namespace BitTorrent { typedef PicoCommandEvent<pt::BitTorrent::MoveStatistics> MoveStatisticsEvent; } }
 namespace pt { namespace BitTorrent { typedef PicoCommandEvent<pt::BitTorrent::SessionStatistics> SessionStatisticsEvent; } }
 namespace pt { namespace BitTorrent { typedef PicoCommandEvent<libtorrent::info_hash_t> InfoHashEvent; } }
 namespace pt { namespace BitTorrent { typedef PicoCommandEvent<std::shared_ptr<libtorrent::torrent_info>> MetadataFoundEvent; } }
 namespace pt { namespace BitTorrent { typedef PicoCommandEvent<pt::BitTorrent::TorrentStatistics> TorrentStatisticsEvent; } }
 namespace pt { namespace BitTorrent { typedef PicoCommandEvent<std::vector<pt::BitTorrent::TorrentHandle*>> TorrentsUpdatedEvent; } }
 
+wxDECLARE_EVENT(ptEVT_DISK_SPACE_LOW, wxCommandEvent);
+wxDECLARE_EVENT(ptEVT_MOVE_STATISTICS, pt::BitTorrent::MoveStatisticsEvent);
 wxDECLARE_EVENT(ptEVT_SESSION_DEBUG_MESSAGE, wxCommandEvent);
 wxDECLARE_EVENT(ptEVT_SESSION_STATISTICS, pt::BitTorrent::SessionStatisticsEvent);
 wxDECLARE_EVENT(ptEVT_TORRENT_ADDED, wxCommandEvent);
+wxDECLARE_EVENT(ptEVT_TORRENT_CORRUPT_PIECES, wxCommandEvent);
+wxDECLARE_EVENT(ptEVT_TORRENT_FILE_PROGRESS, wxCommandEvent);
 wxDECLARE_EVENT(ptEVT_TORRENT_FINISHED, wxCommandEvent);
 wxDECLARE_EVENT(ptEVT_TORRENT_METADATA_FOUND, pt::BitTorrent::MetadataFoundEvent);
+wxDECLARE_EVENT(ptEVT_TORRENT_PEER_INFO, wxCommandEvent);
+wxDECLARE_EVENT(ptEVT_TORRENT_PIECE_AVAILABILITY, wxCommandEvent);
 wxDECLARE_EVENT(ptEVT_TORRENT_REMOVED, pt::BitTorrent::InfoHashEvent);
 wxDECLARE_EVENT(ptEVT_TORRENT_STATISTICS, pt::BitTorrent::TorrentStatisticsEvent);
+wxDECLARE_EVENT(ptEVT_TORRENT_TRACKERS, wxCommandEvent);
 wxDECLARE_EVENT(ptEVT_TORRENTS_UPDATED, pt::BitTorrent::TorrentsUpdatedEvent);
 
 typedef void (wxEvtHandler::* SessionStatisticsEventFunction)(pt::BitTorrent::SessionStatisticsEvent&);
@@ -71,10 +86,15 @@ namespace Core
 {
     class Configuration;
     class Database;
+    class DiskSpaceMonitor;
     class Environment;
 }
 namespace BitTorrent
 {
+    class MoveScheduler;
+    class Scrubber;
+    class SessionMetrics;
+
     class Session : public wxEvtHandler
     {
     public:
@@ -89,37 +109,89 @@ namespace BitTorrent
         void ReloadSettings();
         void RemoveMetadataSearch(std::vector<libtorrent::info_hash_t> const& hashes);
         void RemoveTorrent(TorrentHandle* handle, libtorrent::remove_flags_t flags = {});
+        SessionMetrics const& Metrics() const;
 
     private:
         enum
         {
             ptID_TIMER_SESSION = 1000,
-            ptID_TIMER_RESUME_DATA
+            ptID_TIMER_RESUME_DATA,
+            ptID_TIMER_SCRUB,
+            ptID_TIMER_STORAGE_TIERS
+        };
+
+        struct PieceResetState;
+
+        struct RecheckWorker
+        {
+            std::thread thread;
+            std::shared_ptr<std::atomic<bool>> done;
+        };
+
+        struct ScrubRecord
+        {
+            int next;
+            std::time_t lastCompleted;
+            // not persisted, failed reads are tried again after a restart
+            std::time_t lastFailed;
         };
 
+        void CheckDiskSpace(std::vector<TorrentHandle*> const& updatedTorrents);
+        void IncrementalRecheck(TorrentHandle*);
         bool IsSearching(libtorrent::info_hash_t hash);
         bool IsSearching(libtorrent::info_hash_t hash, libtorrent::info_hash_t& result);
         void LoadIPFilter(std::string const& filePath);
+        void LoadScrubRecords();
         void LoadTorrents();
+        void MoveStorage(TorrentHandle*, std::string const& path);
         void OnAlert();
+        void OnDiskSpaceChanged(wxThreadEvent&);
         void OnSaveResumeDataTimer(wxTimerEvent&);
+        void OnScrubProgress(wxThreadEvent&);
         void PauseAfterRecheck(TorrentHandle*);
+        void PauseOnLowDiskSpace(TorrentHandle*);
         void RemoveMetadataHandle(libtorrent::info_hash_t hash);
+        void ResetPieces(TorrentHandle*, std::vector<libtorrent::piece_index_t> pieces, libtorrent::typed_bitfield<libtorrent::piece_index_t> fallback, bool restore);
         void SaveState();
+        void ScheduleMoves();
         void SaveTorrents();
         void UpdateMetadataHandle(libtorrent::info_hash_t hash, libtorrent::torrent_handle handle);
+        void UpdateScrubTargets();
+        void UpdateStorageTiers();
         void UpdateTorrentLabel(TorrentHandle*);
 
         wxEvtHandler* m_parent;
         wxTimer* m_timer;
         wxTimer* m_resumeDataTimer;
-        
+        wxTimer* m_scrubTimer;
+        wxTimer* m_storageTiersTimer;
+
         std::unique_ptr<libtorrent::session> m_session;
         std::shared_ptr<Core::Database> m_db;
         std::shared_ptr<Core::Configuration> m_cfg;
         std::shared_ptr<Core::Environment> m_env;
         std::thread m_filterLoader;
 
+        std::map<libtorrent::info_hash_t, std::unique_ptr<PieceResetState>> m_pieceResets;
+        std::unordered_set<libtorrent::info_hash_t> m_journalPending;
+        std::vector<RecheckWorker> m_recheckWorkers;
+        std::atomic<bool> m_closing;
+
+        std::unique_ptr<Scrubber> m_scrubber;
+        std::map<std::string, ScrubRecord> m_scrubRecords;
+
+        std::unique_ptr<Core::DiskSpaceMonitor> m_diskSpaceMonitor;
+        std::unordered_set<std::string> m_diskSpacePaths;
+        bool m_diskSpacePathsDirty;
+        // the save paths on each volume that is low on disk space
+        std::map<std::string, std::unordered_set<std::string>> m_lowDiskSpaceVolumes;
+        std::unordered_set<libtorrent::info_hash_t> m_pausedForDiskSpace;
+
+        std::unique_ptr<MoveScheduler> m_moveScheduler;
+
+        std::unique_ptr<SessionMetrics> m_metrics;
+        int m_dhtNodesMetric;
+
         std::map<libtorrent::info_hash_t, TorrentHandle*> m_pauseAfterRecheck;
         std::map<libtorrent::info_hash_t, TorrentHandle*> m_torrents;
         std::unordered_set<libtorrent::info_hash_t> m_metadataRemoving;
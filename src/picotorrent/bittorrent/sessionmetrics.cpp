@@ -0,0 +1,125 @@
+#include "sessionmetrics.hpp"
+
+#include <algorithm>
+#include <chrono>
+
+#include <libtorrent/session_stats.hpp>
+
+namespace lt = libtorrent;
+using pt::BitTorrent::SessionMetrics;
+
+SessionMetrics::SessionMetrics(std::size_t capacity)
+    : m_head(0),
+    m_size(0)
+{
+    for (lt::stats_metric const& metric : lt::session_stats_metrics())
+    {
+        m_metrics.push_back({
+            metric.name,
+            metric.type == lt::metric_type_t::gauge ? Type::Gauge : Type::Counter,
+            metric.value_index });
+    }
+
+    // allocated up front, a snapshot only overwrites the oldest one
+    m_snapshots.resize(std::max<std::size_t>(capacity, 2));
+
+    for (Snapshot& snapshot : m_snapshots)
+    {
+        snapshot.values.resize(m_metrics.size());
+    }
+}
+
+void SessionMetrics::Push(lt::time_point time, lt::span<const std::int64_t> counters)
+{
+    Snapshot& snapshot = m_snapshots[m_head];
+    snapshot.time = time;
+
+    for (std::size_t i = 0; i < m_metrics.size(); i++)
+    {
+        int const idx = m_metrics[i].valueIndex;
+
+        snapshot.values[i] = idx >= 0 && idx < counters.size()
+            ? counters[idx]
+            : 0;
+    }
+
+    m_head = (m_head + 1) % m_snapshots.size();
+    m_size = std::min(m_size + 1, m_snapshots.size());
+}
+
+int SessionMetrics::Find(std::string const& name) const
+{
+    for (std::size_t i = 0; i < m_metrics.size(); i++)
+    {
+        if (m_metrics[i].name == name)
+        {
+            return static_cast<int>(i);
+        }
+    }
+
+    return -1;
+}
+
+std::vector<SessionMetrics::Metric> const& SessionMetrics::Metrics() const
+{
+    return m_metrics;
+}
+
+std::size_t SessionMetrics::Size() const
+{
+    return m_size;
+}
+
+std::int64_t SessionMetrics::Value(int metric) const
+{
+    if (metric < 0 || metric >= static_cast<int>(m_metrics.size()) || m_size == 0)
+    {
+        return 0;
+    }
+
+    return At(0).values[metric];
+}
+
+double SessionMetrics::Rate(int metric) const
+{
+    if (metric < 0 || metric >= static_cast<int>(m_metrics.size()) || m_size < 2)
+    {
+        return 0;
+    }
+
+    Snapshot const& latest = At(0);
+    Snapshot const& previous = At(1);
+
+    double const elapsed = std::chrono::duration<double>(latest.time - previous.time).count();
+
+    if (elapsed <= 0)
+    {
+        return 0;
+    }
+
+    return static_cast<double>(latest.values[metric] - previous.values[metric]) / elapsed;
+}
+
+std::vector<std::int64_t> SessionMetrics::History(int metric) const
+{
+    std::vector<std::int64_t> history;
+
+    if (metric < 0 || metric >= static_cast<int>(m_metrics.size()))
+    {
+        return history;
+    }
+
+    history.reserve(m_size);
+
+    for (std::size_t age = m_size; age > 0; age--)
+    {
+        history.push_back(At(age - 1).values[metric]);
+    }
+
+    return history;
+}
+
+SessionMetrics::Snapshot const& SessionMetrics::At(std::size_t age) const
+{
+    return m_snapshots[(m_head + m_snapshots.size() - 1 - age) % m_snapshots.size()];
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <libtorrent/span.hpp>
+#include <libtorrent/time.hpp>
+
+namespace pt
+{
+namespace BitTorrent
+{
+    // Every counter and gauge of the session, with the last few snapshots
+    // kept in a ring buffer so that rates can be derived from them. The
+    // metric names are resolved once, look a metric up with Find and keep
+    // the index.
+    class SessionMetrics
+    {
+    public:
+        enum class Type
+        {
+            Counter,
+            Gauge
+        };
+
+        struct Metric
+        {
+            std::string name;
+            Type type;
+            // in the counters of a session_stats_alert
+            int valueIndex;
+        };
+
+        explicit SessionMetrics(std::size_t capacity);
+
+        void Push(libtorrent::time_point time, libtorrent::span<const std::int64_t> counters);
+
+        // -1 if there is no metric with this name
+        int Find(std::string const& name) const;
+        std::vector<Metric> const& Metrics() const;
+        // the number of snapshots, at most the capacity
+        std::size_t Size() const;
+
+        // the value in the latest snapshot, or zero if there is none
+        std::int64_t Value(int metric) const;
+        // the change per second between the two latest snapshots
+        double Rate(int metric) const;
+        // oldest first
+        std::vector<std::int64_t> History(int metric) const;
+
+    private:
+        struct Snapshot
+        {
+            libtorrent::time_point time;
+            std::vector<std::int64_t> values;
+        };
+
+        Snapshot const& At(std::size_t age) const;
+
+        std::vector<Metric> m_metrics;
+        std::vector<Snapshot> m_snapshots;
+        // where the next snapshot is written
+        std::size_t m_head;
+        std::size_t m_size;
+    };
+}
+}
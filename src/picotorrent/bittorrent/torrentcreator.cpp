@@ -0,0 +1,91 @@
+#include "torrentcreator.hpp"
+
+#include <memory>
+
+#include <libtorrent/create_torrent.hpp>
+#include <libtorrent/file_storage.hpp>
+
+#include "hashcache.hpp"
+
+namespace lt = libtorrent;
+using pt::BitTorrent::HashCache;
+using pt::BitTorrent::PieceHasher;
+using pt::BitTorrent::TorrentCreator;
+
+std::string TorrentCreator::BasePath(std::string const& f)
+{
+    if (f.empty()) return f;
+
+#ifdef TORRENT_WINDOWS
+    if (f == "\\\\") return "";
+#endif
+    if (f == "/") return "";
+
+    auto len = f.size();
+    // if the last character is / or \ ignore it
+    if (f[len - 1] == '/' || f[len - 1] == '\\') --len;
+    while (len > 0) {
+        --len;
+        if (f[len] == '/' || f[len] == '\\')
+            break;
+    }
+
+    if (f[len] == '/' || f[len] == '\\') ++len;
+    return std::string(f.c_str(), len);
+}
+
+lt::entry TorrentCreator::Create(
+    Params const& params,
+    std::function<void(PieceHasher::Progress const&)> const& progress,
+    std::atomic<bool> const& cancelled,
+    lt::error_code& ec)
+{
+    lt::create_flags_t flags = {};
+    if (params.mode == Mode::v1) { flags = lt::create_torrent::v1_only; }
+    if (params.mode == Mode::v2) { flags = lt::create_torrent::v2_only; }
+
+    lt::file_storage fs;
+    lt::add_files(fs, params.path, flags);
+
+    // a piece size of 0 lets libtorrent pick one from the total size
+    lt::create_torrent ct(fs, params.pieceSize, flags);
+    ct.set_comment(params.comment.c_str());
+    ct.set_creator(params.creator.c_str());
+    ct.set_priv(params.priv);
+
+    for (size_t i = 0; i < params.trackers.size(); i++)
+    {
+        // Add one tracker per tier - this can of course be changed to something more advanced
+        // in the future but for now I think this is the most sensible. Also, dont add more
+        // than int32.MAX trackers, OK? :)
+        ct.add_tracker(params.trackers.at(i), static_cast<int>(i));
+    }
+
+    for (size_t i = 0; i < params.urlSeeds.size(); i++)
+    {
+        ct.add_url_seed(params.urlSeeds.at(i));
+    }
+
+    std::unique_ptr<HashCache> cache;
+
+    if (!params.hashCache.empty())
+    {
+        cache = std::make_unique<HashCache>(params.hashCache);
+        cache->Load();
+    }
+
+    PieceHasher hasher(params.threads, cache.get());
+    hasher.Hash(ct, BasePath(params.path), progress, cancelled, ec);
+
+    if (ec)
+    {
+        return lt::entry();
+    }
+
+    if (cache)
+    {
+        cache->Save();
+    }
+
+    return ct.generate();
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <atomic>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <libtorrent/entry.hpp>
+#include <libtorrent/error_code.hpp>
+
+#include "piecehasher.hpp"
+
+namespace pt
+{
+namespace BitTorrent
+{
+    // Creates a torrent from a file or directory. Shared by the create torrent
+    // dialog and the picotorrent-create tool, so it must not depend on wx.
+    class TorrentCreator
+    {
+    public:
+        enum class Mode
+        {
+            v1,
+            Hybrid,
+            v2
+        };
+
+        struct Params
+        {
+            std::string path;
+            std::string comment;
+            std::string creator;
+            std::vector<std::string> trackers;
+            std::vector<std::string> urlSeeds;
+            bool priv = false;
+            Mode mode = Mode::Hybrid;
+
+            // in bytes, 0 picks a size based on the total size of the files
+            int pieceSize = 0;
+
+            // hashing threads, 0 uses one per core
+            int threads = 0;
+
+            // when set, unchanged files are not hashed again, see HashCache
+            std::filesystem::path hashCache;
+        };
+
+        // the directory the torrent files are relative to, which is also the
+        // save path to use when adding the new torrent
+        static std::string BasePath(std::string const& path);
+
+        // hashes the files and returns the bencoded torrent. hashing errors are
+        // reported in ec, generating the torrent itself throws on failure
+        static libtorrent::entry Create(
+            Params const& params,
+            std::function<void(PieceHasher::Progress const&)> const& progress,
+            std::atomic<bool> const& cancelled,
+            libtorrent::error_code& ec);
+    };
+}
+}
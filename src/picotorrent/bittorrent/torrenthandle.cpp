@@ -1,6 +1,7 @@
 #include "torrenthandle.hpp"
 
 #include <libtorrent/announce_entry.hpp>
+#include <libtorrent/peer_info.hpp>
 #include <libtorrent/session.hpp>
 #include <libtorrent/torrent_handle.hpp>
 #include <libtorrent/torrent_status.hpp>
@@ -77,7 +78,8 @@ TorrentStatus::State getTorrentStatusState(lt::torrent_status const& ts)
 }
 
 TorrentHandle::TorrentHandle(pt::BitTorrent::Session* session, lt::torrent_handle const& th)
-    : m_session(session)
+    : m_session(session),
+    m_peerSources{}
 {
     m_th = std::make_unique<lt::torrent_handle>(th);
     m_status = Update(th.status());
@@ -89,30 +91,34 @@ TorrentHandle::~TorrentHandle()
 
 void TorrentHandle::AddTracker(lt::announce_entry const& entry)
 {
+    if (IsResetting()) { return; }
+
     m_th->add_tracker(entry);
 }
 
-void TorrentHandle::FileProgress(std::vector<std::int64_t>& progress, int flags) const
+std::vector<std::int64_t> const& TorrentHandle::FileProgress() const
 {
-    m_th->file_progress(
-        progress,
-        flags >= 1
-            ? lt::torrent_handle::piece_granularity
-            : lt::file_progress_flags_t{});
+    return m_fileProgress;
 }
 
 void TorrentHandle::ForceReannounce()
 {
+    if (IsResetting()) { return; }
+
     m_th->force_reannounce();
 }
 
 void TorrentHandle::ForceReannounce(int seconds, int trackerIndex)
 {
+    if (IsResetting()) { return; }
+
     m_th->force_reannounce(seconds, trackerIndex);
 }
 
 void TorrentHandle::ForceRecheck()
 {
+    if (IsResetting()) { return; }
+
     if (Status().paused)
     {
         m_session->PauseAfterRecheck(this);
@@ -122,64 +128,146 @@ void TorrentHandle::ForceRecheck()
     m_th->force_recheck();
 }
 
-std::vector<lt::download_priority_t> TorrentHandle::GetFilePriorities() const
+void TorrentHandle::IncrementalRecheck()
 {
-    return m_th->get_file_priorities();
+    m_session->IncrementalRecheck(this);
 }
 
-void TorrentHandle::GetPeerInfo(std::vector<lt::peer_info>& peers) const
+std::vector<lt::download_priority_t> const& TorrentHandle::GetFilePriorities()
 {
-    m_th->get_peer_info(peers);
+    // priorities only change through us, so they are fetched once and
+    // again after each change instead of on every refresh
+    if (!m_filePriorities.has_value())
+    {
+        if (IsResetting())
+        {
+            static const std::vector<lt::download_priority_t> empty;
+            return empty;
+        }
+
+        m_filePriorities = m_th->get_file_priorities();
+    }
+
+    return m_filePriorities.value();
 }
 
 lt::info_hash_t TorrentHandle::InfoHash()
 {
+    if (IsResetting())
+    {
+        return m_resetting.value();
+    }
+
     return m_th->info_hashes();
 }
 
+bool TorrentHandle::IsResetting() const
+{
+    return m_resetting.has_value();
+}
+
 bool TorrentHandle::IsSequentialDownload()
 {
+    if (IsResetting()) { return false; }
+
     return (m_th->flags() & lt::torrent_flags::sequential_download) == lt::torrent_flags::sequential_download;
 }
 
 bool TorrentHandle::IsValid()
 {
+    if (IsResetting()) { return false; }
+
     return m_th->is_valid();
 }
 
 void TorrentHandle::MoveStorage(std::string const& newPath)
 {
-    m_th->move_storage(newPath);
+    m_session->MoveStorage(this, newPath);
 }
 
 void TorrentHandle::Pause()
 {
+    if (IsResetting()) { return; }
+
     m_th->unset_flags(lt::torrent_flags::auto_managed);
     m_th->pause(lt::torrent_handle::graceful_pause);
 }
 
+std::vector<lt::peer_info> const& TorrentHandle::PeerInfo() const
+{
+    return m_peerInfo;
+}
+
+pt::BitTorrent::PeerSources const& TorrentHandle::PeerSourceCounts() const
+{
+    return m_peerSources;
+}
+
+std::vector<int> const& TorrentHandle::PieceAvailability() const
+{
+    return m_pieceAvailability;
+}
+
+void TorrentHandle::PostFileProgress()
+{
+    if (IsResetting()) { return; }
+
+    m_th->post_file_progress({});
+}
+
+void TorrentHandle::PostPeerInfo()
+{
+    if (IsResetting()) { return; }
+
+    m_th->post_peer_info();
+}
+
+void TorrentHandle::PostPieceAvailability()
+{
+    if (IsResetting()) { return; }
+
+    m_th->post_piece_availability();
+}
+
+void TorrentHandle::PostTrackers()
+{
+    if (IsResetting()) { return; }
+
+    m_th->post_trackers();
+}
+
 void TorrentHandle::QueueUp()
 {
+    if (IsResetting()) { return; }
+
     m_th->queue_position_up();
 }
 
 void TorrentHandle::QueueDown()
 {
+    if (IsResetting()) { return; }
+
     m_th->queue_position_down();
 }
 
 void TorrentHandle::QueueTop()
 {
+    if (IsResetting()) { return; }
+
     m_th->queue_position_top();
 }
 
 void TorrentHandle::QueueBottom()
 {
+    if (IsResetting()) { return; }
+
     m_th->queue_position_bottom();
 }
 
 void TorrentHandle::ReplaceTrackers(std::vector<lt::announce_entry> const& trackers)
 {
+    if (IsResetting()) { return; }
+
     m_th->replace_trackers(trackers);
 }
 
@@ -195,6 +283,8 @@ void TorrentHandle::RemoveFiles()
 
 void TorrentHandle::Resume()
 {
+    if (IsResetting()) { return; }
+
     m_th->set_flags(lt::torrent_flags::auto_managed);
     m_th->clear_error();
     m_th->resume();
@@ -202,6 +292,8 @@ void TorrentHandle::Resume()
 
 void TorrentHandle::ResumeForce()
 {
+    if (IsResetting()) { return; }
+
     m_th->unset_flags(lt::torrent_flags::auto_managed);
     m_th->clear_error();
     m_th->resume();
@@ -209,21 +301,31 @@ void TorrentHandle::ResumeForce()
 
 void TorrentHandle::ScrapeTracker(int trackerIndex)
 {
+    if (IsResetting()) { return; }
+
     m_th->scrape_tracker(trackerIndex);
 }
 
 void TorrentHandle::SetFilePriorities(std::vector<lt::download_priority_t> priorities)
 {
+    if (IsResetting()) { return; }
+
     m_th->prioritize_files(priorities);
+    m_filePriorities.reset();
 }
 
 void TorrentHandle::SetFilePriority(lt::file_index_t index, lt::download_priority_t priority)
 {
+    if (IsResetting()) { return; }
+
     m_th->file_priority(index, priority);
+    m_filePriorities.reset();
 }
 
 void TorrentHandle::SetSequentialDownload(bool seq)
 {
+    if (IsResetting()) { return; }
+
     if (seq)
     {
         m_th->set_flags(lt::torrent_flags::sequential_download);
@@ -234,16 +336,23 @@ void TorrentHandle::SetSequentialDownload(bool seq)
     }
 }
 
-TorrentStatus TorrentHandle::Status() const
+TorrentStatus const& TorrentHandle::Status() const
 {
     return *m_status.get();
 }
 
 std::vector<lt::announce_entry> TorrentHandle::Trackers() const
 {
+    if (IsResetting()) { return {}; }
+
     return m_th->trackers();
 }
 
+std::vector<lt::announce_entry> const& TorrentHandle::TrackerList() const
+{
+    return m_trackerList;
+}
+
 void TorrentHandle::ClearLabel()
 {
     m_labelId = -1;
@@ -255,6 +364,29 @@ int TorrentHandle::Label()
     return m_labelId;
 }
 
+void TorrentHandle::SetPeerInfo(std::vector<lt::peer_info> peers)
+{
+    m_peerInfo = std::move(peers);
+    m_peerSources = {};
+
+    for (lt::peer_info const& peer : m_peerInfo)
+    {
+        PeerSources::Count* count = nullptr;
+
+        if (peer.source & lt::peer_info::dht)      { count = &m_peerSources.dht; }
+        else if (peer.source & lt::peer_info::lsd) { count = &m_peerSources.lsd; }
+        else if (peer.source & lt::peer_info::pex) { count = &m_peerSources.pex; }
+
+        if (count == nullptr)
+        {
+            continue;
+        }
+
+        if (peer.flags & lt::peer_info::seed) { count->seeds++; }
+        else                                   { count->leeches++; }
+    }
+}
+
 void TorrentHandle::BuildStatus(libtorrent::torrent_status const& ts)
 {
     m_status = Update(ts);
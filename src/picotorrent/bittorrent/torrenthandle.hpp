@@ -6,12 +6,16 @@
 #endif
 
 #include <memory>
+#include <optional>
 #include <vector>
 
 #include <libtorrent/download_priority.hpp>
 #include <libtorrent/fwd.hpp>
+#include <libtorrent/info_hash.hpp>
 #include <libtorrent/sha1_hash.hpp>
 
+#include "peersources.hpp"
+
 namespace pt
 {
 namespace BitTorrent
@@ -27,20 +31,46 @@ namespace BitTorrent
         virtual ~TorrentHandle();
 
         void AddTracker(libtorrent::announce_entry const& entry);
-        void FileProgress(std::vector<std::int64_t>& progress, int flags) const;
-        std::vector<libtorrent::download_priority_t> GetFilePriorities() const;
-        void GetPeerInfo(std::vector<libtorrent::peer_info>& peers) const;
+        std::vector<libtorrent::download_priority_t> const& GetFilePriorities();
         libtorrent::info_hash_t InfoHash();
         bool IsSequentialDownload();
         bool IsValid();
+
+        // True while the session removes the torrent and adds it again to
+        // reset some of its pieces. Actions are ignored until then and the
+        // queries return what was known before.
+        bool IsResetting() const;
         void ReplaceTrackers(std::vector<libtorrent::announce_entry> const& trackers);
         void ScrapeTracker(int trackerIndex);
-        TorrentStatus Status() const;
+        TorrentStatus const& Status() const;
+
+        // Blocks on the session thread. Only use this when acting on the
+        // trackers, the details view should use TrackerList instead.
         std::vector<libtorrent::announce_entry> Trackers() const;
 
+        // Asynchronous queries. The session posts ptEVT_TORRENT_FILE_PROGRESS,
+        // ptEVT_TORRENT_PEER_INFO, ptEVT_TORRENT_PIECE_AVAILABILITY and
+        // ptEVT_TORRENT_TRACKERS when the result has arrived and the
+        // snapshot below has been updated.
+        void PostFileProgress();
+        void PostPeerInfo();
+        void PostPieceAvailability();
+        void PostTrackers();
+
+        std::vector<std::int64_t> const& FileProgress() const;
+        std::vector<libtorrent::peer_info> const& PeerInfo() const;
+        PeerSources const& PeerSourceCounts() const;
+        std::vector<int> const& PieceAvailability() const;
+        std::vector<libtorrent::announce_entry> const& TrackerList() const;
+
         void ForceReannounce();
         void ForceReannounce(int seconds, int trackerIndex);
         void ForceRecheck();
+
+        // Only verifies the pieces of files whose size or mtime changed since
+        // the torrent was last complete, falls back to ForceRecheck when
+        // there is nothing to compare with.
+        void IncrementalRecheck();
         void MoveStorage(std::string const& newPath);
         void Pause();
         void QueueUp();
@@ -66,13 +96,22 @@ namespace BitTorrent
         TorrentHandle(Session* session, libtorrent::torrent_handle const& th);
 
         void BuildStatus(libtorrent::torrent_status const& ts);
+        void SetPeerInfo(std::vector<libtorrent::peer_info> peers);
         std::unique_ptr<TorrentStatus> Update(libtorrent::torrent_status const& ts);
 
         Session* m_session;
         std::unique_ptr<libtorrent::torrent_handle> m_th;
         std::unique_ptr<TorrentStatus> m_status;
+        std::optional<std::vector<libtorrent::download_priority_t>> m_filePriorities;
+        std::vector<std::int64_t> m_fileProgress;
+        std::vector<libtorrent::peer_info> m_peerInfo;
+        PeerSources m_peerSources;
+        std::vector<int> m_pieceAvailability;
+        std::vector<libtorrent::announce_entry> m_trackerList;
         int m_labelId;
         std::string m_labelName;
+        // the info hash while the torrent is resetting
+        std::optional<libtorrent::info_hash_t> m_resetting;
     };
 }
 }
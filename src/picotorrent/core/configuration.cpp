@@ -107,7 +107,7 @@ std::vector<Configuration::Label> Configuration::GetLabels()
 {
     std::vector<Label> result;
 
-    auto stmt = m_db->CreateStatement("select id, name, color, color_enabled, save_path, save_path_enabled, apply_filter, apply_filter_enabled from label");
+    auto stmt = m_db->CreateStatement("select id, name, color, color_enabled, save_path, save_path_enabled, apply_filter, apply_filter_enabled, completed_path, completed_path_enabled, watermarks_enabled, high_watermark, low_watermark from label");
 
     while (stmt->Read())
     {
@@ -120,6 +120,11 @@ std::vector<Configuration::Label> Configuration::GetLabels()
         lbl.savePathEnabled = stmt->GetBool(5);
         lbl.applyFilter = stmt->GetString(6);
         lbl.applyFilterEnabled = stmt->GetBool(7);
+        lbl.completedPath = stmt->GetString(8);
+        lbl.completedPathEnabled = stmt->GetBool(9);
+        lbl.watermarksEnabled = stmt->GetBool(10);
+        lbl.highWatermark = stmt->GetInt(11);
+        lbl.lowWatermark = stmt->GetInt(12);
 
         result.push_back(lbl);
     }
@@ -145,7 +150,7 @@ void Configuration::UpsertLabel(Configuration::Label const& label)
 {
     if (label.id < 0)
     {
-        auto stmt = m_db->CreateStatement("insert into label (name, color, color_enabled, save_path, save_path_enabled, apply_filter, apply_filter_enabled) values ($1, $2, $3, $4, $5, $6, $7);");
+        auto stmt = m_db->CreateStatement("insert into label (name, color, color_enabled, save_path, save_path_enabled, apply_filter, apply_filter_enabled, completed_path, completed_path_enabled, watermarks_enabled, high_watermark, low_watermark) values ($1, $2, $3, $4, $5, $6, $7, $8, $9, $10, $11, $12);");
         stmt->Bind(1, label.name);
         stmt->Bind(2, label.color);
         stmt->Bind(3, label.colorEnabled);
@@ -153,11 +158,16 @@ void Configuration::UpsertLabel(Configuration::Label const& label)
         stmt->Bind(5, label.savePathEnabled);
         stmt->Bind(6, label.applyFilter);
         stmt->Bind(7, label.applyFilterEnabled);
+        stmt->Bind(8, label.completedPath);
+        stmt->Bind(9, label.completedPathEnabled);
+        stmt->Bind(10, label.watermarksEnabled);
+        stmt->Bind(11, label.highWatermark);
+        stmt->Bind(12, label.lowWatermark);
         stmt->Execute();
     }
     else
     {
-        auto stmt = m_db->CreateStatement("update label set name = $1, color = $2, color_enabled = $3, save_path = $4, save_path_enabled = $5, apply_filter = $6, apply_filter_enabled = $7 where id = $8");
+        auto stmt = m_db->CreateStatement("update label set name = $1, color = $2, color_enabled = $3, save_path = $4, save_path_enabled = $5, apply_filter = $6, apply_filter_enabled = $7, completed_path = $8, completed_path_enabled = $9, watermarks_enabled = $10, high_watermark = $11, low_watermark = $12 where id = $13");
         stmt->Bind(1, label.name);
         stmt->Bind(2, label.color);
         stmt->Bind(3, label.colorEnabled);
@@ -165,7 +175,12 @@ void Configuration::UpsertLabel(Configuration::Label const& label)
         stmt->Bind(5, label.savePathEnabled);
         stmt->Bind(6, label.applyFilter);
         stmt->Bind(7, label.applyFilterEnabled);
-        stmt->Bind(8, label.id);
+        stmt->Bind(8, label.completedPath);
+        stmt->Bind(9, label.completedPathEnabled);
+        stmt->Bind(10, label.watermarksEnabled);
+        stmt->Bind(11, label.highWatermark);
+        stmt->Bind(12, label.lowWatermark);
+        stmt->Bind(13, label.id);
         stmt->Execute();
     }
 }
@@ -34,7 +34,7 @@ namespace Core
 
         struct Label
         {
-            Label() : id(-1), colorEnabled(false), savePathEnabled(false), applyFilterEnabled(false) {}
+            Label() : id(-1), colorEnabled(false), savePathEnabled(false), applyFilterEnabled(false), completedPathEnabled(false), watermarksEnabled(false), highWatermark(90), lowWatermark(75) {}
             int32_t id;
             std::string name;
             std::string color;
@@ -43,6 +43,14 @@ namespace Core
             bool savePathEnabled;
             std::string applyFilter;
             bool applyFilterEnabled;
+            // completed torrents move from the save path to the completed
+            // path, or with watermarks, only when the save path volume is
+            // used above the high watermark, until it is below the low one
+            std::string completedPath;
+            bool completedPathEnabled;
+            bool watermarksEnabled;
+            int highWatermark;
+            int lowWatermark;
         };
 
         struct ListenInterface
@@ -0,0 +1,366 @@
+#include "diskspacemonitor.hpp"
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <sys/stat.h>
+#include <sys/statvfs.h>
+#endif
+
+#include <algorithm>
+#include <filesystem>
+#include <system_error>
+
+#include <boost/log/trivial.hpp>
+
+#ifdef _WIN32
+#include "utils.hpp"
+#endif
+
+namespace fs = std::filesystem;
+using pt::Core::DiskSpaceMonitor;
+
+// a volume is polled at least this often, and at most this often when it
+// fills up fast
+static const std::chrono::milliseconds MaxInterval(30000);
+static const std::chrono::milliseconds MinInterval(1000);
+
+// a low volume is polled often enough to notice space being freed
+static const std::chrono::milliseconds LowInterval(5000);
+
+// percent above the limit a low volume needs before it is not low anymore
+static const int Hysteresis = 1;
+
+DiskSpaceMonitor::DiskSpaceMonitor(std::function<void(Volume const&)> changed)
+    : m_changed(changed),
+    m_limit(0),
+    m_dirty(false),
+    m_stop(false)
+{
+    m_thread = std::thread(&DiskSpaceMonitor::Run, this);
+}
+
+DiskSpaceMonitor::~DiskSpaceMonitor()
+{
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+
+    m_wake.notify_all();
+    m_thread.join();
+}
+
+void DiskSpaceMonitor::SetLimit(int percent)
+{
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (m_limit == percent) { return; }
+        m_limit = percent;
+        m_dirty = true;
+    }
+
+    m_wake.notify_all();
+}
+
+void DiskSpaceMonitor::SetPaths(std::vector<std::string> paths)
+{
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_paths = std::move(paths);
+        m_dirty = true;
+    }
+
+    m_wake.notify_all();
+}
+
+bool DiskSpaceMonitor::Find(std::string const& path, Volume& volume) const
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    auto root = m_publishedRoots.find(path);
+    if (root == m_publishedRoots.end()) { return false; }
+
+    auto published = m_publishedVolumes.find(root->second);
+    if (published == m_publishedVolumes.end()) { return false; }
+
+    volume = published->second;
+    return true;
+}
+
+std::string DiskSpaceMonitor::VolumeRoot(std::string const& input)
+{
+    std::error_code ec;
+    fs::path path = fs::u8path(input);
+
+    // save paths are created when the first file is written to them
+    while (!fs::exists(path, ec) && path.has_parent_path() && path.parent_path() != path)
+    {
+        path = path.parent_path();
+    }
+
+#ifdef _WIN32
+    wchar_t root[MAX_PATH];
+
+    if (!GetVolumePathNameW(path.wstring().c_str(), root, MAX_PATH))
+    {
+        return "";
+    }
+
+    return Utils::toStdString(root);
+#else
+    path = fs::canonical(path, ec);
+
+    struct stat st;
+
+    if (ec || stat(path.c_str(), &st) != 0)
+    {
+        return "";
+    }
+
+    // the mount point is the topmost directory on the same device
+    while (path.has_parent_path() && path.parent_path() != path)
+    {
+        struct stat parent;
+
+        if (stat(path.parent_path().c_str(), &parent) != 0
+            || parent.st_dev != st.st_dev)
+        {
+            break;
+        }
+
+        path = path.parent_path();
+    }
+
+    return path.string();
+#endif
+}
+
+bool DiskSpaceMonitor::FreeSpace(std::string const& root, std::uint64_t& available, std::uint64_t& total)
+{
+#ifdef _WIN32
+    ULARGE_INTEGER freeBytesAvailableToCaller;
+    ULARGE_INTEGER totalNumberOfBytes;
+
+    if (!GetDiskFreeSpaceEx(
+        Utils::toStdWString(root).c_str(),
+        &freeBytesAvailableToCaller,
+        &totalNumberOfBytes,
+        nullptr))
+    {
+        return false;
+    }
+
+    available = freeBytesAvailableToCaller.QuadPart;
+    total = totalNumberOfBytes.QuadPart;
+#else
+    struct statvfs st;
+
+    if (statvfs(root.c_str(), &st) != 0)
+    {
+        return false;
+    }
+
+    available = static_cast<std::uint64_t>(st.f_bavail) * st.f_frsize;
+    total = static_cast<std::uint64_t>(st.f_blocks) * st.f_frsize;
+#endif
+
+    return true;
+}
+
+void DiskSpaceMonitor::Poll(VolumeState& state, int limit)
+{
+    auto const now = std::chrono::steady_clock::now();
+
+    std::uint64_t available = 0;
+    std::uint64_t total = 0;
+
+    if (!FreeSpace(state.volume.root, available, total) || total == 0)
+    {
+        BOOST_LOG_TRIVIAL(warning) << "Failed to get free space of " << state.volume.root;
+        state.nextPoll = now + MaxInterval;
+        return;
+    }
+
+    std::uint64_t const limitBytes = total / 100 * static_cast<std::uint64_t>(limit);
+    std::uint64_t const resumeBytes = total / 100 * static_cast<std::uint64_t>(limit + Hysteresis);
+
+    // a volume right at the limit would otherwise flip back and forth
+    bool const low = state.volume.low
+        ? available < resumeBytes
+        : available < limitBytes;
+
+    std::chrono::milliseconds interval = low ? LowInterval : MaxInterval;
+
+    if (!low
+        && state.lastPoll != std::chrono::steady_clock::time_point()
+        && available < state.lastAvailable)
+    {
+        // poll a few times before the limit is reached at the rate the
+        // volume filled up since the last poll
+        double const elapsed = std::chrono::duration<double>(now - state.lastPoll).count();
+        double const rate = static_cast<double>(state.lastAvailable - available) / elapsed;
+        std::chrono::duration<double> const untilLimit(static_cast<double>(available - limitBytes) / rate);
+
+        interval = std::clamp(
+            std::chrono::duration_cast<std::chrono::milliseconds>(untilLimit / 4),
+            MinInterval,
+            MaxInterval);
+    }
+
+    bool const changed = low != state.volume.low;
+
+    state.volume.available = available;
+    state.volume.total = total;
+    state.volume.low = low;
+    state.lastAvailable = available;
+    state.lastPoll = now;
+    state.nextPoll = now + interval;
+
+    if (changed)
+    {
+        BOOST_LOG_TRIVIAL(info) << "Volume " << state.volume.root << " is " << (low ? "low on" : "no longer low on")
+            << " disk space (avail: " << available << ", total: " << total << ", limit: " << limit << "%)";
+
+        m_changed(state.volume);
+    }
+}
+
+void DiskSpaceMonitor::Publish()
+{
+    std::map<std::string, Volume> volumes;
+
+    for (auto const& [root, state] : m_volumes)
+    {
+        // volumes that were never polled have nothing to tell yet
+        if (state.volume.total > 0)
+        {
+            volumes.insert({ root, state.volume });
+        }
+    }
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_publishedRoots = m_roots;
+    m_publishedVolumes = std::move(volumes);
+}
+
+void DiskSpaceMonitor::Run()
+{
+    for (;;)
+    {
+        std::vector<std::string> paths;
+        bool dirty = false;
+        int limit = 0;
+
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            auto wake = [this]() { return m_stop || m_dirty; };
+
+            if (m_volumes.empty())
+            {
+                m_wake.wait(lock, wake);
+            }
+            else
+            {
+                auto next = std::min_element(
+                    m_volumes.begin(),
+                    m_volumes.end(),
+                    [](auto const& lhs, auto const& rhs) { return lhs.second.nextPoll < rhs.second.nextPoll; });
+
+                m_wake.wait_until(lock, next->second.nextPoll, wake);
+            }
+
+            if (m_stop)
+            {
+                return;
+            }
+
+            if (m_dirty)
+            {
+                paths = m_paths;
+                dirty = true;
+                m_dirty = false;
+            }
+
+            limit = m_limit;
+        }
+
+        if (dirty)
+        {
+            UpdateVolumes(paths);
+        }
+
+        // volumes are polled without a limit too, for Find. nothing is low
+        // then, and volumes that were are reported as not low
+        auto const now = std::chrono::steady_clock::now();
+
+        for (auto& [root, state] : m_volumes)
+        {
+            if (dirty || state.nextPoll <= now)
+            {
+                Poll(state, std::max(limit, 0));
+            }
+        }
+
+        Publish();
+    }
+}
+
+void DiskSpaceMonitor::UpdateVolumes(std::vector<std::string> const& paths)
+{
+    std::map<std::string, std::string> roots;
+    std::map<std::string, VolumeState> volumes;
+
+    for (std::string const& path : paths)
+    {
+        auto cached = m_roots.find(path);
+        std::string root = cached != m_roots.end()
+            ? cached->second
+            : VolumeRoot(path);
+
+        if (root.empty())
+        {
+            continue;
+        }
+
+        roots.insert({ path, root });
+
+        auto volume = volumes.find(root);
+
+        if (volume == volumes.end())
+        {
+            auto existing = m_volumes.find(root);
+
+            volume = volumes.insert({ root, existing != m_volumes.end() ? existing->second : VolumeState() }).first;
+            volume->second.volume.root = root;
+            volume->second.volume.paths.clear();
+        }
+
+        volume->second.volume.paths.push_back(path);
+    }
+
+    for (auto& [root, state] : m_volumes)
+    {
+        if (!state.volume.low)
+        {
+            continue;
+        }
+
+        auto current = volumes.find(root);
+
+        // report low volumes again when their paths change, and gone ones as
+        // not low, so that nothing stays paused because of them
+        if (current == volumes.end())
+        {
+            state.volume.low = false;
+            m_changed(state.volume);
+        }
+        else if (current->second.volume.paths != state.volume.paths)
+        {
+            m_changed(current->second.volume);
+        }
+    }
+
+    m_roots = std::move(roots);
+    m_volumes = std::move(volumes);
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace pt
+{
+namespace Core
+{
+    // Watches the free space of the volumes a set of paths live on. Each
+    // volume is polled once on a background thread, more often the faster it
+    // fills up, and a report is made when it crosses the limit.
+    class DiskSpaceMonitor
+    {
+    public:
+        struct Volume
+        {
+            std::string root;
+            // the watched paths on this volume
+            std::vector<std::string> paths;
+            std::uint64_t available;
+            std::uint64_t total;
+            bool low;
+        };
+
+        // changed is called on the monitor thread
+        explicit DiskSpaceMonitor(std::function<void(Volume const&)> changed);
+        ~DiskSpaceMonitor();
+
+        // the minimum free space in percent of the volume size, or zero for
+        // none. volumes that were low are reported as not low then
+        void SetLimit(int percent);
+        void SetPaths(std::vector<std::string> paths);
+
+        // the volume a watched path is on, as of the last poll. returns false
+        // until the monitor thread has got to the path
+        bool Find(std::string const& path, Volume& volume) const;
+
+        // the mount point or drive root of the volume a path is on, or an
+        // empty string if it cannot be determined
+        static std::string VolumeRoot(std::string const& path);
+        static bool FreeSpace(std::string const& root, std::uint64_t& available, std::uint64_t& total);
+
+    private:
+        struct VolumeState
+        {
+            Volume volume;
+            std::uint64_t lastAvailable;
+            std::chrono::steady_clock::time_point lastPoll;
+            std::chrono::steady_clock::time_point nextPoll;
+        };
+
+        void Poll(VolumeState& state, int limit);
+        void Publish();
+        void Run();
+        void UpdateVolumes(std::vector<std::string> const& paths);
+
+        std::function<void(Volume const&)> m_changed;
+
+        mutable std::mutex m_mutex;
+        std::condition_variable m_wake;
+        std::vector<std::string> m_paths;
+        int m_limit;
+        bool m_dirty;
+        bool m_stop;
+        // copies of the tables below for Find
+        std::map<std::string, std::string> m_publishedRoots;
+        std::map<std::string, Volume> m_publishedVolumes;
+
+        // only touched by the monitor thread
+        std::map<std::string, std::string> m_roots;
+        std::map<std::string, VolumeState> m_volumes;
+
+        std::thread m_thread;
+    };
+}
+}
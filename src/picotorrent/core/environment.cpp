@@ -80,7 +80,7 @@ std::string Environment::GetCrashpadReportUrl()
 
 fs::path Environment::GetCoreDbFilePath()
 {
-    return GetApplicationPath() / "coredb.sqlite";
+    return GetApplicationPath() / "coredb.bin";
 }
 
 std::string Environment::GetCurrentLocale()
@@ -103,6 +103,11 @@ fs::path Environment::GetDatabaseFilePath()
     return GetApplicationDataPath() / "PicoTorrent.sqlite";
 }
 
+fs::path Environment::GetHashCacheFilePath()
+{
+    return GetApplicationDataPath() / "HashCache.bin";
+}
+
 fs::path Environment::GetKnownFolderPath(Environment::KnownFolder knownFolder)
 {
     KNOWNFOLDERID fid = { 0 };
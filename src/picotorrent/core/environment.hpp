@@ -24,6 +24,7 @@ namespace Core
         std::string GetCrashpadReportUrl();
         std::string GetCurrentLocale();
         std::filesystem::path GetDatabaseFilePath();
+        std::filesystem::path GetHashCacheFilePath();
         std::filesystem::path GetKnownFolderPath(KnownFolder knownFolder);
         std::filesystem::path GetLogFilePath();
         bool IsAppContainerProcess();
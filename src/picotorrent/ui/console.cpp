@@ -1,11 +1,20 @@
 #include "console.hpp"
 
+#include <algorithm>
+
+#include <fmt/format.h>
+
+#include "../core/utils.hpp"
+#include "dialogs/textoutputdialog.hpp"
 #include "filters/pqltorrentfilter.hpp"
 #include "ids.hpp"
 #include "models/torrentlistmodel.hpp"
 #include "torrentlistview.hpp"
+#include "translator.hpp"
 
 using pt::UI::Console;
+using pt::UI::Dialogs::TextOutputDialog;
+using pt::UI::Filters::PqlAggregate;
 
 wxDEFINE_EVENT(ptEVT_FILTER_CHANGED, wxCommandEvent);
 
@@ -45,6 +54,13 @@ void Console::SetText(std::string const& text)
 
 void Console::CreateFilter(std::string const& input)
 {
+    // aggregates do not filter the list, they only show their result
+    if (PqlAggregate::IsAggregate(input))
+    {
+        RunAggregate(input);
+        return;
+    }
+
     if (input.empty())
     {
         m_model->ClearFilter();
@@ -68,3 +84,100 @@ void Console::CreateFilter(std::string const& input)
 
     wxPostEvent(GetParent(), evt);
 }
+
+void Console::RunAggregate(std::string const& query)
+{
+    std::string err;
+    auto aggregate = PqlAggregate::Create(query, &err);
+
+    if (!aggregate)
+    {
+        wxMessageBox(err, "Filter error", wxICON_ERROR | wxOK, GetParent());
+        return;
+    }
+
+    auto const& columns = aggregate->Columns();
+    auto const& groupBy = aggregate->GroupBy();
+
+    // build the result as a table of strings, with the group as the first column
+    std::vector<std::vector<std::wstring>> table;
+    std::vector<std::wstring> header;
+
+    if (groupBy.has_value()) { header.push_back(Utils::toStdWString(groupBy.value())); }
+
+    for (auto const& column : columns)
+    {
+        header.push_back(Utils::toStdWString(column.function + "(" + column.field + ")"));
+    }
+
+    table.push_back(header);
+
+    for (auto const& row : aggregate->Evaluate(m_model->GetTorrents()))
+    {
+        std::vector<std::wstring> cells;
+
+        if (groupBy.has_value())
+        {
+            cells.push_back(row.group.empty() ? L"-" : Utils::toStdWString(row.group));
+        }
+
+        for (size_t i = 0; i < columns.size(); i++)
+        {
+            auto const& column = columns[i];
+            double value = row.values[i];
+
+            if (column.function == "count")
+            {
+                cells.push_back(std::to_wstring(static_cast<int64_t>(value)));
+            }
+            else if (column.field == "size")
+            {
+                cells.push_back(Utils::toHumanFileSize(static_cast<int64_t>(value)));
+            }
+            else if (column.field == "dl" || column.field == "ul")
+            {
+                cells.push_back(
+                    fmt::format(
+                        i18n("per_second_format"),
+                        Utils::toHumanFileSize(static_cast<int64_t>(value))));
+            }
+            else
+            {
+                cells.push_back(fmt::format(L"{:.3f}", value));
+            }
+        }
+
+        table.push_back(cells);
+    }
+
+    std::vector<size_t> widths(header.size(), 0);
+
+    for (auto const& cells : table)
+    {
+        for (size_t i = 0; i < cells.size(); i++)
+        {
+            widths[i] = std::max(widths[i], cells[i].size());
+        }
+    }
+
+    std::wstring output;
+
+    for (auto const& cells : table)
+    {
+        for (size_t i = 0; i < cells.size(); i++)
+        {
+            // the group column is left aligned, values are right aligned
+            output += (i == 0 && groupBy.has_value())
+                ? fmt::format(L"{:<{}}", cells[i], widths[i])
+                : fmt::format(L"{:>{}}", cells[i], widths[i]);
+
+            if (i + 1 < cells.size()) { output += L"  "; }
+        }
+
+        output += L"\r\n";
+    }
+
+    TextOutputDialog dlg(GetParent(), wxID_ANY, i18n("query_result"), Utils::toStdWString(query));
+    dlg.SetOutputText(output);
+    dlg.ShowModal();
+}
@@ -21,6 +21,7 @@ namespace pt::UI
 
     private:
         void CreateFilter(std::string const& filter);
+        void RunAggregate(std::string const& query);
 
         wxTextCtrl* m_input;
         Models::TorrentListModel* m_model;
@@ -306,6 +306,8 @@ AddTorrentDialog::AddTorrentDialog(wxWindow* parent, wxWindowID id, lt::add_torr
     this->Bind(wxEVT_BUTTON, &AddTorrentDialog::OnAddTracker, this, ptID_TRACKERS_ADD);
     this->Bind(wxEVT_BUTTON, &AddTorrentDialog::OnRemoveTracker, this, ptID_TRACKERS_REMOVE);
     this->Bind(wxEVT_DATAVIEW_ITEM_CONTEXT_MENU, &AddTorrentDialog::ShowFileContextMenu, this, ptID_FILE_LIST);
+    this->Bind(wxEVT_DATAVIEW_ITEM_EXPANDED, [this](wxDataViewEvent& evt) { m_filesModel->SetExpanded(evt.GetItem(), true); }, ptID_FILE_LIST);
+    this->Bind(wxEVT_DATAVIEW_ITEM_COLLAPSED, [this](wxDataViewEvent& evt) { m_filesModel->SetExpanded(evt.GetItem(), false); }, ptID_FILE_LIST);
     this->Bind(ptEVT_TORRENT_METADATA_FOUND, [this](BitTorrent::MetadataFoundEvent& evt) { this->MetadataFound(evt.GetData()); });
     this->Bind(wxEVT_BUTTON, &AddTorrentDialog::OnCancel, this, ptID_CANCEL);
     this->Bind(wxEVT_BUTTON, &AddTorrentDialog::OnOk, this, ptID_OK);
@@ -315,6 +317,8 @@ AddTorrentDialog::AddTorrentDialog(wxWindow* parent, wxWindowID id, lt::add_torr
 
 AddTorrentDialog::~AddTorrentDialog()
 {
+    m_filesModel->ClearNodes();
+
     {
         auto stmt = m_db->CreateStatement("INSERT INTO path_history (path, type, timestamp) VALUES(?, 'add_torrent_dialog', strftime('%s'))\n"
             "ON CONFLICT (path, type) DO UPDATE SET timestamp = excluded.timestamp;");
@@ -438,12 +442,16 @@ void AddTorrentDialog::Load()
     if (m_params.ti)
     {
         // Files
-        m_filesModel->RebuildTree(m_params.ti);
-        m_filesModel->UpdatePriorities(m_params.file_priorities);
+        m_filesModel->RebuildTree(
+            m_params.ti,
+            [this]()
+            {
+                wxDataViewItemArray children;
+                m_filesModel->GetChildren(m_filesModel->GetRootItem(), children);
+                for (auto const& child : children) { m_filesView->Expand(child); }
+            });
 
-        wxDataViewItemArray children;
-        m_filesModel->GetChildren(m_filesModel->GetRootItem(), children);
-        for (auto const& child : children) { m_filesView->Expand(child); }
+        m_filesModel->UpdatePriorities(m_params.file_priorities);
     }
     else
     {
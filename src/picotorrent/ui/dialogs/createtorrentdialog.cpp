@@ -6,13 +6,14 @@
 #include <boost/log/trivial.hpp>
 #include <fmt/format.h>
 #include <libtorrent/add_torrent_params.hpp>
-#include <libtorrent/create_torrent.hpp>
+#include <libtorrent/bencode.hpp>
 #include <libtorrent/torrent_info.hpp>
 #include <wx/hyperlink.h>
 #include <wx/tokenzr.h>
 
 #include "../../bittorrent/session.hpp"
 #include "../../buildinfo.hpp"
+#include "../../core/environment.hpp"
 #include "../../core/utils.hpp"
 #include "../translator.hpp"
 
@@ -23,65 +24,22 @@ wxDEFINE_EVENT(ptEVT_CREATE_TORRENT_THREAD_PROGRESS, wxThreadEvent);
 
 namespace fs = std::filesystem;
 namespace lt = libtorrent;
+using pt::BitTorrent::PieceHasher;
 using pt::BitTorrent::Session;
+using pt::BitTorrent::TorrentCreator;
 using pt::UI::Dialogs::CreateTorrentDialog;
 
-std::string branch_path(std::string const& f)
-{
-    if (f.empty()) return f;
-
-#ifdef TORRENT_WINDOWS
-    if (f == "\\\\") return "";
-#endif
-    if (f == "/") return "";
-
-    auto len = f.size();
-    // if the last character is / or \ ignore it
-    if (f[len - 1] == '/' || f[len - 1] == '\\') --len;
-    while (len > 0) {
-        --len;
-        if (f[len] == '/' || f[len] == '\\')
-            break;
-    }
-
-    if (f[len] == '/' || f[len] == '\\') ++len;
-    return std::string(f.c_str(), len);
-}
-
-enum class Mode
-{
-    v1,
-    Hybrid,
-    v2
-};
-
-struct CreateTorrentDialog::CreateTorrentParams
-{
-    std::string comment;
-    std::string creator;
-    std::string path;
-    std::vector<std::string> trackers;
-    std::vector<std::string> url_seeds;
-    bool priv;
-    bool add;
-    Mode mode;
-};
-
-struct ProgressPayload
-{
-    int totalPieces;
-    int currentPiece;
-};
-
 struct StopPayload
 {
     lt::entry e;
     std::string bp;
 };
 
-CreateTorrentDialog::CreateTorrentDialog(wxWindow* parent, wxWindowID id, std::shared_ptr<Session> session)
+CreateTorrentDialog::CreateTorrentDialog(wxWindow* parent, wxWindowID id, std::shared_ptr<Core::Environment> env, std::shared_ptr<Session> session)
     : wxDialog(parent, id, i18n("create_torrent"), wxDefaultPosition, wxDefaultSize, wxDEFAULT_DIALOG_STYLE | wxRESIZE_BORDER),
-    m_session(session)
+    m_env(env),
+    m_session(session),
+    m_cancelled(false)
 {
     auto pathSizer = new wxStaticBoxSizer(wxVERTICAL, this, i18n("files"));
     m_numFiles = new wxStaticText(pathSizer->GetStaticBox(), wxID_ANY, wxEmptyString);
@@ -234,18 +192,21 @@ CreateTorrentDialog::CreateTorrentDialog(wxWindow* parent, wxWindowID id, std::s
     this->Bind(ptEVT_CREATE_TORRENT_THREAD_PROGRESS,
         [this](wxThreadEvent& evt)
         {
-            auto pp = evt.GetPayload<ProgressPayload>();
+            auto pp = evt.GetPayload<PieceHasher::Progress>();
             m_status->SetLabel(
                 fmt::format(
                     i18n("status_s"),
                     fmt::format(
-                        i18n("status_hashing_piece"), pp.currentPiece + 1, pp.totalPieces)));
+                        i18n("status_hashing_pieces_rate"),
+                        pp.piecesHashed,
+                        pp.totalPieces,
+                        pp.bytesPerSecond / (1024 * 1024))));
 
             float progress = 0;
 
-            if (pp.currentPiece > 0)
+            if (pp.totalBytes > 0)
             {
-                progress = (pp.currentPiece + 1) / float(pp.totalPieces);
+                progress = pp.bytesHashed / float(pp.totalBytes);
             }
 
             m_progress->SetValue(static_cast<int>(progress * 100));
@@ -256,83 +217,59 @@ CreateTorrentDialog::CreateTorrentDialog(wxWindow* parent, wxWindowID id, std::s
 
 CreateTorrentDialog::~CreateTorrentDialog()
 {
+    m_cancelled = true;
     if (m_worker.joinable()) { m_worker.join(); }
 }
 
-void CreateTorrentDialog::GenerateTorrent(std::unique_ptr<CreateTorrentParams> p)
+void CreateTorrentDialog::GenerateTorrent(std::unique_ptr<TorrentCreator::Params> p)
 {
     wxQueueEvent(this, new wxThreadEvent(ptEVT_CREATE_TORRENT_THREAD_START));
 
-    lt::create_flags_t flags = {};
-    if (p->mode == Mode::v1) { flags = lt::create_torrent::v1_only; }
-    if (p->mode == Mode::v2) { flags = lt::create_torrent::v2_only; }
-
-    lt::file_storage fs;
-    lt::add_files(fs, p->path, flags);
-
-    lt::create_torrent ct(fs, 0, flags);
-    ct.set_comment(p->comment.c_str());
-    ct.set_creator(p->creator.c_str());
-    ct.set_priv(p->priv);
+    lt::error_code ec;
+    lt::entry e;
 
-    for (size_t i = 0; i < p->trackers.size(); i++)
+    try
     {
-        // Add one tracker per tier - this can of course be changed to something more advanced
-        // in the future but for now I think this is the most sensible. Also, dont add more
-        // than int32.MAX trackers, OK? :)
-        ct.add_tracker(p->trackers.at(i), static_cast<int>(i));
-    }
+        // the hasher reports progress a few times per second, so each report
+        // can be posted as is
+        e = TorrentCreator::Create(
+            *p,
+            [this](PieceHasher::Progress const& pp)
+            {
+                auto evt = new wxThreadEvent(ptEVT_CREATE_TORRENT_THREAD_PROGRESS);
+                evt->SetPayload(pp);
 
-    for (size_t i = 0; i < p->url_seeds.size(); i++)
-    {
-        ct.add_url_seed(p->url_seeds.at(i));
+                wxQueueEvent(this, evt);
+            },
+            m_cancelled,
+            ec);
     }
-
-    std::string branch = branch_path(p->path);
-
-    lt::error_code ec;
-    lt::set_piece_hashes(
-        ct,
-        branch,
-        [this, &ct](lt::piece_index_t idx)
-        {
-            ProgressPayload pp;
-            pp.currentPiece = static_cast<int>(idx);
-            pp.totalPieces = ct.num_pieces();
-
-            auto evt = new wxThreadEvent(ptEVT_CREATE_TORRENT_THREAD_PROGRESS);
-            evt->SetPayload(pp);
-
-            wxQueueEvent(this, evt);
-        },
-        ec);
-
-    if (ec)
+    catch (const std::exception& ex)
     {
-        BOOST_LOG_TRIVIAL(error) << "Error when setting piece hashes: " << ec;
+        BOOST_LOG_TRIVIAL(error) << "Error when generating torrent: " << ex.what();
         auto err = new wxThreadEvent(ptEVT_CREATE_TORRENT_THREAD_ERROR);
-        err->SetPayload<std::string>(ec.message());
+        err->SetPayload<std::string>(ex.what());
         wxQueueEvent(this, err);
         return;
     }
 
-    lt::entry e;
-
-    try
+    // the dialog is being destroyed, nobody is listening
+    if (m_cancelled)
     {
-        e = ct.generate();
+        return;
     }
-    catch (const std::exception& ex)
+
+    if (ec)
     {
-        BOOST_LOG_TRIVIAL(error) << "Error when generating torrent: " << ec;
+        BOOST_LOG_TRIVIAL(error) << "Error when setting piece hashes: " << ec;
         auto err = new wxThreadEvent(ptEVT_CREATE_TORRENT_THREAD_ERROR);
-        err->SetPayload<std::string>(ex.what());
+        err->SetPayload<std::string>(ec.message());
         wxQueueEvent(this, err);
         return;
     }
 
     StopPayload sp;
-    sp.bp = branch;
+    sp.bp = TorrentCreator::BasePath(p->path);
     sp.e = e;
 
     auto sevt = new wxThreadEvent(ptEVT_CREATE_TORRENT_THREAD_STOP);
@@ -373,13 +310,13 @@ void CreateTorrentDialog::OnCreateTorrent(wxCommandEvent&)
         return;
     }
 
-    auto params = std::make_unique<CreateTorrentParams>();
+    auto params = std::make_unique<TorrentCreator::Params>();
     params->comment = m_comment->GetValue();
     params->creator = m_creator->GetValue();
     params->path = m_path->GetValue().ToStdString();
     params->priv = m_private->IsChecked();
-    params->add = m_addToSession->IsChecked();
-    params->mode = static_cast<Mode>(m_mode->GetSelection());
+    params->mode = static_cast<TorrentCreator::Mode>(m_mode->GetSelection());
+    params->hashCache = m_env->GetHashCacheFilePath();
 
     {
         wxStringTokenizer tokenizer(m_trackers->GetValue());
@@ -388,7 +325,7 @@ void CreateTorrentDialog::OnCreateTorrent(wxCommandEvent&)
 
     {
         wxStringTokenizer tokenizer(m_urlSeeds->GetValue());
-        while (tokenizer.HasMoreTokens()) { params->url_seeds.push_back(tokenizer.GetNextToken().ToStdString()); }
+        while (tokenizer.HasMoreTokens()) { params->urlSeeds.push_back(tokenizer.GetNextToken().ToStdString()); }
     }
 
     // wait for previous run to join before starting new. this shouldn't
@@ -5,9 +5,12 @@
 #include <wx/wx.h>
 #endif
 
+#include <atomic>
 #include <memory>
 #include <thread>
 
+#include "../../bittorrent/torrentcreator.hpp"
+
 class wxComboBox;
 
 namespace pt
@@ -16,6 +19,10 @@ namespace BitTorrent
 {
     class Session;
 }
+namespace Core
+{
+    class Environment;
+}
 namespace UI
 {
 namespace Dialogs
@@ -23,7 +30,7 @@ namespace Dialogs
     class CreateTorrentDialog : public wxDialog
     {
     public:
-        explicit CreateTorrentDialog(wxWindow* parent, wxWindowID id, std::shared_ptr<BitTorrent::Session> session);
+        CreateTorrentDialog(wxWindow* parent, wxWindowID id, std::shared_ptr<Core::Environment> env, std::shared_ptr<BitTorrent::Session> session);
         virtual ~CreateTorrentDialog();
 
     private:
@@ -36,9 +43,7 @@ namespace Dialogs
             ptID_TXT_PATH
         };
 
-        struct CreateTorrentParams;
-
-        void GenerateTorrent(std::unique_ptr<CreateTorrentParams>);
+        void GenerateTorrent(std::unique_ptr<BitTorrent::TorrentCreator::Params>);
         void OnBrowsePath(wxCommandEvent&);
         void OnCreateTorrent(wxCommandEvent&);
         void SetEnabledState(bool state);
@@ -59,7 +64,9 @@ namespace Dialogs
         wxGauge* m_progress;
         wxButton* m_create;
 
+        std::shared_ptr<Core::Environment> m_env;
         std::shared_ptr<BitTorrent::Session> m_session;
+        std::atomic<bool> m_cancelled;
         std::thread m_worker;
     };
 }
@@ -47,7 +47,15 @@ static std::map<std::string, std::map<std::string, Property>> properties =
     {
         "PicoTorrent",
         {
+            MAKE_PROP(Bool, Bool,    bool, "file_journal.enabled",        "file_journal_enabled",      "When set to true, the size and modification time of each file is recorded when a torrent completes or is moved. An incremental recheck then only verifies the pieces of files that changed since."),
+            MAKE_PROP(Int,  Integer, int,  "move_queue.per_destination",  "move_queue_per_destination", "The number of storage moves that may write to the same volume at once."),
+            MAKE_PROP(Int,  Integer, int,  "move_queue.per_source",       "move_queue_per_source",     "The number of storage moves that may read from the same volume at once."),
+            MAKE_PROP(Int,  Integer, int,  "move_queue.retries",          "move_queue_retries",        "The number of times a failed storage move is tried again."),
+            MAKE_PROP(Int,  Integer, int,  "move_queue.retry_delay",      "move_queue_retry_delay",    "The time (in seconds) to wait before trying a failed storage move again. The wait grows with each attempt."),
             MAKE_PROP(Int,  Integer, int,  "save_resume_data_interval",   "save_resume_data_interval", "The interval (in seconds) between checks to save resume data for torrents. Saving resume data will help keep a current state if (for example) the application exits unexpectedly."),
+            MAKE_PROP(Bool, Bool,    bool, "scrub.enabled",               "scrub_enabled",             "When set to true, the pieces of seeding torrents are verified in the background to find data that went bad on disk. Corrupt pieces are downloaded again."),
+            MAKE_PROP(Int,  Integer, int,  "scrub.interval_days",         "scrub_interval_days",       "The number of days between two verifications of the same torrent."),
+            MAKE_PROP(Int,  Integer, int,  "scrub.rate_limit",            "scrub_rate_limit",          "The rate (in MiB per second) at which the background verification reads from the disk."),
             MAKE_PROP(Int,  Integer, int,  "ui.torrent_overview.columns", "torrent_overview_columns",  "The number of columns to show in the torrent overview panel."),
             MAKE_PROP(Bool, Bool,    bool, "ui.torrent_overview.show_piece_progress", "torrent_overview_show_piece_progress",  "When set to true, show the piece progress bar in the torrent overview panel.")
         }
@@ -3,6 +3,9 @@
 #include <wx/clrpicker.h>
 #include <wx/filepicker.h>
 #include <wx/listctrl.h>
+#include <wx/valtext.h>
+
+#include <fmt/format.h>
 
 #include "../clientdata.hpp"
 #include "../../core/configuration.hpp"
@@ -39,6 +42,13 @@ PreferencesLabelsPage::PreferencesLabelsPage(wxWindow* parent, std::shared_ptr<C
     m_savePathEnabled = new wxCheckBox(labelDetailsSizer->GetStaticBox(), wxID_ANY, wxEmptyString);
     m_applyFilter = new wxTextCtrl(labelDetailsSizer->GetStaticBox(), wxID_ANY, wxEmptyString);
     m_applyFilterEnabled = new wxCheckBox(labelDetailsSizer->GetStaticBox(), wxID_ANY, wxEmptyString);
+    m_completedPath = new wxDirPickerCtrl(labelDetailsSizer->GetStaticBox(), wxID_ANY, wxEmptyString, wxDirSelectorPromptStr, wxDefaultPosition, wxDefaultSize, wxDIRP_DEFAULT_STYLE | wxDIRP_SMALL);
+    m_completedPathEnabled = new wxCheckBox(labelDetailsSizer->GetStaticBox(), wxID_ANY, wxEmptyString);
+    m_watermarksEnabled = new wxCheckBox(labelDetailsSizer->GetStaticBox(), wxID_ANY, wxEmptyString);
+    m_highWatermark = new wxTextCtrl(labelDetailsSizer->GetStaticBox(), wxID_ANY, wxEmptyString, wxDefaultPosition, wxSize(FromDIP(40), -1));
+    m_highWatermark->SetValidator(wxTextValidator(wxFILTER_DIGITS));
+    m_lowWatermark = new wxTextCtrl(labelDetailsSizer->GetStaticBox(), wxID_ANY, wxEmptyString, wxDefaultPosition, wxSize(FromDIP(40), -1));
+    m_lowWatermark->SetValidator(wxTextValidator(wxFILTER_DIGITS));
 
     auto labelDetailsGrid = new wxFlexGridSizer(2, FromDIP(4), FromDIP(25));
     labelDetailsGrid->AddGrowableCol(1, 1);
@@ -63,6 +73,21 @@ PreferencesLabelsPage::PreferencesLabelsPage(wxWindow* parent, std::shared_ptr<C
     applyFilterSizer->Add(m_applyFilter, 1, wxEXPAND);
     labelDetailsGrid->Add(applyFilterSizer, 1, wxALL, FromDIP(3));
 
+    labelDetailsGrid->Add(new wxStaticText(labelDetailsSizer->GetStaticBox(), wxID_ANY, i18n("completed_path")), 0, wxALL | wxALIGN_CENTER_VERTICAL, FromDIP(3));
+    auto completedPathSizer = new wxBoxSizer(wxHORIZONTAL);
+    completedPathSizer->Add(m_completedPathEnabled, 0, wxALIGN_CENTER_VERTICAL);
+    completedPathSizer->Add(m_completedPath, 1, wxEXPAND);
+    labelDetailsGrid->Add(completedPathSizer, 1, wxEXPAND | wxALL, FromDIP(3));
+
+    labelDetailsGrid->Add(new wxStaticText(labelDetailsSizer->GetStaticBox(), wxID_ANY, i18n("save_path_usage")), 0, wxALL | wxALIGN_CENTER_VERTICAL, FromDIP(3));
+    auto watermarksSizer = new wxBoxSizer(wxHORIZONTAL);
+    watermarksSizer->Add(m_watermarksEnabled, 0, wxALIGN_CENTER_VERTICAL);
+    watermarksSizer->Add(new wxStaticText(labelDetailsSizer->GetStaticBox(), wxID_ANY, i18n("move_completed_above")), 0, wxALIGN_CENTER_VERTICAL | wxRIGHT, FromDIP(3));
+    watermarksSizer->Add(m_highWatermark, 0, wxRIGHT, FromDIP(7));
+    watermarksSizer->Add(new wxStaticText(labelDetailsSizer->GetStaticBox(), wxID_ANY, i18n("until_below")), 0, wxALIGN_CENTER_VERTICAL | wxRIGHT, FromDIP(3));
+    watermarksSizer->Add(m_lowWatermark);
+    labelDetailsGrid->Add(watermarksSizer, 1, wxALL, FromDIP(3));
+
     labelDetailsSizer->Add(labelDetailsGrid, 1, wxEXPAND);
 
     auto sizer = new wxBoxSizer(wxVERTICAL);
@@ -140,6 +165,17 @@ PreferencesLabelsPage::PreferencesLabelsPage(wxWindow* parent, std::shared_ptr<C
             m_applyFilter->Enable(label->applyFilterEnabled);
             m_applyFilter->SetValue(label->applyFilter);
             m_applyFilterEnabled->SetValue(label->applyFilterEnabled);
+
+            m_completedPath->Enable(label->completedPathEnabled);
+            m_completedPath->SetPath(Utils::toStdWString(label->completedPath));
+            m_completedPathEnabled->SetValue(label->completedPathEnabled);
+
+            m_watermarksEnabled->Enable(label->completedPathEnabled);
+            m_watermarksEnabled->SetValue(label->watermarksEnabled);
+            m_highWatermark->Enable(label->completedPathEnabled && label->watermarksEnabled);
+            m_highWatermark->ChangeValue(std::to_string(label->highWatermark));
+            m_lowWatermark->Enable(label->completedPathEnabled && label->watermarksEnabled);
+            m_lowWatermark->ChangeValue(std::to_string(label->lowWatermark));
         });
 
     m_labelsList->Bind(
@@ -223,6 +259,64 @@ PreferencesLabelsPage::PreferencesLabelsPage(wxWindow* parent, std::shared_ptr<C
             label->applyFilterEnabled = m_applyFilterEnabled->GetValue();
             m_applyFilter->Enable(m_applyFilterEnabled->GetValue());
         });
+
+    m_completedPathEnabled->Bind(
+        wxEVT_CHECKBOX,
+        [this](wxCommandEvent&)
+        {
+            long sel = m_labelsList->GetFirstSelected();
+            if (sel < 0) { return; }
+            auto label = reinterpret_cast<Configuration::Label*>(m_labelsList->GetItemData(sel));
+            label->completedPathEnabled = m_completedPathEnabled->GetValue();
+            m_completedPath->Enable(label->completedPathEnabled);
+            m_watermarksEnabled->Enable(label->completedPathEnabled);
+            m_highWatermark->Enable(label->completedPathEnabled && label->watermarksEnabled);
+            m_lowWatermark->Enable(label->completedPathEnabled && label->watermarksEnabled);
+        });
+
+    m_completedPath->Bind(
+        wxEVT_DIRPICKER_CHANGED,
+        [this](wxCommandEvent&)
+        {
+            long sel = m_labelsList->GetFirstSelected();
+            if (sel < 0) { return; }
+            auto label = reinterpret_cast<Configuration::Label*>(m_labelsList->GetItemData(sel));
+            label->completedPath = Utils::toStdString(m_completedPath->GetPath().wc_str());
+        });
+
+    m_watermarksEnabled->Bind(
+        wxEVT_CHECKBOX,
+        [this](wxCommandEvent&)
+        {
+            long sel = m_labelsList->GetFirstSelected();
+            if (sel < 0) { return; }
+            auto label = reinterpret_cast<Configuration::Label*>(m_labelsList->GetItemData(sel));
+            label->watermarksEnabled = m_watermarksEnabled->GetValue();
+            m_highWatermark->Enable(label->watermarksEnabled);
+            m_lowWatermark->Enable(label->watermarksEnabled);
+        });
+
+    m_highWatermark->Bind(
+        wxEVT_TEXT,
+        [this](wxCommandEvent&)
+        {
+            long sel = m_labelsList->GetFirstSelected();
+            long value = 0;
+            if (sel < 0 || !m_highWatermark->GetValue().ToLong(&value)) { return; }
+            auto label = reinterpret_cast<Configuration::Label*>(m_labelsList->GetItemData(sel));
+            label->highWatermark = static_cast<int>(value);
+        });
+
+    m_lowWatermark->Bind(
+        wxEVT_TEXT,
+        [this](wxCommandEvent&)
+        {
+            long sel = m_labelsList->GetFirstSelected();
+            long value = 0;
+            if (sel < 0 || !m_lowWatermark->GetValue().ToLong(&value)) { return; }
+            auto label = reinterpret_cast<Configuration::Label*>(m_labelsList->GetItemData(sel));
+            label->lowWatermark = static_cast<int>(value);
+        });
 }
 
 PreferencesLabelsPage::~PreferencesLabelsPage()
@@ -249,6 +343,31 @@ void PreferencesLabelsPage::Save()
 
 bool PreferencesLabelsPage::IsValid()
 {
+    for (int i = 0; i < m_labelsList->GetItemCount(); i++)
+    {
+        auto lbl = reinterpret_cast<Configuration::Label*>(m_labelsList->GetItemData(i));
+
+        if (lbl->completedPathEnabled
+            && lbl->watermarksEnabled
+            && (lbl->highWatermark <= 0
+                || lbl->highWatermark > 100
+                || lbl->lowWatermark < 0
+                || lbl->lowWatermark >= lbl->highWatermark))
+        {
+            m_labelsList->Select(i);
+            m_labelsList->EnsureVisible(i);
+            m_highWatermark->SetFocus();
+
+            wxMessageBox(
+                fmt::format(i18n("invalid_label_watermarks"), Utils::toStdWString(lbl->name)),
+                "PicoTorrent",
+                wxICON_WARNING | wxOK,
+                this);
+
+            return false;
+        }
+    }
+
     return true;
 }
 
@@ -261,6 +380,11 @@ void PreferencesLabelsPage::EnableDisableAll(bool enabled)
     m_savePathEnabled->Enable(enabled);
     m_applyFilter->Enable(enabled);
     m_applyFilterEnabled->Enable(enabled);
+    m_completedPath->Enable(enabled);
+    m_completedPathEnabled->Enable(enabled);
+    m_watermarksEnabled->Enable(enabled);
+    m_highWatermark->Enable(enabled);
+    m_lowWatermark->Enable(enabled);
 
     if (!enabled)
     {
@@ -271,5 +395,10 @@ void PreferencesLabelsPage::EnableDisableAll(bool enabled)
         m_savePathEnabled->SetValue(false);
         m_applyFilter->SetValue("");
         m_applyFilterEnabled->SetValue(false);
+        m_completedPath->SetPath("");
+        m_completedPathEnabled->SetValue(false);
+        m_watermarksEnabled->SetValue(false);
+        m_highWatermark->ChangeValue("");
+        m_lowWatermark->ChangeValue("");
     }
 }
@@ -45,6 +45,11 @@ namespace Dialogs
         wxCheckBox* m_savePathEnabled;
         wxTextCtrl* m_applyFilter;
         wxCheckBox* m_applyFilterEnabled;
+        wxDirPickerCtrl* m_completedPath;
+        wxCheckBox* m_completedPathEnabled;
+        wxCheckBox* m_watermarksEnabled;
+        wxTextCtrl* m_highWatermark;
+        wxTextCtrl* m_lowWatermark;
     };
 }
 }
@@ -39,3 +39,9 @@ void TextOutputDialog::SetOutputText(std::string const& text)
     m_outputText->SetValue(text);
     m_outputText->SetInsertionPointEnd();
 }
+
+void TextOutputDialog::SetOutputText(std::wstring const& text)
+{
+    m_outputText->SetValue(text);
+    m_outputText->SetInsertionPointEnd();
+}
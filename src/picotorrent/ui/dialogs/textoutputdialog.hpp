@@ -20,6 +20,7 @@ namespace Dialogs
         virtual ~TextOutputDialog();
 
         void SetOutputText(std::string const& text);
+        void SetOutputText(std::wstring const& text);
 
     private:
         wxTextCtrl* m_outputText;
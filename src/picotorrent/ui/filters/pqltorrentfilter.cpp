@@ -1,423 +1,341 @@
 #include "pqltorrentfilter.hpp"
 
+#include <algorithm>
+#include <cctype>
+#include <limits>
+#include <map>
 #include <optional>
 
 #include <boost/log/trivial.hpp>
-
-#include <antlr4-runtime.h>
-#include <QueryBaseVisitor.h>
-#include <QueryLexer.h>
-#include <QueryParser.h>
+#include <querycompiler.hpp>
+#include <queryparser.hpp>
 
 #include "../../bittorrent/torrenthandle.hpp"
 #include "../../bittorrent/torrentstatus.hpp"
+#include "trigramindex.hpp"
 
 using pt::BitTorrent::TorrentHandle;
 using pt::BitTorrent::TorrentStatus;
+using pt::PQL::QueryException;
+using pt::PQL::QueryParser;
+using pt::UI::Filters::PqlAggregate;
 using pt::UI::Filters::PqlTorrentFilter;
+using pt::UI::Filters::TrigramIndex;
+
+typedef pt::PQL::QueryCompiler<TorrentStatus, TrigramIndex> Compiler;
+typedef Compiler::CompiledExpression CompiledExpression;
 
-struct Value
+struct CompiledQuery
 {
-    std::optional<int64_t> value_int;
-    std::optional<float> value_float;
-    std::optional<std::string> value_string;
-    std::optional<std::string> suffix_size;
-    std::optional<std::string> suffix_speed;
+    std::optional<CompiledExpression> expression;
+    Compiler::SortKeyFunc orderBy;
+    bool descending = false;
+    std::optional<size_t> limit;
+    std::string error;
 };
 
-static std::map<std::string, std::function<bool(Value const&)>> FieldValidators =
+PqlTorrentFilter::PqlTorrentFilter(
+    std::function<bool(TorrentStatus const&)> const& filter,
+    CandidatesFunc const& candidates,
+    std::function<SortKey(TorrentStatus const&)> const& orderBy,
+    bool descending,
+    std::optional<size_t> limit)
+    : m_filter(filter),
+    m_candidates(candidates),
+    m_orderBy(orderBy),
+    m_descending(descending),
+    m_limit(limit)
 {
-    { "dl",       [](Value const& v) { return v.value_int.has_value() || v.value_float.has_value(); } },
-    { "ul",       [](Value const& v) { return v.value_int.has_value() || v.value_float.has_value(); } },
-    { "progress", [](Value const& v) { return v.value_int.has_value() || v.value_float.has_value(); } },
-    { "size",     [](Value const& v) { return v.value_int.has_value() || v.value_float.has_value(); } },
-    { "name",     [](Value const& v) { return v.value_string.has_value(); } },
-    { "status",   [](Value const& v) { return v.value_string.has_value(); } },
-    { "label",    [](Value const& v) { return v.value_string.has_value(); } },
-};
+}
 
-typedef std::function<bool(TorrentStatus const&)> FilterFunc;
+PqlTorrentFilter::~PqlTorrentFilter()
+{
+}
 
-class ExceptionErrorListener : public antlr4::BaseErrorListener
+std::unique_ptr<pt::UI::Filters::TorrentFilter> PqlTorrentFilter::Create(std::string const& input, std::string* error)
 {
-public:
-    virtual void syntaxError(
-        antlr4::Recognizer* /* recognizer */,
-        antlr4::Token* /* offendingSymbol */,
-        size_t line,
-        size_t charPositionInLine,
-        const std::string& msg,
-        std::exception_ptr e) override {
-
-        e = nullptr;
-        std::ostringstream oss;
-        oss << "Syntax error - " << msg << " at " << line << ":" << charPositionInLine;
-        error_msg = oss.str();
-        throw antlr4::ParseCancellationException(error_msg);
-    }
+    // queries are compiled once and kept around, the console re-applies the same
+    // few queries (and the saved filter on startup) over and over. this is only
+    // ever called from the UI thread.
+    static std::map<std::string, CompiledQuery> cache;
 
-private:
-    std::string error_msg;
-};
+    auto cached = cache.find(input);
 
-class QueryException : public std::exception
-{
-public:
-    QueryException(std::string const& msg, size_t line, size_t pos)
+    if (cached == cache.end())
     {
-        std::ostringstream oss;
-        oss << msg << " at " << line << ":" << pos;
-        m_msg = oss.str();
+        CompiledQuery compiled;
+
+        try
+        {
+            auto query = QueryParser::Parse(input);
+
+            if (!query.aggregates.empty())
+            {
+                throw QueryException("Aggregate functions cannot be used as a filter", query.aggregates[0].functionPosition);
+            }
+
+            compiled.expression = Compiler::CompileFilter(query.filter);
+
+            if (query.orderBy.has_value())
+            {
+                compiled.orderBy = Compiler::CompileOrderBy(query.orderBy.value());
+                compiled.descending = query.orderBy->descending;
+            }
+
+            if (query.limit.has_value())
+            {
+                compiled.limit = static_cast<size_t>(query.limit->count);
+            }
+        }
+        catch (QueryException const& ex)
+        {
+            BOOST_LOG_TRIVIAL(error) << "Failed to parse query: " << ex.what();
+            compiled.expression = std::nullopt;
+            compiled.error = ex.what();
+        }
+
+        // keep the cache bounded, typing in the console produces lots of one-off queries
+        if (cache.size() >= 64)
+        {
+            cache.clear();
+        }
+
+        cached = cache.insert({ input, compiled }).first;
     }
 
-    virtual const char* what() const NOEXCEPT override
+    CompiledQuery const& compiled = cached->second;
+
+    if (!compiled.expression.has_value())
     {
-        return m_msg.c_str();
+        *error = compiled.error;
+        return nullptr;
     }
 
-private:
-    std::string m_msg;
-};
+    return std::unique_ptr<TorrentFilter>(
+        new PqlTorrentFilter(
+            compiled.expression->filter,
+            compiled.expression->candidates,
+            compiled.orderBy,
+            compiled.descending,
+            compiled.limit));
+}
 
-enum class Operator
+bool PqlTorrentFilter::Includes(pt::BitTorrent::TorrentHandle const& torrent)
 {
-    CONTAINS,
-    LT,
-    LTE,
-    EQ,
-    GT,
-    GTE,
-};
+    return m_filter(torrent.Status());
+}
 
-template<typename TLeft, typename TRight>
-bool Compare(TLeft const& lhs, TRight const& rhs, Operator oper)
+std::optional<std::vector<uint32_t>> PqlTorrentFilter::Candidates(TrigramIndex const& index)
 {
-    switch (oper)
+    if (!m_candidates)
     {
-    case Operator::LT: return lhs < rhs;
-    case Operator::LTE: return lhs <= rhs;
-    case Operator::EQ: return lhs == rhs;
-    case Operator::GT: return lhs > rhs;
-    case Operator::GTE: return lhs >= rhs;
+        return std::nullopt;
     }
 
-    throw std::exception("Unknown operator");
+    return m_candidates(index);
 }
 
-class FilterVisitor : public pt::PQL::QueryBaseVisitor
+bool PqlTorrentFilter::HasSelection()
 {
-public:
-    virtual antlrcpp::Any visitAndExpression(pt::PQL::QueryParser::AndExpressionContext* ctx) override
-    {
-        std::vector<FilterFunc> funcs;
+    return m_orderBy || m_limit.has_value();
+}
 
-        for (auto expr : ctx->expression())
+void PqlTorrentFilter::Select(std::vector<pt::BitTorrent::TorrentHandle*>& torrents)
+{
+    if (!m_orderBy)
+    {
+        if (m_limit.has_value() && torrents.size() > m_limit.value())
         {
-            funcs.push_back(this->visit(expr));
+            torrents.resize(m_limit.value());
         }
 
-        return FilterFunc([funcs](TorrentStatus const& ts)
-            {
-                return std::all_of(
-                    funcs.begin(),
-                    funcs.end(),
-                    [&ts](auto const& f)
-                    {
-                        return f(ts);
-                    });
-            });
+        return;
     }
 
-    virtual antlrcpp::Any visitFilter(pt::PQL::QueryParser::FilterContext* ctx) override
+    // extract the sort key once per torrent, then partially sort only the
+    // first k entries which keeps this at O(n log k) for 'limit k'
+    std::vector<std::pair<SortKey, TorrentHandle*>> keyed;
+    keyed.reserve(torrents.size());
+
+    for (auto torrent : torrents)
     {
-        return this->visit(ctx->expression());
+        keyed.emplace_back(m_orderBy(torrent->Status()), torrent);
     }
 
-    virtual antlrcpp::Any visitOrExpression(pt::PQL::QueryParser::OrExpressionContext* ctx) override
-    {
-        std::vector<FilterFunc> funcs;
+    size_t k = m_limit.has_value()
+        ? std::min(m_limit.value(), keyed.size())
+        : keyed.size();
 
-        for (auto expr : ctx->expression())
+    std::partial_sort(
+        keyed.begin(),
+        keyed.begin() + k,
+        keyed.end(),
+        [this](auto const& lhs, auto const& rhs)
         {
-            funcs.push_back(this->visit(expr));
-        }
-
-        return FilterFunc([funcs](TorrentStatus const& ts)
+            if (lhs.first != rhs.first)
             {
-                return std::any_of(
-                    funcs.begin(),
-                    funcs.end(),
-                    [&ts](auto const& f)
-                    {
-                        return f(ts);
-                    });
-            });
-    }
+                return m_descending
+                    ? lhs.first > rhs.first
+                    : lhs.first < rhs.first;
+            }
+
+            // stable tie-break so rows do not jump around between updates
+            return lhs.second->InfoHash() < rhs.second->InfoHash();
+        });
+
+    torrents.resize(k);
 
-    virtual antlrcpp::Any visitOper(pt::PQL::QueryParser::OperContext* ctx) override
+    for (size_t i = 0; i < k; i++)
     {
-        if (ctx->CONTAINS()) return Operator::CONTAINS;
-        if (ctx->EQ()) return Operator::EQ;
-        if (ctx->GT()) return Operator::GT;
-        if (ctx->GTE()) return Operator::GTE;
-        if (ctx->LT()) return Operator::LT;
-        if (ctx->LTE()) return Operator::LTE;
-
-        throw QueryException(
-            "Unknown operator",
-            ctx->getStart()->getLine(),
-            ctx->getStart()->getCharPositionInLine());
+        torrents[i] = keyed[i].second;
     }
+}
 
-    virtual antlrcpp::Any visitOperatorPredicate(pt::PQL::QueryParser::OperatorPredicateContext* ctx) override
-    {
-        std::string ref = this->visit(ctx->reference());
-        Operator oper = this->visit(ctx->oper());
-        Value value = this->visit(ctx->value());
+bool PqlAggregate::IsAggregate(std::string const& input)
+{
+    // an aggregate query starts with a function call, which is never valid in a filter
+    size_t i = 0;
 
-        auto field = FieldValidators.find(ref);
+    while (i < input.size() && std::isspace(static_cast<unsigned char>(input[i]))) { i++; }
+    size_t start = i;
+    while (i < input.size() && std::isalpha(static_cast<unsigned char>(input[i]))) { i++; }
+    if (i == start) { return false; }
+    while (i < input.size() && std::isspace(static_cast<unsigned char>(input[i]))) { i++; }
 
-        if (field == FieldValidators.end())
-        {
-            throw QueryException(
-                "Unknown field: '" + ref + "'",
-                ctx->reference()->getStart()->getLine(),
-                ctx->reference()->getStart()->getCharPositionInLine());
-        }
+    return i < input.size() && input[i] == '(';
+}
 
-        if (!field->second(value))
-        {
-            throw QueryException(
-                "Invalid data type for field '" + ref + "'",
-                ctx->value()->getStart()->getLine(),
-                ctx->value()->getStart()->getCharPositionInLine());
-        }
+std::unique_ptr<PqlAggregate> PqlAggregate::Create(std::string const& input, std::string* error)
+{
+    static std::vector<std::string> Functions = { "avg", "count", "max", "min", "sum" };
 
-        if (ref == "dl" || ref == "ul")
-        {
-            float term = value.value_float.has_value()
-                ? value.value_float.value()
-                : static_cast<float>(value.value_int.value());
+    std::unique_ptr<PqlAggregate> aggregate(new PqlAggregate());
 
-            if (value.suffix_speed.has_value())
-            {
-                std::string suffix = value.suffix_speed.value();
-                if (suffix == "kbps") { term *= 1024; }
-                if (suffix == "mbps") { term *= 1048576; }
-                if (suffix == "gbps") { term *= 1073741824; }
-            }
+    try
+    {
+        auto query = QueryParser::Parse(input);
 
-            if (ref == "dl") return FilterFunc([oper, term](TorrentStatus const& ts) { return Compare(ts.downloadPayloadRate, term, oper); });
-            if (ref == "ul") return FilterFunc([oper, term](TorrentStatus const& ts) { return Compare(ts.uploadPayloadRate, term, oper); });
+        if (query.aggregates.empty())
+        {
+            throw QueryException("Expected an aggregate function", pt::PQL::Position{ 1, 0 });
         }
 
-        if (ref == "name")
+        for (auto const& agg : query.aggregates)
         {
-            std::string term = value.value_string.value();
-
-            if (oper == Operator::CONTAINS)
+            if (std::find(Functions.begin(), Functions.end(), agg.function) == Functions.end())
             {
-                return FilterFunc(
-                    [term](TorrentStatus const& ts)
-                    {
-                        return ts.name.find(term) != std::string::npos;
-                    });
+                throw QueryException("Unknown aggregate function: '" + agg.function + "'", agg.functionPosition);
             }
 
-            return FilterFunc([oper, term](TorrentStatus const& ts) { return Compare(ts.name, term, oper); });
-        }
-
-        if (ref == "progress")
-        {
-            float term = value.value_float.has_value()
-                ? value.value_float.value()
-                : static_cast<float>(value.value_int.value());
-
-            return FilterFunc([oper, term](TorrentStatus const& ts) { return Compare(ts.progress * 100, term, oper); });
-        }
-
-        if (ref == "size")
-        {
-            float term = value.value_float.has_value()
-                ? value.value_float.value()
-                : static_cast<float>(value.value_int.value());
+            if (agg.function == "count")
+            {
+                if (!agg.field.empty())
+                {
+                    throw QueryException("count() does not take a field", agg.fieldPosition);
+                }
 
-            if (value.suffix_size.has_value())
+                aggregate->m_values.push_back(nullptr);
+            }
+            else
             {
-                std::string suffix = value.suffix_size.value();
-                if (suffix == "kb") { term *= 1024; }
-                if (suffix == "mb") { term *= 1048576; }
-                if (suffix == "gb") { term *= 1073741824; }
+                aggregate->m_values.push_back(Compiler::CompileAggregateValue(agg));
             }
 
-            return FilterFunc([oper, term](TorrentStatus const& ts) { return Compare(ts.totalWanted, term, oper); });
+            aggregate->m_columns.push_back({ agg.function, agg.field });
         }
 
-        if (ref == "status")
+        if (query.groupBy.has_value())
         {
-            std::string term = value.value_string.value();
-
-            return FilterFunc(
-                [oper, term](TorrentStatus const& ts)
-                {
-                    if (term == "error" && ts.state == TorrentStatus::State::Error) return true;
-                    if (term == "downloading")
-                    {
-                        return ts.state == TorrentStatus::State::Downloading
-                            || ts.state == TorrentStatus::State::DownloadingChecking
-                            || ts.state == TorrentStatus::State::DownloadingMetadata
-                            || ts.state == TorrentStatus::State::DownloadingPaused
-                            || ts.state == TorrentStatus::State::DownloadingQueued;
-                    }
-                    if (term == "paused")
-                    {
-                        return ts.state == TorrentStatus::State::DownloadingPaused
-                            || ts.state == TorrentStatus::State::UploadingPaused;
-                    }
-                    if (term == "queued")
-                    {
-                        return ts.state == TorrentStatus::State::DownloadingQueued
-                            || ts.state == TorrentStatus::State::UploadingQueued;
-                    }
-                    if (term == "seeding")
-                    {
-                        return ts.state == TorrentStatus::State::Uploading;
-                    }
-                    if (term == "uploading")
-                    {
-                        return ts.state == TorrentStatus::State::Uploading
-                            || ts.state == TorrentStatus::State::UploadingPaused
-                            || ts.state == TorrentStatus::State::UploadingQueued;
-                    }
-                    return false;
-                });
+            aggregate->m_groupKey = Compiler::CompileGroupBy(query.groupBy.value());
+            aggregate->m_groupBy = query.groupBy->field;
         }
 
-        if (ref == "label")
-        {
-            std::string term = value.value_string.value();
-
-            if (oper == Operator::CONTAINS)
-            {
-                return FilterFunc(
-                    [term](TorrentStatus const& ts)
-                    {
-                        return ts.labelName.find(term) != std::string::npos;
-                    });
-            }
+        aggregate->m_filter = Compiler::CompileFilter(query.filter).filter;
 
-            return FilterFunc([oper, term](TorrentStatus const& ts) { return Compare(ts.labelName, term, oper); });
-        }
-
-        throw QueryException(
-            "Unknown field: '" + ref + "'",
-            ctx->getStart()->getLine(),
-            ctx->getStart()->getCharPositionInLine());
+        return aggregate;
     }
-
-    virtual antlrcpp::Any visitPredicateExpression(pt::PQL::QueryParser::PredicateExpressionContext* ctx) override
+    catch (QueryException const& ex)
     {
-        return this->visit(ctx->predicate());
+        BOOST_LOG_TRIVIAL(error) << "Failed to parse query: " << ex.what();
+        *error = ex.what();
     }
 
-    virtual antlrcpp::Any visitReference(pt::PQL::QueryParser::ReferenceContext* ctx) override
+    return nullptr;
+}
+
+std::vector<PqlAggregate::Row> PqlAggregate::Evaluate(std::vector<pt::BitTorrent::TorrentHandle*> const& torrents)
+{
+    struct Accumulator
     {
-        return ctx->getText();
-    }
+        int64_t count = 0;
+        std::vector<double> sum;
+        std::vector<double> min;
+        std::vector<double> max;
+    };
 
-    virtual antlrcpp::Any visitValue(pt::PQL::QueryParser::ValueContext* ctx) override
+    std::map<std::string, Accumulator> groups;
+
+    // a single pass over the torrents, each status is only copied once
+    for (auto torrent : torrents)
     {
-        Value val;
+        TorrentStatus const& ts = torrent->Status();
 
-        if (auto suffix = ctx->UNIT_SIZE())
+        if (!m_filter(ts))
         {
-            val.suffix_size = suffix->getText();
+            continue;
         }
 
-        if (auto suffix = ctx->UNIT_SPEED())
-        {
-            val.suffix_speed = suffix->getText();
-        }
+        std::string key = m_groupKey ? m_groupKey(ts) : "";
+        Accumulator& acc = groups[key];
 
-        if (auto value = ctx->FLOAT())
+        if (acc.count == 0)
         {
-            val.value_float = std::stof(value->getText());
+            acc.sum.resize(m_values.size(), 0);
+            acc.min.resize(m_values.size(), std::numeric_limits<double>::max());
+            acc.max.resize(m_values.size(), std::numeric_limits<double>::lowest());
         }
 
-        if (auto value = ctx->INT())
-        {
-            std::string t = value->getText();
-            val.value_int = std::stoll(t);
-        }
+        acc.count++;
 
-        if (auto value = ctx->STRING())
+        for (size_t i = 0; i < m_values.size(); i++)
         {
-            std::string text = value->getText();
-            if (text.size() > 0 && text[0] == '\"') { text = text.substr(1); }
-            if (text.size() > 0 && text[text.size() - 1] == '\"') { text = text.substr(0, text.size() - 1); }
-            val.value_string = text;
-        }
+            if (!m_values[i]) { continue; }
 
-        if (!val.value_float.has_value()
-            && !val.value_int.has_value()
-            && !val.value_string.has_value())
-        {
-            throw QueryException(
-                "Unknown value: '" + ctx->getText() + "'",
-                ctx->getStart()->getLine(),
-                ctx->getStart()->getCharPositionInLine());
+            double value = m_values[i](ts);
+            acc.sum[i] += value;
+            acc.min[i] = std::min(acc.min[i], value);
+            acc.max[i] = std::max(acc.max[i], value);
         }
-
-        return val;
     }
-};
-
-PqlTorrentFilter::PqlTorrentFilter(std::function<bool(pt::BitTorrent::TorrentStatus const&)> const& filter)
-    : m_filter(filter)
-{
-}
-
-PqlTorrentFilter::~PqlTorrentFilter()
-{
-}
 
-std::unique_ptr<pt::UI::Filters::TorrentFilter> PqlTorrentFilter::Create(std::string const& input, std::string* error)
-{
-    antlr4::ANTLRInputStream inputStream(input);
+    // without grouping, always return a single row - 'count()' should say 0
+    if (!m_groupKey && groups.empty())
+    {
+        Row row;
+        row.values.resize(m_columns.size(), 0);
+        return { row };
+    }
 
-    pt::PQL::QueryLexer lexer(&inputStream);
-    lexer.removeErrorListeners();
-    lexer.addErrorListener(new ExceptionErrorListener());
+    std::vector<Row> result;
 
-    antlr4::CommonTokenStream tokens(&lexer);
+    for (auto const& [key, acc] : groups)
+    {
+        Row row;
+        row.group = key;
 
-    pt::PQL::QueryParser parser(&tokens);
-    parser.removeErrorListeners();
-    parser.addErrorListener(new ExceptionErrorListener());
+        for (size_t i = 0; i < m_columns.size(); i++)
+        {
+            std::string const& function = m_columns[i].function;
 
-    try
-    {
-        FilterVisitor visitor;
-        FilterFunc func = visitor.visitFilter(parser.filter());
+            if (function == "count") { row.values.push_back(static_cast<double>(acc.count)); }
+            if (function == "sum") { row.values.push_back(acc.sum[i]); }
+            if (function == "avg") { row.values.push_back(acc.sum[i] / acc.count); }
+            if (function == "min") { row.values.push_back(acc.min[i]); }
+            if (function == "max") { row.values.push_back(acc.max[i]); }
+        }
 
-        return std::unique_ptr<TorrentFilter>(new PqlTorrentFilter(func));
-    }
-    catch (antlr4::ParseCancellationException const& ex)
-    {
-        BOOST_LOG_TRIVIAL(error) << "Failed to parse query: " << ex.what();
-        *error = ex.what();
-    }
-    catch (QueryException const& ex)
-    {
-        BOOST_LOG_TRIVIAL(error) << "Failed to execute query: " << ex.what();
-        *error = ex.what();
+        result.push_back(row);
     }
 
-    return nullptr;
-}
-
-bool PqlTorrentFilter::Includes(pt::BitTorrent::TorrentHandle const& torrent)
-{
-    TorrentStatus ts = torrent.Status();
-    return m_filter(ts);
+    return result;
 }
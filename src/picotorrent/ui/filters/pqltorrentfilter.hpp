@@ -2,7 +2,10 @@
 
 #include <functional>
 #include <memory>
+#include <optional>
 #include <string>
+#include <variant>
+#include <vector>
 
 #include "torrentfilter.hpp"
 
@@ -13,14 +16,63 @@ namespace pt::UI::Filters
     class PqlTorrentFilter : public TorrentFilter
     {
     public:
+        typedef std::variant<double, std::string> SortKey;
+        typedef std::function<std::optional<std::vector<uint32_t>>(TrigramIndex const&)> CandidatesFunc;
+
         static std::unique_ptr<TorrentFilter> Create(std::string const& input, std::string* error);
 
         ~PqlTorrentFilter();
         bool Includes(BitTorrent::TorrentHandle const& torrent);
+        std::optional<std::vector<uint32_t>> Candidates(TrigramIndex const& index);
+        bool HasSelection();
+        void Select(std::vector<BitTorrent::TorrentHandle*>& torrents);
+
+    private:
+        PqlTorrentFilter(
+            std::function<bool(BitTorrent::TorrentStatus const&)> const& filter,
+            CandidatesFunc const& candidates,
+            std::function<SortKey(BitTorrent::TorrentStatus const&)> const& orderBy,
+            bool descending,
+            std::optional<size_t> limit);
+
+        std::function<bool(BitTorrent::TorrentStatus const&)> m_filter;
+        CandidatesFunc m_candidates;
+        std::function<SortKey(BitTorrent::TorrentStatus const&)> m_orderBy;
+        bool m_descending;
+        std::optional<size_t> m_limit;
+    };
+
+    // aggregate queries, e.g. 'sum(size) by label' or 'count() where status = "error"'
+    class PqlAggregate
+    {
+    public:
+        struct Column
+        {
+            std::string function;
+            std::string field;
+        };
+
+        struct Row
+        {
+            std::string group;
+            std::vector<double> values;
+        };
+
+        static bool IsAggregate(std::string const& input);
+        static std::unique_ptr<PqlAggregate> Create(std::string const& input, std::string* error);
+
+        std::vector<Column> const& Columns() const { return m_columns; }
+        std::optional<std::string> const& GroupBy() const { return m_groupBy; }
+
+        std::vector<Row> Evaluate(std::vector<BitTorrent::TorrentHandle*> const& torrents);
 
     private:
-        PqlTorrentFilter(std::function<bool(BitTorrent::TorrentStatus const&)> const& filter);
+        PqlAggregate() = default;
 
+        std::vector<Column> m_columns;
         std::function<bool(BitTorrent::TorrentStatus const&)> m_filter;
+        std::optional<std::string> m_groupBy;
+        std::function<std::string(BitTorrent::TorrentStatus const&)> m_groupKey;
+        std::vector<std::function<double(BitTorrent::TorrentStatus const&)>> m_values;
     };
 }
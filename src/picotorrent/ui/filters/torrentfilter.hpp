@@ -1,5 +1,11 @@
 #pragma once
 
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "trigramindex.hpp"
+
 namespace pt::BitTorrent
 {
     class TorrentHandle;
@@ -13,5 +19,16 @@ namespace pt::UI::Filters
         virtual ~TorrentFilter() {}
 
         virtual bool Includes(BitTorrent::TorrentHandle const& torrent) = 0;
+
+        // returns the ids (in the name index) of the torrents which may be included,
+        // or nothing if every torrent has to be checked with Includes
+        virtual std::optional<std::vector<uint32_t>> Candidates(TrigramIndex const& /* index */) { return std::nullopt; }
+
+        // filters with a selection (ordering and/or limit) depend on the full set
+        // of included torrents, and the model needs to re-select on each update
+        virtual bool HasSelection() { return false; }
+
+        // orders and trims the included torrents in place
+        virtual void Select(std::vector<BitTorrent::TorrentHandle*>& /* torrents */) {}
     };
 }
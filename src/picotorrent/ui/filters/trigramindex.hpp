@@ -0,0 +1,10 @@
+#pragma once
+
+#include <libtorrent/info_hash.hpp>
+#include <trigramindex.hpp>
+
+namespace pt::UI::Filters
+{
+    // torrent names by info hash
+    typedef pt::PQL::TrigramIndex<libtorrent::info_hash_t> TrigramIndex;
+}
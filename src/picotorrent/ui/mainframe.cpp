@@ -5,6 +5,7 @@
 #include <regex>
 
 #include <boost/log/trivial.hpp>
+#include <fmt/format.h>
 #include <libtorrent/add_torrent_params.hpp>
 #include <libtorrent/magnet_uri.hpp>
 #include <libtorrent/torrent_info.hpp>
@@ -121,12 +122,24 @@ MainFrame::MainFrame(std::shared_ptr<pt::Core::Environment> env, std::shared_ptr
     }
 
     // Session events
+    this->Bind(ptEVT_MOVE_STATISTICS, [this](pt::BitTorrent::MoveStatisticsEvent& evt)
+        {
+            m_statusBar->UpdateMoveStatistics(evt.GetData());
+        });
+
     this->Bind(ptEVT_SESSION_STATISTICS, [this](pt::BitTorrent::SessionStatisticsEvent& evt)
         {
             bool dhtEnabled = m_cfg->Get<bool>("libtorrent.enable_dht").value();
             m_statusBar->UpdateDhtNodesCount(dhtEnabled ? evt.GetData().dhtNodes : -1);
         });
 
+    this->Bind(ptEVT_DISK_SPACE_LOW, [this](wxCommandEvent& evt)
+        {
+            m_taskBarIcon->ShowBalloon(
+                i18n("pause_on_low_disk_space_alert"),
+                evt.GetString());
+        });
+
     this->Bind(ptEVT_TORRENT_ADDED, [this](wxCommandEvent& evt)
         {
             m_torrentsCount++;
@@ -142,6 +155,14 @@ MainFrame::MainFrame(std::shared_ptr<pt::Core::Environment> env, std::shared_ptr
                 Utils::toStdWString(torrent->Status().name));
         });
 
+    this->Bind(ptEVT_TORRENT_CORRUPT_PIECES, [this](wxCommandEvent& evt)
+        {
+            auto torrent = static_cast<BitTorrent::TorrentHandle*>(evt.GetClientData());
+            m_taskBarIcon->ShowBalloon(
+                fmt::format(i18n("torrent_corrupt_pieces"), evt.GetInt()),
+                Utils::toStdWString(torrent->Status().name));
+        });
+
     this->Bind(ptEVT_TORRENT_REMOVED, [this](pt::BitTorrent::InfoHashEvent& evt)
         {
             m_torrentsCount--;
@@ -204,8 +225,33 @@ MainFrame::MainFrame(std::shared_ptr<pt::Core::Environment> env, std::shared_ptr
             {
                 m_torrentDetails->Refresh(selectedUpdated);
             }
+        });
+
+    // details arrive asynchronously and are only shown for a single selection
+    auto isShownInDetails = [this](wxCommandEvent& evt)
+    {
+        return m_selection.size() == 1
+            && m_selection.begin()->second == static_cast<BitTorrent::TorrentHandle*>(evt.GetClientData());
+    };
+
+    this->Bind(ptEVT_TORRENT_FILE_PROGRESS, [this, isShownInDetails](wxCommandEvent& evt)
+        {
+            if (isShownInDetails(evt)) { m_torrentDetails->UpdateFileProgress(m_selection.begin()->second); }
+        });
+
+    this->Bind(ptEVT_TORRENT_PEER_INFO, [this, isShownInDetails](wxCommandEvent& evt)
+        {
+            if (isShownInDetails(evt)) { m_torrentDetails->UpdatePeerInfo(m_selection.begin()->second); }
+        });
+
+    this->Bind(ptEVT_TORRENT_PIECE_AVAILABILITY, [this, isShownInDetails](wxCommandEvent& evt)
+        {
+            if (isShownInDetails(evt)) { m_torrentDetails->UpdatePieceAvailability(m_selection.begin()->second); }
+        });
 
-            this->CheckDiskSpace(torrents);
+    this->Bind(ptEVT_TORRENT_TRACKERS, [this, isShownInDetails](wxCommandEvent& evt)
+        {
+            if (isShownInDetails(evt)) { m_torrentDetails->UpdateTrackers(m_selection.begin()->second); }
         });
 
     this->Bind(wxEVT_DATAVIEW_ITEM_ACTIVATED, [this](wxCommandEvent&)
@@ -520,50 +566,9 @@ void MainFrame::HandleParams(pt::CommandLineOptions const& options)
     AddTorrents(params, true);
 }
 
-void MainFrame::CheckDiskSpace(std::vector<pt::BitTorrent::TorrentHandle*> const& torrents)
+pt::BitTorrent::SessionMetrics const& MainFrame::Metrics() const
 {
-    bool shouldCheck = m_cfg->Get<bool>("pause_on_low_disk_space").value();
-    int limit = m_cfg->Get<int>("pause_on_low_disk_space_limit").value();
-
-    if (!shouldCheck)
-    {
-        return;
-    }
-
-    for (auto torrent : torrents)
-    {
-        auto status = torrent->Status();
-
-        ULARGE_INTEGER freeBytesAvailableToCaller;
-        ULARGE_INTEGER totalNumberOfBytes;
-        ULARGE_INTEGER totalNumberOfFreeBytes;
-
-        BOOL res = GetDiskFreeSpaceEx(
-            Utils::toStdWString(status.savePath).c_str(),
-            &freeBytesAvailableToCaller,
-            &totalNumberOfBytes,
-            &totalNumberOfFreeBytes);
-
-        if (res)
-        {
-            float diskSpaceAvailable = static_cast<float>(freeBytesAvailableToCaller.QuadPart) / static_cast<float>(totalNumberOfBytes.QuadPart);
-            float diskSpaceLimit = limit / 100.0f;
-
-            if (diskSpaceAvailable < diskSpaceLimit)
-            {
-                BOOST_LOG_TRIVIAL(info) << "Pausing torrent "
-                    << status.infoHash << " due to disk space too low (avail: "
-                    << diskSpaceAvailable << ", limit: "
-                    << diskSpaceLimit << ")";
-
-                torrent->Pause();
-
-                m_taskBarIcon->ShowBalloon(
-                    i18n("pause_on_low_disk_space_alert"),
-                    status.name);
-            }
-        }
-    }
+    return m_session->Metrics();
 }
 
 void MainFrame::CreateFilterMenuItems()
@@ -728,7 +733,7 @@ void MainFrame::OnFileAddTorrent(wxCommandEvent&)
 
 void MainFrame::OnFileCreateTorrent(wxCommandEvent&)
 {
-    auto dlg = new Dialogs::CreateTorrentDialog(this, wxID_ANY, m_session);
+    auto dlg = new Dialogs::CreateTorrentDialog(this, wxID_ANY, m_env, m_session);
     dlg->Show();
     dlg->Bind(wxEVT_CLOSE_WINDOW,
         [dlg](wxCloseEvent&)
@@ -26,6 +26,7 @@ namespace pt
 namespace BitTorrent
 {
     class Session;
+    class SessionMetrics;
     class TorrentHandle;
 }
 namespace Core
@@ -62,12 +63,12 @@ namespace Models
         virtual ~MainFrame();
 
         void HandleParams(pt::CommandLineOptions const& options);
+        BitTorrent::SessionMetrics const& Metrics() const;
 
     private:
         wxMenuBar* CreateMainMenu();
 
         void AddTorrents(std::vector<libtorrent::add_torrent_params>& params, bool use_commandline_options);
-        void CheckDiskSpace(std::vector<BitTorrent::TorrentHandle*> const& updatedTorrents);
         void CreateFilterMenuItems();
         void CreateLabelMenuItems();
         void OnClose(wxCloseEvent&);
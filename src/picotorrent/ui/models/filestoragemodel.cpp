@@ -3,24 +3,31 @@
 #include "../../core/utils.hpp"
 #include "../translator.hpp"
 
-#include <boost/algorithm/string.hpp>
-#include <filesystem>
+#include <algorithm>
 #include <shellapi.h>
 
 #include <libtorrent/file_storage.hpp>
 #include <libtorrent/torrent_info.hpp>
-#include <wx/tokenzr.h>
 
-namespace fs = std::filesystem;
 namespace lt = libtorrent;
 using pt::UI::Models::FileStorageModel;
 
+// torrents with fewer files than this are built inline since a worker
+// thread would only make the list flicker
+static const int SyncBuildThreshold = 1000;
+
 static wxIcon FolderIcon;
 static wxIcon UnknownIcon;
 
 FileStorageModel::FileStorageModel(std::function<void(wxDataViewItemArray&, lt::download_priority_t)> const& priorityChanged)
-    : m_priorityChangedCallback(priorityChanged),
-    m_root(std::make_shared<Node>())
+    : m_i18n(std::make_unique<TranslatedStrings>(std::initializer_list<uint32_t>{
+        i18n_id("do_not_download"),
+        i18n_id("low"),
+        i18n_id("normal"),
+        i18n_id("maximum"),
+        i18n_id("state_unknown") })),
+    m_stamp(0),
+    m_priorityChangedCallback(priorityChanged)
 {
     if (!FolderIcon.IsOk())
     {
@@ -46,192 +53,450 @@ FileStorageModel::FileStorageModel(std::function<void(wxDataViewItemArray&, lt::
     }
 }
 
+FileStorageModel::~FileStorageModel()
+{
+    CancelBuild();
+}
+
 void FileStorageModel::ClearNodes()
 {
-    m_root->children.clear();
-    m_map.clear();
+    CancelBuild();
+
+    m_tree.reset();
+    m_text.clear();
+    m_children.clear();
     m_icons.clear();
+    m_pendingPriorities.clear();
+    m_pendingProgress.clear();
 }
 
 std::vector<lt::file_index_t> FileStorageModel::GetFileIndices(wxDataViewItemArray& items)
 {
     std::vector<lt::file_index_t> result;
 
-    for (auto const& item : items)
+    if (!m_tree)
     {
-        FillIndices(
-            static_cast<Node*>(item.GetID()),
-            result);
+        return result;
     }
 
-    return result;
-}
+    std::vector<bool> seen(m_tree->files.size(), false);
+    std::vector<uint32_t> stack;
 
-void FileStorageModel::FillIndices(Node* node, std::vector<lt::file_index_t>& indices)
-{
-    if (node->children.empty())
-    {
-        if (std::find(indices.begin(), indices.end(), node->index) == indices.end())
-        {
-            indices.push_back(node->index);
-        }
-    }
-    else
+    for (auto const& item : items)
     {
-        for (auto p : node->children)
+        stack.push_back(ToNode(item));
+
+        while (!stack.empty())
         {
-            FillIndices(p.second.get(), indices);
+            Node const& node = m_tree->nodes[stack.back()];
+            stack.pop_back();
+
+            if (node.index != lt::file_index_t{ -1 })
+            {
+                int idx = static_cast<int>(node.index);
+
+                if (!seen[idx])
+                {
+                    seen[idx] = true;
+                    result.push_back(node.index);
+                }
+
+                continue;
+            }
+
+            for (uint32_t c = node.firstChild; c != InvalidNode; c = m_tree->nodes[c].nextSibling)
+            {
+                stack.push_back(c);
+            }
         }
     }
+
+    return result;
 }
 
 wxDataViewItem FileStorageModel::GetRootItem()
 {
-    return wxDataViewItem(static_cast<void*>(m_root.get()));
+    return ToItem(0);
 }
 
-void FileStorageModel::RebuildTree(std::shared_ptr<const lt::torrent_info> ti)
+std::unique_ptr<FileStorageModel::Tree> FileStorageModel::BuildTree(lt::file_storage const& files, std::atomic<bool> const& cancelled)
 {
-    m_map.clear();
-    m_root->children.clear();
+    auto tree = std::make_unique<Tree>();
+    tree->nodes.reserve(static_cast<size_t>(files.num_files()) + 1);
+    tree->nodes.emplace_back();
+    tree->files.resize(files.num_files(), InvalidNode);
 
-    if (ti->num_files() == 0)
+    auto addNode = [&tree](uint32_t parent, std::string_view name)
     {
-        return;
-    }
+        uint32_t id = static_cast<uint32_t>(tree->nodes.size());
+
+        Node& node = tree->nodes.emplace_back();
+        node.parent = parent;
+        node.nameOffset = static_cast<uint32_t>(tree->names.size());
+        node.nameLength = static_cast<uint32_t>(name.size());
+        node.nextSibling = tree->nodes[parent].firstChild;
 
-    lt::file_storage const& files = ti->files();
+        tree->nodes[parent].firstChild = id;
+        tree->nodes[parent].childCount++;
+        tree->names.append(name);
+
+        return id;
+    };
+
+    // files in the same directory are almost always listed next to each
+    // other, so the last directory is checked before the lookup table
+    std::unordered_map<std::string, uint32_t> directories;
+    std::string lastDirectory;
+    uint32_t lastDirectoryNode = 0;
 
     for (lt::file_index_t idx : files.file_range())
     {
-        std::shared_ptr<Node> currentNode = m_root;
+        if (cancelled.load(std::memory_order_relaxed))
+        {
+            return nullptr;
+        }
 
-        std::vector<std::string> parts;
-        boost::split(
-            parts,
-            files.file_path(idx),
-            [](char c) { return c == '\\'; });
+        std::string const path = files.file_path(idx);
+        std::string_view directory;
 
-        if (parts.size() > 0)
+        size_t sep = path.find_last_of("\\/");
+        if (sep != std::string::npos)
         {
-            parts.pop_back();
+            directory = std::string_view(path).substr(0, sep);
         }
 
-        for (auto const& part : parts)
+        uint32_t parent = 0;
+
+        if (directory.empty())
         {
-            auto np = currentNode->children.find(part) != currentNode->children.end()
-                ? currentNode->children.at(part)
-                : nullptr;
+            parent = 0;
+        }
+        else if (directory == lastDirectory)
+        {
+            parent = lastDirectoryNode;
+        }
+        else
+        {
+            size_t start = 0;
 
-            if (!np)
+            while (start <= directory.size())
             {
-                np = std::make_shared<Node>();
-                np->name = part;
-                np->parent = currentNode;
-                np->priority = lt::default_priority;
+                size_t end = directory.find_first_of("\\/", start);
+                if (end == std::string_view::npos) { end = directory.size(); }
+
+                std::string key(directory.substr(0, end));
+                auto it = directories.find(key);
 
-                currentNode->children.insert({ np->name, np });
+                if (it == directories.end())
+                {
+                    it = directories.insert({ std::move(key), addNode(parent, directory.substr(start, end - start)) }).first;
+                }
+
+                parent = it->second;
+                start = end + 1;
             }
 
-            currentNode = np;
+            lastDirectory.assign(directory);
+            lastDirectoryNode = parent;
+        }
+
+        auto fileName = files.file_name(idx);
+        uint32_t id = addNode(parent, std::string_view(fileName.data(), fileName.size()));
+        int64_t size = files.file_size(idx);
+
+        tree->nodes[id].index = idx;
+        tree->nodes[id].size = size;
+        tree->files[static_cast<int>(idx)] = id;
+
+        for (uint32_t p = parent; p != InvalidNode; p = tree->nodes[p].parent)
+        {
+            tree->nodes[p].size += size;
         }
+    }
+
+    return tree;
+}
 
-        auto n = std::make_shared<Node>();
-        n->index = idx;
-        n->name = files.file_name(idx).to_string();
-        n->parent = currentNode;
-        n->priority = lt::default_priority;
-        n->size = files.file_size(idx);
+void FileStorageModel::CancelBuild()
+{
+    if (m_cancelled)
+    {
+        m_cancelled->store(true);
+        m_cancelled = nullptr;
+    }
 
-        currentNode->children.insert({ n->name, n });
-        m_map.insert({ idx, n });
+    if (m_builder.joinable())
+    {
+        m_builder.join();
+    }
+}
 
-        std::size_t pos = n->name.find_last_of(".");
+void FileStorageModel::InstallTree(std::unique_ptr<Tree> tree)
+{
+    m_tree = std::move(tree);
+    m_text.assign(m_tree->nodes.size(), NodeText());
+    m_children.clear();
 
-        if (pos != std::string::npos)
+    // priorities and progress that arrived while building are applied
+    // directly since the view has not seen any of these items yet
+    for (size_t i = 0; i < m_pendingPriorities.size() && i < m_tree->files.size(); i++)
+    {
+        m_tree->nodes[m_tree->files[i]].priority = m_pendingPriorities[i];
+    }
+
+    for (size_t i = 0; i < m_pendingProgress.size() && i < m_tree->files.size(); i++)
+    {
+        uint32_t id = m_tree->files[i];
+        int64_t delta = m_pendingProgress[i] - m_tree->nodes[id].done;
+
+        for (uint32_t n = id; n != InvalidNode; n = m_tree->nodes[n].parent)
         {
-            std::string extension = n->name.substr(pos);
+            m_tree->nodes[n].done += delta;
+        }
+    }
 
-            if (m_icons.find(extension) == m_icons.end())
-            {
-                SHFILEINFO shfi = { 0 };
-                SHGetFileInfo(
-                    Utils::toStdWString(extension).c_str(),
-                    FILE_ATTRIBUTE_NORMAL,
-                    &shfi,
-                    sizeof(SHFILEINFO),
-                    SHGFI_USEFILEATTRIBUTES | SHGFI_ICON | SHGFI_SMALLICON);
-
-                wxIcon icon;
-                icon.CreateFromHICON(shfi.hIcon);
-
-                m_icons.insert({ extension, icon });
-            }
+    m_pendingPriorities.clear();
+    m_pendingProgress.clear();
+
+    this->Cleared();
+}
+
+std::vector<uint32_t> const& FileStorageModel::Materialize(uint32_t parent) const
+{
+    auto it = m_children.find(parent);
+
+    if (it != m_children.end())
+    {
+        return it->second;
+    }
+
+    Node const& node = m_tree->nodes[parent];
+
+    std::vector<uint32_t> children;
+    children.reserve(node.childCount);
+
+    for (uint32_t c = node.firstChild; c != InvalidNode; c = m_tree->nodes[c].nextSibling)
+    {
+        children.push_back(c);
+    }
+
+    std::sort(
+        children.begin(),
+        children.end(),
+        [this](uint32_t lhs, uint32_t rhs)
+        {
+            return Name(m_tree->nodes[lhs]) < Name(m_tree->nodes[rhs]);
+        });
+
+    return m_children.insert({ parent, std::move(children) }).first->second;
+}
+
+std::string_view FileStorageModel::Name(Node const& node) const
+{
+    return std::string_view(m_tree->names.data() + node.nameOffset, node.nameLength);
+}
+
+long FileStorageModel::Percent(Node const& node) const
+{
+    return node.size > 0 && node.done > 0
+        ? static_cast<long>(node.done * 100 / node.size)
+        : 0;
+}
+
+bool FileStorageModel::IsVisible(uint32_t id) const
+{
+    // a row is on screen only if every directory above it is expanded
+    for (uint32_t p = m_tree->nodes[id].parent; p != 0 && p != InvalidNode; p = m_tree->nodes[p].parent)
+    {
+        if (!m_tree->nodes[p].expanded)
+        {
+            return false;
         }
     }
 
+    return true;
+}
+
+void FileStorageModel::SetExpanded(wxDataViewItem const& item, bool expanded)
+{
+    if (!m_tree || !item.IsOk())
+    {
+        return;
+    }
+
+    m_tree->nodes[ToNode(item)].expanded = expanded;
+}
+
+void FileStorageModel::RebuildTree(std::shared_ptr<const lt::torrent_info> ti, std::function<void()> const& built)
+{
+    CancelBuild();
+
+    m_tree.reset();
+    m_text.clear();
+    m_children.clear();
+    m_pendingPriorities.clear();
+    m_pendingProgress.clear();
+
     this->Cleared();
+
+    if (ti->num_files() == 0)
+    {
+        return;
+    }
+
+    if (ti->num_files() < SyncBuildThreshold)
+    {
+        std::atomic<bool> cancelled(false);
+        InstallTree(BuildTree(ti->files(), cancelled));
+
+        if (built) { built(); }
+
+        return;
+    }
+
+    auto cancelled = std::make_shared<std::atomic<bool>>(false);
+    m_cancelled = cancelled;
+
+    // keep the model alive until the result has been delivered, even if
+    // the view releases it in the meantime
+    this->IncRef();
+
+    m_builder = std::thread(
+        [this, ti, cancelled, built]()
+        {
+            std::shared_ptr<Tree> tree = BuildTree(ti->files(), *cancelled);
+
+            wxTheApp->CallAfter(
+                [this, tree, cancelled, built]()
+                {
+                    if (!cancelled->load() && tree)
+                    {
+                        m_builder.join();
+                        m_cancelled = nullptr;
+
+                        InstallTree(std::make_unique<Tree>(std::move(*tree)));
+
+                        if (built) { built(); }
+                    }
+
+                    this->DecRef();
+                });
+        });
 }
 
 void FileStorageModel::UpdatePriorities(const std::vector<libtorrent::download_priority_t>& priorities)
 {
-    for (auto& item : m_map)
+    if (!m_tree)
+    {
+        if (m_cancelled) { m_pendingPriorities = priorities; }
+        return;
+    }
+
+    for (size_t i = 0; i < m_tree->files.size(); i++)
     {
-        size_t fileIdx = static_cast<size_t>(int32_t(item.first));
-        lt::download_priority_t prio = lt::default_priority;
-        std::shared_ptr<Node> const& node = item.second;
+        uint32_t id = m_tree->files[i];
+        lt::download_priority_t prio = i < priorities.size()
+            ? priorities[i]
+            : lt::default_priority;
 
-        if (priorities.size() >= fileIdx + 1)
+        if (m_tree->nodes[id].priority == prio)
         {
-            prio = priorities.at(fileIdx);
+            continue;
         }
 
-        if (node->priority == prio)
+        m_tree->nodes[id].priority = prio;
+
+        if (!IsVisible(id))
         {
             continue;
         }
 
-        node->priority = prio;
-
         this->ValueChanged(
-            wxDataViewItem(static_cast<void*>(node.get())),
+            ToItem(id),
             Columns::Priority);
     }
 }
 
 void FileStorageModel::UpdateProgress(std::vector<int64_t> const& progress)
 {
-    for (size_t i = 0; i < progress.size(); i++)
+    if (!m_tree)
+    {
+        if (m_cancelled) { m_pendingProgress = progress; }
+        return;
+    }
+
+    // every node touched in this pass is recorded once with the percentage
+    // it showed before, so a directory whose files move in opposite
+    // directions is only compared against its final value
+    std::vector<std::pair<uint32_t, long>> touched;
+    m_stamp++;
+
+    for (size_t i = 0; i < progress.size() && i < m_tree->files.size(); i++)
     {
-        std::shared_ptr<Node> const& node = m_map.at(lt::file_index_t{ static_cast<int>(i) });
-        float calculatedProgress = .0f;
+        uint32_t id = m_tree->files[i];
+        int64_t delta = progress[i] - m_tree->nodes[id].done;
 
-        if (progress.at(i) > 0)
+        if (delta == 0)
         {
-            calculatedProgress = static_cast<float>(progress.at(i)) / node->size;
+            continue;
         }
 
-        node->progress = calculatedProgress;
+        for (uint32_t n = id; n != 0 && n != InvalidNode; n = m_tree->nodes[n].parent)
+        {
+            Node& node = m_tree->nodes[n];
+
+            if (node.stamp != m_stamp)
+            {
+                node.stamp = m_stamp;
+                touched.push_back({ n, Percent(node) });
+            }
+
+            node.done += delta;
+        }
+    }
+
+    for (auto const& [id, previous] : touched)
+    {
+        if (Percent(m_tree->nodes[id]) == previous
+            || !IsVisible(id))
+        {
+            continue;
+        }
 
         this->ValueChanged(
-            wxDataViewItem(static_cast<void*>(node.get())),
+            ToItem(id),
             Columns::Progress);
     }
 }
 
-wxIcon FileStorageModel::GetIconForFile(std::string const& fileName) const
+wxIcon FileStorageModel::GetIconForFile(std::string_view fileName) const
 {
     std::size_t pos = fileName.find_last_of(".");
-    if (pos == std::string::npos) { return UnknownIcon; }
+    if (pos == std::string_view::npos) { return UnknownIcon; }
+
+    std::string_view extension = fileName.substr(pos);
 
-    std::string extension = fileName.substr(pos);
+    auto it = m_icons.find(extension);
 
-    if (m_icons.find(extension) != m_icons.end())
+    if (it != m_icons.end())
     {
-        return m_icons.at(extension);
+        return it->second;
     }
 
-    return UnknownIcon;
+    // icons are looked up the first time a file with the extension is
+    // painted rather than for every file when the tree is built
+    SHFILEINFO shfi = { 0 };
+    SHGetFileInfo(
+        Utils::toStdWString(std::string(extension)).c_str(),
+        FILE_ATTRIBUTE_NORMAL,
+        &shfi,
+        sizeof(SHFILEINFO),
+        SHGFI_USEFILEATTRIBUTES | SHGFI_ICON | SHGFI_SMALLICON);
+
+    wxIcon icon;
+    icon.CreateFromHICON(shfi.hIcon);
+
+    return m_icons.insert({ std::string(extension), icon }).first->second;
 }
 
 unsigned int FileStorageModel::GetColumnCount() const
@@ -244,11 +509,29 @@ wxString FileStorageModel::GetColumnType(unsigned int) const
     return "string";
 }
 
+FileStorageModel::NodeText const& FileStorageModel::Text(uint32_t id) const
+{
+    NodeText& text = m_text[id];
+
+    // every node except the root has a name, so an empty one has not been formatted yet
+    if (text.name.empty())
+    {
+        Node const& node = m_tree->nodes[id];
+
+        text.name = Utils::toStdWString(std::string(Name(node)));
+        text.size = Utils::toHumanFileSize(node.size);
+    }
+
+    return text;
+}
+
 void FileStorageModel::GetValue(wxVariant &variant, const wxDataViewItem &item, unsigned int col) const
 {
     wxASSERT(item.IsOk());
 
-    Node* node = static_cast<Node*>(item.GetID());
+    Node const& node = m_tree->nodes[ToNode(item)];
+    std::string_view name = Name(node);
+    bool isFile = node.index != lt::file_index_t{ -1 };
 
     switch (col)
     {
@@ -257,49 +540,51 @@ void FileStorageModel::GetValue(wxVariant &variant, const wxDataViewItem &item,
         if (m_priorityChangedCallback)
         {
             variant << wxDataViewCheckIconText(
-                Utils::toStdWString(node->name),
-                node->children.empty()
-                ? GetIconForFile(node->name)
+                Text(ToNode(item)).name,
+                isFile
+                ? GetIconForFile(name)
                 : FolderIcon,
-                node->priority == lt::dont_download ? wxCHK_UNCHECKED : wxCHK_CHECKED);
+                node.priority == lt::dont_download ? wxCHK_UNCHECKED : wxCHK_CHECKED);
         }
         else
         {
             variant << wxDataViewIconText(
-                Utils::toStdWString(node->name),
-                node->children.empty()
-                ? GetIconForFile(node->name)
+                Text(ToNode(item)).name,
+                isFile
+                ? GetIconForFile(name)
                 : FolderIcon);
         }
 
         break;
     }
     case Columns::Size:
-        variant = Utils::toHumanFileSize(node->size);
+        variant = Text(ToNode(item)).size;
         break;
     case Columns::Progress:
-        variant = static_cast<long>(node->progress * 100);
+        variant = Percent(node);
         break;
     case Columns::Priority:
-        if (node->priority == libtorrent::dont_download)
+        m_i18n->Refresh();
+
+        if (node.priority == libtorrent::dont_download)
         {
-            variant = i18n("do_not_download");
+            variant = (*m_i18n)[0];
         }
-        else if (node->priority == libtorrent::low_priority)
+        else if (node.priority == libtorrent::low_priority)
         {
-            variant = i18n("low");
+            variant = (*m_i18n)[1];
         }
-        else if (node->priority == libtorrent::default_priority)
+        else if (node.priority == libtorrent::default_priority)
         {
-            variant = i18n("normal");
+            variant = (*m_i18n)[2];
         }
-        else if (node->priority == libtorrent::top_priority)
+        else if (node.priority == libtorrent::top_priority)
         {
-            variant = i18n("maximum");
+            variant = (*m_i18n)[3];
         }
         else
         {
-            variant = i18n("unknown");
+            variant = (*m_i18n)[4];
         }
 
         break;
@@ -310,23 +595,10 @@ bool FileStorageModel::SetValue(const wxVariant &variant, const wxDataViewItem &
 {
     wxASSERT(item.IsOk());
 
-    Node* node = static_cast<Node*>(item.GetID());
-
     switch (col)
     {
     case Columns::Name:
     {
-        std::function<void(wxDataViewItemArray&, Node*, lt::download_priority_t)> recursiveSkip = [&](auto& arr, Node* node, auto prio)
-        {
-            if (node->priority != prio)
-            {
-                node->priority = prio;
-                arr.push_back(wxDataViewItem(static_cast<void*>(node)));
-            }
-
-            for (auto const [key,n] : node->children) { recursiveSkip(arr, n.get(), prio); }
-        };
-
         wxDataViewCheckIconText checkIconText;
         checkIconText << variant;
 
@@ -335,7 +607,26 @@ bool FileStorageModel::SetValue(const wxVariant &variant, const wxDataViewItem &
             : lt::dont_download;
 
         wxDataViewItemArray changed;
-        recursiveSkip(changed, node, prio);
+        std::vector<uint32_t> stack{ ToNode(item) };
+
+        while (!stack.empty())
+        {
+            uint32_t id = stack.back();
+            stack.pop_back();
+
+            Node& node = m_tree->nodes[id];
+
+            if (node.priority != prio)
+            {
+                node.priority = prio;
+                changed.push_back(ToItem(id));
+            }
+
+            for (uint32_t c = node.firstChild; c != InvalidNode; c = m_tree->nodes[c].nextSibling)
+            {
+                stack.push_back(c);
+            }
+        }
 
         this->ItemsChanged(changed);
 
@@ -352,33 +643,38 @@ wxDataViewItem FileStorageModel::GetParent(const wxDataViewItem &item) const
 {
     wxASSERT(item.IsOk());
 
-    Node* node = static_cast<Node*>(item.GetID());
+    uint32_t parent = m_tree->nodes[ToNode(item)].parent;
 
-    return node->parent.get() == m_root.get()
+    return parent == 0 || parent == InvalidNode
         ? wxDataViewItem(0)
-        : wxDataViewItem(static_cast<void*>(node->parent.get()));
+        : ToItem(parent);
 }
 
 bool FileStorageModel::IsContainer(const wxDataViewItem &item) const
 {
     // Override this to indicate of item is a container, i.e. if it can have child items.
     if (!item.IsOk()) { return true; }
-    Node* node = static_cast<Node*>(item.GetID());
-    return !(node->children.empty());
+    if (!m_tree) { return false; }
+    return m_tree->nodes[ToNode(item)].firstChild != InvalidNode;
 }
 
 unsigned int FileStorageModel::GetChildren(const wxDataViewItem &item, wxDataViewItemArray &array) const
 {
-    Node* node = item.IsOk()
-        ? static_cast<Node*>(item.GetID()) != nullptr
-        ? static_cast<Node*>(item.GetID())
-        : m_root.get()
-        : m_root.get();
+    if (!m_tree)
+    {
+        return 0;
+    }
+
+    // children are sorted and handed out the first time a directory is
+    // expanded, so large trees only pay for what is actually shown
+    std::vector<uint32_t> const& children = Materialize(item.IsOk() ? ToNode(item) : 0);
+
+    array.Alloc(array.size() + children.size());
 
-    for (auto p : node->children)
+    for (uint32_t child : children)
     {
-        array.Add(wxDataViewItem(static_cast<void*>(p.second.get())));
+        array.Add(ToItem(child));
     }
 
-    return node->children.size();
+    return static_cast<unsigned int>(children.size());
 }
@@ -5,17 +5,27 @@
 #include <wx/wx.h>
 #endif
 
+#include <atomic>
+#include <functional>
+#include <limits>
 #include <map>
 #include <memory>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
 
 #include <libtorrent/download_priority.hpp>
 #include <libtorrent/fwd.hpp>
+#include <libtorrent/units.hpp>
 #include <wx/dataview.h>
 
 namespace pt
 {
 namespace UI
 {
+    class TranslatedStrings;
+
 namespace Models
 {
     class FileStorageModel : public wxDataViewModel
@@ -31,6 +41,7 @@ namespace Models
         };
 
         FileStorageModel(std::function<void(wxDataViewItemArray&, libtorrent::download_priority_t)> const& priorityChanged = nullptr);
+        virtual ~FileStorageModel();
 
         // Things we need to override
         unsigned int GetColumnCount() const wxOVERRIDE;
@@ -44,29 +55,79 @@ namespace Models
         void ClearNodes();
         std::vector<libtorrent::file_index_t> GetFileIndices(wxDataViewItemArray&);
         wxDataViewItem GetRootItem();
-        void RebuildTree(std::shared_ptr<const libtorrent::torrent_info> ti);
+
+        // Small torrents are built inline. Larger ones are built on a worker
+        // thread and `built` is called on the UI thread once the tree is in
+        // place. ClearNodes (or another rebuild) cancels a pending build.
+        void RebuildTree(std::shared_ptr<const libtorrent::torrent_info> ti, std::function<void()> const& built = nullptr);
+        void SetExpanded(wxDataViewItem const& item, bool expanded);
         void UpdatePriorities(const std::vector<libtorrent::download_priority_t>& priorities);
         void UpdateProgress(std::vector<int64_t> const& progress);
 
     private:
+        static constexpr uint32_t InvalidNode = std::numeric_limits<uint32_t>::max();
+
         struct Node
         {
-            std::string name;
-            int64_t size;
-            libtorrent::file_index_t index;
-            libtorrent::download_priority_t priority;
-            float progress;
-
-            std::shared_ptr<Node> parent;
-            std::map<std::string, std::shared_ptr<Node>> children;
+            uint32_t parent = InvalidNode;
+            uint32_t firstChild = InvalidNode;
+            uint32_t nextSibling = InvalidNode;
+            uint32_t childCount = 0;
+            uint32_t nameOffset = 0;
+            uint32_t nameLength = 0;
+
+            int64_t size = 0;
+            int64_t done = 0;
+            libtorrent::file_index_t index{ -1 };
+            libtorrent::download_priority_t priority = libtorrent::default_priority;
+
+            uint32_t stamp = 0;
+            bool expanded = false;
+        };
+
+        // Every node lives in one flat vector and every name in one
+        // character buffer. Node 0 is the root.
+        struct Tree
+        {
+            std::vector<Node> nodes;
+            std::vector<uint32_t> files;
+            std::string names;
         };
 
-        void FillIndices(Node* node, std::vector<libtorrent::file_index_t>& indices);
-        wxIcon GetIconForFile(std::string const& fileName) const;
+        static std::unique_ptr<Tree> BuildTree(libtorrent::file_storage const& files, std::atomic<bool> const& cancelled);
+
+        void CancelBuild();
+        void InstallTree(std::unique_ptr<Tree> tree);
+        std::vector<uint32_t> const& Materialize(uint32_t node) const;
+        std::string_view Name(Node const& node) const;
+        long Percent(Node const& node) const;
+        bool IsVisible(uint32_t node) const;
+        wxIcon GetIconForFile(std::string_view fileName) const;
+
+        static uint32_t ToNode(wxDataViewItem const& item) { return static_cast<uint32_t>(reinterpret_cast<uintptr_t>(item.GetID()) - 1); }
+        static wxDataViewItem ToItem(uint32_t node) { return wxDataViewItem(reinterpret_cast<void*>(static_cast<uintptr_t>(node) + 1)); }
+
+        // names and sizes never change for a tree, so they are formatted the
+        // first time a row is shown and kept until the tree is replaced
+        struct NodeText
+        {
+            wxString name;
+            wxString size;
+        };
+
+        NodeText const& Text(uint32_t node) const;
+
+        std::unique_ptr<Tree> m_tree;
+        mutable std::vector<NodeText> m_text;
+        mutable std::unique_ptr<TranslatedStrings> m_i18n;
+        mutable std::unordered_map<uint32_t, std::vector<uint32_t>> m_children;
+        mutable std::map<std::string, wxIcon, std::less<>> m_icons;
 
-        std::shared_ptr<Node> m_root;
-        std::map<libtorrent::file_index_t, std::shared_ptr<Node>> m_map;
-        std::map<std::string, wxIcon> m_icons;
+        std::thread m_builder;
+        std::shared_ptr<std::atomic<bool>> m_cancelled;
+        std::vector<libtorrent::download_priority_t> m_pendingPriorities;
+        std::vector<int64_t> m_pendingProgress;
+        uint32_t m_stamp;
 
         std::function<void(wxDataViewItemArray&, libtorrent::download_priority_t)> m_priorityChangedCallback;
     };
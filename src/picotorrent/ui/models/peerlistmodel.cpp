@@ -9,7 +9,16 @@
 namespace lt = libtorrent;
 using pt::UI::Models::PeerListModel;
 
+namespace
+{
+    uint32_t bit(uint32_t col)
+    {
+        return 1u << col;
+    }
+}
+
 PeerListModel::PeerListModel()
+    : m_i18n(std::make_unique<TranslatedStrings>(std::initializer_list<uint32_t>{ i18n_id("per_second_format") }))
 {
 }
 
@@ -20,53 +29,106 @@ PeerListModel::~PeerListModel()
 void PeerListModel::ResetPeers()
 {
     m_data.clear();
+    m_cache.clear();
+    m_rows.clear();
     Reset(0);
 }
 
 void PeerListModel::Update(std::vector<lt::peer_info> const& peers)
 {
-    // Remove old data
-    for (auto it = m_data.begin(); it != m_data.end();)
+    std::unordered_map<lt::tcp::endpoint, lt::peer_info const*, EndpointHash> incoming;
+    incoming.reserve(peers.size());
+
+    for (auto const& peer : peers)
     {
-        auto f = std::find_if(
-            peers.begin(),
-            peers.end(),
-            [it](lt::peer_info const& p)
-            {
-                return p.ip == it->ip;
-            });
+        incoming.insert({ peer.ip, &peer });
+    }
+
+    // Remove old data - compact the rows in a single pass and keep the
+    // relative order, so each peer keeps its place in the list
+    wxArrayInt removed;
+    size_t write = 0;
 
-        if (f == peers.end())
+    m_rows.clear();
+
+    for (size_t read = 0; read < m_data.size(); read++)
+    {
+        if (incoming.find(m_data[read].ip) == incoming.end())
         {
-            it = m_data.erase(it);
-            RowDeleted(std::distance(m_data.begin(), it));
+            removed.Add(static_cast<int>(read));
+            continue;
         }
-        else
+
+        if (write != read)
         {
-            ++it;
+            m_data[write] = std::move(m_data[read]);
+            m_cache[write] = std::move(m_cache[read]);
         }
+
+        m_rows.insert({ m_data[write].ip, write });
+        write++;
     }
 
-    // Add or update new data
+    m_data.resize(write);
+    m_cache.resize(write);
 
-    for (auto it = peers.begin(); it != peers.end(); it++)
+    if (!removed.IsEmpty())
     {
-        auto f = std::find_if(m_data.begin(), m_data.end(), [it](lt::peer_info& p) { return p.ip == it->ip; });
+        RowsDeleted(removed);
+    }
+
+    // Add or update new data
+    for (auto const& peer : peers)
+    {
+        auto row = m_rows.find(peer.ip);
 
-        if (f == m_data.end())
+        if (row == m_rows.end())
         {
-            m_data.push_back(*it);
+            m_rows.insert({ peer.ip, m_data.size() });
+            m_data.push_back(peer);
+            m_cache.push_back(RowCache());
+            m_cache.back().valid = 0;
             RowAppended();
+            continue;
         }
-        else
+
+        // only touch the fields we show, and only notify if any of them changed
+        lt::peer_info& existing = m_data[row->second];
+        uint32_t changed = 0;
+
+        if (existing.client != peer.client) { existing.client = peer.client; changed |= bit(Column::Client); }
+        if (existing.flags != peer.flags) { existing.flags = peer.flags; changed |= bit(Column::Flags); }
+        if (existing.source != peer.source) { existing.source = peer.source; changed |= bit(Column::Flags); }
+        if (existing.payload_down_speed != peer.payload_down_speed) { existing.payload_down_speed = peer.payload_down_speed; changed |= bit(Column::DownloadRate); }
+        if (existing.payload_up_speed != peer.payload_up_speed) { existing.payload_up_speed = peer.payload_up_speed; changed |= bit(Column::UploadRate); }
+        if (existing.progress != peer.progress) { existing.progress = peer.progress; changed |= bit(Column::Progress); }
+
+        if (changed != 0)
         {
-            auto distance = std::distance(m_data.begin(), f);
-            m_data.at(distance) = *it;
-            RowChanged(distance);
+            m_cache[row->second].valid &= ~changed;
+            RowChanged(static_cast<unsigned int>(row->second));
         }
     }
 }
 
+size_t PeerListModel::EndpointHash::operator()(lt::tcp::endpoint const& ep) const
+{
+    size_t hash = std::hash<unsigned short>()(ep.port());
+    auto const& address = ep.address();
+
+    if (address.is_v4())
+    {
+        return hash ^ (std::hash<unsigned long>()(address.to_v4().to_ulong()) << 1);
+    }
+
+    for (auto b : address.to_v6().to_bytes())
+    {
+        hash = hash * 31 + b;
+    }
+
+    return hash;
+}
+
 unsigned int PeerListModel::GetColumnCount() const
 {
     return Column::_Max;
@@ -81,14 +143,40 @@ void PeerListModel::GetValueByRow(wxVariant &variant, unsigned int row, unsigned
 {
     lt::peer_info const& peer = m_data.at(row);
 
+    if (col == Column::Progress)
+    {
+        variant = static_cast<long>(peer.progress * 100);
+        return;
+    }
+
+    // the rate columns are formatted with a translated string
+    if (m_i18n->Refresh())
+    {
+        for (auto& cache : m_cache)
+        {
+            cache.valid = 0;
+        }
+    }
+
+    RowCache& cache = m_cache.at(row);
+
+    if ((cache.valid & bit(col)) == 0)
+    {
+        cache.cells[col] = FormatCell(peer, col);
+        cache.valid |= bit(col);
+    }
+
+    variant = cache.cells[col];
+}
+
+wxString PeerListModel::FormatCell(lt::peer_info const& peer, unsigned int col) const
+{
     switch (col)
     {
     case Column::IP:
-        variant = peer.ip.address().to_string();
-        break;
+        return peer.ip.address().to_string();
     case Column::Client:
-        variant = wxString::FromUTF8(peer.client);
-        break;
+        return wxString::FromUTF8(peer.client);
     case Column::Flags:
     {
         std::stringstream flags;
@@ -172,46 +260,33 @@ void PeerListModel::GetValueByRow(wxVariant &variant, unsigned int row, unsigned
             flags << "L ";
         }
 
-        variant = flags.str();
-
-        break;
+        return flags.str();
     }
     case Column::DownloadRate:
     {
         if (peer.payload_down_speed <= 0)
         {
-            variant = "-";
-        }
-        else
-        {
-            variant = fmt::format(
-                i18n("per_second_format"),
-                Utils::toHumanFileSize(peer.payload_down_speed));
+            return "-";
         }
 
-        break;
+        return fmt::format(
+            (*m_i18n)[0],
+            Utils::toHumanFileSize(peer.payload_down_speed));
     }
     case Column::UploadRate:
     {
         if (peer.payload_up_speed <= 0)
         {
-            variant = "-";
-        }
-        else
-        {
-            variant = fmt::format(
-                i18n("per_second_format"),
-                Utils::toHumanFileSize(peer.payload_up_speed));
+            return "-";
         }
 
-        break;
-    }
-    case Column::Progress:
-    {
-        variant = static_cast<long>(peer.progress * 100);
-        break;
+        return fmt::format(
+            (*m_i18n)[0],
+            Utils::toHumanFileSize(peer.payload_up_speed));
     }
     }
+
+    return wxEmptyString;
 }
 
 bool PeerListModel::SetValueByRow(const wxVariant&, unsigned int, unsigned int)
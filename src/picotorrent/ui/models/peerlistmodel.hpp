@@ -6,14 +6,20 @@
 #endif
 
 #include <libtorrent/fwd.hpp>
+#include <libtorrent/socket.hpp>
 #include <wx/dataview.h>
 
+#include <array>
+#include <memory>
+#include <unordered_map>
 #include <vector>
 
 namespace pt
 {
 namespace UI
 {
+    class TranslatedStrings;
+
 namespace Models
 {
     class PeerListModel : public wxDataViewVirtualListModel
@@ -42,7 +48,23 @@ namespace Models
         void GetValueByRow(wxVariant &variant, unsigned row, unsigned col) const wxOVERRIDE;
         bool SetValueByRow(const wxVariant &variant, unsigned row, unsigned col) wxOVERRIDE;
 
+        struct EndpointHash
+        {
+            size_t operator()(libtorrent::tcp::endpoint const& ep) const;
+        };
+
+        struct RowCache
+        {
+            std::array<wxString, Column::_Max> cells;
+            uint32_t valid;
+        };
+
+        wxString FormatCell(libtorrent::peer_info const& peer, unsigned int col) const;
+
         std::vector<libtorrent::peer_info> m_data;
+        mutable std::vector<RowCache> m_cache;
+        mutable std::unique_ptr<TranslatedStrings> m_i18n;
+        std::unordered_map<libtorrent::tcp::endpoint, size_t, EndpointHash> m_rows;
     };
 }
 }
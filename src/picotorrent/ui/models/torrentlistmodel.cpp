@@ -1,5 +1,7 @@
 #include "torrentlistmodel.hpp"
 
+#include <set>
+
 #include <boost/log/trivial.hpp>
 #include <fmt/format.h>
 
@@ -7,15 +9,66 @@
 #include "../../bittorrent/torrentstatus.hpp"
 #include "../../core/utils.hpp"
 #include "../filters/torrentfilter.hpp"
+#include "../filters/trigramindex.hpp"
 #include "../translator.hpp"
 
 using pt::BitTorrent::TorrentHandle;
 using pt::BitTorrent::TorrentStatus;
 using pt::UI::Models::TorrentListModel;
 
+namespace
+{
+    // indices into the interned strings, in the same order as the keys
+    // passed to TranslatedStrings in the constructor
+    enum Strings
+    {
+        StateDownloadingChecking,
+        StateCheckingResumeData,
+        StateDownloading,
+        StateDownloadingMetadata,
+        StateDownloadingPaused,
+        StateDownloadingQueued,
+        StateError,
+        StateErrorDetails,
+        StateUnknown,
+        StateUploading,
+        StateUploadingPaused,
+        StateUploadingQueued,
+        EtaS,
+        EtaMS,
+        EtaHMS,
+        PerSecond,
+        DOfD
+    };
+
+    uint32_t bit(uint32_t col)
+    {
+        return 1u << col;
+    }
+}
+
 TorrentListModel::TorrentListModel()
-    : m_filter(nullptr),
-    m_filterLabelId(-1)
+    : m_filterLabelId(-1),
+    m_filter(nullptr),
+    m_nameIndex(std::make_unique<Filters::TrigramIndex>()),
+    m_i18n(std::make_unique<TranslatedStrings>(std::initializer_list<uint32_t>{
+        i18n_id("state_downloading_checking"),
+        i18n_id("state_checking_resume_data"),
+        i18n_id("state_downloading"),
+        i18n_id("state_downloading_metadata"),
+        i18n_id("state_downloading_paused"),
+        i18n_id("state_downloading_queued"),
+        i18n_id("state_error"),
+        i18n_id("state_error_details"),
+        i18n_id("state_unknown"),
+        i18n_id("state_uploading"),
+        i18n_id("state_uploading_paused"),
+        i18n_id("state_uploading_queued"),
+        i18n_id("eta_s_format"),
+        i18n_id("eta_ms_format"),
+        i18n_id("eta_hms_format"),
+        i18n_id("per_second_format"),
+        i18n_id("d_of_d") }))
 {
 }
 
@@ -26,7 +79,8 @@ TorrentListModel::~TorrentListModel()
 void TorrentListModel::AddTorrent(pt::BitTorrent::TorrentHandle* torrent)
 {
     m_torrents.insert({ torrent->InfoHash(), torrent });
-    ApplyFilter();
+    m_nameIndex->Insert(torrent->InfoHash(), torrent->Status().name);
+    ApplyFilter({ torrent });
 }
 
 void TorrentListModel::ClearFilter()
@@ -69,9 +123,24 @@ TorrentHandle* TorrentListModel::GetTorrentFromItem(wxDataViewItem const& item)
     return m_torrents.at(hash);
 }
 
+std::vector<TorrentHandle*> TorrentListModel::GetTorrents()
+{
+    std::vector<TorrentHandle*> torrents;
+    torrents.reserve(m_torrents.size());
+
+    for (auto const& [hash, torrent] : m_torrents)
+    {
+        torrents.push_back(torrent);
+    }
+
+    return torrents;
+}
+
 void TorrentListModel::RemoveTorrent(lt::info_hash_t const& hash)
 {
     m_torrents.erase(hash);
+    m_cache.erase(hash);
+    m_nameIndex->Remove(hash);
 
     auto iter = std::find(
         m_filtered.begin(),
@@ -84,10 +153,23 @@ void TorrentListModel::RemoveTorrent(lt::info_hash_t const& hash)
         m_filtered.erase(iter);
         RowDeleted(dist);
     }
+
+    // a removed torrent may leave room for another one in the selection
+    if (m_filter && m_filter->HasSelection())
+    {
+        ApplySelection({});
+    }
 }
 
 void TorrentListModel::UpdateTorrents(std::vector<TorrentHandle*> torrents)
 {
+    // keep the name index in sync, names change when metadata is received or the torrent is renamed
+    for (auto torrent : torrents)
+    {
+        m_nameIndex->Update(torrent->InfoHash(), torrent->Status().name);
+        Invalidate(torrent);
+    }
+
     ApplyFilter(torrents);
 }
 
@@ -251,7 +333,7 @@ bool TorrentListModel::GetAttrByRow(unsigned int row, unsigned int col, wxDataVi
     {
     case Columns::Status:
     {
-        BitTorrent::TorrentStatus  status = torrent->Status();
+        BitTorrent::TorrentStatus const& status = torrent->Status();
 
         if (status.state == TorrentStatus::State::Error)
         {
@@ -294,33 +376,91 @@ void TorrentListModel::GetValueByRow(wxVariant& variant, uint32_t row, uint32_t
     }
 
     BitTorrent::TorrentHandle* torrent = findTorrent->second;
-    BitTorrent::TorrentStatus  status = torrent->Status();
+    BitTorrent::TorrentStatus const& status = torrent->Status();
+
+    switch (col)
+    {
+    case Columns::Progress:
+    {
+        variant = static_cast<long>(status.progress * 100);
+        return;
+    }
+    case Columns::Label:
+    {
+        auto lbl = m_labelsNames.find(torrent->Label());
+
+        if (torrent->Label() < 0 || lbl == m_labelsNames.end())
+        {
+            variant << wxDataViewIconText("-");
+            return;
+        }
+
+        wxIcon ic = wxNullIcon;
+        auto labelIcon = m_labelsIcons.find(torrent->Label());
+
+        if (labelIcon != m_labelsIcons.end())
+        {
+            ic = labelIcon->second;
+        }
+
+        variant << wxDataViewIconText(lbl->second, ic);
+
+        return;
+    }
+    }
+
+    // a new locale means every cached cell may be in the wrong language
+    if (m_i18n->Refresh())
+    {
+        for (auto& [_, cache] : m_cache)
+        {
+            cache.valid = 0;
+        }
+    }
+
+    auto cache = m_cache.find(hash);
+
+    if (cache == m_cache.end())
+    {
+        cache = m_cache.insert({ hash, RowCache() }).first;
+        cache->second.valid = 0;
+        UpdateSource(cache->second.source, status);
+    }
+
+    if ((cache->second.valid & bit(col)) == 0)
+    {
+        cache->second.cells[col] = FormatCell(status, col);
+        cache->second.valid |= bit(col);
+    }
+
+    variant = cache->second.cells[col];
+}
+
+wxString TorrentListModel::FormatCell(BitTorrent::TorrentStatus const& status, uint32_t col) const
+{
+    TranslatedStrings const& tr = *m_i18n;
 
     switch (col)
     {
     case Columns::Name:
     {
-        variant = Utils::toStdWString(status.name);
-        break;
+        return Utils::toStdWString(status.name);
     }
     case Columns::QueuePosition:
     {
-        variant = status.queuePosition < 0
+        return status.queuePosition < 0
             ? "-"
             : std::to_string(status.queuePosition + 1);
-        break;
     }
     case Columns::Size:
     {
-        variant = Utils::toHumanFileSize(status.totalWanted);
-        break;
+        return Utils::toHumanFileSize(status.totalWanted);
     }
     case Columns::SizeRemaining:
     {
-        variant = status.totalWantedRemaining <= 0
+        return status.totalWantedRemaining <= 0
             ? L"-"
             : Utils::toHumanFileSize(status.totalWantedRemaining);
-        break;
     }
     case Columns::Status:
     {
@@ -328,80 +468,56 @@ void TorrentListModel::GetValueByRow(wxVariant& variant, uint32_t row, uint32_t
         {
         case TorrentStatus::State::CheckingFiles:
         case TorrentStatus::State::DownloadingChecking:
-            variant = i18n("state_downloading_checking");
-            break;
+            return tr[Strings::StateDownloadingChecking];
 
         case TorrentStatus::State::CheckingResumeData:
-            variant = i18n("state_checking_resume_data");
-            break;
+            return tr[Strings::StateCheckingResumeData];
 
         case TorrentStatus::State::Downloading:
-            variant = i18n("state_downloading");
-            break;
+            return tr[Strings::StateDownloading];
 
         case TorrentStatus::State::DownloadingMetadata:
-            variant = i18n("state_downloading_metadata");
-            break;
+            return tr[Strings::StateDownloadingMetadata];
 
         case TorrentStatus::State::DownloadingPaused:
-            variant = i18n("state_downloading_paused");
-            break;
+            return tr[Strings::StateDownloadingPaused];
 
         case TorrentStatus::State::DownloadingQueued:
-            variant = i18n("state_downloading_queued");
-            break;
+            return tr[Strings::StateDownloadingQueued];
 
         case TorrentStatus::State::Error:
             if (status.errorDetails.empty())
             {
-                variant = fmt::format(
-                    i18n("state_error"),
+                return fmt::format(
+                    tr[Strings::StateError],
                     Utils::toStdWString(status.error).c_str());
             }
-            else
-            {
-                variant = fmt::format(
-                    i18n("state_error_details"),
-                    Utils::toStdWString(status.error).c_str(),
-                    Utils::toStdWString(status.errorDetails).c_str());
-            }
 
-            break;
+            return fmt::format(
+                tr[Strings::StateErrorDetails],
+                Utils::toStdWString(status.error).c_str(),
+                Utils::toStdWString(status.errorDetails).c_str());
 
         case TorrentStatus::State::Unknown:
-            variant = i18n("state_unknown");
-            break;
+            return tr[Strings::StateUnknown];
 
         case TorrentStatus::State::Uploading:
-            variant = i18n("state_uploading");
-            break;
+            return tr[Strings::StateUploading];
 
         case TorrentStatus::State::UploadingPaused:
-            variant = i18n("state_uploading_paused");
-            break;
+            return tr[Strings::StateUploadingPaused];
 
         case TorrentStatus::State::UploadingQueued:
-            variant = i18n("state_uploading_queued");
-            break;
-        default:
-            variant = "-";
-            break;
+            return tr[Strings::StateUploadingQueued];
         }
 
-        break;
-    }
-    case Columns::Progress:
-    {
-        variant = static_cast<long>(status.progress * 100);
-        break;
+        return "-";
     }
     case Columns::ETA:
     {
-        variant = "-";
-
         if (status.paused || status.eta.count() <= 0)
         {
-            break;
+            return "-";
         }
 
         std::chrono::hours hours_left = std::chrono::duration_cast<std::chrono::hours>(status.eta);
@@ -412,140 +528,153 @@ void TorrentListModel::GetValueByRow(wxVariant& variant, uint32_t row, uint32_t
         {
             if (min_left.count() <= 0)
             {
-                variant = fmt::format(i18n("eta_s_format"), sec_left.count());
-                break;
+                return fmt::format(tr[Strings::EtaS], sec_left.count());
             }
 
-            variant = fmt::format(i18n("eta_ms_format"), min_left.count(), sec_left.count());
-            break;
+            return fmt::format(tr[Strings::EtaMS], min_left.count(), sec_left.count());
         }
 
-        variant = fmt::format(
-            i18n("eta_hms_format"),
+        return fmt::format(
+            tr[Strings::EtaHMS],
             hours_left.count(),
             min_left.count(),
             sec_left.count());
-
-        break;
     }
     case Columns::DownloadSpeed:
     {
-        variant = "-";
-
         if (status.paused || status.state == TorrentStatus::Uploading || status.downloadPayloadRate == 0)
         {
-            break;
+            return "-";
         }
 
-        variant = fmt::format(
-            i18n("per_second_format"),
+        return fmt::format(
+            tr[Strings::PerSecond],
             Utils::toHumanFileSize(status.downloadPayloadRate));
-
-        break;
     }
     case Columns::UploadSpeed:
     {
-        variant = "-";
-
         if (status.paused || status.uploadPayloadRate == 0)
         {
-            break;
+            return "-";
         }
 
-        variant = fmt::format(
-            i18n("per_second_format"),
+        return fmt::format(
+            tr[Strings::PerSecond],
             Utils::toHumanFileSize(status.uploadPayloadRate));
-
-        break;
     }
     case Columns::Availability:
     {
-        variant = "-";
-
         if (status.paused || status.availability < 0)
         {
-            break;
+            return "-";
         }
 
-        variant = fmt::format("{:.3f}", status.availability);
-
-        break;
+        return fmt::format("{:.3f}", status.availability);
     }
     case Columns::Ratio:
     {
-        variant = fmt::format("{:.3f}", status.ratio);
-        break;
+        return fmt::format("{:.3f}", status.ratio);
     }
     case Columns::Seeds:
     {
-        variant = "-";
-
         if (status.paused)
         {
-            break;
+            return "-";
         }
 
-        variant = fmt::format(
-            i18n("d_of_d"),
+        return fmt::format(
+            tr[Strings::DOfD],
             status.seedsCurrent,
             status.seedsTotal);
-
-        break;
     }
     case Columns::Peers:
     {
-        variant = "-";
-
         if (status.paused)
         {
-            break;
+            return "-";
         }
 
-        variant = fmt::format(
-            i18n("d_of_d"),
+        return fmt::format(
+            tr[Strings::DOfD],
             status.peersCurrent,
             status.peersTotal);
-
-        break;
     }
     case Columns::AddedOn:
     {
-        variant = wxDateTime(status.addedOn).FormatISOCombined(' ');
-        break;
+        return wxDateTime(status.addedOn).FormatISOCombined(' ');
     }
     case Columns::CompletedOn:
     {
-        variant = status.completedOn.IsValid()
+        return status.completedOn.IsValid()
             ? wxDateTime(status.completedOn).FormatISOCombined(' ')
             : "-";
-
-        break;
     }
-    case Columns::Label:
+    }
+
+    return wxEmptyString;
+}
+
+void TorrentListModel::Invalidate(BitTorrent::TorrentHandle* torrent)
+{
+    auto cache = m_cache.find(torrent->InfoHash());
+
+    // rows which have never been shown have nothing to invalidate
+    if (cache == m_cache.end())
     {
-        auto lbl = m_labels.find(torrent->Label());
+        return;
+    }
 
-        if (torrent->Label() < 0 || lbl == m_labels.end())
-        {
-            variant << wxDataViewIconText("-");
-            break;
-        }
+    cache->second.valid &= ~UpdateSource(cache->second.source, torrent->Status());
+}
 
-        wxIcon ic = wxNullIcon;
-        auto [name, _] = lbl->second;
-        auto labelIcon = m_labelsIcons.find(torrent->Label());
+uint32_t TorrentListModel::UpdateSource(RowSource& source, BitTorrent::TorrentStatus const& status)
+{
+    uint32_t changed = 0;
 
-        if (labelIcon != m_labelsIcons.end())
+    auto update = [&changed](auto& field, auto const& value, uint32_t columns)
+    {
+        if (field != value)
         {
-            ic = labelIcon->second;
+            field = value;
+            changed |= columns;
         }
+    };
 
-        variant << wxDataViewIconText(
-            Utils::toStdWString(name), ic);
+    // paused hides the transfer related columns
+    uint32_t pausedColumns = bit(Columns::ETA)
+        | bit(Columns::DownloadSpeed)
+        | bit(Columns::UploadSpeed)
+        | bit(Columns::Availability)
+        | bit(Columns::Seeds)
+        | bit(Columns::Peers);
+
+    update(source.name, status.name, bit(Columns::Name));
+    update(source.queuePosition, status.queuePosition, bit(Columns::QueuePosition));
+    update(source.totalWanted, status.totalWanted, bit(Columns::Size));
+    update(source.totalWantedRemaining, status.totalWantedRemaining, bit(Columns::SizeRemaining));
+    update(source.state, static_cast<int>(status.state), bit(Columns::Status) | bit(Columns::DownloadSpeed));
+    update(source.error, status.error, bit(Columns::Status));
+    update(source.errorDetails, status.errorDetails, bit(Columns::Status));
+    update(source.eta, status.eta, bit(Columns::ETA));
+    update(source.paused, status.paused, pausedColumns);
+    update(source.downloadPayloadRate, status.downloadPayloadRate, bit(Columns::DownloadSpeed));
+    update(source.uploadPayloadRate, status.uploadPayloadRate, bit(Columns::UploadSpeed));
+    update(source.availability, status.availability, bit(Columns::Availability));
+    update(source.ratio, status.ratio, bit(Columns::Ratio));
+    update(source.seedsCurrent, status.seedsCurrent, bit(Columns::Seeds));
+    update(source.seedsTotal, status.seedsTotal, bit(Columns::Seeds));
+    update(source.peersCurrent, status.peersCurrent, bit(Columns::Peers));
+    update(source.peersTotal, status.peersTotal, bit(Columns::Peers));
+    // invalid dates cannot be compared, so compare their raw values instead
+    auto ticks = [](wxDateTime const& dt)
+    {
+        return dt.IsValid() ? dt.GetValue() : wxLongLong(-1);
+    };
 
-        break;
-    }
-    }
+    update(source.addedOn, ticks(status.addedOn), bit(Columns::AddedOn));
+    update(source.completedOn, ticks(status.completedOn), bit(Columns::CompletedOn));
+
+    return changed;
 }
 
 void TorrentListModel::UpdateLabels(std::map<int, std::tuple<std::string, std::string>> const& labels, int size)
@@ -592,11 +721,14 @@ void TorrentListModel::UpdateLabels(std::map<int, std::tuple<std::string, std::s
     m_labels = labels;
     m_labelsColors.clear();
     m_labelsIcons.clear();
+    m_labelsNames.clear();
 
     for (auto const& [id, nv] : m_labels)
     {
         auto [name, color] = nv;
 
+        m_labelsNames.insert({ id, Utils::toStdWString(name) });
+
         if (color.empty()) { continue; }
 
         m_labelsColors.insert({ id, wxColor(color) });
@@ -634,35 +766,44 @@ void TorrentListModel::UpdateLabels(std::map<int, std::tuple<std::string, std::s
 void TorrentListModel::ApplyFilter()
 {
     std::vector<TorrentHandle*> filter;
-    for (auto const& [hash, torrent] : m_torrents)
-    {
-        filter.push_back(torrent);
-    }
-    ApplyFilter(filter);
-}
+    auto candidates = FindCandidates();
 
-void TorrentListModel::ApplyFilter(std::vector<pt::BitTorrent::TorrentHandle*> torrents)
-{
-    const std::function<bool(TorrentHandle*)> show = [this](TorrentHandle* torrent)
+    if (candidates.has_value())
     {
-        // if both label id and filter function is set - this function must check that
-        // the torrent both has the label and is included in the filter function
-        // otherwise, check each
-        if (m_filter && m_filterLabelId > 0)
+        // only check the torrents the index matched, and the ones currently
+        // shown since they may need to be removed
+        std::set<lt::info_hash_t> hashes(m_filtered.begin(), m_filtered.end());
+
+        for (uint32_t id : candidates.value())
         {
-            return m_filter->Includes(*torrent) && torrent->Label() == m_filterLabelId;
+            hashes.insert(m_nameIndex->Key(id));
         }
-        else if (m_filter)
+
+        for (auto const& hash : hashes)
         {
-            return m_filter->Includes(*torrent);
+            filter.push_back(m_torrents.at(hash));
         }
-        else if (m_filterLabelId > 0)
+    }
+    else
+    {
+        for (auto const& [hash, torrent] : m_torrents)
         {
-            return torrent->Label() == m_filterLabelId;
+            filter.push_back(torrent);
         }
+    }
 
-        return true;
-    };
+    ApplyFilter(filter);
+}
+
+void TorrentListModel::ApplyFilter(std::vector<pt::BitTorrent::TorrentHandle*> torrents)
+{
+    if (m_filter && m_filter->HasSelection())
+    {
+        ApplySelection(torrents);
+        return;
+    }
+
+    auto candidates = FindCandidates();
 
     for (auto torrent : torrents)
     {
@@ -679,7 +820,7 @@ void TorrentListModel::ApplyFilter(std::vector<pt::BitTorrent::TorrentHandle*> t
         if (iter == m_filtered.end())
         {
             // but we want to show it according to the filters
-            if (show(torrent))
+            if (IsVisible(torrent, candidates))
             {
                 // so show it
                 m_filtered.push_back(torrent->InfoHash());
@@ -690,7 +831,7 @@ void TorrentListModel::ApplyFilter(std::vector<pt::BitTorrent::TorrentHandle*> t
         else
         {
             // but we don't want to show it
-            if (!show(torrent))
+            if (!IsVisible(torrent, candidates))
             {
                 // so delete it
                 m_filtered.erase(iter);
@@ -705,3 +846,113 @@ void TorrentListModel::ApplyFilter(std::vector<pt::BitTorrent::TorrentHandle*> t
         }
     }
 }
+
+void TorrentListModel::ApplySelection(std::vector<pt::BitTorrent::TorrentHandle*> const& updated)
+{
+    // the selection (ordering and limit) depends on every included torrent,
+    // so run the filter over all of them and let it pick the top rows
+    std::vector<TorrentHandle*> selected;
+    auto candidates = FindCandidates();
+
+    if (candidates.has_value())
+    {
+        for (uint32_t id : candidates.value())
+        {
+            auto torrent = m_torrents.at(m_nameIndex->Key(id));
+
+            if (IsVisible(torrent, std::nullopt))
+            {
+                selected.push_back(torrent);
+            }
+        }
+    }
+    else
+    {
+        for (auto const& [hash, torrent] : m_torrents)
+        {
+            if (IsVisible(torrent, std::nullopt))
+            {
+                selected.push_back(torrent);
+            }
+        }
+    }
+
+    m_filter->Select(selected);
+
+    std::set<lt::info_hash_t> changed;
+
+    for (auto torrent : updated)
+    {
+        changed.insert(torrent->InfoHash());
+    }
+
+    // diff the new selection against the current rows in rank order, only
+    // notifying the view about rows which actually changed
+    size_t common = std::min(selected.size(), m_filtered.size());
+
+    for (size_t i = 0; i < common; i++)
+    {
+        auto hash = selected[i]->InfoHash();
+
+        if (m_filtered[i] != hash || changed.count(hash) > 0)
+        {
+            m_filtered[i] = hash;
+            RowChanged(static_cast<unsigned int>(i));
+        }
+    }
+
+    for (size_t i = common; i < selected.size(); i++)
+    {
+        m_filtered.push_back(selected[i]->InfoHash());
+        RowAppended();
+    }
+
+    while (m_filtered.size() > selected.size())
+    {
+        m_filtered.pop_back();
+        RowDeleted(static_cast<unsigned int>(m_filtered.size()));
+    }
+}
+
+std::optional<std::vector<uint32_t>> TorrentListModel::FindCandidates()
+{
+    if (!m_filter)
+    {
+        return std::nullopt;
+    }
+
+    return m_filter->Candidates(*m_nameIndex);
+}
+
+bool TorrentListModel::IsVisible(pt::BitTorrent::TorrentHandle* torrent, std::optional<std::vector<uint32_t>> const& candidates)
+{
+    // torrents the name index ruled out cannot match the filter
+    if (candidates.has_value())
+    {
+        auto id = m_nameIndex->Find(torrent->InfoHash());
+
+        if (!id.has_value()
+            || !std::binary_search(candidates->begin(), candidates->end(), id.value()))
+        {
+            return false;
+        }
+    }
+
+    // if both label id and filter function is set - this function must check that
+    // the torrent both has the label and is included in the filter function
+    // otherwise, check each
+    if (m_filter && m_filterLabelId > 0)
+    {
+        return m_filter->Includes(*torrent) && torrent->Label() == m_filterLabelId;
+    }
+    else if (m_filter)
+    {
+        return m_filter->Includes(*torrent);
+    }
+    else if (m_filterLabelId > 0)
+    {
+        return torrent->Label() == m_filterLabelId;
+    }
+
+    return true;
+}
@@ -5,20 +5,31 @@
 #include <wx/wx.h>
 #endif
 
+#include <array>
+#include <chrono>
+#include <cstdint>
 #include <map>
 #include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 
 #include <libtorrent/info_hash.hpp>
 #include <wx/dataview.h>
 
+#include "../filters/trigramindex.hpp"
+
 namespace pt::BitTorrent
 {
     class TorrentHandle;
     struct TorrentStatus;
 }
 
+namespace pt::UI
+{
+    class TranslatedStrings;
+}
+
 namespace pt::UI::Filters
 {
     class TorrentFilter;
@@ -56,6 +67,7 @@ namespace pt::UI::Models
         void AddTorrent(BitTorrent::TorrentHandle* torrent);
         int GetRowIndex(BitTorrent::TorrentHandle* torrent);
         BitTorrent::TorrentHandle* GetTorrentFromItem(wxDataViewItem const& item);
+        std::vector<BitTorrent::TorrentHandle*> GetTorrents();
         void RemoveTorrent(libtorrent::info_hash_t const& hash);
         void UpdateTorrents(std::vector<BitTorrent::TorrentHandle*> torrents);
         void SetBackgroundColorEnabled(bool enabled);
@@ -82,16 +94,61 @@ namespace pt::UI::Models
         void UpdateLabels(std::map<int, std::tuple<std::string, std::string>> const& labels, int size);
 
     private:
+        // the values a row was last formatted from, compared against each
+        // new status to find out which cells need to be formatted again
+        struct RowSource
+        {
+            std::string name;
+            int queuePosition;
+            std::int64_t totalWanted;
+            std::int64_t totalWantedRemaining;
+            int state;
+            std::string error;
+            std::string errorDetails;
+            std::chrono::seconds eta;
+            bool paused;
+            int downloadPayloadRate;
+            int uploadPayloadRate;
+            float availability;
+            float ratio;
+            int seedsCurrent;
+            int seedsTotal;
+            int peersCurrent;
+            int peersTotal;
+            wxLongLong addedOn;
+            wxLongLong completedOn;
+        };
+
+        struct RowCache
+        {
+            std::array<wxString, Columns::_Max> cells;
+            uint32_t valid;
+            RowSource source;
+        };
+
+        static uint32_t UpdateSource(RowSource& source, BitTorrent::TorrentStatus const& status);
+
+        wxString FormatCell(BitTorrent::TorrentStatus const& status, uint32_t col) const;
+        void Invalidate(BitTorrent::TorrentHandle* torrent);
+
         void ApplyFilter();
         void ApplyFilter(std::vector<BitTorrent::TorrentHandle*> torrents);
+        void ApplySelection(std::vector<BitTorrent::TorrentHandle*> const& updated);
+        std::optional<std::vector<uint32_t>> FindCandidates();
+        bool IsVisible(BitTorrent::TorrentHandle* torrent, std::optional<std::vector<uint32_t>> const& candidates);
 
         bool m_backgroundColorEnabled;
         int m_filterLabelId;
         std::unique_ptr<Filters::TorrentFilter> m_filter;
+        std::unique_ptr<Filters::TrigramIndex> m_nameIndex;
         std::vector<libtorrent::info_hash_t> m_filtered;
         std::map<int, std::tuple<std::string, std::string>> m_labels;
         std::map<int, wxColor> m_labelsColors;
         std::map<int, wxIcon> m_labelsIcons;
         std::map<libtorrent::info_hash_t, BitTorrent::TorrentHandle*> m_torrents;
+        std::map<int, wxString> m_labelsNames;
+
+        mutable std::map<libtorrent::info_hash_t, RowCache> m_cache;
+        mutable std::unique_ptr<TranslatedStrings> m_i18n;
     };
 }
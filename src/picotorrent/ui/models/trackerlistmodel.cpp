@@ -1,8 +1,9 @@
 #include "trackerlistmodel.hpp"
 
+#include <algorithm>
+
 #include <fmt/format.h>
 #include <libtorrent/announce_entry.hpp>
-#include <libtorrent/peer_info.hpp>
 
 #include "../../bittorrent//torrenthandle.hpp"
 #include "../../bittorrent//torrentstatus.hpp"
@@ -13,6 +14,7 @@ namespace lt = libtorrent;
 using pt::UI::Models::TrackerListModel;
 
 TrackerListModel::TrackerListModel()
+    : m_stamp(0)
 {
 }
 
@@ -44,240 +46,245 @@ void TrackerListModel::ResetTrackers()
     m_pex = nullptr;
 
     m_items.clear();
+    m_tiers.clear();
+    m_trackers.clear();
 
     this->Cleared();
 }
 
-void TrackerListModel::Update(pt::BitTorrent::TorrentHandle* torrent)
+// Computes the displayed values for a tracker and returns true if any of
+// them differ from what the item already shows.
+static bool updateTracker(TrackerListModel::ListItem& item, lt::announce_entry const& ae)
 {
-    if (m_dht == nullptr)
-    {
-        m_dht = std::make_shared<ListItem>();
-        m_dht->key = "DHT";
-        m_dht->tier = -1;
-
-        m_items.insert(
-            m_items.begin(),
-            m_dht);
-
-        this->ItemAdded(wxDataViewItem(), wxDataViewItem(m_dht.get()));
-    }
-
-    if (m_lsd == nullptr)
-    {
-        m_lsd = std::make_shared<ListItem>();
-        m_lsd->key = "LSD";
-        m_lsd->tier = -1;
+    int numDownloaded = -1;
+    int numLeeches = -1;
+    int numSeeds = -1;
 
-        m_items.insert(
-            m_items.begin() + 1,
-            m_lsd);
-
-        this->ItemAdded(wxDataViewItem(), wxDataViewItem(m_lsd.get()));
-    }
-
-    if (m_pex == nullptr)
+    for (lt::announce_endpoint const& ep : ae.endpoints)
     {
-        m_pex = std::make_shared<ListItem>();
-        m_pex->key = "PeX";
-        m_pex->tier = -1;
+        lt::announce_infohash const& ah = ep.info_hashes[lt::protocol_version::V1];
 
-        m_items.insert(
-            m_items.begin() + 2,
-            m_pex);
-
-        this->ItemAdded(wxDataViewItem(), wxDataViewItem(m_pex.get()));
+        numDownloaded = std::max(numDownloaded, ah.scrape_downloaded);
+        numLeeches = std::max(numLeeches, ah.scrape_incomplete);
+        numSeeds = std::max(numSeeds, ah.scrape_complete);
     }
 
-    auto trackers = torrent->Trackers();
-
-    std::vector<lt::peer_info> peers;
-    torrent->GetPeerInfo(peers);
+    TrackerListModel::ListItemStatus status = item.status;
+    std::wstring errorMessage = item.errorMessage;
+    int fails = item.fails;
+    int failLimit = item.failLimit;
+    std::chrono::seconds nextAnnounce = item.nextAnnounce;
 
-    m_dht->numLeeches = m_dht->numSeeds = 0;
-    m_lsd->numLeeches = m_lsd->numSeeds = 0;
-    m_pex->numLeeches = m_pex->numSeeds = 0;
+    auto endpoint = std::min_element(
+        ae.endpoints.begin(),
+        ae.endpoints.end(),
+        [](lt::announce_endpoint const& l, lt::announce_endpoint const& r)
+        {
+            return l.info_hashes[lt::protocol_version::V1].fails < r.info_hashes[lt::protocol_version::V1].fails;
+        });
 
-    for (lt::peer_info const& peer : peers)
+    if (endpoint != ae.endpoints.end())
     {
-        bool seed = static_cast<bool>(peer.flags & lt::peer_info::seed);
+        lt::announce_infohash const& ah = endpoint->info_hashes[lt::protocol_version::V1];
+
+        failLimit = ae.fail_limit;
+        fails = ah.fails;
+        nextAnnounce = std::chrono::seconds(lt::total_seconds(ah.next_announce - lt::clock_type::now()));
 
-        if (static_cast<bool>(peer.source & lt::peer_info::dht))
+        if (ah.updating)
         {
-            if (seed) m_dht->numSeeds += 1;
-            else      m_dht->numLeeches += 1;
+            status = TrackerListModel::ListItemStatus::updating;
         }
-        else if (static_cast<bool>(peer.source & lt::peer_info::lsd))
+        else if (ah.last_error)
         {
-            if (seed) m_lsd->numSeeds += 1;
-            else      m_lsd->numLeeches += 1;
+            errorMessage = fmt::format(
+                i18n("error_s"),
+                ah.message.empty()
+                    ? pt::Utils::toStdWString(ah.last_error.message())
+                    : fmt::format(
+                        L"{0} \"{1}\"",
+                        pt::Utils::toStdWString(ah.last_error.message()),
+                        pt::Utils::toStdWString(ah.message)));
+
+            status = TrackerListModel::ListItemStatus::error;
         }
-        else if (static_cast<bool>(peer.source & lt::peer_info::pex))
+        else if (ae.verified)
         {
-            if (seed) m_pex->numSeeds += 1;
-            else      m_pex->numLeeches += 1;
+            status = TrackerListModel::ListItemStatus::working;
         }
     }
 
-    wxDataViewItemArray staticItems;
-    staticItems.push_back(wxDataViewItem(m_dht.get()));
-    staticItems.push_back(wxDataViewItem(m_lsd.get()));
-    staticItems.push_back(wxDataViewItem(m_pex.get()));
+    if (item.numDownloaded == numDownloaded
+        && item.numLeeches == numLeeches
+        && item.numSeeds == numSeeds
+        && item.status == status
+        && item.errorMessage == errorMessage
+        && item.fails == fails
+        && item.failLimit == failLimit
+        && item.nextAnnounce == nextAnnounce)
+    {
+        return false;
+    }
 
-    this->ItemsChanged(staticItems);
+    item.numDownloaded = numDownloaded;
+    item.numLeeches = numLeeches;
+    item.numSeeds = numSeeds;
+    item.status = status;
+    item.errorMessage = errorMessage;
+    item.fails = fails;
+    item.failLimit = failLimit;
+    item.nextAnnounce = nextAnnounce;
 
-    // loop through each tier (ie. skip the first three items which are static)
+    return true;
+}
+
+TrackerListModel::TrackerMap::iterator TrackerListModel::RemoveTracker(TrackerMap::iterator entry)
+{
+    auto tracker = entry->second.item;
+    auto tier = tracker->parent;
 
-    for (auto tierIterator = m_items.begin() + 3; tierIterator != m_items.end();)
+    tier->children.erase(
+        std::find(tier->children.begin(), tier->children.end(), tracker));
+
+    this->ItemDeleted(
+        wxDataViewItem(tier.get()),
+        wxDataViewItem(tracker.get()));
+
+    // If the tier has no children left... Remove it
+    if (tier->children.empty())
     {
-        auto tier = (*tierIterator);
+        m_items.erase(std::find(m_items.begin(), m_items.end(), tier));
+        m_tiers.erase(tier->tier);
 
-        wxDataViewItemArray deletedTrackers;
+        this->ItemDeleted(
+            wxDataViewItem(0),
+            wxDataViewItem(tier.get()));
+    }
 
-        // loop through each tracker in this tier and remove the trackers which are not present in the
-        // new copy of trackers
+    return m_trackers.erase(entry);
+}
 
-        for (auto trackerIterator = tier->children.begin(); trackerIterator != tier->children.end();)
+void TrackerListModel::Update(pt::BitTorrent::TorrentHandle* torrent)
+{
+    auto addStatic = [this](std::shared_ptr<ListItem>& item, std::string const& key, size_t pos)
+    {
+        if (item != nullptr)
         {
-            auto foundIterator = std::find_if(
-                trackers.begin(),
-                trackers.end(),
-                [tierIterator, trackerIterator](lt::announce_entry const& ae)
-                {
-                    return ae.url == (*trackerIterator)->key
-                        && ae.tier == (*tierIterator)->tier;
-                });
-
-            if (foundIterator == trackers.end())
-            {
-                deletedTrackers.push_back(wxDataViewItem((*trackerIterator).get()));
-                trackerIterator = tier->children.erase(trackerIterator);
-            }
-            else
-            {
-                trackerIterator++;
-            }
+            return;
         }
 
-        this->ItemsDeleted(
-            wxDataViewItem(tier.get()),
-            deletedTrackers);
+        item = std::make_shared<ListItem>();
+        item->key = key;
+        item->tier = -1;
+        item->status = ListItemStatus::unknown;
+        item->numLeeches = item->numSeeds = 0;
 
-        // If the tier has no children left... Remove it
-        if (tier->children.empty())
-        {
-            this->ItemDeleted(
-                wxDataViewItem(0),
-                wxDataViewItem(tier.get()));
+        m_items.insert(
+            m_items.begin() + pos,
+            item);
 
-            tierIterator = m_items.erase(tierIterator);
-        }
-        else
+        this->ItemAdded(wxDataViewItem(), wxDataViewItem(item.get()));
+    };
+
+    addStatic(m_dht, "DHT", 0);
+    addStatic(m_lsd, "LSD", 1);
+    addStatic(m_pex, "PeX", 2);
+
+    wxDataViewItemArray changed;
+
+    // the source counters are counted once per peer snapshot by the torrent
+    // handle, so there is no need to walk the peers here
+    auto const& sources = torrent->PeerSourceCounts();
+
+    auto updateSource = [&changed](std::shared_ptr<ListItem> const& item, BitTorrent::PeerSources::Count const& count)
+    {
+        if (item->numSeeds == count.seeds
+            && item->numLeeches == count.leeches)
         {
-            tierIterator++;
+            return;
         }
-    }
 
-    // Add or update new data
-    for (auto iter = trackers.begin(); iter != trackers.end(); iter++)
-    {
-        // Check if we have a tier for this item
+        item->numSeeds = count.seeds;
+        item->numLeeches = count.leeches;
 
-        auto tierIter = std::find_if(
-            m_items.begin(),
-            m_items.end(),
-            [iter](auto const& t) { return iter->tier == t->tier; });
+        changed.push_back(wxDataViewItem(item.get()));
+    };
 
-        if (tierIter == m_items.end())
-        {
-            auto newTier = std::make_shared<ListItem>();
-            newTier->key = Utils::toStdString(fmt::format(i18n("tier_n"), iter->tier));
-            newTier->tier = iter->tier;
+    updateSource(m_dht, sources.dht);
+    updateSource(m_lsd, sources.lsd);
+    updateSource(m_pex, sources.pex);
 
-            m_items.push_back(newTier);
+    m_stamp++;
 
-            tierIter = m_items.end() - 1;
+    // libtorrent keeps tracker urls unique per torrent, so they are used
+    // as the key when diffing against the previous list
+    for (lt::announce_entry const& ae : torrent->TrackerList())
+    {
+        auto entry = m_trackers.find(ae.url);
 
-            this->ItemAdded(
-                wxDataViewItem(0),
-                wxDataViewItem(newTier.get()));
+        if (entry != m_trackers.end()
+            && entry->second.item->tier != ae.tier)
+        {
+            RemoveTracker(entry);
+            entry = m_trackers.end();
         }
 
-        auto endpoint = std::min_element(
-            iter->endpoints.begin(),
-            iter->endpoints.end(),
-            [](lt::announce_endpoint const& l, lt::announce_endpoint const& r)
-            {
-                return l.info_hashes[lt::protocol_version::V1].fails < r.info_hashes[lt::protocol_version::V1].fails;
-            });
+        if (entry == m_trackers.end())
+        {
+            auto tier = m_tiers.find(ae.tier);
 
-        auto trackerIter = std::find_if(
-            (*tierIter)->children.begin(),
-            (*tierIter)->children.end(),
-            [iter](auto const& itm)
+            if (tier == m_tiers.end())
             {
-                return itm->tier == iter->tier
-                    && itm->key == iter->url;
-            });
+                auto newTier = std::make_shared<ListItem>();
+                newTier->key = Utils::toStdString(fmt::format(i18n("tier_n"), ae.tier));
+                newTier->tier = ae.tier;
+                newTier->status = ListItemStatus::unknown;
 
-        if (trackerIter == (*tierIter)->children.end())
-        {
-            auto newTracker = std::make_shared<ListItem>();
-            newTracker->key = iter->url;
-            newTracker->parent = (*tierIter);
-            newTracker->tier = iter->tier;
+                m_items.push_back(newTier);
+                tier = m_tiers.insert({ ae.tier, newTier }).first;
+
+                this->ItemAdded(
+                    wxDataViewItem(0),
+                    wxDataViewItem(newTier.get()));
+            }
 
-            (*tierIter)->children.push_back(newTracker);
+            auto newTracker = std::make_shared<ListItem>();
+            newTracker->key = ae.url;
+            newTracker->parent = tier->second;
+            newTracker->tier = ae.tier;
+            newTracker->status = ListItemStatus::unknown;
+            newTracker->numDownloaded = newTracker->numLeeches = newTracker->numSeeds = -1;
+            newTracker->fails = newTracker->failLimit = 0;
+            newTracker->nextAnnounce = std::chrono::seconds(0);
 
-            trackerIter = (*tierIter)->children.end() - 1;
+            tier->second->children.push_back(newTracker);
 
             this->ItemAdded(
                 wxDataViewItem(newTracker->parent.get()),
                 wxDataViewItem(newTracker.get()));
-        }
 
-        for (lt::announce_endpoint const& ep : iter->endpoints)
-        {
-            lt::announce_infohash const& ah = ep.info_hashes[lt::protocol_version::V1];
-
-            (*trackerIter)->numDownloaded = std::max((*trackerIter)->numDownloaded, ah.scrape_downloaded);
-            (*trackerIter)->numLeeches = std::max((*trackerIter)->numLeeches, ah.scrape_incomplete);
-            (*trackerIter)->numSeeds = std::max((*trackerIter)->numSeeds, ah.scrape_complete);
+            entry = m_trackers.insert({ ae.url, TrackerEntry{ newTracker, 0 } }).first;
         }
 
-        if (endpoint != iter->endpoints.end())
-        {
-            lt::announce_infohash const& ah = endpoint->info_hashes[lt::protocol_version::V1];
+        entry->second.stamp = m_stamp;
 
-            (*trackerIter)->failLimit = iter->fail_limit;
-            (*trackerIter)->fails = ah.fails;
-            (*trackerIter)->nextAnnounce = std::chrono::seconds(lt::total_seconds(ah.next_announce - lt::clock_type::now()));
-
-            if (ah.updating)
-            {
-                (*trackerIter)->status = ListItemStatus::updating;
-            }
-            else if (ah.last_error)
-            {
-                std::wstring error = fmt::format(
-                    i18n("error_s"),
-                    ah.message.empty()
-                        ? Utils::toStdWString(ah.last_error.message())
-                        : fmt::format(
-                            L"{0} \"{1}\"",
-                            Utils::toStdWString(ah.last_error.message()),
-                            Utils::toStdWString(ah.message)));
-
-                (*trackerIter)->errorMessage = error;
-                (*trackerIter)->status = ListItemStatus::error;
-            }
-            else if (iter->verified)
-            {
-                (*trackerIter)->status = ListItemStatus::working;
-            }
+        if (updateTracker(*entry->second.item, ae))
+        {
+            changed.push_back(wxDataViewItem(entry->second.item.get()));
         }
+    }
 
-        this->ItemChanged(wxDataViewItem((*trackerIter).get()));
+    // anything not seen in this pass has been removed from the torrent
+    for (auto entry = m_trackers.begin(); entry != m_trackers.end();)
+    {
+        entry = entry->second.stamp != m_stamp
+            ? RemoveTracker(entry)
+            : std::next(entry);
+    }
+
+    if (!changed.empty())
+    {
+        this->ItemsChanged(changed);
     }
 }
 
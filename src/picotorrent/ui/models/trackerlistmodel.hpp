@@ -9,7 +9,10 @@
 #include <wx/dataview.h>
 
 #include <chrono>
+#include <map>
 #include <memory>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace pt
@@ -79,11 +82,24 @@ namespace Models
         void Update(BitTorrent::TorrentHandle* torrent);
 
     private:
+        struct TrackerEntry
+        {
+            std::shared_ptr<ListItem> item;
+            uint32_t stamp;
+        };
+
+        typedef std::unordered_map<std::string, TrackerEntry> TrackerMap;
+
+        TrackerMap::iterator RemoveTracker(TrackerMap::iterator entry);
+
         std::shared_ptr<ListItem> m_dht;
         std::shared_ptr<ListItem> m_lsd;
         std::shared_ptr<ListItem> m_pex;
 
         std::vector<std::shared_ptr<ListItem>> m_items;
+        std::map<int, std::shared_ptr<ListItem>> m_tiers;
+        TrackerMap m_trackers;
+        uint32_t m_stamp;
     };
 }
 }
@@ -3,6 +3,7 @@
 #include <fmt/format.h>
 
 #include "translator.hpp"
+#include "../bittorrent/movestatistics.hpp"
 #include "../core/utils.hpp"
 
 using pt::UI::StatusBar;
@@ -15,11 +16,12 @@ StatusBar::StatusBar(wxWindow* parent)
         -1,
         -1,
         -1,
+        -1,
         -1
     };
 
-    SetFieldsCount(4);
-    SetStatusWidths(4, widths);
+    SetFieldsCount(5);
+    SetStatusWidths(5, widths);
 }
 
 void StatusBar::UpdateDhtNodesCount(int64_t nodes)
@@ -34,6 +36,30 @@ void StatusBar::UpdateDhtNodesCount(int64_t nodes)
     }
 }
 
+void StatusBar::UpdateMoveStatistics(pt::BitTorrent::MoveStatistics const& stats)
+{
+    int const done = stats.finished + stats.failed;
+
+    if (stats.active + stats.queued > 0)
+    {
+        SetStatusText(
+            fmt::format(
+                i18n("moving_n_of_n_torrents"),
+                done + stats.active,
+                done + stats.active + stats.queued,
+                Utils::toHumanFileSize(stats.bytesRemaining)),
+            4);
+    }
+    else if (stats.failed > 0)
+    {
+        SetStatusText(fmt::format(i18n("n_moves_failed"), stats.failed), 4);
+    }
+    else
+    {
+        SetStatusText(wxEmptyString, 4);
+    }
+}
+
 void StatusBar::UpdateTorrentCount(int64_t torrents)
 {
     SetStatusText(fmt::format(i18n("num_torrents"), torrents), 0);
@@ -9,6 +9,10 @@
 
 namespace pt
 {
+namespace BitTorrent
+{
+    struct MoveStatistics;
+}
 namespace UI
 {
     class StatusBar : public wxStatusBar
@@ -18,6 +22,7 @@ namespace UI
 
         void UpdateDhtNodesCount(int64_t nodes);
         void UpdateIPFilterStatus(bool enabled);
+        void UpdateMoveStatistics(BitTorrent::MoveStatistics const& stats);
         void UpdateTorrentCount(int64_t torrents);
         void UpdateTransferRates(int64_t downSpeed, int64_t upSpeed);
     };
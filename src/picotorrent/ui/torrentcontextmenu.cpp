@@ -71,6 +71,7 @@ TorrentContextMenu::TorrentContextMenu(wxWindow* parent, std::shared_ptr<pt::Cor
     AppendSeparator();
     Append(ptID_FORCE_REANNOUNCE, i18n("force_reannounce"));
     Append(ptID_FORCE_RECHECK, i18n("force_recheck"));
+    Append(ptID_INCREMENTAL_RECHECK, i18n("incremental_recheck"));
 
     if (selectedTorrents.size() == 1)
     {
@@ -300,6 +301,11 @@ TorrentContextMenu::TorrentContextMenu(wxWindow* parent, std::shared_ptr<pt::Cor
         [&](wxCommandEvent&) { for (auto torrent : selectedTorrents) { torrent->ForceRecheck(); } },
         TorrentContextMenu::ptID_FORCE_RECHECK);
 
+    Bind(
+        wxEVT_MENU,
+        [&](wxCommandEvent&) { for (auto torrent : selectedTorrents) { torrent->IncrementalRecheck(); } },
+        TorrentContextMenu::ptID_INCREMENTAL_RECHECK);
+
     Bind(
         wxEVT_MENU,
         [&](wxCommandEvent&) { for (auto torrent : selectedTorrents) { torrent->ForceReannounce(); } },
@@ -43,6 +43,7 @@ namespace UI
             ptID_COPY_INFO_HASH,
             ptID_OPEN_IN_EXPLORER,
             ptID_FORCE_RECHECK,
+            ptID_INCREMENTAL_RECHECK,
             ptID_FORCE_REANNOUNCE,
             ptID_SEQUENTIAL_DOWNLOAD,
             ptID_EXPORT_MAGNET_LINK,
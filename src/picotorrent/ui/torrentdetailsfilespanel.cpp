@@ -32,6 +32,19 @@ TorrentDetailsFilesPanel::TorrentDetailsFilesPanel(wxWindow* parent, wxWindowID
     this->SetSizerAndFit(mainSizer);
 
     this->Bind(wxEVT_DATAVIEW_ITEM_CONTEXT_MENU, &TorrentDetailsFilesPanel::ShowFileContextMenu, this, wxID_ANY);
+    this->Bind(wxEVT_DATAVIEW_ITEM_EXPANDED, [this](wxDataViewEvent& evt) { m_filesModel->SetExpanded(evt.GetItem(), true); });
+    this->Bind(wxEVT_DATAVIEW_ITEM_COLLAPSED, [this](wxDataViewEvent& evt) { m_filesModel->SetExpanded(evt.GetItem(), false); });
+}
+
+TorrentDetailsFilesPanel::~TorrentDetailsFilesPanel()
+{
+    // cancel any tree still being built so it does not call back into us
+    m_filesModel->ClearNodes();
+}
+
+int TorrentDetailsFilesPanel::GetNeeds() const
+{
+    return TorrentDetailsPanel::Status | TorrentDetailsPanel::FileProgress;
 }
 
 void TorrentDetailsFilesPanel::Refresh(pt::BitTorrent::TorrentHandle* torrent)
@@ -54,23 +67,34 @@ void TorrentDetailsFilesPanel::Refresh(pt::BitTorrent::TorrentHandle* torrent)
             m_torrent = torrent;
             m_torrentPrevFileCount = tf->num_files();
 
-            m_filesModel->RebuildTree(tf);
-
-            wxDataViewItemArray children;
-            m_filesModel->GetChildren(m_filesModel->GetRootItem(), children);
-            for (auto const& child : children) { m_fileList->Expand(child); }
+            m_filesModel->RebuildTree(
+                tf,
+                [this]()
+                {
+                    wxDataViewItemArray children;
+                    m_filesModel->GetChildren(m_filesModel->GetRootItem(), children);
+                    for (auto const& child : children) { m_fileList->Expand(child); }
+                });
         }
 
-        std::vector<int64_t> progress;
-        torrent->FileProgress(progress, 0);
-
         m_filesModel->UpdatePriorities(m_torrent->GetFilePriorities());
-        m_filesModel->UpdateProgress(progress);
 
         m_fileList->Thaw();
     }
 }
 
+void TorrentDetailsFilesPanel::UpdateProgress(pt::BitTorrent::TorrentHandle* torrent)
+{
+    if (m_torrent != torrent)
+    {
+        return;
+    }
+
+    m_fileList->Freeze();
+    m_filesModel->UpdateProgress(torrent->FileProgress());
+    m_fileList->Thaw();
+}
+
 void TorrentDetailsFilesPanel::Reset()
 {
     m_torrent = nullptr;
@@ -5,6 +5,8 @@
 #include <wx/wx.h>
 #endif
 
+#include "torrentdetailspanel.hpp"
+
 namespace pt
 {
 namespace BitTorrent
@@ -20,13 +22,16 @@ namespace Models
 
     class TorrentFileListView;
 
-    class TorrentDetailsFilesPanel : public wxPanel
+    class TorrentDetailsFilesPanel : public wxPanel, public TorrentDetailsPanel
     {
     public:
         TorrentDetailsFilesPanel(wxWindow* parent, wxWindowID id);
+        virtual ~TorrentDetailsFilesPanel();
 
-        void Refresh(BitTorrent::TorrentHandle* torrent);
-        void Reset();
+        int GetNeeds() const override;
+        void Refresh(BitTorrent::TorrentHandle* torrent) override;
+        void Reset() override;
+        void UpdateProgress(BitTorrent::TorrentHandle* torrent);
 
     private:
         void ShowFileContextMenu(wxCommandEvent&);
@@ -11,6 +11,7 @@
 #include "../bittorrent/torrentstatus.hpp"
 #include "../core/utils.hpp"
 #include "translator.hpp"
+#include "widgets/pieceavailabilitybar.hpp"
 #include "widgets/pieceprogressbar.hpp"
 
 using pt::UI::TorrentDetailsOverviewPanel;
@@ -86,6 +87,7 @@ public:
 TorrentDetailsOverviewPanel::TorrentDetailsOverviewPanel(wxWindow* parent, wxWindowID id, int cols, bool showPieceProgress)
     : wxScrolledWindow(parent, id),
     m_pieceProgress(nullptr),
+    m_pieceAvailability(nullptr),
     m_name(new CopyableStaticText(this)),
     m_infoHash(new CopyableStaticText(this)),
     m_savePath(new CopyableStaticText(this)),
@@ -141,7 +143,9 @@ TorrentDetailsOverviewPanel::TorrentDetailsOverviewPanel(wxWindow* parent, wxWin
     if (showPieceProgress)
     {
         m_pieceProgress = new Widgets::PieceProgressBar(this, wxID_ANY);
+        m_pieceAvailability = new Widgets::PieceAvailabilityBar(this, wxID_ANY);
         m_mainSizer->Add(m_pieceProgress, 0, wxEXPAND | wxTOP | wxRIGHT | wxLEFT, FromDIP(5));
+        m_mainSizer->Add(m_pieceAvailability, 0, wxEXPAND | wxTOP | wxRIGHT | wxLEFT, FromDIP(2));
     }
     
     m_mainSizer->Add(m_sizer, 1, wxALL | wxEXPAND, FromDIP(5));
@@ -151,6 +155,13 @@ TorrentDetailsOverviewPanel::TorrentDetailsOverviewPanel(wxWindow* parent, wxWin
     this->SetScrollRate(5, 5);
 }
 
+int TorrentDetailsOverviewPanel::GetNeeds() const
+{
+    return m_pieceAvailability != nullptr
+        ? TorrentDetailsPanel::Status | TorrentDetailsPanel::PieceAvailability
+        : TorrentDetailsPanel::Status;
+}
+
 void TorrentDetailsOverviewPanel::Refresh(pt::BitTorrent::TorrentHandle* torrent)
 {
     auto status = torrent->Status();
@@ -226,6 +237,7 @@ void TorrentDetailsOverviewPanel::Reset()
     if (m_pieceProgress != nullptr)
     {
         m_pieceProgress->UpdateBitfield({});
+        m_pieceAvailability->UpdateAvailability({});
     }
 
     m_name->SetLabel("-");
@@ -242,18 +254,31 @@ void TorrentDetailsOverviewPanel::Reset()
     m_totalUpload->SetLabel("-");
 }
 
+void TorrentDetailsOverviewPanel::UpdatePieceAvailability(pt::BitTorrent::TorrentHandle* torrent)
+{
+    if (m_pieceAvailability != nullptr)
+    {
+        m_pieceAvailability->UpdateAvailability(torrent->PieceAvailability());
+    }
+}
+
 void TorrentDetailsOverviewPanel::UpdateView(int cols, bool showPieceProgress)
 {
     if (showPieceProgress && m_pieceProgress == nullptr)
     {
         m_pieceProgress = new Widgets::PieceProgressBar(this, wxID_ANY);
+        m_pieceAvailability = new Widgets::PieceAvailabilityBar(this, wxID_ANY);
         m_mainSizer->Insert(0, m_pieceProgress, 0, wxEXPAND | wxTOP | wxRIGHT | wxLEFT, FromDIP(5));
+        m_mainSizer->Insert(1, m_pieceAvailability, 0, wxEXPAND | wxTOP | wxRIGHT | wxLEFT, FromDIP(2));
     }
     else if (!showPieceProgress && m_pieceProgress != nullptr)
     {
+        m_mainSizer->Remove(1);
         m_mainSizer->Remove(0);
 
+        delete m_pieceAvailability;
         delete m_pieceProgress;
+        m_pieceAvailability = nullptr;
         m_pieceProgress = nullptr;
     }
 
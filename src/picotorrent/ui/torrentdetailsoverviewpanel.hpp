@@ -5,9 +5,11 @@
 #include <wx/wx.h>
 #endif
 
+#include "torrentdetailspanel.hpp"
+
 class wxFlexGridSizer;
 
-namespace pt::UI::Widgets { class PieceProgressBar; }
+namespace pt::UI::Widgets { class PieceAvailabilityBar; class PieceProgressBar; }
 
 namespace pt
 {
@@ -17,19 +19,22 @@ namespace BitTorrent
 }
 namespace UI
 {
-    class TorrentDetailsOverviewPanel : public wxScrolledWindow
+    class TorrentDetailsOverviewPanel : public wxScrolledWindow, public TorrentDetailsPanel
     {
     public:
         TorrentDetailsOverviewPanel(wxWindow* parent, wxWindowID id, int cols = 2, bool showPieceProgress = true);
 
-        void Refresh(BitTorrent::TorrentHandle* torrent);
-        void Reset();
+        int GetNeeds() const override;
+        void Refresh(BitTorrent::TorrentHandle* torrent) override;
+        void Reset() override;
+        void UpdatePieceAvailability(BitTorrent::TorrentHandle* torrent);
         void UpdateView(int cols, bool showPieceProgress);
 
     private:
         wxFlexGridSizer* m_sizer;
         wxBoxSizer* m_mainSizer;
         Widgets::PieceProgressBar* m_pieceProgress;
+        Widgets::PieceAvailabilityBar* m_pieceAvailability;
         wxStaticText* m_name;
         wxStaticText* m_infoHash;
         wxStaticText* m_savePath;
@@ -0,0 +1,28 @@
+#pragma once
+
+namespace pt::BitTorrent { class TorrentHandle; }
+
+namespace pt::UI
+{
+    // Implemented by each page in the torrent details notebook. Only the
+    // visible page is refreshed, and GetNeeds tells the view which queries
+    // to post to the session for it.
+    class TorrentDetailsPanel
+    {
+    public:
+        enum Needs
+        {
+            Status = 1,
+            FileProgress = 2,
+            PeerInfo = 4,
+            Trackers = 8,
+            PieceAvailability = 16
+        };
+
+        virtual ~TorrentDetailsPanel() { }
+
+        virtual int GetNeeds() const = 0;
+        virtual void Refresh(BitTorrent::TorrentHandle* torrent) = 0;
+        virtual void Reset() = 0;
+    };
+}
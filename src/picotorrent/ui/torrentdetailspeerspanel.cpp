@@ -15,7 +15,8 @@ using pt::UI::Models::PeerListModel;
 TorrentDetailsPeersPanel::TorrentDetailsPeersPanel(wxWindow* parent, wxWindowID id)
     : wxPanel(parent, id),
     m_peersView(new wxDataViewCtrl(this, wxID_ANY)),
-    m_peersModel(new PeerListModel())
+    m_peersModel(new PeerListModel()),
+    m_torrent(nullptr)
 {
     m_peersView->AppendTextColumn(i18n("ip"), PeerListModel::Column::IP, wxDATAVIEW_CELL_INERT, FromDIP(110));
     m_peersView->AppendTextColumn(i18n("client"), PeerListModel::Column::Client, wxDATAVIEW_CELL_INERT, FromDIP(140));
@@ -35,6 +36,11 @@ TorrentDetailsPeersPanel::TorrentDetailsPeersPanel(wxWindow* parent, wxWindowID
     this->SetSizerAndFit(mainSizer);
 }
 
+int TorrentDetailsPeersPanel::GetNeeds() const
+{
+    return TorrentDetailsPanel::PeerInfo;
+}
+
 void TorrentDetailsPeersPanel::Refresh(pt::BitTorrent::TorrentHandle* torrent)
 {
     if (!torrent->IsValid())
@@ -43,13 +49,26 @@ void TorrentDetailsPeersPanel::Refresh(pt::BitTorrent::TorrentHandle* torrent)
         return;
     }
 
-    std::vector<lt::peer_info> peers;
-    torrent->GetPeerInfo(peers);
+    if (m_torrent != torrent)
+    {
+        m_peersModel->ResetPeers();
+    }
 
-    m_peersModel->Update(peers);
+    m_torrent = torrent;
 }
 
 void TorrentDetailsPeersPanel::Reset()
 {
+    m_torrent = nullptr;
     m_peersModel->ResetPeers();
 }
+
+void TorrentDetailsPeersPanel::UpdatePeers(pt::BitTorrent::TorrentHandle* torrent)
+{
+    if (m_torrent != torrent)
+    {
+        return;
+    }
+
+    m_peersModel->Update(torrent->PeerInfo());
+}
@@ -5,6 +5,8 @@
 #include <wx/wx.h>
 #endif
 
+#include "torrentdetailspanel.hpp"
+
 class wxDataViewCtrl;
 
 namespace pt
@@ -19,13 +21,15 @@ namespace Models
 {
     class PeerListModel;
 }
-    class TorrentDetailsPeersPanel : public wxPanel
+    class TorrentDetailsPeersPanel : public wxPanel, public TorrentDetailsPanel
     {
     public:
         TorrentDetailsPeersPanel(wxWindow* parent, wxWindowID id);
 
-        void Refresh(BitTorrent::TorrentHandle* torrent);
-        void Reset();
+        int GetNeeds() const override;
+        void Refresh(BitTorrent::TorrentHandle* torrent) override;
+        void Reset() override;
+        void UpdatePeers(BitTorrent::TorrentHandle* torrent);
 
     private:
         BitTorrent::TorrentHandle* m_torrent;
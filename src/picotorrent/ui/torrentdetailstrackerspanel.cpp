@@ -20,7 +20,8 @@ TorrentDetailsTrackersPanel::TorrentDetailsTrackersPanel(wxWindow* parent, wxWin
     : wxPanel(parent, id),
     m_trackersModel(new Models::TrackerListModel()),
     m_trackersView(new wxDataViewCtrl(this, wxID_ANY)),
-    m_torrent(nullptr)
+    m_torrent(nullptr),
+    m_expandTiers(false)
 {
     m_trackersView->AppendTextColumn(
         i18n("url"),
@@ -82,6 +83,11 @@ TorrentDetailsTrackersPanel::TorrentDetailsTrackersPanel(wxWindow* parent, wxWin
     this->Bind(wxEVT_COMMAND_DATAVIEW_ITEM_CONTEXT_MENU, &TorrentDetailsTrackersPanel::ShowTrackerContextMenu, this);
 }
 
+int TorrentDetailsTrackersPanel::GetNeeds() const
+{
+    return TorrentDetailsPanel::Trackers | TorrentDetailsPanel::PeerInfo;
+}
+
 void TorrentDetailsTrackersPanel::Refresh(pt::BitTorrent::TorrentHandle* torrent)
 {
     if (!torrent->IsValid())
@@ -90,15 +96,10 @@ void TorrentDetailsTrackersPanel::Refresh(pt::BitTorrent::TorrentHandle* torrent
         return;
     }
 
-    m_trackersModel->Update(torrent);
-
     if (m_torrent == nullptr
         || m_torrent->InfoHash() != torrent->InfoHash())
     {
-        for (auto const& node : m_trackersModel->GetTierNodes())
-        {
-            m_trackersView->Expand(node);
-        }
+        m_expandTiers = true;
     }
 
     m_torrent = torrent;
@@ -110,6 +111,26 @@ void TorrentDetailsTrackersPanel::Reset()
     m_trackersModel->ResetTrackers();
 }
 
+void TorrentDetailsTrackersPanel::UpdateTrackers(pt::BitTorrent::TorrentHandle* torrent)
+{
+    if (m_torrent != torrent)
+    {
+        return;
+    }
+
+    m_trackersModel->Update(torrent);
+
+    if (m_expandTiers)
+    {
+        for (auto const& node : m_trackersModel->GetTierNodes())
+        {
+            m_trackersView->Expand(node);
+        }
+
+        m_expandTiers = false;
+    }
+}
+
 void TorrentDetailsTrackersPanel::ShowTrackerContextMenu(wxDataViewEvent& evt)
 {
     if (m_torrent == nullptr)
@@ -5,6 +5,8 @@
 #include <wx/wx.h>
 #endif
 
+#include "torrentdetailspanel.hpp"
+
 class wxDataViewCtrl;
 class wxDataViewEvent;
 
@@ -20,13 +22,15 @@ namespace Models
 {
     class TrackerListModel;
 }
-    class TorrentDetailsTrackersPanel : public wxPanel
+    class TorrentDetailsTrackersPanel : public wxPanel, public TorrentDetailsPanel
     {
     public:
         TorrentDetailsTrackersPanel(wxWindow* parent, wxWindowID id);
 
-        void Refresh(BitTorrent::TorrentHandle* torrent);
-        void Reset();
+        int GetNeeds() const override;
+        void Refresh(BitTorrent::TorrentHandle* torrent) override;
+        void Reset() override;
+        void UpdateTrackers(BitTorrent::TorrentHandle* torrent);
 
     private:
         enum
@@ -42,6 +46,7 @@ namespace Models
         void ShowTrackerContextMenu(wxDataViewEvent&);
 
         BitTorrent::TorrentHandle* m_torrent;
+        bool m_expandTiers;
 
         Models::TrackerListModel* m_trackersModel;
         wxDataViewCtrl* m_trackersView;
@@ -3,6 +3,7 @@
 #include <wx/notebook.h>
 #include <wx/sizer.h>
 
+#include "../bittorrent/torrenthandle.hpp"
 #include "../core/configuration.hpp"
 #include "torrentdetailsfilespanel.hpp"
 #include "torrentdetailsoverviewpanel.hpp"
@@ -18,13 +19,20 @@ TorrentDetailsView::TorrentDetailsView(wxWindow* parent, wxWindowID id, std::sha
     m_overview(new TorrentDetailsOverviewPanel(this, wxID_ANY)),
     m_files(new TorrentDetailsFilesPanel(this, wxID_ANY)),
     m_peers(new TorrentDetailsPeersPanel(this, wxID_ANY)),
-    m_trackers(new TorrentDetailsTrackersPanel(this, wxID_ANY))
+    m_trackers(new TorrentDetailsTrackersPanel(this, wxID_ANY)),
+    m_torrent(nullptr)
 {
     this->AddPage(m_overview, i18n("overview"));
     this->AddPage(m_files,    i18n("files"));
     this->AddPage(m_peers,    i18n("peers"));
     this->AddPage(m_trackers, i18n("trackers"));
     this->ReloadConfiguration();
+
+    // same order as the pages above
+    m_panels = { m_overview, m_files, m_peers, m_trackers };
+    m_stale.resize(m_panels.size(), false);
+
+    this->Bind(wxEVT_NOTEBOOK_PAGE_CHANGED, &TorrentDetailsView::OnPageChanged, this);
 }
 
 TorrentDetailsView::~TorrentDetailsView()
@@ -39,10 +47,68 @@ void TorrentDetailsView::Refresh(std::map<lt::info_hash_t, pt::BitTorrent::Torre
         return;
     }
 
-    m_overview->Refresh(torrents.begin()->second);
-    m_files->Refresh(torrents.begin()->second);
-    m_peers->Refresh(torrents.begin()->second);
-    m_trackers->Refresh(torrents.begin()->second);
+    auto torrent = torrents.begin()->second;
+    int selected = this->GetSelection();
+    bool changed = m_torrent != torrent;
+
+    // hidden pages are left alone until they are shown, but they should
+    // not show data for another torrent in the meantime
+    for (size_t i = 0; i < m_panels.size(); i++)
+    {
+        if (static_cast<int>(i) != selected && changed)
+        {
+            m_panels[i]->Reset();
+        }
+
+        m_stale[i] = m_stale[i] || changed || static_cast<int>(i) != selected;
+    }
+
+    m_torrent = torrent;
+
+    if (selected != wxNOT_FOUND)
+    {
+        RefreshPage(selected);
+    }
+}
+
+void TorrentDetailsView::OnPageChanged(wxBookCtrlEvent& evt)
+{
+    int page = evt.GetSelection();
+
+    if (m_torrent != nullptr
+        && page != wxNOT_FOUND
+        && m_stale[page])
+    {
+        RefreshPage(page);
+    }
+
+    evt.Skip();
+}
+
+void TorrentDetailsView::RefreshPage(size_t page)
+{
+    TorrentDetailsPanel* panel = m_panels[page];
+    int needs = panel->GetNeeds();
+
+    // panels that do not read the torrent status only need to be told when
+    // the torrent changes, their data comes from the queries below
+    if ((needs & TorrentDetailsPanel::Status) || m_stale[page])
+    {
+        panel->Refresh(m_torrent);
+        m_stale[page] = false;
+    }
+
+    if (!m_torrent->IsValid())
+    {
+        return;
+    }
+
+    // peer info is posted before the tracker list so the tracker counters
+    // are computed from a fresh peer snapshot
+    if (needs & TorrentDetailsPanel::FileProgress)      { m_torrent->PostFileProgress(); }
+    if (needs & TorrentDetailsPanel::PeerInfo)          { m_torrent->PostPeerInfo(); }
+    if (needs & TorrentDetailsPanel::PieceAvailability) { m_torrent->PostPieceAvailability(); }
+    if (needs & TorrentDetailsPanel::Trackers)          { m_torrent->PostTrackers(); }
 }
 
 void TorrentDetailsView::ReloadConfiguration()
@@ -57,8 +123,31 @@ void TorrentDetailsView::ReloadConfiguration()
 
 void TorrentDetailsView::Reset()
 {
-    m_overview->Reset();
-    m_files->Reset();
-    m_peers->Reset();
-    m_trackers->Reset();
+    m_torrent = nullptr;
+
+    for (size_t i = 0; i < m_panels.size(); i++)
+    {
+        m_panels[i]->Reset();
+        m_stale[i] = false;
+    }
+}
+
+void TorrentDetailsView::UpdateFileProgress(pt::BitTorrent::TorrentHandle* torrent)
+{
+    if (this->GetCurrentPage() == m_files) { m_files->UpdateProgress(torrent); }
+}
+
+void TorrentDetailsView::UpdatePeerInfo(pt::BitTorrent::TorrentHandle* torrent)
+{
+    if (this->GetCurrentPage() == m_peers) { m_peers->UpdatePeers(torrent); }
+}
+
+void TorrentDetailsView::UpdatePieceAvailability(pt::BitTorrent::TorrentHandle* torrent)
+{
+    if (this->GetCurrentPage() == m_overview) { m_overview->UpdatePieceAvailability(torrent); }
+}
+
+void TorrentDetailsView::UpdateTrackers(pt::BitTorrent::TorrentHandle* torrent)
+{
+    if (this->GetCurrentPage() == m_trackers) { m_trackers->UpdateTrackers(torrent); }
 }
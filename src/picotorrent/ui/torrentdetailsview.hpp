@@ -7,6 +7,7 @@
 
 #include <map>
 #include <memory>
+#include <vector>
 
 #include <libtorrent/info_hash.hpp>
 #include <wx/notebook.h>
@@ -18,6 +19,7 @@ namespace pt::UI
 {
     class TorrentDetailsFilesPanel;
     class TorrentDetailsOverviewPanel;
+    class TorrentDetailsPanel;
     class TorrentDetailsPeersPanel;
     class TorrentDetailsTrackersPanel;
 
@@ -31,8 +33,19 @@ namespace pt::UI
         void ReloadConfiguration();
         void Reset();
 
+        void UpdateFileProgress(BitTorrent::TorrentHandle* torrent);
+        void UpdatePeerInfo(BitTorrent::TorrentHandle* torrent);
+        void UpdatePieceAvailability(BitTorrent::TorrentHandle* torrent);
+        void UpdateTrackers(BitTorrent::TorrentHandle* torrent);
+
     private:
+        void OnPageChanged(wxBookCtrlEvent&);
+        void RefreshPage(size_t page);
+
         std::shared_ptr<Core::Configuration> m_cfg;
+        BitTorrent::TorrentHandle* m_torrent;
+        std::vector<TorrentDetailsPanel*> m_panels;
+        std::vector<bool> m_stale;
 
         TorrentDetailsOverviewPanel* m_overview;
         TorrentDetailsFilesPanel* m_files;
@@ -1,17 +1,45 @@
 #include "translator.hpp"
 
+#include <algorithm>
+
+#include <chrono>
+
 #include <boost/log/trivial.hpp>
-#include <nlohmann/json.hpp>
-#include <sqlite3.h>
 
+#include "../../l10n/catalogue.hpp"
 #include "../core/utils.hpp"
 
-using json = nlohmann::json;
+using pt::L10n::CatalogueHeader;
+using pt::L10n::CatalogueLocale;
+using pt::L10n::CatalogueString;
+using pt::UI::TranslatedStrings;
 using pt::UI::Translator;
 
+std::optional<uint32_t> pt::UI::I18n::Find(std::string_view key)
+{
+    auto it = std::lower_bound(std::begin(Keys), std::end(Keys), key);
+
+    if (it == std::end(Keys) || *it != key)
+    {
+        return std::nullopt;
+    }
+
+    return static_cast<uint32_t>(std::distance(std::begin(Keys), it));
+}
+
 Translator::Translator()
-    : m_selectedLocale("en")
+    : m_selectedLocale("en"),
+    m_mapping(NULL),
+    m_view(nullptr),
+    m_size(0),
+    m_generation(1)
+{
+    Resolve();
+}
+
+Translator::~Translator()
 {
+    Unload();
 }
 
 Translator& Translator::GetInstance()
@@ -25,44 +53,125 @@ std::string Translator::GetLocale()
     return m_selectedLocale;
 }
 
+template<typename T>
+T const* Translator::At(uint32_t offset, size_t count) const
+{
+    if (m_view == nullptr
+        || offset % alignof(T) != 0
+        || offset > m_size
+        || count > (m_size - offset) / sizeof(T))
+    {
+        return nullptr;
+    }
+
+    return reinterpret_cast<T const*>(m_view + offset);
+}
+
 void Translator::LoadDatabase(std::filesystem::path const& filePath)
 {
-    std::string convertedPath = Utils::toStdString(filePath.wstring());
+    auto begin = std::chrono::high_resolution_clock::now();
+
+    BOOST_LOG_TRIVIAL(info) << "Loading translations from " << Utils::toStdString(filePath.wstring());
+
+    HANDLE file = CreateFile(
+        filePath.wstring().c_str(),
+        GENERIC_READ,
+        FILE_SHARE_READ,
+        NULL,
+        OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL,
+        NULL);
+
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        BOOST_LOG_TRIVIAL(error) << "Failed to open translations catalogue: " << GetLastError();
+        return;
+    }
+
+    LARGE_INTEGER size;
+    GetFileSizeEx(file, &size);
+
+    // the mapping keeps the file open, only the pages we read are loaded
+    HANDLE mapping = CreateFileMapping(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    CloseHandle(file);
+
+    if (mapping == NULL)
+    {
+        BOOST_LOG_TRIVIAL(error) << "Failed to map translations catalogue: " << GetLastError();
+        return;
+    }
+
+    // the strings resolved from a previous catalogue are copies, so it can
+    // be released before the new one is read
+    Unload();
 
-    BOOST_LOG_TRIVIAL(info) << "Loading translations from " << convertedPath;
+    m_mapping = mapping;
+    m_view = static_cast<uint8_t const*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    m_size = static_cast<size_t>(size.QuadPart);
 
-    sqlite3* db = nullptr;
+    auto header = At<CatalogueHeader>(0);
 
-    if (sqlite3_open(convertedPath.c_str(), &db) != SQLITE_OK)
+    if (header == nullptr
+        || header->magic != L10n::CatalogueMagic
+        || header->version != L10n::CatalogueVersion)
     {
-        BOOST_LOG_TRIVIAL(error) << "Failed to load translations database";
+        BOOST_LOG_TRIVIAL(error) << "Translations catalogue is invalid or has an unsupported version";
+        Unload();
         return;
     }
 
-    sqlite3_exec(
-        db,
-        "SELECT locale, key, value FROM translations ORDER BY locale, key ASC",
-        &Translator::LoadDatabaseCallback,
-        this,
-        nullptr);
+    auto keys = At<CatalogueString>(header->keysOffset, header->keyCount);
+    auto locales = At<CatalogueLocale>(header->localesOffset, header->localeCount);
+
+    if (keys == nullptr || locales == nullptr)
+    {
+        BOOST_LOG_TRIVIAL(error) << "Translations catalogue is truncated";
+        Unload();
+        return;
+    }
+
+    // map the catalogue keys to the ids compiled into the binary, they only
+    // differ if the catalogue is older or newer than the executable
+    m_keyIds.assign(header->keyCount, I18n::KeyCount);
+
+    for (uint32_t i = 0; i < header->keyCount; i++)
+    {
+        auto key = At<char>(keys[i].offset, keys[i].length);
+        if (key == nullptr) { continue; }
+
+        if (auto id = I18n::Find(std::string_view(key, keys[i].length)))
+        {
+            m_keyIds[i] = id.value();
+        }
+    }
+
+    for (uint32_t i = 0; i < header->localeCount; i++)
+    {
+        auto name = At<char>(locales[i].name.offset, locales[i].name.length);
+        if (name == nullptr) { continue; }
+
+        m_locales.insert({ std::string(name, locales[i].name.length), i });
+    }
 
-    sqlite3_close(db);
+    Resolve();
+
+    auto end = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::duration<double, std::milli>>(end - begin).count();
+
+    BOOST_LOG_TRIVIAL(info) << "Loaded " << m_locales.size() << " locale(s) and " << m_keyIds.size() << " key(s) in " << duration << " ms";
 }
 
-int Translator::LoadDatabaseCallback(void* user, int, char** data, char**)
+std::vector<Translator::Language> Translator::Languages()
 {
-    Translator* tr = static_cast<Translator*>(user);
-
-    std::string loc = data[0];
-    std::string key = data[1];
-    std::wstring val = Utils::toStdWString(data[2]);
+    std::vector<Language> result;
     TCHAR localeNameBuffer[1024];
 
-    if (tr->m_languages.find(loc) == tr->m_languages.end())
+    // the display names are only needed for the preferences dialog, so they
+    // are looked up here instead of when the catalogue is loaded
+    for (auto const& [locale, _] : m_locales)
     {
         Language l;
-        l.locale = loc;
-
+        l.locale = locale;
 
         int res = GetLocaleInfoEx(
             Utils::toStdWString(l.locale).c_str(),
@@ -79,21 +188,7 @@ int Translator::LoadDatabaseCallback(void* user, int, char** data, char**)
             BOOST_LOG_TRIVIAL(error) << "GetLocaleInfoEx returned " << res << " for " << l.locale;
         }
 
-        tr->m_languages.insert({ loc, l });
-    }
-
-    tr->m_languages.at(loc).translations.insert({ key, val });
-
-    return SQLITE_OK;
-}
-
-std::vector<Translator::Language> Translator::Languages()
-{
-    std::vector<Language> result;
-
-    for (auto& p : m_languages)
-    {
-        result.push_back(p.second);
+        result.push_back(l);
     }
 
     std::sort(
@@ -109,39 +204,74 @@ std::vector<Translator::Language> Translator::Languages()
 
 std::wstring Translator::Translate(std::string const& key)
 {
-    // Try to find the language we have selected
-    auto lang = m_languages.find(m_selectedLocale);
+    if (auto id = I18n::Find(key))
+    {
+        return m_strings[id.value()];
+    }
 
-    // Didn't find our selected language, try with 'en' instead
-    if (lang == m_languages.end()) { lang = m_languages.find("en-US"); }
+    return Utils::toStdWString(key);
+}
+
+void Translator::Resolve()
+{
+    m_strings.resize(I18n::KeyCount);
 
-    // Didn't find 'en', return the key
-    if (lang == m_languages.end())
+    for (uint32_t id = 0; id < I18n::KeyCount; id++)
     {
-        return Utils::toStdWString(key);
+        m_strings[id] = Utils::toStdWString(std::string(I18n::Keys[id]));
     }
 
-    auto translation = lang->second.translations.find(key);
+    // Try to find the language we have selected, otherwise use en-US. Only
+    // the value tables of these two are read from the catalogue.
+    auto en = m_locales.find("en-US");
+    auto lang = m_locales.find(m_selectedLocale);
+
+    if (lang == m_locales.end()) { lang = en; }
+
+    auto header = At<CatalogueHeader>(0);
+    auto locales = header != nullptr
+        ? At<CatalogueLocale>(header->localesOffset, header->localeCount)
+        : nullptr;
 
-    if (translation == lang->second.translations.end())
+    auto values = [&](std::map<std::string, uint32_t>::iterator it) -> CatalogueString const*
     {
-        auto en = lang = m_languages.find("en-US");
-        if (en == m_languages.end())
-        {
-            return Utils::toStdWString(key);
-        }
+        if (locales == nullptr || it == m_locales.end()) { return nullptr; }
+        return At<CatalogueString>(locales[it->second].valuesOffset, m_keyIds.size());
+    };
+
+    CatalogueString const* selectedValues = values(lang);
+    CatalogueString const* fallbackValues = values(en);
 
-        auto enTranslation = en->second.translations.find(key);
+    for (size_t i = 0; i < m_keyIds.size(); i++)
+    {
+        uint32_t id = m_keyIds[i];
+        if (id >= I18n::KeyCount) { continue; }
 
-        if (enTranslation != en->second.translations.end())
+        for (auto table : { selectedValues, fallbackValues })
         {
-            return enTranslation->second;
-        }
+            if (table == nullptr || table[i].length == 0) { continue; }
+
+            auto str = At<wchar_t>(table[i].offset, table[i].length);
+            if (str == nullptr) { continue; }
 
-        return Utils::toStdWString(key);
+            m_strings[id].assign(str, table[i].length);
+            break;
+        }
     }
 
-    return translation->second;
+    m_generation++;
+}
+
+void Translator::Unload()
+{
+    if (m_view != nullptr) { UnmapViewOfFile(m_view); }
+    if (m_mapping != NULL) { CloseHandle(m_mapping); }
+
+    m_mapping = NULL;
+    m_view = nullptr;
+    m_size = 0;
+    m_locales.clear();
+    m_keyIds.clear();
 }
 
 void Translator::SetLocale(std::string const& locale)
@@ -150,7 +280,7 @@ void Translator::SetLocale(std::string const& locale)
     // in this case, we want to use the 'en' translations. check if we have an
     // exact match, otherwise remove the -SV part and check again
 
-    if (m_languages.find(locale) == m_languages.end())
+    if (m_locales.find(locale) == m_locales.end())
     {
         std::string tmpLocale = locale;
 
@@ -159,7 +289,7 @@ void Translator::SetLocale(std::string const& locale)
             tmpLocale = locale.substr(0, locale.find_first_of('-'));
         }
 
-        if (m_languages.find(tmpLocale) != m_languages.end())
+        if (m_locales.find(tmpLocale) != m_locales.end())
         {
             BOOST_LOG_TRIVIAL(info) << "Adjusting locale from " << locale << " to " << tmpLocale << " in order to match available language";
             m_selectedLocale = tmpLocale;
@@ -167,7 +297,7 @@ void Translator::SetLocale(std::string const& locale)
         else
         {
             // loop through and see if we have other locales which might match. take first
-            for (auto const& lang : m_languages)
+            for (auto const& lang : m_locales)
             {
                 if (lang.first.size() >= tmpLocale.size()
                     && lang.first.substr(0, tmpLocale.size()) == tmpLocale)
@@ -183,4 +313,26 @@ void Translator::SetLocale(std::string const& locale)
     {
         m_selectedLocale = locale;
     }
+
+    Resolve();
+}
+
+TranslatedStrings::TranslatedStrings(std::initializer_list<uint32_t> ids)
+    : m_ids(ids.begin(), ids.end()),
+    m_generation(0)
+{
+}
+
+bool TranslatedStrings::Refresh()
+{
+    uint32_t generation = Translator::GetInstance().Generation();
+
+    if (m_generation == generation)
+    {
+        return false;
+    }
+
+    m_generation = generation;
+
+    return true;
 }
@@ -2,13 +2,51 @@
 
 #include <Windows.h>
 
+#include <cstdint>
 #include <filesystem>
+#include <initializer_list>
 #include <map>
 #include <memory>
+#include <optional>
+#include <stdexcept>
 #include <string>
+#include <string_view>
+#include <type_traits>
 #include <vector>
 
-#define i18n(key) pt::UI::Translator::GetInstance().Translate(key)
+#include "i18nkeys.hpp"
+
+namespace pt::UI::I18n
+{
+    // Resolves a key to its index in the generated (sorted) key table. Used
+    // through i18n_id, an unknown key throws during constant evaluation and
+    // fails the build.
+    constexpr uint32_t Id(std::string_view key)
+    {
+        uint32_t lo = 0;
+        uint32_t hi = KeyCount;
+
+        while (lo < hi)
+        {
+            uint32_t mid = lo + (hi - lo) / 2;
+
+            if (Keys[mid] < key) { lo = mid + 1; }
+            else { hi = mid; }
+        }
+
+        if (lo == KeyCount || Keys[lo] != key)
+        {
+            throw std::invalid_argument("unknown i18n key");
+        }
+
+        return lo;
+    }
+
+    std::optional<uint32_t> Find(std::string_view key);
+}
+
+#define i18n_id(key) std::integral_constant<uint32_t, pt::UI::I18n::Id(key)>::value
+#define i18n(key) pt::UI::Translator::GetInstance().Translate(i18n_id(key))
 
 namespace pt
 {
@@ -21,7 +59,6 @@ namespace UI
         {
             std::string locale;
             std::wstring name;
-            std::map<std::string, std::wstring> translations;
         };
 
         static Translator& GetInstance();
@@ -29,19 +66,51 @@ namespace UI
         Translator(Translator const&) = delete;
         void operator=(Translator const&) = delete;
 
+        uint32_t Generation() const { return m_generation; }
         std::string GetLocale();
         std::vector<Language> Languages();
         void LoadDatabase(std::filesystem::path const& filePath);
         void SetLocale(std::string const& localeName);
+        std::wstring const& Translate(uint32_t id) const { return m_strings[id]; }
         std::wstring Translate(std::string const& key);
 
     private:
         Translator();
+        ~Translator();
+
+        template<typename T>
+        T const* At(uint32_t offset, size_t count = 1) const;
 
-        static int LoadDatabaseCallback(void* user, int count, char** data, char** columns);
+        void Resolve();
+        void Unload();
 
         std::string m_selectedLocale;
-        std::map<std::string, Language> m_languages;
+
+        // the memory mapped catalogue, see l10n/catalogue.hpp
+        HANDLE m_mapping;
+        uint8_t const* m_view;
+        size_t m_size;
+
+        std::map<std::string, uint32_t> m_locales;
+        std::vector<uint32_t> m_keyIds;
+        std::vector<std::wstring> m_strings;
+        uint32_t m_generation;
+    };
+
+    // A fixed set of translations for models which format the same handful of
+    // strings for every row. Refresh tells them when the locale or the loaded
+    // translations changed, so anything formatted before can be thrown away.
+    class TranslatedStrings
+    {
+    public:
+        TranslatedStrings(std::initializer_list<uint32_t> ids);
+
+        bool Refresh();
+        std::wstring const& operator[](size_t index) const { return Translator::GetInstance().Translate(m_ids.at(index)); }
+
+    private:
+        std::vector<uint32_t> m_ids;
+        uint32_t m_generation;
     };
 }
 }
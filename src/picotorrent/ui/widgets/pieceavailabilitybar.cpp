@@ -0,0 +1,229 @@
+#include "pieceavailabilitybar.hpp"
+
+#include <algorithm>
+#include <limits>
+
+#include <fmt/format.h>
+#include <wx/dcbuffer.h>
+
+#include "../translator.hpp"
+
+using pt::UI::Widgets::PieceAvailabilityBar;
+
+// availability at or above this many peers is drawn with the full colour
+static const int SaturationPeers = 10;
+
+static wxColor heat(int64_t tenths)
+{
+    static wxColor missing(217, 83, 79);
+    static wxColor bar("#35b1e1");
+
+    if (tenths <= 0)
+    {
+        return missing;
+    }
+
+    // never fully white, a piece with a single peer must still be visible
+    int64_t t = 40 + std::min<int64_t>(tenths, SaturationPeers * 10) * 215 / (SaturationPeers * 10);
+
+    return wxColor(
+        static_cast<unsigned char>(255 - (255 - bar.Red())   * t / 255),
+        static_cast<unsigned char>(255 - (255 - bar.Green()) * t / 255),
+        static_cast<unsigned char>(255 - (255 - bar.Blue())  * t / 255));
+}
+
+PieceAvailabilityBar::PieceAvailabilityBar(wxWindow* parent, wxWindowID id)
+    : wxPanel(parent, id, wxDefaultPosition, wxSize(-1, parent->FromDIP(10)), wxTAB_TRAVERSAL | wxNO_BORDER | wxBG_STYLE_PAINT),
+    m_dirtyBegin(0),
+    m_dirtyEnd(0)
+{
+    Connect(wxEVT_ERASE_BACKGROUND, wxEraseEventHandler(PieceAvailabilityBar::OnEraseBackground));
+    Connect(wxEVT_PAINT, wxPaintEventHandler(PieceAvailabilityBar::OnPaint));
+    Connect(wxEVT_SIZE, wxSizeEventHandler(PieceAvailabilityBar::OnSize));
+}
+
+void PieceAvailabilityBar::UpdateAvailability(std::vector<int> const& availability)
+{
+    bool full = availability.size() != m_availability.size();
+
+    m_previous.swap(m_availability);
+    m_availability = availability;
+
+    Reduce(full);
+}
+
+void PieceAvailabilityBar::Reduce(bool full)
+{
+    int width = std::max(this->GetClientSize().GetWidth() - 2, 0);
+    int64_t const pieces = static_cast<int64_t>(m_availability.size());
+
+    if (static_cast<int>(m_buckets.size()) != width)
+    {
+        m_buckets.assign(width, Bucket{ 0, 0, 0 });
+        full = true;
+    }
+
+    int dirtyBegin = std::numeric_limits<int>::max();
+    int dirtyEnd = -1;
+
+    if (pieces > 0)
+    {
+        for (int x = 0; x < width; x++)
+        {
+            auto begin = static_cast<size_t>(x * pieces / width);
+            auto end = std::max(begin + 1, static_cast<size_t>((x + 1) * pieces / width));
+
+            // unchanged ranges are skipped with a plain compare against the
+            // previous snapshot
+            if (!full
+                && std::equal(
+                    m_availability.begin() + begin,
+                    m_availability.begin() + end,
+                    m_previous.begin() + begin))
+            {
+                continue;
+            }
+
+            Bucket bucket{ std::numeric_limits<int>::max(), 0, static_cast<int>(end - begin) };
+
+            for (size_t i = begin; i < end; i++)
+            {
+                bucket.min = std::min(bucket.min, m_availability[i]);
+                bucket.sum += m_availability[i];
+            }
+
+            Bucket& current = m_buckets[x];
+
+            if (full
+                || current.min != bucket.min
+                || current.sum * bucket.count != bucket.sum * current.count)
+            {
+                current = bucket;
+                dirtyBegin = std::min(dirtyBegin, x);
+                dirtyEnd = std::max(dirtyEnd, x + 1);
+            }
+        }
+    }
+
+    if (full)
+    {
+        dirtyBegin = 0;
+        dirtyEnd = width;
+    }
+
+    if (dirtyEnd <= dirtyBegin)
+    {
+        return;
+    }
+
+    int rarest = std::numeric_limits<int>::max();
+    int64_t total = 0;
+
+    for (auto const& bucket : m_buckets)
+    {
+        rarest = std::min(rarest, bucket.min);
+        total += bucket.sum;
+    }
+
+    if (pieces > 0 && width > 0)
+    {
+        this->SetToolTip(
+            fmt::format(
+                i18n("piece_availability_tooltip"),
+                rarest,
+                static_cast<double>(total) / pieces));
+    }
+    else
+    {
+        this->UnsetToolTip();
+    }
+
+    if (m_dirtyEnd > m_dirtyBegin)
+    {
+        m_dirtyBegin = std::min(m_dirtyBegin, dirtyBegin);
+        m_dirtyEnd = std::max(m_dirtyEnd, dirtyEnd);
+    }
+    else
+    {
+        m_dirtyBegin = dirtyBegin;
+        m_dirtyEnd = dirtyEnd;
+    }
+
+    this->RefreshRect(
+        wxRect(
+            dirtyBegin + 1,
+            0,
+            dirtyEnd - dirtyBegin,
+            this->GetClientSize().GetHeight()));
+}
+
+void PieceAvailabilityBar::OnEraseBackground(wxEraseEvent&)
+{
+}
+
+void PieceAvailabilityBar::OnSize(wxSizeEvent&)
+{
+    Reduce(true);
+    Refresh();
+}
+
+void PieceAvailabilityBar::OnPaint(wxPaintEvent&)
+{
+    wxBufferedPaintDC dc(this);
+    RenderAvailability(dc);
+}
+
+void PieceAvailabilityBar::RenderAvailability(wxDC& dc)
+{
+    static wxColor darkBorder(50, 50, 50);
+
+    wxSize size = this->GetClientSize();
+
+    if (m_availability.empty() || m_buckets.empty())
+    {
+        dc.SetBrush(*wxWHITE);
+        dc.SetPen(wxColor(190, 190, 190));
+        dc.DrawRectangle(this->GetClientRect());
+        return;
+    }
+
+    int width = static_cast<int>(m_buckets.size());
+
+    if (!m_image.IsOk() || m_image.GetWidth() != width)
+    {
+        m_image.Create(width, 2);
+        m_dirtyBegin = 0;
+        m_dirtyEnd = width;
+    }
+
+    if (m_dirtyEnd > m_dirtyBegin)
+    {
+        // only the changed columns of the two scanlines are recoloured
+        for (int x = m_dirtyBegin; x < m_dirtyEnd; x++)
+        {
+            Bucket const& bucket = m_buckets[x];
+
+            wxColor avg = heat(bucket.count > 0 ? bucket.sum * 10 / bucket.count : 0);
+            wxColor min = heat(int64_t(bucket.min) * 10);
+
+            m_image.SetRGB(x, 0, avg.Red(), avg.Green(), avg.Blue());
+            m_image.SetRGB(x, 1, min.Red(), min.Green(), min.Blue());
+        }
+
+        m_scanlines = wxBitmap(m_image);
+        m_dirtyBegin = m_dirtyEnd = 0;
+    }
+
+    dc.SetBrush(*wxWHITE);
+    dc.SetPen(darkBorder);
+    dc.DrawRectangle({ 0, 0 }, size);
+
+    wxMemoryDC memDC(m_scanlines);
+
+    dc.StretchBlit(
+        { 1, 1 },
+        { width, size.GetHeight() - 2 },
+        &memDC,
+        { 0, 0 },
+        m_scanlines.GetSize());
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <wx/wxprec.h>
+#ifndef WX_PRECOMP
+#include <wx/wx.h>
+#endif
+
+#include <vector>
+
+namespace pt::UI::Widgets
+{
+    class PieceAvailabilityBar : public wxPanel
+    {
+    public:
+        PieceAvailabilityBar(wxWindow* parent, wxWindowID id);
+        void UpdateAvailability(std::vector<int> const& availability);
+
+    protected:
+        void OnEraseBackground(wxEraseEvent&);
+        void OnSize(wxSizeEvent&);
+        void OnPaint(wxPaintEvent&);
+
+    private:
+        struct Bucket
+        {
+            int min;
+            int64_t sum;
+            int count;
+        };
+
+        void Reduce(bool full);
+        void RenderAvailability(wxDC& dc);
+
+        std::vector<int> m_availability;
+        std::vector<int> m_previous;
+
+        // one bucket per pixel, the top half of the bar shows the average
+        // availability and the bottom half the rarest piece in the bucket
+        std::vector<Bucket> m_buckets;
+        wxImage m_image;
+        wxBitmap m_scanlines;
+        int m_dirtyBegin;
+        int m_dirtyEnd;
+    };
+}
@@ -1,23 +1,153 @@
 #include "pieceprogressbar.hpp"
 
+#include <algorithm>
+#include <limits>
+
 #include <wx/dcbuffer.h>
 
 namespace lt = libtorrent;
 using pt::UI::Widgets::PieceProgressBar;
 
+static int popcount(uint32_t v)
+{
+    v = v - ((v >> 1) & 0x55555555);
+    v = (v & 0x33333333) + ((v >> 2) & 0x33333333);
+    return static_cast<int>((((v + (v >> 4)) & 0x0F0F0F0F) * 0x01010101) >> 24);
+}
+
+// mask for bits [begin, end) where bit 0 is the most significant one
+static uint32_t rangeMask(int begin, int end)
+{
+    uint32_t head = begin == 0 ? 0xFFFFFFFF : (0xFFFFFFFF >> begin);
+    uint32_t tail = end == 32 ? 0xFFFFFFFF : ~(0xFFFFFFFF >> end);
+    return head & tail;
+}
+
 PieceProgressBar::PieceProgressBar(wxWindow* parent, wxWindowID id, lt::typed_bitfield<lt::piece_index_t> field)
     : wxPanel(parent, id, wxDefaultPosition, wxSize(-1, parent->FromDIP(15)), wxTAB_TRAVERSAL | wxNO_BORDER | wxBG_STYLE_PAINT),
-    m_bitfield(field)
+    m_pieces(0),
+    m_scanlineDirty(true)
 {
     Connect(wxEVT_ERASE_BACKGROUND, wxEraseEventHandler(PieceProgressBar::OnEraseBackground));
     Connect(wxEVT_PAINT, wxPaintEventHandler(PieceProgressBar::OnPaint));
     Connect(wxEVT_SIZE, wxSizeEventHandler(PieceProgressBar::OnSize));
+
+    UpdateBitfield(field);
 }
 
 void PieceProgressBar::UpdateBitfield(lt::typed_bitfield<lt::piece_index_t> const& field)
 {
-    m_bitfield = field;
-    Refresh();
+    int pieces = field.size();
+    size_t numWords = static_cast<size_t>((pieces + 31) / 32);
+    unsigned char const* bytes = reinterpret_cast<unsigned char const*>(field.data());
+
+    bool resized = pieces != m_pieces;
+
+    if (resized)
+    {
+        m_pieces = pieces;
+        m_words.assign(numWords, 0);
+    }
+
+    // compare word by word and only recompute the buckets covering the
+    // pieces that changed since the last update
+    int first = std::numeric_limits<int>::max();
+    int last = -1;
+
+    for (size_t i = 0; i < numWords; i++)
+    {
+        uint32_t word = (uint32_t(bytes[i * 4]) << 24)
+            | (uint32_t(bytes[i * 4 + 1]) << 16)
+            | (uint32_t(bytes[i * 4 + 2]) << 8)
+            | uint32_t(bytes[i * 4 + 3]);
+
+        if (word == m_words[i])
+        {
+            continue;
+        }
+
+        m_words[i] = word;
+
+        first = std::min(first, static_cast<int>(i * 32));
+        last = std::max(last, std::min(static_cast<int>(i * 32 + 31), m_pieces - 1));
+    }
+
+    if (resized)
+    {
+        RecomputeBuckets(0, m_pieces - 1);
+    }
+    else if (last >= 0)
+    {
+        RecomputeBuckets(first, last);
+    }
+
+    if (resized || m_scanlineDirty)
+    {
+        Refresh();
+    }
+}
+
+int PieceProgressBar::CountPieces(int begin, int end) const
+{
+    int count = 0;
+
+    while (begin < end)
+    {
+        int word = begin / 32;
+        int bit = begin % 32;
+        int stop = std::min(32, bit + (end - begin));
+
+        uint32_t value = m_words[word];
+
+        if (bit != 0 || stop != 32)
+        {
+            value &= rangeMask(bit, stop);
+        }
+
+        count += popcount(value);
+        begin += stop - bit;
+    }
+
+    return count;
+}
+
+void PieceProgressBar::RecomputeBuckets(int first, int last)
+{
+    int width = std::max(this->GetClientSize().GetWidth() - 2, 0);
+
+    if (static_cast<int>(m_buckets.size()) != width)
+    {
+        m_buckets.assign(width, 0);
+        first = 0;
+        last = m_pieces - 1;
+        m_scanlineDirty = true;
+    }
+
+    if (width == 0 || m_pieces == 0)
+    {
+        return;
+    }
+
+    // bucket x covers pieces [x * pieces / width, (x + 1) * pieces / width),
+    // and at least one piece when there are more pixels than pieces
+    int64_t const pieces = m_pieces;
+    int begin = static_cast<int>(std::max<int64_t>(0, first * int64_t(width) / pieces - 1));
+    int end = static_cast<int>(std::min<int64_t>(width, (last + 1) * int64_t(width) / pieces + 1));
+
+    for (int x = begin; x < end; x++)
+    {
+        int pieceBegin = static_cast<int>(x * pieces / width);
+        int pieceEnd = std::max(pieceBegin + 1, static_cast<int>((x + 1) * pieces / width));
+
+        uint8_t coverage = static_cast<uint8_t>(
+            CountPieces(pieceBegin, pieceEnd) * 255 / (pieceEnd - pieceBegin));
+
+        if (m_buckets[x] != coverage)
+        {
+            m_buckets[x] = coverage;
+            m_scanlineDirty = true;
+        }
+    }
 }
 
 void PieceProgressBar::OnEraseBackground(wxEraseEvent&)
@@ -26,6 +156,7 @@ void PieceProgressBar::OnEraseBackground(wxEraseEvent&)
 
 void PieceProgressBar::OnSize(wxSizeEvent&)
 {
+    RecomputeBuckets(0, m_pieces - 1);
     Refresh();
 }
 
@@ -40,34 +171,41 @@ void PieceProgressBar::RenderProgress(wxDC& dc)
     static wxColor bar("#35b1e1");
     static wxColor darkBorder(50, 50, 50);
 
-    if (m_bitfield.size() > 0)
+    if (m_pieces > 0 && !m_buckets.empty())
     {
-        wxBitmap prg(m_bitfield.size() + 2, this->GetClientSize().GetHeight());
-        wxMemoryDC memDC;
-
-        memDC.SelectObject(prg);
-        memDC.SetBrush(*wxWHITE);
-        memDC.SetPen(darkBorder);
-        memDC.DrawRectangle({ 0, 0 }, prg.GetSize());
-
-        memDC.SetPen(bar);
-
-        for (int idx = 0; idx < m_bitfield.size(); idx++)
+        if (m_scanlineDirty)
         {
-            lt::piece_index_t pcs{ idx };
+            // one pixel high image where each pixel is blended between
+            // white and the bar colour by its bucket coverage
+            wxImage line(static_cast<int>(m_buckets.size()), 1);
+            unsigned char* rgb = line.GetData();
 
-            if (m_bitfield[pcs])
+            for (size_t x = 0; x < m_buckets.size(); x++)
             {
-                memDC.DrawLine(idx + 1, 1, idx + 1, prg.GetHeight() - 1);
+                int c = m_buckets[x];
+                rgb[x * 3]     = static_cast<unsigned char>(255 - (255 - bar.Red())   * c / 255);
+                rgb[x * 3 + 1] = static_cast<unsigned char>(255 - (255 - bar.Green()) * c / 255);
+                rgb[x * 3 + 2] = static_cast<unsigned char>(255 - (255 - bar.Blue())  * c / 255);
             }
+
+            m_scanline = wxBitmap(line);
+            m_scanlineDirty = false;
         }
 
+        wxSize size = this->GetClientSize();
+
+        dc.SetBrush(*wxWHITE);
+        dc.SetPen(darkBorder);
+        dc.DrawRectangle({ 0, 0 }, size);
+
+        wxMemoryDC memDC(m_scanline);
+
         dc.StretchBlit(
-            { 0, 0 },
-            this->GetClientSize(),
+            { 1, 1 },
+            { m_scanline.GetWidth(), size.GetHeight() - 2 },
             &memDC,
             { 0, 0 },
-            prg.GetSize());
+            m_scanline.GetSize());
     }
     else
     {
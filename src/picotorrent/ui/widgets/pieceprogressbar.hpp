@@ -5,6 +5,8 @@
 #include <wx/wx.h>
 #endif
 
+#include <vector>
+
 #include <libtorrent/bitfield.hpp>
 #include <libtorrent/fwd.hpp>
 
@@ -22,8 +24,18 @@ namespace pt::UI::Widgets
         void OnPaint(wxPaintEvent&);
 
     private:
+        int CountPieces(int begin, int end) const;
+        void RecomputeBuckets(int first, int last);
         void RenderProgress(wxDC& dc);
 
-        libtorrent::typed_bitfield<libtorrent::piece_index_t> m_bitfield;
+        // the bitfield is kept as host order words with the first piece in
+        // the most significant bit, so ranges can be counted a word at a time
+        std::vector<uint32_t> m_words;
+        int m_pieces;
+
+        // one bucket per pixel, holding the share of its pieces we have
+        std::vector<uint8_t> m_buckets;
+        wxBitmap m_scanline;
+        bool m_scanlineDirty;
     };
 }
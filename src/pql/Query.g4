@@ -1,7 +1,16 @@
 grammar Query;
 
+// reference grammar - the parser in queryparser.cpp is hand-written
+
 AND         : 'and';
 OR          : 'or';
+ORDER       : 'order';
+BY          : 'by';
+ASC         : 'asc';
+DESC        : 'desc';
+LIMIT       : 'limit';
+WHERE       : 'where';
+GROUP       : 'group';
 
 // comparison operators
 EQ          : '=';
@@ -16,13 +25,34 @@ INT         : '-'? [0-9]+ ;
 FLOAT       : '-'? [0-9]+'.'[0-9]+;
 STRING      : '"' .*? '"';
 
-UNIT_SIZE   : 'kb' | 'mb' | 'gb';
-UNIT_SPEED  : 'kbps' | 'mbps' | 'gbps';
+UNIT_SIZE   : 'b' | 'kb' | 'mb' | 'gb';
+UNIT_SPEED  : 'bps' | 'kbps' | 'mbps' | 'gbps';
 
 ID          : [a-zA-Z]+;
 
+query
+    : aggregateQuery EOF
+    | filter EOF
+    ;
+
 filter
-    : expression
+    : expression? orderBy? limit?
+    ;
+
+orderBy
+    : ORDER BY ID (ASC | DESC)?
+    ;
+
+limit
+    : LIMIT INT
+    ;
+
+aggregateQuery
+    : aggregate (',' aggregate)* (WHERE expression)? (GROUP? BY ID)?
+    ;
+
+aggregate
+    : ID '(' ID? ')'
     ;
 
 expression
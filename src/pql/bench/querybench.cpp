@@ -0,0 +1,115 @@
+#include <iterator>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <queryparser.hpp>
+
+#include "torrentgenerator.hpp"
+
+using pt::PQL::QueryParser;
+using pt::PQL::Tests::GenerateTorrents;
+using pt::PQL::Tests::IndexNames;
+using pt::PQL::Tests::QueryCompiler;
+using pt::PQL::Tests::TorrentStatus;
+using pt::PQL::Tests::TrigramIndex;
+
+static const char* Queries[] =
+{
+    // numeric only
+    "size > 1 gb and dl > 100 kbps",
+    // string compares, nothing for the index
+    "savepath ~ \"seeding\" or label = \"Linux\"",
+    // answered by the name index first
+    "name ~ \"bunny\" and progress = 100",
+    // a bit of everything
+    "status = \"seeding\" and ratio < 1 or name ~ \"ubuntu\" and size > 500 mb or ul > 1 mbps",
+};
+
+static std::vector<TorrentStatus> const& Torrents(int64_t count)
+{
+    static std::map<int64_t, std::vector<TorrentStatus>> torrents;
+
+    auto iter = torrents.find(count);
+
+    if (iter == torrents.end())
+    {
+        iter = torrents.insert({ count, GenerateTorrents(static_cast<size_t>(count)) }).first;
+    }
+
+    return iter->second;
+}
+
+static void BM_Parse(benchmark::State& state)
+{
+    std::string query = Queries[state.range(0)];
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(QueryParser::Parse(query));
+    }
+
+    state.SetLabel(query);
+}
+
+static void BM_ParseAndCompile(benchmark::State& state)
+{
+    std::string query = Queries[state.range(0)];
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(QueryCompiler::CompileFilter(QueryParser::Parse(query).filter));
+    }
+
+    state.SetLabel(query);
+}
+
+// what TorrentListModel does on every refresh: narrow with the name index
+// when the query allows it, then check each remaining torrent
+static void BM_Evaluate(benchmark::State& state)
+{
+    std::string query = Queries[state.range(0)];
+    auto const& torrents = Torrents(state.range(1));
+    TrigramIndex index = IndexNames(torrents);
+
+    auto compiled = QueryCompiler::CompileFilter(QueryParser::Parse(query).filter);
+    size_t matches = 0;
+
+    for (auto _ : state)
+    {
+        matches = 0;
+
+        auto candidates = compiled.candidates
+            ? compiled.candidates(index)
+            : std::nullopt;
+
+        if (candidates.has_value())
+        {
+            for (uint32_t id : candidates.value())
+            {
+                if (compiled.filter(torrents[index.Key(id)])) { matches++; }
+            }
+        }
+        else
+        {
+            for (TorrentStatus const& ts : torrents)
+            {
+                if (compiled.filter(ts)) { matches++; }
+            }
+        }
+
+        benchmark::DoNotOptimize(matches);
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(torrents.size()));
+    state.counters["matches"] = static_cast<double>(matches);
+    state.SetLabel(query);
+}
+
+BENCHMARK(BM_Parse)->DenseRange(0, std::size(Queries) - 1);
+BENCHMARK(BM_ParseAndCompile)->DenseRange(0, std::size(Queries) - 1);
+
+BENCHMARK(BM_Evaluate)
+    ->ArgsProduct({ benchmark::CreateDenseRange(0, std::size(Queries) - 1, 1), { 1000, 10000, 100000 } })
+    ->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,117 @@
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "torrentgenerator.hpp"
+
+using pt::PQL::Tests::GenerateTorrents;
+using pt::PQL::Tests::IndexNames;
+using pt::PQL::Tests::TorrentStatus;
+using pt::PQL::Tests::TrigramIndex;
+using pt::PQL::TrigramText;
+
+static const char* Needles[] =
+{
+    // in a large share of the names
+    "x264",
+    // in a few hundred of them
+    "sintel.tears",
+    // in none
+    "no such torrent",
+};
+
+static std::vector<TorrentStatus> const& Torrents()
+{
+    static std::vector<TorrentStatus> torrents = GenerateTorrents(100000);
+    return torrents;
+}
+
+static void BM_TrigramBuild(benchmark::State& state)
+{
+    auto const& torrents = Torrents();
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(IndexNames(torrents));
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(torrents.size()));
+}
+
+// the refresh path, where almost every name is unchanged
+static void BM_TrigramUpdateUnchanged(benchmark::State& state)
+{
+    auto const& torrents = Torrents();
+    TrigramIndex index = IndexNames(torrents);
+
+    for (auto _ : state)
+    {
+        for (uint32_t i = 0; i < torrents.size(); i++)
+        {
+            index.Update(i, torrents[i].name);
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(torrents.size()));
+}
+
+static void BM_TrigramRename(benchmark::State& state)
+{
+    auto const& torrents = Torrents();
+    TrigramIndex index = IndexNames(torrents);
+    uint32_t i = 0;
+
+    for (auto _ : state)
+    {
+        index.Update(i, torrents[(i + 1) % torrents.size()].name);
+        i = (i + 7919) % torrents.size();
+    }
+}
+
+static void BM_TrigramQuery(benchmark::State& state)
+{
+    std::string needle = Needles[state.range(0)];
+    TrigramIndex index = IndexNames(Torrents());
+    size_t matches = 0;
+
+    for (auto _ : state)
+    {
+        auto result = index.Query(needle);
+        matches = result->size();
+        benchmark::DoNotOptimize(result);
+    }
+
+    state.counters["candidates"] = static_cast<double>(matches);
+    state.SetLabel(needle);
+}
+
+// what '~' costs without the index
+static void BM_LinearScan(benchmark::State& state)
+{
+    std::string needle = TrigramText::Normalize(Needles[state.range(0)]);
+    auto const& torrents = Torrents();
+    size_t matches = 0;
+
+    for (auto _ : state)
+    {
+        matches = 0;
+
+        for (TorrentStatus const& ts : torrents)
+        {
+            if (TrigramText::Contains(ts.name, needle)) { matches++; }
+        }
+
+        benchmark::DoNotOptimize(matches);
+    }
+
+    state.counters["matches"] = static_cast<double>(matches);
+    state.SetLabel(needle);
+}
+
+BENCHMARK(BM_TrigramBuild)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_TrigramUpdateUnchanged)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_TrigramRename);
+BENCHMARK(BM_TrigramQuery)->DenseRange(0, std::size(Needles) - 1)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_LinearScan)->DenseRange(0, std::size(Needles) - 1)->Unit(benchmark::kMicrosecond);
@@ -1,9 +0,0 @@
-
-// Generated from .\Query.g4 by ANTLR 4.9
-
-
-#include "QueryBaseVisitor.h"
-
-
-using namespace pt::PQL;
-
@@ -1,201 +0,0 @@
-
-// Generated from .\Query.g4 by ANTLR 4.9
-
-
-#include "QueryLexer.h"
-
-
-using namespace antlr4;
-
-using namespace pt::PQL;
-
-QueryLexer::QueryLexer(CharStream *input) : Lexer(input) {
-  _interpreter = new atn::LexerATNSimulator(this, _atn, _decisionToDFA, _sharedContextCache);
-}
-
-QueryLexer::~QueryLexer() {
-  delete _interpreter;
-}
-
-std::string QueryLexer::getGrammarFileName() const {
-  return "Query.g4";
-}
-
-const std::vector<std::string>& QueryLexer::getRuleNames() const {
-  return _ruleNames;
-}
-
-const std::vector<std::string>& QueryLexer::getChannelNames() const {
-  return _channelNames;
-}
-
-const std::vector<std::string>& QueryLexer::getModeNames() const {
-  return _modeNames;
-}
-
-const std::vector<std::string>& QueryLexer::getTokenNames() const {
-  return _tokenNames;
-}
-
-dfa::Vocabulary& QueryLexer::getVocabulary() const {
-  return _vocabulary;
-}
-
-const std::vector<uint16_t> QueryLexer::getSerializedATN() const {
-  return _serializedATN;
-}
-
-const atn::ATN& QueryLexer::getATN() const {
-  return _atn;
-}
-
-
-
-
-// Static vars and initialization.
-std::vector<dfa::DFA> QueryLexer::_decisionToDFA;
-atn::PredictionContextCache QueryLexer::_sharedContextCache;
-
-// We own the ATN which in turn owns the ATN states.
-atn::ATN QueryLexer::_atn;
-std::vector<uint16_t> QueryLexer::_serializedATN;
-
-std::vector<std::string> QueryLexer::_ruleNames = {
-  "AND", "OR", "EQ", "CONTAINS", "GT", "GTE", "LT", "LTE", "WS", "INT", 
-  "FLOAT", "STRING", "UNIT_SIZE", "UNIT_SPEED", "ID"
-};
-
-std::vector<std::string> QueryLexer::_channelNames = {
-  "DEFAULT_TOKEN_CHANNEL", "HIDDEN"
-};
-
-std::vector<std::string> QueryLexer::_modeNames = {
-  "DEFAULT_MODE"
-};
-
-std::vector<std::string> QueryLexer::_literalNames = {
-  "", "'and'", "'or'", "'='", "'~'", "'>'", "'>='", "'<'", "'<='"
-};
-
-std::vector<std::string> QueryLexer::_symbolicNames = {
-  "", "AND", "OR", "EQ", "CONTAINS", "GT", "GTE", "LT", "LTE", "WS", "INT", 
-  "FLOAT", "STRING", "UNIT_SIZE", "UNIT_SPEED", "ID"
-};
-
-dfa::Vocabulary QueryLexer::_vocabulary(_literalNames, _symbolicNames);
-
-std::vector<std::string> QueryLexer::_tokenNames;
-
-QueryLexer::Initializer::Initializer() {
-  // This code could be in a static initializer lambda, but VS doesn't allow access to private class members from there.
-	for (size_t i = 0; i < _symbolicNames.size(); ++i) {
-		std::string name = _vocabulary.getLiteralName(i);
-		if (name.empty()) {
-			name = _vocabulary.getSymbolicName(i);
-		}
-
-		if (name.empty()) {
-			_tokenNames.push_back("<INVALID>");
-		} else {
-      _tokenNames.push_back(name);
-    }
-	}
-
-  _serializedATN = {
-    0x3, 0x608b, 0xa72a, 0x8133, 0xb9ed, 0x417c, 0x3be7, 0x7786, 0x5964, 
-    0x2, 0x11, 0x77, 0x8, 0x1, 0x4, 0x2, 0x9, 0x2, 0x4, 0x3, 0x9, 0x3, 0x4, 
-    0x4, 0x9, 0x4, 0x4, 0x5, 0x9, 0x5, 0x4, 0x6, 0x9, 0x6, 0x4, 0x7, 0x9, 
-    0x7, 0x4, 0x8, 0x9, 0x8, 0x4, 0x9, 0x9, 0x9, 0x4, 0xa, 0x9, 0xa, 0x4, 
-    0xb, 0x9, 0xb, 0x4, 0xc, 0x9, 0xc, 0x4, 0xd, 0x9, 0xd, 0x4, 0xe, 0x9, 
-    0xe, 0x4, 0xf, 0x9, 0xf, 0x4, 0x10, 0x9, 0x10, 0x3, 0x2, 0x3, 0x2, 0x3, 
-    0x2, 0x3, 0x2, 0x3, 0x3, 0x3, 0x3, 0x3, 0x3, 0x3, 0x4, 0x3, 0x4, 0x3, 
-    0x5, 0x3, 0x5, 0x3, 0x6, 0x3, 0x6, 0x3, 0x7, 0x3, 0x7, 0x3, 0x7, 0x3, 
-    0x8, 0x3, 0x8, 0x3, 0x9, 0x3, 0x9, 0x3, 0x9, 0x3, 0xa, 0x6, 0xa, 0x38, 
-    0xa, 0xa, 0xd, 0xa, 0xe, 0xa, 0x39, 0x3, 0xa, 0x3, 0xa, 0x3, 0xb, 0x5, 
-    0xb, 0x3f, 0xa, 0xb, 0x3, 0xb, 0x6, 0xb, 0x42, 0xa, 0xb, 0xd, 0xb, 0xe, 
-    0xb, 0x43, 0x3, 0xc, 0x5, 0xc, 0x47, 0xa, 0xc, 0x3, 0xc, 0x6, 0xc, 0x4a, 
-    0xa, 0xc, 0xd, 0xc, 0xe, 0xc, 0x4b, 0x3, 0xc, 0x3, 0xc, 0x6, 0xc, 0x50, 
-    0xa, 0xc, 0xd, 0xc, 0xe, 0xc, 0x51, 0x3, 0xd, 0x3, 0xd, 0x7, 0xd, 0x56, 
-    0xa, 0xd, 0xc, 0xd, 0xe, 0xd, 0x59, 0xb, 0xd, 0x3, 0xd, 0x3, 0xd, 0x3, 
-    0xe, 0x3, 0xe, 0x3, 0xe, 0x3, 0xe, 0x3, 0xe, 0x3, 0xe, 0x5, 0xe, 0x63, 
-    0xa, 0xe, 0x3, 0xf, 0x3, 0xf, 0x3, 0xf, 0x3, 0xf, 0x3, 0xf, 0x3, 0xf, 
-    0x3, 0xf, 0x3, 0xf, 0x3, 0xf, 0x3, 0xf, 0x3, 0xf, 0x3, 0xf, 0x5, 0xf, 
-    0x71, 0xa, 0xf, 0x3, 0x10, 0x6, 0x10, 0x74, 0xa, 0x10, 0xd, 0x10, 0xe, 
-    0x10, 0x75, 0x3, 0x57, 0x2, 0x11, 0x3, 0x3, 0x5, 0x4, 0x7, 0x5, 0x9, 
-    0x6, 0xb, 0x7, 0xd, 0x8, 0xf, 0x9, 0x11, 0xa, 0x13, 0xb, 0x15, 0xc, 
-    0x17, 0xd, 0x19, 0xe, 0x1b, 0xf, 0x1d, 0x10, 0x1f, 0x11, 0x3, 0x2, 0x5, 
-    0x5, 0x2, 0xb, 0xc, 0xf, 0xf, 0x22, 0x22, 0x3, 0x2, 0x32, 0x3b, 0x4, 
-    0x2, 0x43, 0x5c, 0x63, 0x7c, 0x2, 0x82, 0x2, 0x3, 0x3, 0x2, 0x2, 0x2, 
-    0x2, 0x5, 0x3, 0x2, 0x2, 0x2, 0x2, 0x7, 0x3, 0x2, 0x2, 0x2, 0x2, 0x9, 
-    0x3, 0x2, 0x2, 0x2, 0x2, 0xb, 0x3, 0x2, 0x2, 0x2, 0x2, 0xd, 0x3, 0x2, 
-    0x2, 0x2, 0x2, 0xf, 0x3, 0x2, 0x2, 0x2, 0x2, 0x11, 0x3, 0x2, 0x2, 0x2, 
-    0x2, 0x13, 0x3, 0x2, 0x2, 0x2, 0x2, 0x15, 0x3, 0x2, 0x2, 0x2, 0x2, 0x17, 
-    0x3, 0x2, 0x2, 0x2, 0x2, 0x19, 0x3, 0x2, 0x2, 0x2, 0x2, 0x1b, 0x3, 0x2, 
-    0x2, 0x2, 0x2, 0x1d, 0x3, 0x2, 0x2, 0x2, 0x2, 0x1f, 0x3, 0x2, 0x2, 0x2, 
-    0x3, 0x21, 0x3, 0x2, 0x2, 0x2, 0x5, 0x25, 0x3, 0x2, 0x2, 0x2, 0x7, 0x28, 
-    0x3, 0x2, 0x2, 0x2, 0x9, 0x2a, 0x3, 0x2, 0x2, 0x2, 0xb, 0x2c, 0x3, 0x2, 
-    0x2, 0x2, 0xd, 0x2e, 0x3, 0x2, 0x2, 0x2, 0xf, 0x31, 0x3, 0x2, 0x2, 0x2, 
-    0x11, 0x33, 0x3, 0x2, 0x2, 0x2, 0x13, 0x37, 0x3, 0x2, 0x2, 0x2, 0x15, 
-    0x3e, 0x3, 0x2, 0x2, 0x2, 0x17, 0x46, 0x3, 0x2, 0x2, 0x2, 0x19, 0x53, 
-    0x3, 0x2, 0x2, 0x2, 0x1b, 0x62, 0x3, 0x2, 0x2, 0x2, 0x1d, 0x70, 0x3, 
-    0x2, 0x2, 0x2, 0x1f, 0x73, 0x3, 0x2, 0x2, 0x2, 0x21, 0x22, 0x7, 0x63, 
-    0x2, 0x2, 0x22, 0x23, 0x7, 0x70, 0x2, 0x2, 0x23, 0x24, 0x7, 0x66, 0x2, 
-    0x2, 0x24, 0x4, 0x3, 0x2, 0x2, 0x2, 0x25, 0x26, 0x7, 0x71, 0x2, 0x2, 
-    0x26, 0x27, 0x7, 0x74, 0x2, 0x2, 0x27, 0x6, 0x3, 0x2, 0x2, 0x2, 0x28, 
-    0x29, 0x7, 0x3f, 0x2, 0x2, 0x29, 0x8, 0x3, 0x2, 0x2, 0x2, 0x2a, 0x2b, 
-    0x7, 0x80, 0x2, 0x2, 0x2b, 0xa, 0x3, 0x2, 0x2, 0x2, 0x2c, 0x2d, 0x7, 
-    0x40, 0x2, 0x2, 0x2d, 0xc, 0x3, 0x2, 0x2, 0x2, 0x2e, 0x2f, 0x7, 0x40, 
-    0x2, 0x2, 0x2f, 0x30, 0x7, 0x3f, 0x2, 0x2, 0x30, 0xe, 0x3, 0x2, 0x2, 
-    0x2, 0x31, 0x32, 0x7, 0x3e, 0x2, 0x2, 0x32, 0x10, 0x3, 0x2, 0x2, 0x2, 
-    0x33, 0x34, 0x7, 0x3e, 0x2, 0x2, 0x34, 0x35, 0x7, 0x3f, 0x2, 0x2, 0x35, 
-    0x12, 0x3, 0x2, 0x2, 0x2, 0x36, 0x38, 0x9, 0x2, 0x2, 0x2, 0x37, 0x36, 
-    0x3, 0x2, 0x2, 0x2, 0x38, 0x39, 0x3, 0x2, 0x2, 0x2, 0x39, 0x37, 0x3, 
-    0x2, 0x2, 0x2, 0x39, 0x3a, 0x3, 0x2, 0x2, 0x2, 0x3a, 0x3b, 0x3, 0x2, 
-    0x2, 0x2, 0x3b, 0x3c, 0x8, 0xa, 0x2, 0x2, 0x3c, 0x14, 0x3, 0x2, 0x2, 
-    0x2, 0x3d, 0x3f, 0x7, 0x2f, 0x2, 0x2, 0x3e, 0x3d, 0x3, 0x2, 0x2, 0x2, 
-    0x3e, 0x3f, 0x3, 0x2, 0x2, 0x2, 0x3f, 0x41, 0x3, 0x2, 0x2, 0x2, 0x40, 
-    0x42, 0x9, 0x3, 0x2, 0x2, 0x41, 0x40, 0x3, 0x2, 0x2, 0x2, 0x42, 0x43, 
-    0x3, 0x2, 0x2, 0x2, 0x43, 0x41, 0x3, 0x2, 0x2, 0x2, 0x43, 0x44, 0x3, 
-    0x2, 0x2, 0x2, 0x44, 0x16, 0x3, 0x2, 0x2, 0x2, 0x45, 0x47, 0x7, 0x2f, 
-    0x2, 0x2, 0x46, 0x45, 0x3, 0x2, 0x2, 0x2, 0x46, 0x47, 0x3, 0x2, 0x2, 
-    0x2, 0x47, 0x49, 0x3, 0x2, 0x2, 0x2, 0x48, 0x4a, 0x9, 0x3, 0x2, 0x2, 
-    0x49, 0x48, 0x3, 0x2, 0x2, 0x2, 0x4a, 0x4b, 0x3, 0x2, 0x2, 0x2, 0x4b, 
-    0x49, 0x3, 0x2, 0x2, 0x2, 0x4b, 0x4c, 0x3, 0x2, 0x2, 0x2, 0x4c, 0x4d, 
-    0x3, 0x2, 0x2, 0x2, 0x4d, 0x4f, 0x7, 0x30, 0x2, 0x2, 0x4e, 0x50, 0x9, 
-    0x3, 0x2, 0x2, 0x4f, 0x4e, 0x3, 0x2, 0x2, 0x2, 0x50, 0x51, 0x3, 0x2, 
-    0x2, 0x2, 0x51, 0x4f, 0x3, 0x2, 0x2, 0x2, 0x51, 0x52, 0x3, 0x2, 0x2, 
-    0x2, 0x52, 0x18, 0x3, 0x2, 0x2, 0x2, 0x53, 0x57, 0x7, 0x24, 0x2, 0x2, 
-    0x54, 0x56, 0xb, 0x2, 0x2, 0x2, 0x55, 0x54, 0x3, 0x2, 0x2, 0x2, 0x56, 
-    0x59, 0x3, 0x2, 0x2, 0x2, 0x57, 0x58, 0x3, 0x2, 0x2, 0x2, 0x57, 0x55, 
-    0x3, 0x2, 0x2, 0x2, 0x58, 0x5a, 0x3, 0x2, 0x2, 0x2, 0x59, 0x57, 0x3, 
-    0x2, 0x2, 0x2, 0x5a, 0x5b, 0x7, 0x24, 0x2, 0x2, 0x5b, 0x1a, 0x3, 0x2, 
-    0x2, 0x2, 0x5c, 0x5d, 0x7, 0x6d, 0x2, 0x2, 0x5d, 0x63, 0x7, 0x64, 0x2, 
-    0x2, 0x5e, 0x5f, 0x7, 0x6f, 0x2, 0x2, 0x5f, 0x63, 0x7, 0x64, 0x2, 0x2, 
-    0x60, 0x61, 0x7, 0x69, 0x2, 0x2, 0x61, 0x63, 0x7, 0x64, 0x2, 0x2, 0x62, 
-    0x5c, 0x3, 0x2, 0x2, 0x2, 0x62, 0x5e, 0x3, 0x2, 0x2, 0x2, 0x62, 0x60, 
-    0x3, 0x2, 0x2, 0x2, 0x63, 0x1c, 0x3, 0x2, 0x2, 0x2, 0x64, 0x65, 0x7, 
-    0x6d, 0x2, 0x2, 0x65, 0x66, 0x7, 0x64, 0x2, 0x2, 0x66, 0x67, 0x7, 0x72, 
-    0x2, 0x2, 0x67, 0x71, 0x7, 0x75, 0x2, 0x2, 0x68, 0x69, 0x7, 0x6f, 0x2, 
-    0x2, 0x69, 0x6a, 0x7, 0x64, 0x2, 0x2, 0x6a, 0x6b, 0x7, 0x72, 0x2, 0x2, 
-    0x6b, 0x71, 0x7, 0x75, 0x2, 0x2, 0x6c, 0x6d, 0x7, 0x69, 0x2, 0x2, 0x6d, 
-    0x6e, 0x7, 0x64, 0x2, 0x2, 0x6e, 0x6f, 0x7, 0x72, 0x2, 0x2, 0x6f, 0x71, 
-    0x7, 0x75, 0x2, 0x2, 0x70, 0x64, 0x3, 0x2, 0x2, 0x2, 0x70, 0x68, 0x3, 
-    0x2, 0x2, 0x2, 0x70, 0x6c, 0x3, 0x2, 0x2, 0x2, 0x71, 0x1e, 0x3, 0x2, 
-    0x2, 0x2, 0x72, 0x74, 0x9, 0x4, 0x2, 0x2, 0x73, 0x72, 0x3, 0x2, 0x2, 
-    0x2, 0x74, 0x75, 0x3, 0x2, 0x2, 0x2, 0x75, 0x73, 0x3, 0x2, 0x2, 0x2, 
-    0x75, 0x76, 0x3, 0x2, 0x2, 0x2, 0x76, 0x20, 0x3, 0x2, 0x2, 0x2, 0xd, 
-    0x2, 0x39, 0x3e, 0x43, 0x46, 0x4b, 0x51, 0x57, 0x62, 0x70, 0x75, 0x3, 
-    0x8, 0x2, 0x2, 
-  };
-
-  atn::ATNDeserializer deserializer;
-  _atn = deserializer.deserialize(_serializedATN);
-
-  size_t count = _atn.getNumberOfDecisions();
-  _decisionToDFA.reserve(count);
-  for (size_t i = 0; i < count; i++) { 
-    _decisionToDFA.emplace_back(_atn.getDecisionState(i), i);
-  }
-}
-
-QueryLexer::Initializer QueryLexer::_init;
@@ -1,200 +0,0 @@
-
-// Generated from .\Query.g4 by ANTLR 4.9
-
-#pragma once
-
-
-#include "antlr4-runtime.h"
-
-
-namespace pt::PQL {
-
-
-class  QueryParser : public antlr4::Parser {
-public:
-  enum {
-    AND = 1, OR = 2, EQ = 3, CONTAINS = 4, GT = 5, GTE = 6, LT = 7, LTE = 8, 
-    WS = 9, INT = 10, FLOAT = 11, STRING = 12, UNIT_SIZE = 13, UNIT_SPEED = 14, 
-    ID = 15
-  };
-
-  enum {
-    RuleFilter = 0, RuleExpression = 1, RuleReference = 2, RulePredicate = 3, 
-    RuleOper = 4, RuleValue = 5
-  };
-
-  explicit QueryParser(antlr4::TokenStream *input);
-  ~QueryParser();
-
-  virtual std::string getGrammarFileName() const override;
-  virtual const antlr4::atn::ATN& getATN() const override { return _atn; };
-  virtual const std::vector<std::string>& getTokenNames() const override { return _tokenNames; }; // deprecated: use vocabulary instead.
-  virtual const std::vector<std::string>& getRuleNames() const override;
-  virtual antlr4::dfa::Vocabulary& getVocabulary() const override;
-
-
-  class FilterContext;
-  class ExpressionContext;
-  class ReferenceContext;
-  class PredicateContext;
-  class OperContext;
-  class ValueContext; 
-
-  class  FilterContext : public antlr4::ParserRuleContext {
-  public:
-    FilterContext(antlr4::ParserRuleContext *parent, size_t invokingState);
-    virtual size_t getRuleIndex() const override;
-    ExpressionContext *expression();
-
-
-    virtual antlrcpp::Any accept(antlr4::tree::ParseTreeVisitor *visitor) override;
-   
-  };
-
-  FilterContext* filter();
-
-  class  ExpressionContext : public antlr4::ParserRuleContext {
-  public:
-    ExpressionContext(antlr4::ParserRuleContext *parent, size_t invokingState);
-   
-    ExpressionContext() = default;
-    void copyFrom(ExpressionContext *context);
-    using antlr4::ParserRuleContext::copyFrom;
-
-    virtual size_t getRuleIndex() const override;
-
-   
-  };
-
-  class  AndExpressionContext : public ExpressionContext {
-  public:
-    AndExpressionContext(ExpressionContext *ctx);
-
-    std::vector<ExpressionContext *> expression();
-    ExpressionContext* expression(size_t i);
-    antlr4::tree::TerminalNode *AND();
-
-    virtual antlrcpp::Any accept(antlr4::tree::ParseTreeVisitor *visitor) override;
-  };
-
-  class  PredicateExpressionContext : public ExpressionContext {
-  public:
-    PredicateExpressionContext(ExpressionContext *ctx);
-
-    PredicateContext *predicate();
-
-    virtual antlrcpp::Any accept(antlr4::tree::ParseTreeVisitor *visitor) override;
-  };
-
-  class  OrExpressionContext : public ExpressionContext {
-  public:
-    OrExpressionContext(ExpressionContext *ctx);
-
-    std::vector<ExpressionContext *> expression();
-    ExpressionContext* expression(size_t i);
-    antlr4::tree::TerminalNode *OR();
-
-    virtual antlrcpp::Any accept(antlr4::tree::ParseTreeVisitor *visitor) override;
-  };
-
-  ExpressionContext* expression();
-  ExpressionContext* expression(int precedence);
-  class  ReferenceContext : public antlr4::ParserRuleContext {
-  public:
-    ReferenceContext(antlr4::ParserRuleContext *parent, size_t invokingState);
-    virtual size_t getRuleIndex() const override;
-    antlr4::tree::TerminalNode *ID();
-
-
-    virtual antlrcpp::Any accept(antlr4::tree::ParseTreeVisitor *visitor) override;
-   
-  };
-
-  ReferenceContext* reference();
-
-  class  PredicateContext : public antlr4::ParserRuleContext {
-  public:
-    PredicateContext(antlr4::ParserRuleContext *parent, size_t invokingState);
-   
-    PredicateContext() = default;
-    void copyFrom(PredicateContext *context);
-    using antlr4::ParserRuleContext::copyFrom;
-
-    virtual size_t getRuleIndex() const override;
-
-   
-  };
-
-  class  OperatorPredicateContext : public PredicateContext {
-  public:
-    OperatorPredicateContext(PredicateContext *ctx);
-
-    ReferenceContext *reference();
-    OperContext *oper();
-    ValueContext *value();
-
-    virtual antlrcpp::Any accept(antlr4::tree::ParseTreeVisitor *visitor) override;
-  };
-
-  PredicateContext* predicate();
-
-  class  OperContext : public antlr4::ParserRuleContext {
-  public:
-    OperContext(antlr4::ParserRuleContext *parent, size_t invokingState);
-    virtual size_t getRuleIndex() const override;
-    antlr4::tree::TerminalNode *EQ();
-    antlr4::tree::TerminalNode *CONTAINS();
-    antlr4::tree::TerminalNode *GT();
-    antlr4::tree::TerminalNode *GTE();
-    antlr4::tree::TerminalNode *LT();
-    antlr4::tree::TerminalNode *LTE();
-
-
-    virtual antlrcpp::Any accept(antlr4::tree::ParseTreeVisitor *visitor) override;
-   
-  };
-
-  OperContext* oper();
-
-  class  ValueContext : public antlr4::ParserRuleContext {
-  public:
-    ValueContext(antlr4::ParserRuleContext *parent, size_t invokingState);
-    virtual size_t getRuleIndex() const override;
-    antlr4::tree::TerminalNode *INT();
-    antlr4::tree::TerminalNode *WS();
-    antlr4::tree::TerminalNode *UNIT_SIZE();
-    antlr4::tree::TerminalNode *UNIT_SPEED();
-    antlr4::tree::TerminalNode *FLOAT();
-    antlr4::tree::TerminalNode *STRING();
-
-
-    virtual antlrcpp::Any accept(antlr4::tree::ParseTreeVisitor *visitor) override;
-   
-  };
-
-  ValueContext* value();
-
-
-  virtual bool sempred(antlr4::RuleContext *_localctx, size_t ruleIndex, size_t predicateIndex) override;
-  bool expressionSempred(ExpressionContext *_localctx, size_t predicateIndex);
-
-private:
-  static std::vector<antlr4::dfa::DFA> _decisionToDFA;
-  static antlr4::atn::PredictionContextCache _sharedContextCache;
-  static std::vector<std::string> _ruleNames;
-  static std::vector<std::string> _tokenNames;
-
-  static std::vector<std::string> _literalNames;
-  static std::vector<std::string> _symbolicNames;
-  static antlr4::dfa::Vocabulary _vocabulary;
-  static antlr4::atn::ATN _atn;
-  static std::vector<uint16_t> _serializedATN;
-
-
-  struct Initializer {
-    Initializer();
-  };
-  static Initializer _init;
-};
-
-}  // namespace pt::PQL
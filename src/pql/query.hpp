@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace pt::PQL
+{
+    struct Position
+    {
+        size_t line;
+        size_t column;
+    };
+
+    enum class Operator
+    {
+        Contains,
+        Eq,
+        Gt,
+        Gte,
+        Lt,
+        Lte,
+    };
+
+    struct Value
+    {
+        std::optional<int64_t> intValue;
+        std::optional<float> floatValue;
+        std::optional<std::string> stringValue;
+        std::optional<std::string> sizeUnit;
+        std::optional<std::string> speedUnit;
+        Position position;
+    };
+
+    struct Predicate
+    {
+        std::string reference;
+        Position referencePosition;
+        Operator oper;
+        Value value;
+    };
+
+    struct Expression
+    {
+        enum class Type
+        {
+            And,
+            Or,
+            Predicate,
+        };
+
+        Type type;
+        // set for And and Or, always at least two
+        std::vector<Expression> children;
+        // set for Predicate
+        std::optional<pt::PQL::Predicate> predicate;
+    };
+
+    struct OrderBy
+    {
+        std::string field;
+        Position position;
+        bool descending;
+    };
+
+    struct Limit
+    {
+        int64_t count;
+        Position position;
+    };
+
+    struct Aggregate
+    {
+        std::string function;
+        Position functionPosition;
+        // empty for count()
+        std::string field;
+        Position fieldPosition;
+    };
+
+    struct GroupBy
+    {
+        std::string field;
+        Position position;
+    };
+
+    struct Query
+    {
+        // set for aggregate queries, e.g. 'sum(size) by label'
+        std::vector<Aggregate> aggregates;
+
+        // the filter expression, or the 'where' expression of an aggregate query
+        std::optional<Expression> filter;
+
+        std::optional<OrderBy> orderBy;
+        std::optional<Limit> limit;
+        std::optional<GroupBy> groupBy;
+    };
+}
@@ -0,0 +1,437 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <variant>
+#include <vector>
+
+#include "query.hpp"
+#include "queryexception.hpp"
+#include "trigramindex.hpp"
+
+namespace pt::PQL
+{
+    // Compiles a parsed query to functions over a torrent status. TStatus is
+    // pt::BitTorrent::TorrentStatus in the client, and only needs the fields
+    // PQL knows about, so the language can be tested and measured without
+    // the rest of the client. TIndex is a TrigramIndex over torrent names.
+    template<typename TStatus, typename TIndex>
+    class QueryCompiler
+    {
+    public:
+        typedef std::variant<double, std::string> SortKey;
+
+        typedef std::function<bool(TStatus const&)> FilterFunc;
+        typedef std::function<SortKey(TStatus const&)> SortKeyFunc;
+        typedef std::function<double(TStatus const&)> ValueFunc;
+        typedef std::function<std::string(TStatus const&)> GroupKeyFunc;
+        typedef std::function<std::optional<std::vector<uint32_t>>(TIndex const&)> CandidatesFunc;
+
+        struct CompiledExpression
+        {
+            CompiledExpression(FilterFunc const& f, CandidatesFunc const& c = nullptr)
+                : filter(f),
+                candidates(c)
+            {
+            }
+
+            FilterFunc filter;
+            // narrows the torrents to check using the name index, empty if the
+            // expression cannot be answered by the index
+            CandidatesFunc candidates;
+        };
+
+        // all of these throw QueryException with the position of the error
+
+        static CompiledExpression CompileFilter(std::optional<Expression> const& expr)
+        {
+            // an empty filter includes every torrent
+            if (!expr.has_value())
+            {
+                return CompiledExpression([](TStatus const&) { return true; });
+            }
+
+            return CompileExpression(expr.value());
+        }
+
+        static SortKeyFunc CompileOrderBy(OrderBy const& orderBy)
+        {
+            std::string const& f = orderBy.field;
+
+            if (f == "dl")       return [](TStatus const& ts) { return SortKey(static_cast<double>(ts.downloadPayloadRate)); };
+            if (f == "ul")       return [](TStatus const& ts) { return SortKey(static_cast<double>(ts.uploadPayloadRate)); };
+            if (f == "progress") return [](TStatus const& ts) { return SortKey(static_cast<double>(ts.progress)); };
+            if (f == "ratio")    return [](TStatus const& ts) { return SortKey(static_cast<double>(ts.ratio)); };
+            if (f == "size")     return [](TStatus const& ts) { return SortKey(static_cast<double>(ts.totalWanted)); };
+            if (f == "name")     return [](TStatus const& ts) { return SortKey(ts.name); };
+            if (f == "label")    return [](TStatus const& ts) { return SortKey(ts.labelName); };
+            if (f == "savepath") return [](TStatus const& ts) { return SortKey(ts.savePath); };
+
+            throw QueryException("Cannot order by field: '" + f + "'", orderBy.position);
+        }
+
+        // numeric fields which can be used in aggregate functions
+        static ValueFunc CompileAggregateValue(Aggregate const& aggregate)
+        {
+            std::string const& f = aggregate.field;
+
+            if (f == "dl")       return [](TStatus const& ts) { return static_cast<double>(ts.downloadPayloadRate); };
+            if (f == "ul")       return [](TStatus const& ts) { return static_cast<double>(ts.uploadPayloadRate); };
+            if (f == "progress") return [](TStatus const& ts) { return static_cast<double>(ts.progress * 100); };
+            if (f == "ratio")    return [](TStatus const& ts) { return static_cast<double>(ts.ratio); };
+            if (f == "size")     return [](TStatus const& ts) { return static_cast<double>(ts.totalWanted); };
+
+            throw QueryException("Cannot aggregate field: '" + f + "'", aggregate.fieldPosition);
+        }
+
+        // fields which aggregates can be grouped by
+        static GroupKeyFunc CompileGroupBy(GroupBy const& groupBy)
+        {
+            std::string const& f = groupBy.field;
+
+            if (f == "label")    return [](TStatus const& ts) { return ts.labelName; };
+            if (f == "savepath") return [](TStatus const& ts) { return ts.savePath; };
+            if (f == "status")   return [](TStatus const& ts) { return StatusName(ts); };
+
+            throw QueryException("Cannot group by field: '" + f + "'", groupBy.position);
+        }
+
+        static std::string StatusName(TStatus const& ts)
+        {
+            switch (ts.state)
+            {
+            case TStatus::State::Error:
+                return "error";
+            case TStatus::State::DownloadingPaused:
+            case TStatus::State::UploadingPaused:
+                return "paused";
+            case TStatus::State::DownloadingQueued:
+            case TStatus::State::UploadingQueued:
+                return "queued";
+            case TStatus::State::Downloading:
+            case TStatus::State::DownloadingChecking:
+            case TStatus::State::DownloadingMetadata:
+                return "downloading";
+            case TStatus::State::Uploading:
+                return "seeding";
+            default:
+                break;
+            }
+
+            return "unknown";
+        }
+
+    private:
+        template<typename TLeft, typename TRight>
+        static bool Compare(TLeft const& lhs, TRight const& rhs, Operator oper)
+        {
+            switch (oper)
+            {
+            case Operator::Lt: return lhs < rhs;
+            case Operator::Lte: return lhs <= rhs;
+            case Operator::Eq: return lhs == rhs;
+            case Operator::Gt: return lhs > rhs;
+            case Operator::Gte: return lhs >= rhs;
+            default: break;
+            }
+
+            // '~' is rejected for anything but strings, which handle it themselves
+            return false;
+        }
+
+        static bool IsNumber(Value const& v) { return v.intValue.has_value() || v.floatValue.has_value(); }
+        static bool IsString(Value const& v) { return v.stringValue.has_value(); }
+
+        static float NumericTerm(Value const& value)
+        {
+            return value.floatValue.has_value()
+                ? value.floatValue.value()
+                : static_cast<float>(value.intValue.value());
+        }
+
+        static CompiledExpression CompileContains(std::string const& term, std::string TStatus::* field)
+        {
+            std::string needle = TrigramText::Normalize(term);
+
+            return CompiledExpression(
+                [needle, field](TStatus const& ts)
+                {
+                    return TrigramText::Contains(ts.*field, needle);
+                });
+        }
+
+        static CompiledExpression CompilePredicate(Predicate const& predicate)
+        {
+            std::string const& ref = predicate.reference;
+            Operator oper = predicate.oper;
+            Value const& value = predicate.value;
+
+            bool valid;
+
+            if (ref == "dl" || ref == "ul" || ref == "progress" || ref == "ratio" || ref == "size") { valid = IsNumber(value); }
+            else if (ref == "name" || ref == "savepath" || ref == "status" || ref == "label") { valid = IsString(value); }
+            else
+            {
+                throw QueryException("Unknown field: '" + ref + "'", predicate.referencePosition);
+            }
+
+            if (!valid)
+            {
+                throw QueryException("Invalid data type for field '" + ref + "'", value.position);
+            }
+
+            // '~' only makes sense for strings
+            if (oper == Operator::Contains && !value.stringValue.has_value())
+            {
+                throw QueryException("Operator '~' cannot be used with field '" + ref + "'", value.position);
+            }
+
+            if (ref == "dl" || ref == "ul")
+            {
+                float term = NumericTerm(value);
+
+                if (value.speedUnit.has_value())
+                {
+                    std::string suffix = value.speedUnit.value();
+                    if (suffix == "kbps") { term *= 1024; }
+                    if (suffix == "mbps") { term *= 1048576; }
+                    if (suffix == "gbps") { term *= 1073741824; }
+                }
+
+                if (ref == "dl") return CompiledExpression([oper, term](TStatus const& ts) { return Compare(ts.downloadPayloadRate, term, oper); });
+                return CompiledExpression([oper, term](TStatus const& ts) { return Compare(ts.uploadPayloadRate, term, oper); });
+            }
+
+            if (ref == "name")
+            {
+                std::string term = value.stringValue.value();
+
+                if (oper == Operator::Contains)
+                {
+                    std::string needle = TrigramText::Normalize(term);
+
+                    return CompiledExpression(
+                        [needle](TStatus const& ts)
+                        {
+                            return TrigramText::Contains(ts.name, needle);
+                        },
+                        [needle](TIndex const& index)
+                        {
+                            return index.Query(needle);
+                        });
+                }
+
+                return CompiledExpression([oper, term](TStatus const& ts) { return Compare(ts.name, term, oper); });
+            }
+
+            if (ref == "progress")
+            {
+                float term = NumericTerm(value);
+                return CompiledExpression([oper, term](TStatus const& ts) { return Compare(ts.progress * 100, term, oper); });
+            }
+
+            if (ref == "size")
+            {
+                float term = NumericTerm(value);
+
+                if (value.sizeUnit.has_value())
+                {
+                    std::string suffix = value.sizeUnit.value();
+                    if (suffix == "kb") { term *= 1024; }
+                    if (suffix == "mb") { term *= 1048576; }
+                    if (suffix == "gb") { term *= 1073741824; }
+                }
+
+                return CompiledExpression([oper, term](TStatus const& ts) { return Compare(ts.totalWanted, term, oper); });
+            }
+
+            if (ref == "status")
+            {
+                std::string term = value.stringValue.value();
+
+                return CompiledExpression(
+                    [term](TStatus const& ts)
+                    {
+                        if (term == "error" && ts.state == TStatus::State::Error) return true;
+                        if (term == "downloading")
+                        {
+                            return ts.state == TStatus::State::Downloading
+                                || ts.state == TStatus::State::DownloadingChecking
+                                || ts.state == TStatus::State::DownloadingMetadata
+                                || ts.state == TStatus::State::DownloadingPaused
+                                || ts.state == TStatus::State::DownloadingQueued;
+                        }
+                        if (term == "paused")
+                        {
+                            return ts.state == TStatus::State::DownloadingPaused
+                                || ts.state == TStatus::State::UploadingPaused;
+                        }
+                        if (term == "queued")
+                        {
+                            return ts.state == TStatus::State::DownloadingQueued
+                                || ts.state == TStatus::State::UploadingQueued;
+                        }
+                        if (term == "seeding")
+                        {
+                            return ts.state == TStatus::State::Uploading;
+                        }
+                        if (term == "uploading")
+                        {
+                            return ts.state == TStatus::State::Uploading
+                                || ts.state == TStatus::State::UploadingPaused
+                                || ts.state == TStatus::State::UploadingQueued;
+                        }
+                        return false;
+                    });
+            }
+
+            if (ref == "ratio")
+            {
+                float term = NumericTerm(value);
+                return CompiledExpression([oper, term](TStatus const& ts) { return Compare(ts.ratio, term, oper); });
+            }
+
+            if (ref == "savepath")
+            {
+                std::string term = value.stringValue.value();
+
+                if (oper == Operator::Contains)
+                {
+                    return CompileContains(term, &TStatus::savePath);
+                }
+
+                return CompiledExpression([oper, term](TStatus const& ts) { return Compare(ts.savePath, term, oper); });
+            }
+
+            // label
+            std::string term = value.stringValue.value();
+
+            if (oper == Operator::Contains)
+            {
+                return CompileContains(term, &TStatus::labelName);
+            }
+
+            return CompiledExpression([oper, term](TStatus const& ts) { return Compare(ts.labelName, term, oper); });
+        }
+
+        static CompiledExpression CompileExpression(Expression const& expr)
+        {
+            if (expr.type == Expression::Type::Predicate)
+            {
+                return CompilePredicate(expr.predicate.value());
+            }
+
+            std::vector<FilterFunc> funcs;
+            std::vector<CandidatesFunc> candidates;
+            bool indexed = true;
+
+            for (auto const& child : expr.children)
+            {
+                CompiledExpression compiled = CompileExpression(child);
+                funcs.push_back(compiled.filter);
+
+                if (compiled.candidates) { candidates.push_back(compiled.candidates); }
+                else { indexed = false; }
+            }
+
+            if (expr.type == Expression::Type::And)
+            {
+                FilterFunc filter = [funcs](TStatus const& ts)
+                    {
+                        return std::all_of(
+                            funcs.begin(),
+                            funcs.end(),
+                            [&ts](auto const& f)
+                            {
+                                return f(ts);
+                            });
+                    };
+
+                if (candidates.empty())
+                {
+                    return CompiledExpression(filter);
+                }
+
+                // any side that can use the index narrows the whole expression
+                return CompiledExpression(
+                    filter,
+                    [candidates](TIndex const& index) -> std::optional<std::vector<uint32_t>>
+                    {
+                        std::optional<std::vector<uint32_t>> result;
+
+                        for (auto const& c : candidates)
+                        {
+                            auto ids = c(index);
+                            if (!ids.has_value()) { continue; }
+
+                            if (!result.has_value())
+                            {
+                                result = std::move(ids);
+                                continue;
+                            }
+
+                            std::vector<uint32_t> intersection;
+
+                            std::set_intersection(
+                                result->begin(),
+                                result->end(),
+                                ids->begin(),
+                                ids->end(),
+                                std::back_inserter(intersection));
+
+                            result = std::move(intersection);
+                        }
+
+                        return result;
+                    });
+            }
+
+            FilterFunc filter = [funcs](TStatus const& ts)
+                {
+                    return std::any_of(
+                        funcs.begin(),
+                        funcs.end(),
+                        [&ts](auto const& f)
+                        {
+                            return f(ts);
+                        });
+                };
+
+            // every side must be able to use the index, otherwise we need to check all torrents
+            if (!indexed)
+            {
+                return CompiledExpression(filter);
+            }
+
+            return CompiledExpression(
+                filter,
+                [candidates](TIndex const& index) -> std::optional<std::vector<uint32_t>>
+                {
+                    std::vector<uint32_t> result;
+
+                    for (auto const& c : candidates)
+                    {
+                        auto ids = c(index);
+                        if (!ids.has_value()) { return std::nullopt; }
+
+                        std::vector<uint32_t> merged;
+
+                        std::set_union(
+                            result.begin(),
+                            result.end(),
+                            ids->begin(),
+                            ids->end(),
+                            std::back_inserter(merged));
+
+                        result = std::move(merged);
+                    }
+
+                    return result;
+                });
+        }
+    };
+}
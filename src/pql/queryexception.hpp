@@ -0,0 +1,30 @@
+#pragma once
+
+#include <exception>
+#include <string>
+
+#include "query.hpp"
+
+namespace pt::PQL
+{
+    class QueryException : public std::exception
+    {
+    public:
+        QueryException(std::string const& msg, Position const& position)
+            : m_msg(msg + " at " + std::to_string(position.line) + ":" + std::to_string(position.column)),
+            m_position(position)
+        {
+        }
+
+        virtual const char* what() const noexcept override
+        {
+            return m_msg.c_str();
+        }
+
+        Position const& position() const { return m_position; }
+
+    private:
+        std::string m_msg;
+        Position m_position;
+    };
+}
@@ -0,0 +1,114 @@
+#include "querylexer.hpp"
+
+#include "queryexception.hpp"
+
+using pt::PQL::QueryLexer;
+using pt::PQL::Token;
+
+static bool IsDigit(char c) { return c >= '0' && c <= '9'; }
+static bool IsLetter(char c) { return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z'); }
+
+std::vector<Token> QueryLexer::Tokenize(std::string const& input)
+{
+    std::vector<Token> tokens;
+
+    size_t i = 0;
+    size_t line = 1;
+    size_t column = 0;
+
+    // moves the cursor forward while keeping track of the line and column
+    auto advance = [&](size_t count)
+    {
+        for (size_t n = 0; n < count && i < input.size(); n++, i++)
+        {
+            if (input[i] == '\n') { line++; column = 0; }
+            else { column++; }
+        }
+    };
+
+    while (i < input.size())
+    {
+        char c = input[i];
+
+        if (c == ' ' || c == '\t' || c == '\r' || c == '\n')
+        {
+            advance(1);
+            continue;
+        }
+
+        size_t start = i;
+        Position position{ line, column };
+
+        if (IsLetter(c))
+        {
+            size_t end = start;
+            while (end < input.size() && IsLetter(input[end])) { end++; }
+
+            tokens.push_back({ Token::Type::Id, input.substr(start, end - start), position });
+            advance(end - start);
+            continue;
+        }
+
+        if (IsDigit(c) || (c == '-' && start + 1 < input.size() && IsDigit(input[start + 1])))
+        {
+            size_t end = start + 1;
+            while (end < input.size() && IsDigit(input[end])) { end++; }
+
+            Token::Type type = Token::Type::Int;
+
+            if (end + 1 < input.size() && input[end] == '.' && IsDigit(input[end + 1]))
+            {
+                type = Token::Type::Float;
+                end++;
+                while (end < input.size() && IsDigit(input[end])) { end++; }
+            }
+
+            tokens.push_back({ type, input.substr(start, end - start), position });
+            advance(end - start);
+            continue;
+        }
+
+        if (c == '"')
+        {
+            size_t end = input.find('"', start + 1);
+
+            if (end == std::string::npos)
+            {
+                throw QueryException("Syntax error - unterminated string", position);
+            }
+
+            tokens.push_back({ Token::Type::String, input.substr(start + 1, end - start - 1), position });
+            advance(end - start + 1);
+            continue;
+        }
+
+        bool hasNext = start + 1 < input.size();
+
+        switch (c)
+        {
+        case '=': tokens.push_back({ Token::Type::Eq, "=", position }); break;
+        case '~': tokens.push_back({ Token::Type::Contains, "~", position }); break;
+        case '(': tokens.push_back({ Token::Type::LeftParen, "(", position }); break;
+        case ')': tokens.push_back({ Token::Type::RightParen, ")", position }); break;
+        case ',': tokens.push_back({ Token::Type::Comma, ",", position }); break;
+        case '>':
+            if (hasNext && input[start + 1] == '=') { tokens.push_back({ Token::Type::Gte, ">=", position }); advance(1); }
+            else { tokens.push_back({ Token::Type::Gt, ">", position }); }
+            break;
+        case '<':
+            if (hasNext && input[start + 1] == '=') { tokens.push_back({ Token::Type::Lte, "<=", position }); advance(1); }
+            else { tokens.push_back({ Token::Type::Lt, "<", position }); }
+            break;
+        default:
+            throw QueryException(
+                std::string("Syntax error - token recognition error at: '") + c + "'",
+                position);
+        }
+
+        advance(1);
+    }
+
+    tokens.push_back({ Token::Type::End, "<EOF>", Position{ line, column } });
+
+    return tokens;
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "query.hpp"
+
+namespace pt::PQL
+{
+    struct Token
+    {
+        enum class Type
+        {
+            Id,
+            Int,
+            Float,
+            String,
+            Eq,
+            Contains,
+            Gt,
+            Gte,
+            Lt,
+            Lte,
+            LeftParen,
+            RightParen,
+            Comma,
+            End,
+        };
+
+        Type type;
+        std::string text;
+        Position position;
+    };
+
+    class QueryLexer
+    {
+    public:
+        // throws QueryException on invalid input
+        static std::vector<Token> Tokenize(std::string const& input);
+    };
+}
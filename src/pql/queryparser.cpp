@@ -0,0 +1,359 @@
+#include "queryparser.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <stdexcept>
+
+using pt::PQL::Aggregate;
+using pt::PQL::Expression;
+using pt::PQL::GroupBy;
+using pt::PQL::Limit;
+using pt::PQL::Operator;
+using pt::PQL::OrderBy;
+using pt::PQL::Predicate;
+using pt::PQL::Query;
+using pt::PQL::QueryException;
+using pt::PQL::QueryLexer;
+using pt::PQL::QueryParser;
+using pt::PQL::Token;
+using pt::PQL::Value;
+
+static std::string ToLower(std::string text)
+{
+    std::transform(
+        text.begin(),
+        text.end(),
+        text.begin(),
+        [](char c) { return static_cast<char>(std::tolower(static_cast<unsigned char>(c))); });
+
+    return text;
+}
+
+Query QueryParser::Parse(std::string const& input)
+{
+    QueryParser parser(QueryLexer::Tokenize(input));
+    return parser.ParseQuery();
+}
+
+QueryParser::QueryParser(std::vector<Token> tokens)
+    : m_tokens(std::move(tokens)),
+    m_pos(0)
+{
+}
+
+// query
+//     : aggregate (',' aggregate)* ('where' expression)? ('group'? 'by' ID)?
+//     | expression? ('order' 'by' ID ('asc' | 'desc')?)? ('limit' INT)?
+//     ;
+Query QueryParser::ParseQuery()
+{
+    Query query;
+
+    if (Peek().type == Token::Type::Id
+        && Peek(1).type == Token::Type::LeftParen)
+    {
+        query.aggregates = ParseAggregates();
+
+        if (IsKeyword("where"))
+        {
+            Next();
+            query.filter = ParseOr();
+        }
+
+        if (IsKeyword("group") && IsKeyword("by", 1))
+        {
+            Next();
+        }
+
+        if (IsKeyword("by"))
+        {
+            Next();
+            Token const& field = Expect(Token::Type::Id, "field");
+            query.groupBy = GroupBy{ field.text, field.position };
+        }
+    }
+    else
+    {
+        if (Peek().type != Token::Type::End
+            && !IsKeyword("limit")
+            && !(IsKeyword("order") && IsKeyword("by", 1)))
+        {
+            query.filter = ParseOr();
+        }
+
+        if (IsKeyword("order"))
+        {
+            Next();
+
+            if (!IsKeyword("by"))
+            {
+                throw QueryException("Syntax error - expected 'by' but found '" + Peek().text + "'", Peek().position);
+            }
+
+            Next();
+
+            Token const& field = Expect(Token::Type::Id, "field");
+            OrderBy orderBy{ field.text, field.position, false };
+
+            if (IsKeyword("asc") || IsKeyword("desc"))
+            {
+                orderBy.descending = Next().text == "desc";
+            }
+
+            query.orderBy = orderBy;
+        }
+
+        if (IsKeyword("limit"))
+        {
+            Next();
+
+            Token const& count = Expect(Token::Type::Int, "number");
+            int64_t value = 0;
+
+            try
+            {
+                value = std::stoll(count.text);
+            }
+            catch (std::out_of_range const&)
+            {
+                value = -1;
+            }
+
+            if (value <= 0)
+            {
+                throw QueryException("Limit must be a positive integer", count.position);
+            }
+
+            query.limit = Limit{ value, count.position };
+        }
+    }
+
+    if (Peek().type != Token::Type::End)
+    {
+        throw QueryException("Syntax error - extraneous input '" + Peek().text + "'", Peek().position);
+    }
+
+    return query;
+}
+
+// aggregate: ID '(' ID? ')';
+std::vector<Aggregate> QueryParser::ParseAggregates()
+{
+    std::vector<Aggregate> aggregates;
+
+    while (true)
+    {
+        Aggregate aggregate;
+
+        Token const& function = Expect(Token::Type::Id, "function");
+        aggregate.function = function.text;
+        aggregate.functionPosition = function.position;
+
+        Expect(Token::Type::LeftParen, "'('");
+
+        aggregate.fieldPosition = Peek().position;
+
+        if (Peek().type == Token::Type::Id)
+        {
+            aggregate.field = Next().text;
+        }
+
+        Expect(Token::Type::RightParen, "')'");
+        aggregates.push_back(aggregate);
+
+        if (Peek().type != Token::Type::Comma)
+        {
+            break;
+        }
+
+        Next();
+    }
+
+    return aggregates;
+}
+
+// 'and' binds tighter than 'or', just like in the grammar
+Expression QueryParser::ParseOr()
+{
+    Expression lhs = ParseAnd();
+
+    if (!IsKeyword("or"))
+    {
+        return lhs;
+    }
+
+    Expression expr;
+    expr.type = Expression::Type::Or;
+    expr.children.push_back(std::move(lhs));
+
+    while (IsKeyword("or"))
+    {
+        Next();
+        expr.children.push_back(ParseAnd());
+    }
+
+    return expr;
+}
+
+Expression QueryParser::ParseAnd()
+{
+    Expression lhs;
+    lhs.type = Expression::Type::Predicate;
+    lhs.predicate = ParsePredicate();
+
+    if (!IsKeyword("and"))
+    {
+        return lhs;
+    }
+
+    Expression expr;
+    expr.type = Expression::Type::And;
+    expr.children.push_back(std::move(lhs));
+
+    while (IsKeyword("and"))
+    {
+        Next();
+
+        Expression rhs;
+        rhs.type = Expression::Type::Predicate;
+        rhs.predicate = ParsePredicate();
+
+        expr.children.push_back(std::move(rhs));
+    }
+
+    return expr;
+}
+
+// predicate: ID oper value;
+Predicate QueryParser::ParsePredicate()
+{
+    Predicate predicate;
+
+    if (IsKeyword("and") || IsKeyword("or"))
+    {
+        throw QueryException("Syntax error - expected field but found '" + Peek().text + "'", Peek().position);
+    }
+
+    Token const& reference = Expect(Token::Type::Id, "field");
+    predicate.reference = reference.text;
+    predicate.referencePosition = reference.position;
+
+    Token const& oper = Next();
+
+    switch (oper.type)
+    {
+    case Token::Type::Contains: predicate.oper = Operator::Contains; break;
+    case Token::Type::Eq: predicate.oper = Operator::Eq; break;
+    case Token::Type::Gt: predicate.oper = Operator::Gt; break;
+    case Token::Type::Gte: predicate.oper = Operator::Gte; break;
+    case Token::Type::Lt: predicate.oper = Operator::Lt; break;
+    case Token::Type::Lte: predicate.oper = Operator::Lte; break;
+    default:
+        throw QueryException("Syntax error - expected operator but found '" + oper.text + "'", oper.position);
+    }
+
+    predicate.value = ParseValue();
+
+    return predicate;
+}
+
+// value: (INT | FLOAT) (UNIT_SIZE | UNIT_SPEED)? | STRING;
+Value QueryParser::ParseValue()
+{
+    Value value;
+    Token const& token = Next();
+
+    value.position = token.position;
+
+    switch (token.type)
+    {
+    case Token::Type::String:
+        value.stringValue = token.text;
+        return value;
+
+    case Token::Type::Int:
+        try
+        {
+            value.intValue = std::stoll(token.text);
+        }
+        catch (std::out_of_range const&)
+        {
+            throw QueryException("Number out of range: '" + token.text + "'", token.position);
+        }
+        break;
+
+    case Token::Type::Float:
+        try
+        {
+            value.floatValue = std::stof(token.text);
+        }
+        catch (std::invalid_argument const&)
+        {
+            throw QueryException("Invalid number: '" + token.text + "'", token.position);
+        }
+        catch (std::out_of_range const&)
+        {
+            // too large for a float, or so small it underflows
+            throw QueryException("Number out of range: '" + token.text + "'", token.position);
+        }
+        break;
+
+    default:
+        throw QueryException("Syntax error - expected value but found '" + token.text + "'", token.position);
+    }
+
+    if (Peek().type == Token::Type::Id)
+    {
+        // units are case insensitive
+        std::string unit = ToLower(Peek().text);
+
+        if (unit == "b" || unit == "kb" || unit == "mb" || unit == "gb")
+        {
+            value.sizeUnit = unit;
+            Next();
+        }
+        else if (unit == "bps" || unit == "kbps" || unit == "mbps" || unit == "gbps")
+        {
+            value.speedUnit = unit;
+            Next();
+        }
+    }
+
+    return value;
+}
+
+bool QueryParser::IsKeyword(std::string const& keyword, size_t offset)
+{
+    Token const& token = Peek(offset);
+    return token.type == Token::Type::Id && token.text == keyword;
+}
+
+Token const& QueryParser::Peek(size_t offset)
+{
+    // the last token is always End
+    return m_tokens[std::min(m_pos + offset, m_tokens.size() - 1)];
+}
+
+Token const& QueryParser::Next()
+{
+    Token const& token = Peek();
+
+    if (m_pos < m_tokens.size() - 1)
+    {
+        m_pos++;
+    }
+
+    return token;
+}
+
+Token const& QueryParser::Expect(Token::Type type, std::string const& description)
+{
+    if (Peek().type != type)
+    {
+        throw QueryException(
+            "Syntax error - expected " + description + " but found '" + Peek().text + "'",
+            Peek().position);
+    }
+
+    return Next();
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "query.hpp"
+#include "queryexception.hpp"
+#include "querylexer.hpp"
+
+namespace pt::PQL
+{
+    class QueryParser
+    {
+    public:
+        // throws QueryException with the exact position of the error
+        static Query Parse(std::string const& input);
+
+    private:
+        QueryParser(std::vector<Token> tokens);
+
+        Query ParseQuery();
+        std::vector<Aggregate> ParseAggregates();
+        Expression ParseOr();
+        Expression ParseAnd();
+        Predicate ParsePredicate();
+        Value ParseValue();
+
+        bool IsKeyword(std::string const& keyword, size_t offset = 0);
+        Token const& Peek(size_t offset = 0);
+        Token const& Next();
+        Token const& Expect(Token::Type type, std::string const& description);
+
+        std::vector<Token> m_tokens;
+        size_t m_pos;
+    };
+}
@@ -0,0 +1,346 @@
+#include <algorithm>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <queryparser.hpp>
+
+#include "torrentgenerator.hpp"
+
+using pt::PQL::Expression;
+using pt::PQL::QueryException;
+using pt::PQL::QueryParser;
+using pt::PQL::Tests::GenerateTorrents;
+using pt::PQL::Tests::IndexNames;
+using pt::PQL::Tests::QueryCompiler;
+using pt::PQL::Tests::TorrentStatus;
+
+namespace
+{
+    typedef std::function<bool(TorrentStatus const&)> Reference;
+
+    std::vector<TorrentStatus> const& Torrents()
+    {
+        static std::vector<TorrentStatus> torrents = GenerateTorrents(5000);
+        return torrents;
+    }
+
+    QueryCompiler::FilterFunc Compile(std::string const& query)
+    {
+        return QueryCompiler::CompileFilter(QueryParser::Parse(query).filter).filter;
+    }
+
+    // the query must agree with the reference on every generated torrent. unless
+    // told otherwise, it must also match some but not all of them, since a
+    // query that matches nothing or everything says little about the operator
+    void ExpectConforms(std::string const& query, Reference const& reference, bool partial = true)
+    {
+        SCOPED_TRACE(query);
+
+        auto filter = Compile(query);
+        size_t matches = 0;
+
+        for (TorrentStatus const& ts : Torrents())
+        {
+            bool const expected = reference(ts);
+            ASSERT_EQ(expected, filter(ts)) << "torrent: " << ts.name;
+            if (expected) { matches++; }
+        }
+
+        if (partial)
+        {
+            EXPECT_GT(matches, 0u);
+            EXPECT_LT(matches, Torrents().size());
+        }
+    }
+
+    void ExpectError(std::string const& query, size_t column)
+    {
+        SCOPED_TRACE(query);
+
+        try
+        {
+            Compile(query);
+            FAIL() << "expected a QueryException";
+        }
+        catch (QueryException const& ex)
+        {
+            EXPECT_EQ(column, ex.position().column);
+        }
+    }
+}
+
+TEST(ConformanceTest, EmptyQueryMatchesEverything)
+{
+    ExpectConforms("", [](TorrentStatus const&) { return true; }, false);
+}
+
+TEST(ConformanceTest, Size)
+{
+    ExpectConforms("size > 1000", [](auto const& ts) { return ts.totalWanted > 1000.0f; });
+    ExpectConforms("size >= 1024", [](auto const& ts) { return ts.totalWanted >= 1024.0f; });
+    ExpectConforms("size < 1000", [](auto const& ts) { return ts.totalWanted < 1000.0f; });
+    ExpectConforms("size <= 1024", [](auto const& ts) { return ts.totalWanted <= 1024.0f; });
+
+    std::int64_t const exact = Torrents()[7].totalWanted;
+    ExpectConforms("size = " + std::to_string(exact), [exact](auto const& ts) { return ts.totalWanted == static_cast<float>(exact); });
+}
+
+TEST(ConformanceTest, SizeUnits)
+{
+    ExpectConforms("size >= 512 b", [](auto const& ts) { return ts.totalWanted >= 512.0f; });
+    ExpectConforms("size > 1 kb", [](auto const& ts) { return ts.totalWanted > 1024.0f; });
+    ExpectConforms("size > 10 mb", [](auto const& ts) { return ts.totalWanted > 10.0f * 1048576.0f; });
+    ExpectConforms("size < 1.5 gb", [](auto const& ts) { return ts.totalWanted < 1.5f * 1073741824.0f; });
+    ExpectConforms("size > 1.5gb", [](auto const& ts) { return ts.totalWanted > 1.5f * 1073741824.0f; });
+
+    // units are case insensitive
+    ExpectConforms("size > 2 GB", [](auto const& ts) { return ts.totalWanted > 2.0f * 1073741824.0f; });
+    ExpectConforms("size <= 100 Mb", [](auto const& ts) { return ts.totalWanted <= 100.0f * 1048576.0f; });
+}
+
+TEST(ConformanceTest, DownloadAndUploadRates)
+{
+    ExpectConforms("dl = 0", [](auto const& ts) { return ts.downloadPayloadRate == 0; });
+    ExpectConforms("dl > 1000", [](auto const& ts) { return ts.downloadPayloadRate > 1000.0f; });
+    ExpectConforms("dl >= 1000", [](auto const& ts) { return ts.downloadPayloadRate >= 1000.0f; });
+    ExpectConforms("dl < 1000", [](auto const& ts) { return ts.downloadPayloadRate < 1000.0f; });
+    ExpectConforms("dl <= 1000", [](auto const& ts) { return ts.downloadPayloadRate <= 1000.0f; });
+
+    ExpectConforms("ul = 0", [](auto const& ts) { return ts.uploadPayloadRate == 0; });
+    ExpectConforms("ul > 1000", [](auto const& ts) { return ts.uploadPayloadRate > 1000.0f; });
+    ExpectConforms("ul >= 1000", [](auto const& ts) { return ts.uploadPayloadRate >= 1000.0f; });
+    ExpectConforms("ul < 1000", [](auto const& ts) { return ts.uploadPayloadRate < 1000.0f; });
+    ExpectConforms("ul <= 1000", [](auto const& ts) { return ts.uploadPayloadRate <= 1000.0f; });
+}
+
+TEST(ConformanceTest, SpeedUnits)
+{
+    ExpectConforms("ul > 100000 bps", [](auto const& ts) { return ts.uploadPayloadRate > 100000.0f; });
+    ExpectConforms("dl > 100 kbps", [](auto const& ts) { return ts.downloadPayloadRate > 100.0f * 1024.0f; });
+    ExpectConforms("dl >= 1.5 mbps", [](auto const& ts) { return ts.downloadPayloadRate >= 1.5f * 1048576.0f; });
+    ExpectConforms("dl < 0.01 gbps", [](auto const& ts) { return ts.downloadPayloadRate < 0.01f * 1073741824.0f; });
+    ExpectConforms("ul < 2 MBPS", [](auto const& ts) { return ts.uploadPayloadRate < 2.0f * 1048576.0f; });
+}
+
+TEST(ConformanceTest, Progress)
+{
+    // progress is compared in percent
+    ExpectConforms("progress = 50", [](auto const& ts) { return ts.progress * 100 == 50.0f; });
+    ExpectConforms("progress > 50", [](auto const& ts) { return ts.progress * 100 > 50.0f; });
+    ExpectConforms("progress >= 99.5", [](auto const& ts) { return ts.progress * 100 >= 99.5f; });
+    ExpectConforms("progress < 10", [](auto const& ts) { return ts.progress * 100 < 10.0f; });
+    ExpectConforms("progress <= 10", [](auto const& ts) { return ts.progress * 100 <= 10.0f; });
+}
+
+TEST(ConformanceTest, Ratio)
+{
+    ExpectConforms("ratio = 1.5", [](auto const& ts) { return ts.ratio == 1.5f; });
+    ExpectConforms("ratio > 2", [](auto const& ts) { return ts.ratio > 2.0f; });
+    ExpectConforms("ratio >= 2", [](auto const& ts) { return ts.ratio >= 2.0f; });
+    ExpectConforms("ratio < 0.5", [](auto const& ts) { return ts.ratio < 0.5f; });
+    ExpectConforms("ratio <= 0.5", [](auto const& ts) { return ts.ratio <= 0.5f; });
+}
+
+TEST(ConformanceTest, Name)
+{
+    std::string const exact = Torrents()[42].name;
+
+    ExpectConforms("name = \"" + exact + "\"", [exact](auto const& ts) { return ts.name == exact; });
+    ExpectConforms("name > \"M\"", [](auto const& ts) { return ts.name > "M"; });
+    ExpectConforms("name >= \"Linux\"", [](auto const& ts) { return ts.name >= "Linux"; });
+    ExpectConforms("name < \"M\"", [](auto const& ts) { return ts.name < "M"; });
+    ExpectConforms("name <= \"Linux\"", [](auto const& ts) { return ts.name <= "Linux"; });
+
+    // '~' folds ASCII case on both sides
+    ExpectConforms("name ~ \"bunny\"", [](auto const& ts) { return ts.name.find("Bunny") != std::string::npos; });
+    ExpectConforms("name ~ \"X26\"", [](auto const& ts) { return ts.name.find("x26") != std::string::npos; });
+    ExpectConforms("name ~ \"flac-1\"", [](auto const& ts) { return ts.name.find("FLAC-1") != std::string::npos; });
+}
+
+TEST(ConformanceTest, Label)
+{
+    ExpectConforms("label = \"Linux\"", [](auto const& ts) { return ts.labelName == "Linux"; });
+    ExpectConforms("label = \"\"", [](auto const& ts) { return ts.labelName.empty(); });
+    ExpectConforms("label > \"Linux\"", [](auto const& ts) { return ts.labelName > "Linux"; });
+    ExpectConforms("label >= \"Linux\"", [](auto const& ts) { return ts.labelName >= "Linux"; });
+    ExpectConforms("label < \"Linux\"", [](auto const& ts) { return ts.labelName < "Linux"; });
+    ExpectConforms("label <= \"Linux\"", [](auto const& ts) { return ts.labelName <= "Linux"; });
+    ExpectConforms("label ~ \"MUS\"", [](auto const& ts) { return ts.labelName == "Music"; });
+}
+
+TEST(ConformanceTest, SavePath)
+{
+    ExpectConforms("savepath = \"D:\\Seeding\"", [](auto const& ts) { return ts.savePath == "D:\\Seeding"; });
+    ExpectConforms("savepath > \"D:\"", [](auto const& ts) { return ts.savePath > "D:"; });
+    ExpectConforms("savepath >= \"D:\\Seeding\"", [](auto const& ts) { return ts.savePath >= "D:\\Seeding"; });
+    ExpectConforms("savepath < \"D:\"", [](auto const& ts) { return ts.savePath < "D:"; });
+    ExpectConforms("savepath <= \"D:\\Seeding\"", [](auto const& ts) { return ts.savePath <= "D:\\Seeding"; });
+    ExpectConforms("savepath ~ \"seeding\"", [](auto const& ts) { return ts.savePath.find("Seeding") != std::string::npos; });
+}
+
+TEST(ConformanceTest, Status)
+{
+    typedef TorrentStatus::State S;
+
+    ExpectConforms("status = \"error\"", [](auto const& ts) { return ts.state == S::Error; });
+    ExpectConforms("status = \"downloading\"", [](auto const& ts)
+    {
+        return ts.state == S::Downloading || ts.state == S::DownloadingChecking || ts.state == S::DownloadingMetadata
+            || ts.state == S::DownloadingPaused || ts.state == S::DownloadingQueued;
+    });
+    ExpectConforms("status = \"paused\"", [](auto const& ts) { return ts.state == S::DownloadingPaused || ts.state == S::UploadingPaused; });
+    ExpectConforms("status = \"queued\"", [](auto const& ts) { return ts.state == S::DownloadingQueued || ts.state == S::UploadingQueued; });
+    ExpectConforms("status = \"seeding\"", [](auto const& ts) { return ts.state == S::Uploading; });
+    ExpectConforms("status = \"uploading\"", [](auto const& ts)
+    {
+        return ts.state == S::Uploading || ts.state == S::UploadingPaused || ts.state == S::UploadingQueued;
+    });
+    ExpectConforms("status = \"checking\"", [](auto const&) { return false; }, false);
+}
+
+TEST(ConformanceTest, AndBindsTighterThanOr)
+{
+    ExpectConforms(
+        "label = \"Linux\" or size > 1 gb and dl > 0",
+        [](auto const& ts) { return ts.labelName == "Linux" || (ts.totalWanted > 1073741824.0f && ts.downloadPayloadRate > 0); });
+
+    ExpectConforms(
+        "size > 1 gb and dl > 0 or label = \"Linux\"",
+        [](auto const& ts) { return (ts.totalWanted > 1073741824.0f && ts.downloadPayloadRate > 0) || ts.labelName == "Linux"; });
+
+    ExpectConforms(
+        "ratio > 4 or label = \"Music\" and progress = 100 or name ~ \"iso\" and size < 1 mb",
+        [](auto const& ts)
+        {
+            return ts.ratio > 4.0f
+                || (ts.labelName == "Music" && ts.progress * 100 == 100.0f)
+                || (ts.name.find("ISO") != std::string::npos && ts.totalWanted < 1048576.0f);
+        });
+}
+
+TEST(ConformanceTest, ChainsAreFlattened)
+{
+    auto query = QueryParser::Parse("dl > 0 or ul > 0 or ratio > 1 and size > 1 and progress > 1");
+
+    ASSERT_TRUE(query.filter.has_value());
+    EXPECT_EQ(Expression::Type::Or, query.filter->type);
+    ASSERT_EQ(3u, query.filter->children.size());
+    EXPECT_EQ(Expression::Type::Predicate, query.filter->children[0].type);
+    EXPECT_EQ(Expression::Type::Predicate, query.filter->children[1].type);
+    EXPECT_EQ(Expression::Type::And, query.filter->children[2].type);
+    EXPECT_EQ(3u, query.filter->children[2].children.size());
+}
+
+TEST(ConformanceTest, IndexCandidatesAgreeWithFullScan)
+{
+    auto index = IndexNames(Torrents());
+
+    std::vector<std::string> queries =
+    {
+        "name ~ \"bunny\"",
+        "name ~ \"SINTEL\" and size > 1 gb",
+        "size > 1 gb and name ~ \"sintel\" and name ~ \"x265\"",
+        "name ~ \"debian\" or name ~ \"fedora\"",
+        "name ~ \"no such name\"",
+    };
+
+    for (std::string const& query : queries)
+    {
+        SCOPED_TRACE(query);
+
+        auto compiled = QueryCompiler::CompileFilter(QueryParser::Parse(query).filter);
+        ASSERT_TRUE(static_cast<bool>(compiled.candidates));
+
+        auto candidates = compiled.candidates(index);
+        ASSERT_TRUE(candidates.has_value());
+
+        std::vector<uint32_t> expected;
+        std::vector<uint32_t> actual;
+
+        for (uint32_t i = 0; i < Torrents().size(); i++)
+        {
+            if (compiled.filter(Torrents()[i])) { expected.push_back(i); }
+        }
+
+        for (uint32_t id : candidates.value())
+        {
+            if (compiled.filter(Torrents()[index.Key(id)])) { actual.push_back(index.Key(id)); }
+        }
+
+        std::sort(actual.begin(), actual.end());
+        EXPECT_EQ(expected, actual);
+    }
+}
+
+TEST(ConformanceTest, IndexIsNotUsedWhenItCannotAnswer)
+{
+    auto index = IndexNames(Torrents());
+
+    // every side of an 'or' has to use the index
+    EXPECT_FALSE(static_cast<bool>(QueryCompiler::CompileFilter(QueryParser::Parse("name ~ \"bunny\" or dl > 0").filter).candidates));
+    EXPECT_FALSE(static_cast<bool>(QueryCompiler::CompileFilter(QueryParser::Parse("label ~ \"linux\"").filter).candidates));
+
+    // too short for a trigram
+    auto shortNeedle = QueryCompiler::CompileFilter(QueryParser::Parse("name ~ \"iso\" or name ~ \"ar\"").filter);
+    ASSERT_TRUE(static_cast<bool>(shortNeedle.candidates));
+    EXPECT_FALSE(shortNeedle.candidates(index).has_value());
+}
+
+TEST(ConformanceTest, OrderByGroupByAndAggregates)
+{
+    TorrentStatus const& ts = Torrents()[3];
+
+    auto orderBy = [](std::string const& field)
+    {
+        return QueryCompiler::CompileOrderBy(QueryParser::Parse("order by " + field).orderBy.value());
+    };
+
+    EXPECT_EQ(QueryCompiler::SortKey(static_cast<double>(ts.downloadPayloadRate)), orderBy("dl")(ts));
+    EXPECT_EQ(QueryCompiler::SortKey(static_cast<double>(ts.uploadPayloadRate)), orderBy("ul")(ts));
+    EXPECT_EQ(QueryCompiler::SortKey(static_cast<double>(ts.progress)), orderBy("progress")(ts));
+    EXPECT_EQ(QueryCompiler::SortKey(static_cast<double>(ts.ratio)), orderBy("ratio")(ts));
+    EXPECT_EQ(QueryCompiler::SortKey(static_cast<double>(ts.totalWanted)), orderBy("size")(ts));
+    EXPECT_EQ(QueryCompiler::SortKey(ts.name), orderBy("name")(ts));
+    EXPECT_EQ(QueryCompiler::SortKey(ts.labelName), orderBy("label")(ts));
+    EXPECT_EQ(QueryCompiler::SortKey(ts.savePath), orderBy("savepath")(ts));
+    EXPECT_THROW(orderBy("status"), QueryException);
+
+    auto aggregate = [](std::string const& field)
+    {
+        return QueryCompiler::CompileAggregateValue(QueryParser::Parse("sum(" + field + ")").aggregates.at(0));
+    };
+
+    EXPECT_EQ(static_cast<double>(ts.downloadPayloadRate), aggregate("dl")(ts));
+    EXPECT_EQ(static_cast<double>(ts.uploadPayloadRate), aggregate("ul")(ts));
+    EXPECT_EQ(static_cast<double>(ts.progress * 100), aggregate("progress")(ts));
+    EXPECT_EQ(static_cast<double>(ts.ratio), aggregate("ratio")(ts));
+    EXPECT_EQ(static_cast<double>(ts.totalWanted), aggregate("size")(ts));
+    EXPECT_THROW(aggregate("name"), QueryException);
+
+    auto groupBy = [](std::string const& field)
+    {
+        return QueryCompiler::CompileGroupBy(QueryParser::Parse("count() by " + field).groupBy.value());
+    };
+
+    EXPECT_EQ(ts.labelName, groupBy("label")(ts));
+    EXPECT_EQ(ts.savePath, groupBy("savepath")(ts));
+    EXPECT_EQ(QueryCompiler::StatusName(ts), groupBy("status")(ts));
+    EXPECT_THROW(groupBy("size"), QueryException);
+}
+
+TEST(ConformanceTest, Errors)
+{
+    ExpectError("foo = 1", 0);
+    ExpectError("size = \"big\"", 7);
+    ExpectError("name = 10", 7);
+    ExpectError("status = 1", 9);
+    ExpectError("size ~ 10", 7);
+    ExpectError("dl > 1 and bar < 2", 11);
+    ExpectError("size >", 6);
+    ExpectError("size > 1 and", 12);
+    ExpectError("name ~ \"unterminated", 7);
+    ExpectError("size ! 1", 5);
+    ExpectError("order by size limit 0", 20);
+}
@@ -0,0 +1,504 @@
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <queryparser.hpp>
+
+#include "torrentgenerator.hpp"
+
+using pt::PQL::Expression;
+using pt::PQL::Operator;
+using pt::PQL::Position;
+using pt::PQL::Query;
+using pt::PQL::QueryException;
+using pt::PQL::QueryParser;
+using pt::PQL::Value;
+using pt::PQL::Tests::GenerateTorrents;
+using pt::PQL::Tests::QueryCompiler;
+
+namespace
+{
+    // Renders a parsed query back to text in a canonical form - single spaces,
+    // lowercase units and 'by' instead of 'group by'. Since the parser
+    // flattens and/or chains and 'and' binds tighter, no parentheses are needed.
+    class Printer
+    {
+    public:
+        static std::string Print(Query const& query)
+        {
+            std::vector<std::string> parts;
+
+            if (!query.aggregates.empty())
+            {
+                std::string aggregates;
+
+                for (size_t i = 0; i < query.aggregates.size(); i++)
+                {
+                    if (i > 0) { aggregates += ", "; }
+                    aggregates += query.aggregates[i].function + "(" + query.aggregates[i].field + ")";
+                }
+
+                parts.push_back(aggregates);
+
+                if (query.filter) { parts.push_back("where " + Print(*query.filter)); }
+                if (query.groupBy) { parts.push_back("by " + query.groupBy->field); }
+            }
+            else
+            {
+                if (query.filter) { parts.push_back(Print(*query.filter)); }
+                if (query.orderBy) { parts.push_back("order by " + query.orderBy->field + (query.orderBy->descending ? " desc" : "")); }
+                if (query.limit) { parts.push_back("limit " + std::to_string(query.limit->count)); }
+            }
+
+            return Join(parts, " ");
+        }
+
+        static std::string Print(Expression const& expr)
+        {
+            if (expr.type == Expression::Type::Predicate)
+            {
+                auto const& p = expr.predicate.value();
+                return p.reference + " " + Print(p.oper) + " " + Print(p.value);
+            }
+
+            std::vector<std::string> children;
+            for (auto const& child : expr.children) { children.push_back(Print(child)); }
+
+            return Join(children, expr.type == Expression::Type::And ? " and " : " or ");
+        }
+
+    private:
+        static std::string Print(Operator oper)
+        {
+            switch (oper)
+            {
+            case Operator::Contains: return "~";
+            case Operator::Eq: return "=";
+            case Operator::Gt: return ">";
+            case Operator::Gte: return ">=";
+            case Operator::Lt: return "<";
+            case Operator::Lte: return "<=";
+            }
+
+            return "?";
+        }
+
+        static std::string Print(Value const& value)
+        {
+            std::string result;
+
+            if (value.stringValue) { return "\"" + *value.stringValue + "\""; }
+            if (value.intValue) { result = std::to_string(*value.intValue); }
+
+            if (value.floatValue)
+            {
+                std::ostringstream ss;
+                ss << *value.floatValue;
+                result = ss.str();
+
+                if (result.find('.') == std::string::npos) { result += ".0"; }
+            }
+
+            if (value.sizeUnit) { result += " " + *value.sizeUnit; }
+            if (value.speedUnit) { result += " " + *value.speedUnit; }
+
+            return result;
+        }
+
+        static std::string Join(std::vector<std::string> const& parts, std::string const& separator)
+        {
+            std::string result;
+
+            for (size_t i = 0; i < parts.size(); i++)
+            {
+                if (i > 0) { result += separator; }
+                result += parts[i];
+            }
+
+            return result;
+        }
+    };
+
+    // Produces random sentences of the reference grammar in Query.g4. Each
+    // sentence is written twice, once canonically and once with the freedom
+    // the grammar allows: any whitespace, units with or without a space and in
+    // any case, 'group by' for 'by' and an explicit 'asc'.
+    class SentenceGenerator
+    {
+    public:
+        explicit SentenceGenerator(uint32_t seed)
+            : m_rng(seed)
+        {
+        }
+
+        void Next(std::string& canonical, std::string& noisy)
+        {
+            m_canonical.clear();
+            m_noisy.clear();
+
+            if (Chance(4)) { AggregateQuery(); }
+            else { FilterQuery(); }
+
+            canonical = m_canonical;
+            noisy = m_noisy;
+        }
+
+    private:
+        // query: aggregateQuery EOF | filter EOF;
+        void AggregateQuery()
+        {
+            static const char* Functions[] = { "count", "sum", "avg", "min", "max" };
+
+            size_t count = 1 + Pick(3);
+
+            for (size_t i = 0; i < count; i++)
+            {
+                if (i > 0) { Emit(",", ","); }
+
+                std::string function = Functions[Pick(std::size(Functions))];
+                std::string field = function == "count" ? "" : Field();
+
+                Emit(function + "(" + field + ")", function + Space(true) + "(" + Space(true) + field + Space(true) + ")");
+            }
+
+            if (Chance(2)) { Emit("where", "where"); Expression(); }
+
+            if (Chance(2))
+            {
+                std::string field = Field();
+                Emit("by " + field, (Chance(2) ? "group" + Space() : "") + "by" + Space() + field);
+            }
+        }
+
+        // filter: expression? orderBy? limit?;
+        void FilterQuery()
+        {
+            if (Chance(6) == false || Chance(2)) { Expression(); }
+
+            if (Chance(3))
+            {
+                std::string field = Field();
+                int direction = static_cast<int>(Pick(3));
+
+                Emit(
+                    "order by " + field + (direction == 2 ? " desc" : ""),
+                    "order" + Space() + "by" + Space() + field + (direction == 0 ? "" : direction == 1 ? Space() + "asc" : Space() + "desc"));
+            }
+
+            if (Chance(3))
+            {
+                std::string count = std::to_string(1 + Pick(1000));
+                Emit("limit " + count, "limit" + Space() + count);
+            }
+        }
+
+        // expression: expression AND expression | expression OR expression | predicate;
+        void Expression()
+        {
+            size_t terms = 1 + Pick(4);
+
+            for (size_t i = 0; i < terms; i++)
+            {
+                if (i > 0)
+                {
+                    std::string oper = Chance(2) ? "and" : "or";
+                    Emit(oper, oper);
+                }
+
+                Predicate();
+            }
+        }
+
+        // predicate: reference oper value;
+        void Predicate()
+        {
+            static const char* Operators[] = { "=", "~", ">", ">=", "<", "<=" };
+
+            std::string field = Field();
+            std::string oper = Operators[Pick(std::size(Operators))];
+
+            Emit(field, field);
+            Emit(oper, oper);
+            Value();
+        }
+
+        // value: (INT | FLOAT) WS? (UNIT_SIZE | UNIT_SPEED)? | STRING;
+        void Value()
+        {
+            static const char* Units[] = { "b", "kb", "mb", "gb", "bps", "kbps", "mbps", "gbps" };
+            static const char* Fractions[] = { "0", "25", "5", "75" };
+            static const char* Strings[] = { "", "a", "Big Buck Bunny", "D:\\Seeding", "x264 ~ or and 10 gb", "(1)" };
+
+            if (Chance(4))
+            {
+                std::string text = "\"" + std::string(Strings[Pick(std::size(Strings))]) + "\"";
+                Emit(text, text);
+                return;
+            }
+
+            std::string number = (Chance(5) ? "-" : "") + std::to_string(Pick(10000));
+
+            // only fractions that print back exactly
+            if (Chance(2))
+            {
+                number += ".";
+                number += Fractions[Pick(std::size(Fractions))];
+            }
+
+            if (!Chance(3))
+            {
+                Emit(number, number);
+                return;
+            }
+
+            std::string unit = Units[Pick(std::size(Units))];
+            std::string noisyUnit = unit;
+
+            for (char& c : noisyUnit)
+            {
+                if (Chance(2)) { c = static_cast<char>(c - 'a' + 'A'); }
+            }
+
+            Emit(number + " " + unit, number + (Chance(2) ? Space() : "") + noisyUnit);
+        }
+
+        std::string Field()
+        {
+            static const char* Fields[] = { "dl", "ul", "progress", "ratio", "size", "name", "label", "savepath", "status", "foo" };
+            return Fields[Pick(std::size(Fields))];
+        }
+
+        std::string Space(bool optional = false)
+        {
+            static const char* Whitespace[] = { " ", "  ", "\t", "\n", "\r\n", " \n\t " };
+
+            if (optional && Chance(2)) { return ""; }
+            return Whitespace[Pick(std::size(Whitespace))];
+        }
+
+        void Emit(std::string const& canonical, std::string const& noisy)
+        {
+            if (!m_canonical.empty() && canonical != ",") { m_canonical += " "; }
+            m_canonical += canonical;
+
+            // whitespace is needed between words, but not around commas
+            m_noisy += Space(m_noisy.empty() || canonical == "," || m_noisy.back() == ',');
+            m_noisy += noisy;
+        }
+
+        bool Chance(size_t n) { return Pick(n) == 0; }
+        size_t Pick(size_t n) { return static_cast<size_t>(m_rng() % n); }
+
+        std::mt19937 m_rng;
+        std::string m_canonical;
+        std::string m_noisy;
+    };
+
+    std::string TextAt(std::string const& input, Position const& position, size_t length)
+    {
+        size_t offset = 0;
+
+        for (size_t line = 1; line < position.line; line++)
+        {
+            offset = input.find('\n', offset) + 1;
+        }
+
+        return input.substr(offset + position.column, length);
+    }
+
+    bool IsWithin(std::string const& input, Position const& position)
+    {
+        size_t offset = 0;
+
+        for (size_t line = 1; line < position.line; line++)
+        {
+            offset = input.find('\n', offset);
+            if (offset == std::string::npos) { return false; }
+            offset++;
+        }
+
+        size_t end = input.find('\n', offset);
+        if (end == std::string::npos) { end = input.size(); }
+
+        return offset + position.column <= end;
+    }
+
+    void CheckPositions(std::string const& input, Expression const& expr)
+    {
+        if (expr.type != Expression::Type::Predicate)
+        {
+            for (auto const& child : expr.children) { CheckPositions(input, child); }
+            return;
+        }
+
+        auto const& p = expr.predicate.value();
+        EXPECT_EQ(p.reference, TextAt(input, p.referencePosition, p.reference.size()));
+    }
+
+    // parsing must either succeed or fail with a QueryException pointing into
+    // the input - anything else escaping the parser is a bug
+    void ExpectParsesOrReportsError(std::string const& input)
+    {
+        try
+        {
+            Query query = QueryParser::Parse(input);
+
+            // whatever parses must also compile or report a QueryException
+            try
+            {
+                QueryCompiler::CompileFilter(query.filter);
+                if (query.orderBy) { QueryCompiler::CompileOrderBy(*query.orderBy); }
+                if (query.groupBy) { QueryCompiler::CompileGroupBy(*query.groupBy); }
+                for (auto const& aggregate : query.aggregates) { QueryCompiler::CompileAggregateValue(aggregate); }
+            }
+            catch (QueryException const& ex)
+            {
+                EXPECT_TRUE(IsWithin(input, ex.position())) << ex.what() << " in: " << input;
+            }
+        }
+        catch (QueryException const& ex)
+        {
+            EXPECT_TRUE(IsWithin(input, ex.position())) << ex.what() << " in: " << input;
+        }
+        catch (std::exception const& ex)
+        {
+            ADD_FAILURE() << "unexpected " << typeid(ex).name() << ": " << ex.what() << " in: " << input;
+        }
+    }
+}
+
+TEST(ParserTest, OutOfRangeNumbersAreQueryErrors)
+{
+    std::string const huge = "1" + std::string(60, '0');
+    std::string const tiny = "0." + std::string(60, '0') + "1";
+
+    for (std::string const& query : { "size > " + huge, "size > " + huge + ".5", "ratio > " + tiny, "ratio < -" + huge + ".0 gb" })
+    {
+        SCOPED_TRACE(query);
+
+        try
+        {
+            QueryParser::Parse(query);
+            FAIL() << "expected a QueryException";
+        }
+        catch (QueryException const& ex)
+        {
+            EXPECT_EQ(1u, ex.position().line);
+            EXPECT_EQ(query.find_first_of("-0123456789"), ex.position().column);
+            EXPECT_NE(std::string::npos, std::string(ex.what()).find("out of range"));
+        }
+    }
+}
+
+TEST(ParserTest, GrammarSentencesParse)
+{
+    SentenceGenerator generator(29);
+    std::string canonical;
+    std::string noisy;
+
+    for (int i = 0; i < 5000; i++)
+    {
+        generator.Next(canonical, noisy);
+        SCOPED_TRACE(noisy);
+
+        Query query;
+        ASSERT_NO_THROW(query = QueryParser::Parse(noisy));
+
+        // the freedom in the noisy form does not change the query
+        EXPECT_EQ(canonical, Printer::Print(query));
+
+        if (query.filter) { CheckPositions(noisy, *query.filter); }
+    }
+}
+
+TEST(ParserTest, PrintedQueriesRoundTrip)
+{
+    SentenceGenerator generator(30);
+    std::string canonical;
+    std::string noisy;
+
+    for (int i = 0; i < 5000; i++)
+    {
+        generator.Next(canonical, noisy);
+        SCOPED_TRACE(canonical);
+
+        std::string printed = Printer::Print(QueryParser::Parse(canonical));
+        EXPECT_EQ(canonical, printed);
+        EXPECT_EQ(printed, Printer::Print(QueryParser::Parse(printed)));
+    }
+}
+
+TEST(ParserTest, FuzzTokenSoup)
+{
+    static const char* Tokens[] =
+    {
+        "size", "dl", "name", "status", "foo", "and", "or", "order", "by", "asc", "desc", "limit", "where", "group",
+        "count", "sum", "=", "~", ">", ">=", "<", "<=", "(", ")", ",", "gb", "kbps", "B",
+        "0", "-1", "10", "1.5", "-0.25", "9223372036854775808", "99999999999999999999999999999999999999999999.9",
+        "0.00000000000000000000000000000000000000000000001", "\"x\"", "\"\"", "\"", "!", "#", "-", ".", "\n",
+    };
+
+    std::mt19937 rng(31);
+
+    for (int i = 0; i < 20000; i++)
+    {
+        std::string input;
+        size_t count = rng() % 12;
+
+        for (size_t t = 0; t < count; t++)
+        {
+            if (t > 0 && rng() % 4 != 0) { input += ' '; }
+            input += Tokens[rng() % std::size(Tokens)];
+        }
+
+        ExpectParsesOrReportsError(input);
+    }
+}
+
+TEST(ParserTest, FuzzMutatedSentences)
+{
+    static const char Alphabet[] = "abdegiklmnoprstuyz0123456789.-\"~=<>(), \n\t!";
+
+    SentenceGenerator generator(32);
+    std::mt19937 rng(33);
+    std::string canonical;
+    std::string noisy;
+
+    for (int i = 0; i < 20000; i++)
+    {
+        generator.Next(canonical, noisy);
+
+        std::string input = noisy;
+        size_t mutations = 1 + rng() % 4;
+
+        for (size_t m = 0; m < mutations; m++)
+        {
+            size_t pos = input.empty() ? 0 : rng() % input.size();
+            char c = Alphabet[rng() % (sizeof(Alphabet) - 1)];
+
+            switch (rng() % 3)
+            {
+            case 0: input.insert(input.begin() + pos, c); break;
+            case 1: if (!input.empty()) { input.erase(pos, 1); } break;
+            case 2: if (!input.empty()) { input[pos] = c; } break;
+            }
+        }
+
+        ExpectParsesOrReportsError(input);
+    }
+}
+
+TEST(ParserTest, FuzzRandomBytes)
+{
+    std::mt19937 rng(34);
+
+    for (int i = 0; i < 20000; i++)
+    {
+        std::string input(rng() % 24, '\0');
+        for (char& c : input) { c = static_cast<char>(rng() % 256); }
+
+        ExpectParsesOrReportsError(input);
+    }
+}
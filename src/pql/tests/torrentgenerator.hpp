@@ -0,0 +1,117 @@
+#pragma once
+
+#include <cstdint>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <querycompiler.hpp>
+#include <trigramindex.hpp>
+
+namespace pt::PQL::Tests
+{
+    // the fields of pt::BitTorrent::TorrentStatus which PQL reads, with the
+    // same names and types
+    struct TorrentStatus
+    {
+        enum State
+        {
+            Unknown,
+            Error,
+            CheckingFiles,
+            CheckingResumeData,
+            Downloading,
+            DownloadingChecking,
+            DownloadingMetadata,
+            DownloadingPaused,
+            DownloadingQueued,
+            Uploading,
+            UploadingPaused,
+            UploadingQueued
+        };
+
+        int          downloadPayloadRate;
+        std::string  labelName;
+        std::string  name;
+        float        progress;
+        float        ratio;
+        std::string  savePath;
+        State        state;
+        std::int64_t totalWanted;
+        int          uploadPayloadRate;
+    };
+
+    typedef pt::PQL::TrigramIndex<uint32_t> TrigramIndex;
+    typedef pt::PQL::QueryCompiler<TorrentStatus, TrigramIndex> QueryCompiler;
+
+    // Deterministic torrents with a spread of values in every field. Names
+    // are made of release-like words, so substring searches hit a realistic
+    // fraction of a library.
+    inline std::vector<TorrentStatus> GenerateTorrents(size_t count, uint32_t seed = 1)
+    {
+        static const char* Words[] =
+        {
+            "Ubuntu", "Debian", "Fedora", "Arch", "Linux", "Server", "Desktop", "Live",
+            "Big", "Buck", "Bunny", "Sintel", "Tears", "Of", "Steel", "Cosmos",
+            "Laundromat", "Elephants", "Dream", "Spring", "Agent", "Caminandes", "Wikipedia", "Dump",
+            "OpenStreetMap", "Planet", "Archive", "Collection", "Complete", "Season", "Edition", "Remastered",
+        };
+
+        static const char* Tags[] = { "1080p", "2160p", "x264", "x265", "FLAC", "ISO", "amd64", "arm64" };
+        static const char* Labels[] = { "", "Linux", "Movies", "Music", "Archive" };
+        static const char* SavePaths[] = { "C:\\Downloads", "D:\\Seeding", "D:\\Seeding\\Linux", "/srv/torrents" };
+
+        std::mt19937 rng(seed);
+        auto pick = [&rng](size_t n) { return static_cast<size_t>(rng() % n); };
+
+        std::vector<TorrentStatus> torrents;
+        torrents.reserve(count);
+
+        for (size_t i = 0; i < count; i++)
+        {
+            TorrentStatus ts;
+
+            size_t words = 2 + pick(4);
+
+            for (size_t w = 0; w < words; w++)
+            {
+                ts.name += Words[pick(std::size(Words))];
+                ts.name += '.';
+            }
+
+            ts.name += Tags[pick(std::size(Tags))];
+            ts.name += '-' + std::to_string(i);
+
+            ts.labelName = Labels[pick(std::size(Labels))];
+            ts.savePath = SavePaths[pick(std::size(SavePaths))];
+            ts.state = static_cast<TorrentStatus::State>(pick(TorrentStatus::UploadingQueued + 1));
+
+            // sizes from a few bytes to ~64 GB, spread over the magnitudes
+            ts.totalWanted = static_cast<std::int64_t>(1 + rng() % 1023) << pick(27);
+
+            bool const active = ts.state == TorrentStatus::Downloading || ts.state == TorrentStatus::Uploading;
+            ts.downloadPayloadRate = active ? static_cast<int>(rng() % (32 * 1024 * 1024)) : 0;
+            ts.uploadPayloadRate = active ? static_cast<int>(rng() % (4 * 1024 * 1024)) : 0;
+
+            ts.progress = static_cast<float>(pick(1001)) / 1000.0f;
+            ts.ratio = static_cast<float>(pick(5001)) / 1000.0f;
+
+            torrents.push_back(ts);
+        }
+
+        return torrents;
+    }
+
+    inline TrigramIndex IndexNames(std::vector<TorrentStatus> const& torrents)
+    {
+        TrigramIndex index;
+
+        for (size_t i = 0; i < torrents.size(); i++)
+        {
+            index.Insert(static_cast<uint32_t>(i), torrents[i].name);
+        }
+
+        return index;
+    }
+}
@@ -0,0 +1,107 @@
+#include <algorithm>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "torrentgenerator.hpp"
+
+using pt::PQL::Tests::GenerateTorrents;
+using pt::PQL::Tests::IndexNames;
+using pt::PQL::Tests::TrigramIndex;
+using pt::PQL::TrigramText;
+
+namespace
+{
+    std::vector<uint32_t> Keys(TrigramIndex const& index, std::vector<uint32_t> const& ids)
+    {
+        std::vector<uint32_t> keys;
+        for (uint32_t id : ids) { keys.push_back(index.Key(id)); }
+        std::sort(keys.begin(), keys.end());
+        return keys;
+    }
+}
+
+TEST(TrigramIndexTest, ShortNeedlesAreNotAnswered)
+{
+    TrigramIndex index;
+    index.Insert(1, "Big Buck Bunny");
+
+    EXPECT_FALSE(index.Query("").has_value());
+    EXPECT_FALSE(index.Query("bu").has_value());
+    EXPECT_TRUE(index.Query("bun").has_value());
+}
+
+TEST(TrigramIndexTest, QueryFoldsCase)
+{
+    TrigramIndex index;
+    index.Insert(1, "Big Buck Bunny");
+    index.Insert(2, "Sintel");
+
+    EXPECT_EQ(std::vector<uint32_t>({ 1 }), Keys(index, index.Query("BUNNY").value()));
+    EXPECT_EQ(std::vector<uint32_t>({ 2 }), Keys(index, index.Query("sInTeL").value()));
+    EXPECT_TRUE(index.Query("tears").value().empty());
+}
+
+TEST(TrigramIndexTest, UpdateAndRemove)
+{
+    TrigramIndex index;
+    index.Insert(1, "debian-12.iso");
+    index.Insert(2, "fedora-39.iso");
+
+    index.Update(1, "ubuntu-24.04.iso");
+    EXPECT_TRUE(index.Query("debian").value().empty());
+    EXPECT_EQ(std::vector<uint32_t>({ 1 }), Keys(index, index.Query("ubuntu").value()));
+    EXPECT_EQ(std::vector<uint32_t>({ 1, 2 }), Keys(index, index.Query(".iso").value()));
+
+    uint32_t id = index.Find(2).value();
+    index.Remove(2);
+    EXPECT_FALSE(index.Find(2).has_value());
+    EXPECT_EQ(std::vector<uint32_t>({ 1 }), Keys(index, index.Query(".iso").value()));
+
+    // ids of removed documents are reused
+    index.Insert(3, "archlinux.iso");
+    EXPECT_EQ(id, index.Find(3).value());
+    EXPECT_EQ(std::vector<uint32_t>({ 1, 3 }), Keys(index, index.Query(".iso").value()));
+}
+
+// the index may return false positives, since it only checks that every
+// trigram is present, but never misses a match
+TEST(TrigramIndexTest, CandidatesCoverEveryMatch)
+{
+    auto torrents = GenerateTorrents(2000, 7);
+    auto index = IndexNames(torrents);
+
+    for (std::string needle : { "bunny", "X264", "sintel.tears", "-19", "flac-1", "nothing here" })
+    {
+        SCOPED_TRACE(needle);
+
+        std::string normalized = TrigramText::Normalize(needle);
+        std::vector<uint32_t> expected;
+
+        for (uint32_t i = 0; i < torrents.size(); i++)
+        {
+            if (TrigramText::Contains(torrents[i].name, normalized)) { expected.push_back(i); }
+        }
+
+        std::vector<uint32_t> candidates = Keys(index, index.Query(needle).value());
+        std::vector<uint32_t> matches;
+
+        std::copy_if(
+            candidates.begin(),
+            candidates.end(),
+            std::back_inserter(matches),
+            [&](uint32_t key) { return TrigramText::Contains(torrents[key].name, normalized); });
+
+        EXPECT_EQ(expected, matches);
+    }
+}
+
+TEST(TrigramTextTest, Contains)
+{
+    EXPECT_TRUE(TrigramText::Contains("Big Buck Bunny", "buck"));
+    EXPECT_TRUE(TrigramText::Contains("Big Buck Bunny", ""));
+    EXPECT_FALSE(TrigramText::Contains("Big Buck Bunny", "Buck"));
+    EXPECT_FALSE(TrigramText::Contains("", "a"));
+}
@@ -0,0 +1,64 @@
+#include "trigramindex.hpp"
+
+using pt::PQL::TrigramText;
+
+bool TrigramText::Contains(std::string const& text, std::string const& needle)
+{
+    // compare in place instead of normalizing the text, this runs once per
+    // torrent for every evaluation of the filter
+    auto iter = std::search(
+        text.begin(),
+        text.end(),
+        needle.begin(),
+        needle.end(),
+        [](char lhs, char rhs)
+        {
+            return (lhs >= 'A' && lhs <= 'Z' ? static_cast<char>(lhs - 'A' + 'a') : lhs) == rhs;
+        });
+
+    return iter != text.end() || needle.empty();
+}
+
+std::string TrigramText::Normalize(std::string const& text)
+{
+    // only ASCII is folded, UTF-8 sequences are left as-is
+    std::string result = text;
+
+    std::transform(
+        result.begin(),
+        result.end(),
+        result.begin(),
+        [](char c)
+        {
+            return c >= 'A' && c <= 'Z'
+                ? static_cast<char>(c - 'A' + 'a')
+                : c;
+        });
+
+    return result;
+}
+
+std::vector<uint32_t> TrigramText::Trigrams(std::string const& text)
+{
+    std::vector<uint32_t> result;
+
+    if (text.size() < 3)
+    {
+        return result;
+    }
+
+    result.reserve(text.size() - 2);
+
+    for (size_t i = 0; i + 2 < text.size(); i++)
+    {
+        result.push_back(
+            static_cast<uint32_t>(static_cast<uint8_t>(text[i])) << 16
+            | static_cast<uint32_t>(static_cast<uint8_t>(text[i + 1])) << 8
+            | static_cast<uint32_t>(static_cast<uint8_t>(text[i + 2])));
+    }
+
+    std::sort(result.begin(), result.end());
+    result.erase(std::unique(result.begin(), result.end()), result.end());
+
+    return result;
+}
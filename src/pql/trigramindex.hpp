@@ -0,0 +1,197 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <map>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace pt::PQL
+{
+    // ASCII case folding and trigram extraction, shared by the index and the
+    // per-row checks of '~'
+    class TrigramText
+    {
+    public:
+        // case insensitive substring match against an already normalized needle
+        static bool Contains(std::string const& text, std::string const& needle);
+        static std::string Normalize(std::string const& text);
+
+        // the sorted, unique trigrams of an already normalized text
+        static std::vector<uint32_t> Trigrams(std::string const& text);
+    };
+
+    // An in-memory trigram index over short texts such as torrent names. Each
+    // document gets a small id, which is what queries return, and ids of
+    // removed documents are reused.
+    template<typename TKey>
+    class TrigramIndex : public TrigramText
+    {
+    public:
+        void Clear()
+        {
+            m_ids.clear();
+            m_documents.clear();
+            m_free.clear();
+            m_postings.clear();
+        }
+
+        void Insert(TKey const& key, std::string const& text)
+        {
+            if (m_ids.find(key) != m_ids.end())
+            {
+                Update(key, text);
+                return;
+            }
+
+            uint32_t id;
+
+            if (m_free.empty())
+            {
+                id = static_cast<uint32_t>(m_documents.size());
+                m_documents.push_back({});
+            }
+            else
+            {
+                id = m_free.back();
+                m_free.pop_back();
+            }
+
+            Document& doc = m_documents[id];
+            doc.key = key;
+            doc.text = Normalize(text);
+
+            m_ids.insert({ key, id });
+
+            for (uint32_t trigram : Trigrams(doc.text))
+            {
+                auto& posting = m_postings[trigram];
+                posting.insert(std::lower_bound(posting.begin(), posting.end(), id), id);
+            }
+        }
+
+        void Remove(TKey const& key)
+        {
+            auto iter = m_ids.find(key);
+            if (iter == m_ids.end()) { return; }
+
+            uint32_t id = iter->second;
+            Document& doc = m_documents[id];
+
+            for (uint32_t trigram : Trigrams(doc.text))
+            {
+                auto posting = m_postings.find(trigram);
+                if (posting == m_postings.end()) { continue; }
+
+                auto& ids = posting->second;
+                auto pos = std::lower_bound(ids.begin(), ids.end(), id);
+
+                if (pos != ids.end() && *pos == id)
+                {
+                    ids.erase(pos);
+                }
+
+                if (ids.empty())
+                {
+                    m_postings.erase(posting);
+                }
+            }
+
+            doc.text.clear();
+            m_ids.erase(iter);
+            m_free.push_back(id);
+        }
+
+        void Update(TKey const& key, std::string const& text)
+        {
+            auto iter = m_ids.find(key);
+
+            if (iter != m_ids.end())
+            {
+                // the common case - nothing was renamed
+                if (m_documents[iter->second].text == Normalize(text)) { return; }
+                Remove(key);
+            }
+
+            Insert(key, text);
+        }
+
+        std::optional<uint32_t> Find(TKey const& key) const
+        {
+            auto iter = m_ids.find(key);
+            if (iter == m_ids.end()) { return std::nullopt; }
+            return iter->second;
+        }
+
+        TKey const& Key(uint32_t id) const
+        {
+            return m_documents.at(id).key;
+        }
+
+        // returns the sorted ids of every document that contains all trigrams
+        // of the needle, or nothing if the needle is too short to use the index
+        std::optional<std::vector<uint32_t>> Query(std::string const& needle) const
+        {
+            std::string normalized = Normalize(needle);
+
+            if (normalized.size() < 3)
+            {
+                return std::nullopt;
+            }
+
+            std::vector<std::vector<uint32_t> const*> postings;
+
+            for (uint32_t trigram : Trigrams(normalized))
+            {
+                auto iter = m_postings.find(trigram);
+
+                // no document has this trigram, so nothing can match
+                if (iter == m_postings.end())
+                {
+                    return std::vector<uint32_t>();
+                }
+
+                postings.push_back(&iter->second);
+            }
+
+            // intersect the smallest lists first to keep the working set small
+            std::sort(
+                postings.begin(),
+                postings.end(),
+                [](auto lhs, auto rhs) { return lhs->size() < rhs->size(); });
+
+            std::vector<uint32_t> result = *postings[0];
+
+            for (size_t i = 1; i < postings.size() && !result.empty(); i++)
+            {
+                std::vector<uint32_t> intersection;
+
+                std::set_intersection(
+                    result.begin(),
+                    result.end(),
+                    postings[i]->begin(),
+                    postings[i]->end(),
+                    std::back_inserter(intersection));
+
+                result = std::move(intersection);
+            }
+
+            return result;
+        }
+
+    private:
+        struct Document
+        {
+            TKey key;
+            std::string text;
+        };
+
+        std::map<TKey, uint32_t> m_ids;
+        std::vector<Document> m_documents;
+        std::vector<uint32_t> m_free;
+        std::unordered_map<uint32_t, std::vector<uint32_t>> m_postings;
+    };
+}
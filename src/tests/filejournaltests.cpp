@@ -0,0 +1,141 @@
+#include <chrono>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <libtorrent/bitfield.hpp>
+#include <libtorrent/file_storage.hpp>
+
+#include "../picotorrent/bittorrent/filejournal.hpp"
+#include "tempdirectory.hpp"
+
+namespace fs = std::filesystem;
+namespace lt = libtorrent;
+using pt::BitTorrent::FileJournal;
+using pt::Tests::TempDirectory;
+
+namespace
+{
+    const int PieceLength = 64 * 1024;
+
+    // a is in pieces 0 and 1, b only in piece 1 and c in pieces 1 to 3
+    lt::file_storage Storage(TempDirectory& dir)
+    {
+        lt::file_storage storage;
+        storage.add_file("set/a", PieceLength + 100);
+        storage.add_file("set/b", 300);
+        storage.add_file("set/c", PieceLength * 2);
+        storage.add_file("set/empty", 0);
+        storage.set_piece_length(PieceLength);
+        storage.set_num_pieces(static_cast<int>((storage.total_size() + PieceLength - 1) / PieceLength));
+
+        for (lt::file_index_t i : storage.file_range())
+        {
+            dir.Write(storage.file_path(i), storage.file_size(i), static_cast<uint32_t>(static_cast<int>(i) + 1));
+        }
+
+        return storage;
+    }
+
+    FileJournal Journal(TempDirectory& dir, lt::file_storage const& storage)
+    {
+        return FileJournal::Create(
+            storage,
+            dir.Path().string(),
+            lt::typed_bitfield<lt::piece_index_t>(storage.num_pieces(), true));
+    }
+
+    void Touch(fs::path const& path)
+    {
+        fs::last_write_time(path, fs::last_write_time(path) - std::chrono::hours(1));
+    }
+
+    std::vector<lt::piece_index_t> Pieces(std::vector<int> const& pieces)
+    {
+        return std::vector<lt::piece_index_t>(pieces.begin(), pieces.end());
+    }
+}
+
+TEST(FileJournalTest, UnchangedFilesHaveNoPieces)
+{
+    TempDirectory dir;
+    lt::file_storage storage = Storage(dir);
+    FileJournal journal = Journal(dir, storage);
+
+    EXPECT_EQ(4, storage.num_pieces());
+    EXPECT_EQ(dir.Path().string(), journal.SavePath());
+    EXPECT_TRUE(journal.Verified().all_set());
+    EXPECT_TRUE(journal.ChangedPieces(storage).empty());
+}
+
+TEST(FileJournalTest, ChangedSizeIncludesSharedPieces)
+{
+    TempDirectory dir;
+    lt::file_storage storage = Storage(dir);
+    FileJournal journal = Journal(dir, storage);
+
+    fs::resize_file(dir.Path() / "set" / "b", 200);
+
+    EXPECT_EQ(Pieces({ 1 }), journal.ChangedPieces(storage));
+}
+
+TEST(FileJournalTest, ChangedMtimeIncludesSharedPieces)
+{
+    TempDirectory dir;
+    lt::file_storage storage = Storage(dir);
+    FileJournal journal = Journal(dir, storage);
+
+    Touch(dir.Path() / "set" / "a");
+
+    EXPECT_EQ(Pieces({ 0, 1 }), journal.ChangedPieces(storage));
+}
+
+TEST(FileJournalTest, MissingFileHasAllItsPieces)
+{
+    TempDirectory dir;
+    lt::file_storage storage = Storage(dir);
+    FileJournal journal = Journal(dir, storage);
+
+    fs::remove(dir.Path() / "set" / "c");
+
+    EXPECT_EQ(Pieces({ 1, 2, 3 }), journal.ChangedPieces(storage));
+}
+
+TEST(FileJournalTest, PiecesAreSortedWithoutDuplicates)
+{
+    TempDirectory dir;
+    lt::file_storage storage = Storage(dir);
+    FileJournal journal = Journal(dir, storage);
+
+    // all three share piece 1
+    fs::remove(dir.Path() / "set" / "c");
+    fs::resize_file(dir.Path() / "set" / "b", 200);
+    Touch(dir.Path() / "set" / "a");
+
+    EXPECT_EQ(Pieces({ 0, 1, 2, 3 }), journal.ChangedPieces(storage));
+}
+
+TEST(FileJournalTest, EmptyFilesAreIgnored)
+{
+    TempDirectory dir;
+    lt::file_storage storage = Storage(dir);
+    FileJournal journal = Journal(dir, storage);
+
+    fs::remove(dir.Path() / "set" / "empty");
+
+    EXPECT_TRUE(journal.ChangedPieces(storage).empty());
+}
+
+TEST(FileJournalTest, MissingAtCreationIsAlwaysChanged)
+{
+    TempDirectory dir;
+    lt::file_storage storage = Storage(dir);
+
+    fs::remove(dir.Path() / "set" / "a");
+    FileJournal journal = Journal(dir, storage);
+
+    dir.Write("set/a", PieceLength + 100, 1);
+
+    EXPECT_EQ(Pieces({ 0, 1 }), journal.ChangedPieces(storage));
+}
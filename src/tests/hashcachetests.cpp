@@ -0,0 +1,303 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <libtorrent/bencode.hpp>
+#include <libtorrent/create_torrent.hpp>
+#include <libtorrent/file_storage.hpp>
+#include <libtorrent/torrent_info.hpp>
+
+#include "../picotorrent/bittorrent/hashcache.hpp"
+#include "../picotorrent/bittorrent/piecehasher.hpp"
+#include "tempdirectory.hpp"
+
+namespace fs = std::filesystem;
+namespace lt = libtorrent;
+using pt::BitTorrent::HashCache;
+using pt::BitTorrent::PieceHasher;
+using pt::Tests::TempDirectory;
+
+namespace
+{
+    const int PieceLength = 64 * 1024;
+
+    struct File
+    {
+        std::string name;
+        std::int64_t size;
+    };
+
+    lt::file_storage Layout(std::vector<File> const& files)
+    {
+        lt::file_storage storage;
+
+        for (File const& file : files)
+        {
+            storage.add_file("set/" + file.name, file.size);
+        }
+
+        return storage;
+    }
+
+    // creates the torrent, with the PieceHasher when given a cache and with
+    // libtorrent's own set_piece_hashes as the reference otherwise
+    lt::torrent_info Create(std::vector<File> const& files, lt::create_flags_t flags, fs::path const& base, HashCache* cache)
+    {
+        lt::file_storage storage = Layout(files);
+        lt::create_torrent ct(storage, PieceLength, flags);
+        lt::error_code ec;
+
+        if (cache)
+        {
+            std::atomic<bool> cancelled{ false };
+            PieceHasher(2, cache).Hash(ct, base.string(), nullptr, cancelled, ec);
+        }
+        else
+        {
+            lt::set_piece_hashes(ct, base.string(), ec);
+        }
+
+        EXPECT_FALSE(ec) << ec.message();
+
+        std::vector<char> buffer;
+        lt::bencode(std::back_inserter(buffer), ct.generate());
+
+        return lt::torrent_info(buffer, lt::from_span);
+    }
+
+    template<typename Hash>
+    Hash Garbage()
+    {
+        Hash hash;
+        std::fill(hash.begin(), hash.end(), static_cast<char>(0xab));
+        return hash;
+    }
+
+    // the cache key, as the PieceHasher computes it
+    std::string CachePath(fs::path const& base, std::string const& name)
+    {
+        return fs::absolute(base / "set" / name).lexically_normal().u8string();
+    }
+
+    // replaces every cached hash of a file with garbage, so a piece which is
+    // taken from the cache afterwards is easy to tell from one that was hashed
+    void Poison(HashCache& cache, fs::path const& base, std::string const& name, std::int64_t size)
+    {
+        std::string path = CachePath(base, name);
+        HashCache::Entry const* entry = cache.Find(path, size, HashCache::LastWriteTime(path), PieceLength);
+        ASSERT_NE(nullptr, entry);
+
+        HashCache::Entry poisoned = *entry;
+        for (auto& hash : poisoned.v1) { hash = Garbage<lt::sha1_hash>(); }
+        for (auto& hash : poisoned.v2) { hash = Garbage<lt::sha256_hash>(); }
+
+        cache.Store(path, std::move(poisoned));
+    }
+}
+
+TEST(HashCacheTest, FindMissesOnChangedFile)
+{
+    HashCache cache(fs::path("unused"));
+
+    HashCache::Entry entry{};
+    entry.size = 1000;
+    entry.mtime = 42;
+    entry.pieceLength = PieceLength;
+
+    cache.Store("/a", entry);
+
+    EXPECT_NE(nullptr, cache.Find("/a", 1000, 42, PieceLength));
+    EXPECT_EQ(nullptr, cache.Find("/b", 1000, 42, PieceLength));
+    EXPECT_EQ(nullptr, cache.Find("/a", 1001, 42, PieceLength));
+    EXPECT_EQ(nullptr, cache.Find("/a", 1000, 43, PieceLength));
+    EXPECT_EQ(nullptr, cache.Find("/a", 1000, 42, PieceLength * 2));
+}
+
+TEST(HashCacheTest, SaveAndLoad)
+{
+    TempDirectory dir;
+    fs::path file = dir.Path() / "hashcache.bin";
+
+    HashCache::Entry entry{};
+    entry.size = 3 * PieceLength;
+    entry.mtime = 1234567890123;
+    entry.pieceLength = PieceLength;
+    entry.alignment = 17;
+    entry.tailPadding = 99;
+    entry.v1 = { Garbage<lt::sha1_hash>(), lt::sha1_hash() };
+    entry.v2 = { Garbage<lt::sha256_hash>() };
+
+    {
+        HashCache cache(file);
+        cache.Store("/some/file", entry);
+        ASSERT_TRUE(cache.Save());
+    }
+
+    HashCache cache(file);
+    cache.Load();
+
+    HashCache::Entry const* loaded = cache.Find("/some/file", entry.size, entry.mtime, PieceLength);
+    ASSERT_NE(nullptr, loaded);
+    EXPECT_EQ(entry.alignment, loaded->alignment);
+    EXPECT_EQ(entry.tailPadding, loaded->tailPadding);
+    EXPECT_EQ(entry.v1, loaded->v1);
+    EXPECT_EQ(entry.v2, loaded->v2);
+
+    // a truncated cache is dropped as a whole
+    fs::resize_file(file, fs::file_size(file) - 1);
+    cache.Load();
+    EXPECT_EQ(nullptr, cache.Find("/some/file", entry.size, entry.mtime, PieceLength));
+}
+
+TEST(HashCacheTest, CorruptCountsAreIgnored)
+{
+    TempDirectory dir;
+    fs::path file = dir.Path() / "hashcache.bin";
+    std::string const path = "/some/file";
+
+    HashCache::Entry entry{};
+    entry.size = PieceLength;
+    entry.mtime = 42;
+    entry.pieceLength = PieceLength;
+    entry.v1 = { Garbage<lt::sha1_hash>() };
+
+    // magic, version and entry count, then the path and the fixed fields
+    std::streamoff const pathLength = 12;
+    std::streamoff const v1Count = pathLength + 4 + static_cast<std::streamoff>(path.size()) + 8 + 8 + 4 + 4 + 4;
+
+    for (std::streamoff offset : { pathLength, v1Count })
+    {
+        {
+            HashCache cache(file);
+            cache.Store(path, entry);
+            ASSERT_TRUE(cache.Save());
+        }
+
+        {
+            std::fstream patch(file, std::ios::binary | std::ios::in | std::ios::out);
+            uint32_t const huge = 0xfffffff0;
+            patch.seekp(offset);
+            patch.write(reinterpret_cast<char const*>(&huge), sizeof(huge));
+        }
+
+        HashCache cache(file);
+        EXPECT_NO_THROW(cache.Load());
+        EXPECT_EQ(nullptr, cache.Find(path, entry.size, entry.mtime, PieceLength));
+    }
+}
+
+TEST(HashCacheTest, HashesMatchLibtorrentWithAndWithoutCache)
+{
+    TempDirectory dir;
+    dir.Write("set/a.bin", PieceLength * 3 / 2, 1);
+    dir.Write("set/b.bin", PieceLength * 4 + 100, 2);
+    dir.Write("set/c.bin", 1000, 3);
+
+    std::vector<File> files = { { "a.bin", PieceLength * 3 / 2 }, { "b.bin", PieceLength * 4 + 100 }, { "c.bin", 1000 } };
+
+    for (lt::create_flags_t flags : { lt::create_torrent::v1_only, lt::create_torrent::v2_only, lt::create_flags_t{} })
+    {
+        HashCache cache(dir.Path() / "hashcache.bin");
+
+        lt::torrent_info reference = Create(files, flags, dir.Path(), nullptr);
+        lt::torrent_info cold = Create(files, flags, dir.Path(), &cache);
+        lt::torrent_info warm = Create(files, flags, dir.Path(), &cache);
+
+        EXPECT_EQ(reference.info_hashes(), cold.info_hashes());
+        EXPECT_EQ(reference.info_hashes(), warm.info_hashes());
+    }
+}
+
+// v1 hashes of a file depend on where it starts relative to the piece
+// boundaries, so they can not be reused once a file before it changed size
+TEST(HashCacheTest, AlignmentChangeMissesV1)
+{
+    TempDirectory dir;
+    dir.Write("set/a.bin", PieceLength * 3 / 2, 1);
+    dir.Write("set/a2.bin", PieceLength * 5 / 4, 2);
+    dir.Write("set/b.bin", PieceLength * 4, 3);
+
+    std::vector<File> before = { { "a.bin", PieceLength * 3 / 2 }, { "b.bin", PieceLength * 4 } };
+    std::vector<File> after = { { "a2.bin", PieceLength * 5 / 4 }, { "b.bin", PieceLength * 4 } };
+
+    HashCache cache(dir.Path() / "hashcache.bin");
+    Create(before, lt::create_torrent::v1_only, dir.Path(), &cache);
+    Poison(cache, dir.Path(), "b.bin", PieceLength * 4);
+
+    // same layout - the three pieces which lie in b.bin alone come from the cache
+    lt::torrent_info same = Create(before, lt::create_torrent::v1_only, dir.Path(), &cache);
+    EXPECT_EQ(Garbage<lt::sha1_hash>(), same.hash_for_piece(lt::piece_index_t(2)));
+    EXPECT_EQ(Garbage<lt::sha1_hash>(), same.hash_for_piece(lt::piece_index_t(4)));
+    EXPECT_NE(Garbage<lt::sha1_hash>(), same.hash_for_piece(lt::piece_index_t(1)));
+
+    // shifted by a quarter piece - nothing may come from the cache
+    lt::torrent_info shifted = Create(after, lt::create_torrent::v1_only, dir.Path(), &cache);
+    EXPECT_EQ(Create(after, lt::create_torrent::v1_only, dir.Path(), nullptr).info_hashes(), shifted.info_hashes());
+}
+
+// the last v1 piece of a file includes the padding after it, so it can only
+// be reused if the file is padded the same way
+TEST(HashCacheTest, PaddingChangeMissesTailPiece)
+{
+    TempDirectory dir;
+    dir.Write("set/a.bin", PieceLength, 1);
+    dir.Write("set/b.bin", PieceLength * 5 / 2, 2);
+    dir.Write("set/c.bin", PieceLength, 3);
+
+    std::vector<File> padded = { { "a.bin", PieceLength }, { "b.bin", PieceLength * 5 / 2 }, { "c.bin", PieceLength } };
+    std::vector<File> last = { { "a.bin", PieceLength }, { "b.bin", PieceLength * 5 / 2 } };
+
+    // hybrid torrents pad every file but the last to a piece boundary
+    HashCache cache(dir.Path() / "hashcache.bin");
+    Create(padded, {}, dir.Path(), &cache);
+    Poison(cache, dir.Path(), "b.bin", PieceLength * 5 / 2);
+
+    lt::torrent_info ti = Create(last, {}, dir.Path(), &cache);
+    lt::torrent_info reference = Create(last, {}, dir.Path(), nullptr);
+
+    EXPECT_EQ(Garbage<lt::sha1_hash>(), ti.hash_for_piece(lt::piece_index_t(1)));
+    EXPECT_EQ(Garbage<lt::sha1_hash>(), ti.hash_for_piece(lt::piece_index_t(2)));
+    EXPECT_EQ(reference.hash_for_piece(lt::piece_index_t(3)), ti.hash_for_piece(lt::piece_index_t(3)));
+}
+
+// v2 piece roots only depend on the file itself
+TEST(HashCacheTest, AlignmentChangeStillHitsV2)
+{
+    TempDirectory dir;
+    dir.Write("set/a.bin", PieceLength * 3 / 2, 1);
+    dir.Write("set/a2.bin", PieceLength * 5 / 4, 2);
+    dir.Write("set/b.bin", PieceLength * 4, 3);
+
+    HashCache cache(dir.Path() / "hashcache.bin");
+    Create({ { "a.bin", PieceLength * 3 / 2 }, { "b.bin", PieceLength * 4 } }, lt::create_torrent::v2_only, dir.Path(), &cache);
+    Poison(cache, dir.Path(), "b.bin", PieceLength * 4);
+
+    std::vector<File> after = { { "a2.bin", PieceLength * 5 / 4 }, { "b.bin", PieceLength * 4 } };
+    lt::torrent_info ti = Create(after, lt::create_torrent::v2_only, dir.Path(), &cache);
+
+    EXPECT_NE(Create(after, lt::create_torrent::v2_only, dir.Path(), nullptr).info_hashes(), ti.info_hashes());
+}
+
+TEST(HashCacheTest, ModifiedFileMisses)
+{
+    TempDirectory dir;
+    dir.Write("set/a.bin", PieceLength * 3, 1);
+
+    std::vector<File> files = { { "a.bin", PieceLength * 3 } };
+
+    HashCache cache(dir.Path() / "hashcache.bin");
+    Create(files, {}, dir.Path(), &cache);
+    Poison(cache, dir.Path(), "a.bin", PieceLength * 3);
+
+    // same size, new content and mtime
+    dir.Write("set/a.bin", PieceLength * 3, 2);
+    fs::last_write_time(dir.Path() / "set" / "a.bin", fs::file_time_type::clock::now() + std::chrono::hours(1));
+
+    EXPECT_EQ(Create(files, {}, dir.Path(), nullptr).info_hashes(), Create(files, {}, dir.Path(), &cache).info_hashes());
+}
@@ -0,0 +1,198 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <libtorrent/info_hash.hpp>
+#include <libtorrent/sha1_hash.hpp>
+
+#include "../picotorrent/bittorrent/movescheduler.hpp"
+
+namespace lt = libtorrent;
+using pt::BitTorrent::MoveScheduler;
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    lt::info_hash_t Hash(int n)
+    {
+        lt::sha1_hash hash;
+        hash[0] = static_cast<std::uint8_t>(n);
+        return lt::info_hash_t(hash);
+    }
+
+    // the volume is everything before the first slash, "fast/a" is on "fast"
+    MoveScheduler Scheduler(int perSource, int perDestination)
+    {
+        MoveScheduler scheduler([](std::string const& path) { return path.substr(0, path.find('/')); });
+        scheduler.SetLimits({ perSource, perDestination, 2, std::chrono::seconds(10) });
+        return scheduler;
+    }
+
+    std::vector<lt::info_hash_t> Hashes(std::vector<MoveScheduler::Move> const& moves)
+    {
+        std::vector<lt::info_hash_t> hashes;
+        for (auto const& move : moves) { hashes.push_back(move.infoHash); }
+        return hashes;
+    }
+}
+
+TEST(MoveSchedulerTest, SmallestFirst)
+{
+    MoveScheduler scheduler = Scheduler(10, 10);
+    scheduler.Enqueue(Hash(1), "fast/1", "slow/1", 300);
+    scheduler.Enqueue(Hash(2), "fast/2", "slow/2", 100);
+    scheduler.Enqueue(Hash(3), "fast/3", "slow/3", 200);
+
+    EXPECT_EQ((std::vector<lt::info_hash_t>{ Hash(2), Hash(3), Hash(1) }), Hashes(scheduler.Next(Clock::now())));
+}
+
+TEST(MoveSchedulerTest, PerSourceLimit)
+{
+    Clock::time_point const now = Clock::now();
+    MoveScheduler scheduler = Scheduler(1, 10);
+    scheduler.Enqueue(Hash(1), "fast/1", "slow/1", 100);
+    scheduler.Enqueue(Hash(2), "fast/2", "other/2", 200);
+    scheduler.Enqueue(Hash(3), "ssd/3", "slow/3", 300);
+
+    EXPECT_EQ((std::vector<lt::info_hash_t>{ Hash(1), Hash(3) }), Hashes(scheduler.Next(now)));
+    EXPECT_TRUE(scheduler.Next(now).empty());
+
+    scheduler.Finished(Hash(1));
+    EXPECT_EQ((std::vector<lt::info_hash_t>{ Hash(2) }), Hashes(scheduler.Next(now)));
+}
+
+TEST(MoveSchedulerTest, PerDestinationLimit)
+{
+    Clock::time_point const now = Clock::now();
+    MoveScheduler scheduler = Scheduler(10, 1);
+    scheduler.Enqueue(Hash(1), "fast/1", "slow/1", 100);
+    scheduler.Enqueue(Hash(2), "ssd/2", "slow/2", 200);
+    scheduler.Enqueue(Hash(3), "ssd/3", "other/3", 300);
+
+    EXPECT_EQ((std::vector<lt::info_hash_t>{ Hash(1), Hash(3) }), Hashes(scheduler.Next(now)));
+    EXPECT_TRUE(scheduler.Next(now).empty());
+
+    // removing an active move frees its slots
+    scheduler.Remove(Hash(1));
+    EXPECT_EQ((std::vector<lt::info_hash_t>{ Hash(2) }), Hashes(scheduler.Next(now)));
+}
+
+TEST(MoveSchedulerTest, RenamesAreNotLimited)
+{
+    Clock::time_point const now = Clock::now();
+    MoveScheduler scheduler = Scheduler(1, 1);
+    scheduler.Enqueue(Hash(1), "fast/1", "slow/1", 100);
+    scheduler.Enqueue(Hash(2), "fast/2", "fast/done/2", 200);
+    scheduler.Enqueue(Hash(3), "slow/3", "slow/done/3", 300);
+
+    EXPECT_EQ((std::vector<lt::info_hash_t>{ Hash(1), Hash(2), Hash(3) }), Hashes(scheduler.Next(now)));
+
+    // and do not take up a slot either
+    scheduler.Finished(Hash(1));
+    scheduler.Enqueue(Hash(4), "fast/4", "slow/4", 400);
+    EXPECT_EQ((std::vector<lt::info_hash_t>{ Hash(4) }), Hashes(scheduler.Next(now)));
+}
+
+TEST(MoveSchedulerTest, UnknownVolumeIsThePath)
+{
+    MoveScheduler scheduler([](std::string const&) { return std::string(); });
+    scheduler.Enqueue(Hash(1), "fast/1", "fast/done/1", 100);
+    scheduler.Enqueue(Hash(2), "fast/2", "fast/done/2", 200);
+
+    // so neither move shares a volume with the other
+    std::vector<MoveScheduler::Move> moves = scheduler.Next(Clock::now());
+    ASSERT_EQ(2u, moves.size());
+    EXPECT_EQ("fast/1", moves[0].sourceVolume);
+    EXPECT_EQ("fast/done/1", moves[0].destinationVolume);
+}
+
+TEST(MoveSchedulerTest, RetriesWithBackoff)
+{
+    Clock::time_point const now = Clock::now();
+    MoveScheduler scheduler = Scheduler(1, 1);
+    scheduler.Enqueue(Hash(1), "fast/1", "slow/1", 100);
+    ASSERT_EQ(1u, scheduler.Next(now).size());
+
+    EXPECT_TRUE(scheduler.Failed(Hash(1), now));
+    EXPECT_TRUE(scheduler.Next(now + std::chrono::seconds(9)).empty());
+
+    std::vector<MoveScheduler::Move> moves = scheduler.Next(now + std::chrono::seconds(10));
+    ASSERT_EQ(1u, moves.size());
+    EXPECT_EQ(1, moves[0].attempts);
+
+    // the second attempt waits twice as long
+    EXPECT_TRUE(scheduler.Failed(Hash(1), now));
+    EXPECT_TRUE(scheduler.Next(now + std::chrono::seconds(19)).empty());
+    ASSERT_EQ(1u, scheduler.Next(now + std::chrono::seconds(20)).size());
+
+    EXPECT_FALSE(scheduler.Failed(Hash(1), now));
+    EXPECT_FALSE(scheduler.Contains(Hash(1)));
+    EXPECT_TRUE(scheduler.Empty());
+    EXPECT_EQ(1, scheduler.Statistics().failed);
+}
+
+TEST(MoveSchedulerTest, DeferKeepsAttempts)
+{
+    Clock::time_point const now = Clock::now();
+    MoveScheduler scheduler = Scheduler(1, 1);
+    scheduler.Enqueue(Hash(1), "fast/1", "slow/1", 100);
+    scheduler.Enqueue(Hash(2), "fast/2", "slow/2", 200);
+    ASSERT_EQ(1u, scheduler.Next(now).size());
+
+    for (int i = 1; i <= 5; i++)
+    {
+        scheduler.Defer(Hash(1), now + std::chrono::seconds(i));
+        EXPECT_TRUE(scheduler.Contains(Hash(1)));
+
+        // the deferred move frees its slot
+        std::vector<MoveScheduler::Move> moves = scheduler.Next(now + std::chrono::seconds(i));
+        ASSERT_EQ(1u, moves.size());
+        EXPECT_EQ(Hash(1), moves[0].infoHash);
+        EXPECT_EQ(0, moves[0].attempts);
+    }
+
+    scheduler.Defer(Hash(1), now + std::chrono::seconds(10));
+    EXPECT_EQ((std::vector<lt::info_hash_t>{ Hash(2) }), Hashes(scheduler.Next(now)));
+}
+
+TEST(MoveSchedulerTest, EnqueueReplacesQueuedMove)
+{
+    MoveScheduler scheduler = Scheduler(1, 1);
+    scheduler.Enqueue(Hash(1), "fast/1", "slow/1", 100);
+    scheduler.Enqueue(Hash(1), "fast/1", "other/1", 100);
+
+    std::vector<MoveScheduler::Move> moves = scheduler.Next(Clock::now());
+    ASSERT_EQ(1u, moves.size());
+    EXPECT_EQ("other/1", moves[0].destination);
+}
+
+TEST(MoveSchedulerTest, Statistics)
+{
+    Clock::time_point const now = Clock::now();
+    MoveScheduler scheduler = Scheduler(1, 1);
+    scheduler.Enqueue(Hash(1), "fast/1", "slow/1", 100);
+    scheduler.Enqueue(Hash(2), "fast/2", "slow/2", 200);
+    scheduler.Next(now);
+
+    auto stats = scheduler.Statistics();
+    EXPECT_EQ(1, stats.active);
+    EXPECT_EQ(1, stats.queued);
+    EXPECT_EQ(300, stats.bytesRemaining);
+
+    scheduler.Finished(Hash(1));
+    stats = scheduler.Statistics();
+    EXPECT_EQ(0, stats.active);
+    EXPECT_EQ(1, stats.finished);
+    EXPECT_EQ(200, stats.bytesRemaining);
+
+    // counting starts over once the queue has been empty
+    scheduler.Next(now);
+    scheduler.Finished(Hash(2));
+    EXPECT_TRUE(scheduler.Empty());
+    scheduler.Enqueue(Hash(3), "fast/3", "slow/3", 300);
+    EXPECT_EQ(0, scheduler.Statistics().finished);
+}
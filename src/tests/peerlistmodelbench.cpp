@@ -0,0 +1,166 @@
+#include <wx/wxprec.h>
+#ifndef WX_PRECOMP
+#include <wx/wx.h>
+#endif
+
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <libtorrent/peer_info.hpp>
+
+#include "../picotorrent/ui/models/peerlistmodel.hpp"
+
+namespace lt = libtorrent;
+using pt::UI::Models::PeerListModel;
+
+static std::vector<lt::peer_info> GeneratePeers(size_t count, uint32_t first = 0)
+{
+    static const char* Clients[] = { "qBittorrent 4.6.2", "Transmission 4.0.5", "libtorrent 2.0.9", "PicoTorrent 3.0.0", "uTorrent 3.6.0", "Deluge 2.1.1" };
+
+    std::mt19937 rng(first + 1);
+    std::vector<lt::peer_info> peers(count);
+
+    for (size_t i = 0; i < count; i++)
+    {
+        lt::peer_info& peer = peers[i];
+        uint32_t n = first + static_cast<uint32_t>(i);
+
+        peer.ip = lt::tcp::endpoint(lt::address_v4(0x0a000000 + n), static_cast<unsigned short>(6881 + n % 1000));
+        peer.client = Clients[rng() % std::size(Clients)];
+        peer.flags = lt::peer_info::interesting | lt::peer_info::outgoing_connection;
+        peer.payload_down_speed = static_cast<int>(rng() % (512 * 1024));
+        peer.payload_up_speed = static_cast<int>(rng() % (128 * 1024));
+        peer.progress = static_cast<float>(rng() % 1001) / 1000.0f;
+    }
+
+    return peers;
+}
+
+// a refresh of a busy swarm: the same peers, but most of them changed rates
+static void BM_PeerListUpdateRates(benchmark::State& state)
+{
+    auto peers = GeneratePeers(static_cast<size_t>(state.range(0)));
+    std::mt19937 rng(1);
+
+    wxObjectDataPtr<PeerListModel> model(new PeerListModel());
+    model->Update(peers);
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        for (auto& peer : peers)
+        {
+            if (rng() % 4 != 0) { peer.payload_down_speed = static_cast<int>(rng() % (512 * 1024)); }
+        }
+        state.ResumeTiming();
+
+        model->Update(peers);
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// a tenth of the peers leave and as many new ones connect on every refresh
+static void BM_PeerListUpdateChurn(benchmark::State& state)
+{
+    size_t const count = static_cast<size_t>(state.range(0));
+    auto peers = GeneratePeers(count);
+    auto fresh = GeneratePeers(count * 100, static_cast<uint32_t>(count));
+    size_t next = 0;
+
+    wxObjectDataPtr<PeerListModel> model(new PeerListModel());
+    model->Update(peers);
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        for (size_t i = 0; i < count / 10; i++)
+        {
+            peers[(next * 7 + i * 10) % count] = fresh[next % fresh.size()];
+            next++;
+        }
+        state.ResumeTiming();
+
+        model->Update(peers);
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// opening the peers tab of a torrent
+static void BM_PeerListUpdateInitial(benchmark::State& state)
+{
+    auto peers = GeneratePeers(static_cast<size_t>(state.range(0)));
+    wxObjectDataPtr<PeerListModel> model(new PeerListModel());
+
+    for (auto _ : state)
+    {
+        model->ResetPeers();
+        model->Update(peers);
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// what the view asks for when it repaints after an update
+static void BM_PeerListPaint(benchmark::State& state)
+{
+    auto peers = GeneratePeers(static_cast<size_t>(state.range(0)));
+    std::mt19937 rng(1);
+
+    wxObjectDataPtr<PeerListModel> model(new PeerListModel());
+    model->Update(peers);
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        for (auto& peer : peers)
+        {
+            if (rng() % 4 != 0) { peer.payload_down_speed = static_cast<int>(rng() % (512 * 1024)); }
+        }
+        model->Update(peers);
+        state.ResumeTiming();
+
+        wxVariant value;
+
+        for (unsigned int row = 0; row < peers.size(); row++)
+        {
+            for (unsigned int col = 0; col < PeerListModel::Column::_Max; col++)
+            {
+                model->GetValue(value, model->GetItem(row), col);
+            }
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_PeerListUpdateRates)->Arg(2000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_PeerListUpdateChurn)->Arg(2000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_PeerListUpdateInitial)->Arg(2000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_PeerListPaint)->Arg(2000)->Unit(benchmark::kMicrosecond);
+
+int main(int argc, char** argv)
+{
+    // the models need wx to be initialized, but no application or window
+    wxInitializer initializer;
+
+    if (!initializer.IsOk())
+    {
+        return 1;
+    }
+
+    benchmark::Initialize(&argc, argv);
+
+    if (benchmark::ReportUnrecognizedArguments(argc, argv))
+    {
+        return 1;
+    }
+
+    benchmark::RunSpecifiedBenchmarks();
+
+    return 0;
+}
@@ -0,0 +1,236 @@
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <libtorrent/create_torrent.hpp>
+#include <libtorrent/file_storage.hpp>
+
+#include "../picotorrent/bittorrent/hashcache.hpp"
+#include "../picotorrent/bittorrent/piecehasher.hpp"
+
+namespace fs = std::filesystem;
+namespace lt = libtorrent;
+using pt::BitTorrent::HashCache;
+using pt::BitTorrent::PieceHasher;
+
+namespace
+{
+    struct DataSet
+    {
+        const char* name;
+        int files;
+        std::int64_t fileSize;
+    };
+
+    // the same 256 MB as a few large files and as many small ones, where the
+    // per-file work and the v2 padding start to matter
+    const DataSet Sets[] =
+    {
+        { "2 x 128 MB", 2, 128 * 1024 * 1024 },
+        { "2048 x 128 KB", 2048, 128 * 1024 },
+        { "300 x 1 MB - 17", 300, 1024 * 1024 - 17 },
+    };
+
+    const lt::create_flags_t Modes[] =
+    {
+        lt::create_torrent::v1_only,
+        lt::create_torrent::v2_only,
+        {},
+    };
+
+    const char* ModeNames[] = { "v1", "v2", "hybrid" };
+
+    // Random data written once per run to the temp directory and removed when
+    // the benchmark exits. After the first iteration it is served from the
+    // page cache, so these numbers are about hashing, not the disk.
+    class DataSetFiles
+    {
+    public:
+        ~DataSetFiles()
+        {
+            std::error_code ec;
+            fs::remove_all(Root(), ec);
+        }
+
+        static std::string const& Path(int index)
+        {
+            static DataSetFiles instance;
+
+            auto iter = instance.m_paths.find(index);
+
+            if (iter == instance.m_paths.end())
+            {
+                iter = instance.m_paths.insert({ index, Generate(index) }).first;
+            }
+
+            return iter->second;
+        }
+
+    private:
+        static fs::path Root()
+        {
+            return fs::temp_directory_path() / "picotorrent-bench";
+        }
+
+        static std::string Generate(int index)
+        {
+            DataSet const& ds = Sets[index];
+            fs::path dir = Root() / std::to_string(index);
+            fs::create_directories(dir);
+
+            std::mt19937_64 rng(index + 1);
+            std::vector<std::uint64_t> buffer(static_cast<size_t>(ds.fileSize / 8) + 1);
+
+            for (int f = 0; f < ds.files; f++)
+            {
+                for (auto& word : buffer) { word = rng(); }
+
+                std::ofstream out(dir / ("file-" + std::to_string(f) + ".bin"), std::ios::binary);
+                out.write(reinterpret_cast<char const*>(buffer.data()), ds.fileSize);
+            }
+
+            return dir.string();
+        }
+
+        std::map<int, std::string> m_paths;
+    };
+
+    lt::file_storage Files(int index)
+    {
+        lt::file_storage files;
+        lt::add_files(files, DataSetFiles::Path(index));
+        return files;
+    }
+
+    std::string BasePath(int index)
+    {
+        return fs::path(DataSetFiles::Path(index)).parent_path().string();
+    }
+
+    void SetLabel(benchmark::State& state)
+    {
+        state.SetLabel(std::string(Sets[state.range(0)].name) + ", " + ModeNames[state.range(1)]);
+        state.SetBytesProcessed(state.iterations() * Sets[state.range(0)].files * Sets[state.range(0)].fileSize);
+    }
+}
+
+// args are the data set, the torrent mode and the number of hashing threads
+static void BM_PieceHasher(benchmark::State& state)
+{
+    lt::file_storage const files = Files(static_cast<int>(state.range(0)));
+    std::string const base = BasePath(static_cast<int>(state.range(0)));
+    std::atomic<bool> cancelled{ false };
+
+    for (auto _ : state)
+    {
+        // create_torrent keeps a reference to the files and may add pad
+        // files to them for v2, so every torrent is made from its own copy
+        lt::file_storage copy = files;
+        lt::create_torrent ct(copy, 0, Modes[state.range(1)]);
+        lt::error_code ec;
+
+        PieceHasher(static_cast<int>(state.range(2))).Hash(ct, base, nullptr, cancelled, ec);
+
+        if (ec)
+        {
+            state.SkipWithError(ec.message().c_str());
+            break;
+        }
+    }
+
+    SetLabel(state);
+}
+
+// creating the same torrent again, where every piece comes from the cache
+static void BM_PieceHasherCached(benchmark::State& state)
+{
+    lt::file_storage const files = Files(static_cast<int>(state.range(0)));
+    std::string const base = BasePath(static_cast<int>(state.range(0)));
+    std::atomic<bool> cancelled{ false };
+
+    HashCache cache(fs::temp_directory_path() / "picotorrent-bench" / "hashcache.bin");
+    lt::error_code ec;
+
+    {
+        lt::file_storage copy = files;
+        lt::create_torrent ct(copy, 0, Modes[state.range(1)]);
+        PieceHasher(0, &cache).Hash(ct, base, nullptr, cancelled, ec);
+    }
+
+    for (auto _ : state)
+    {
+        lt::file_storage copy = files;
+        lt::create_torrent ct(copy, 0, Modes[state.range(1)]);
+        PieceHasher(0, &cache).Hash(ct, base, nullptr, cancelled, ec);
+
+        if (ec)
+        {
+            state.SkipWithError(ec.message().c_str());
+            break;
+        }
+    }
+
+    SetLabel(state);
+}
+
+// what the create torrent dialog used before, a single hashing thread
+static void BM_SetPieceHashes(benchmark::State& state)
+{
+    lt::file_storage const files = Files(static_cast<int>(state.range(0)));
+    std::string const base = BasePath(static_cast<int>(state.range(0)));
+
+    for (auto _ : state)
+    {
+        lt::file_storage copy = files;
+        lt::create_torrent ct(copy, 0, Modes[state.range(1)]);
+        lt::error_code ec;
+
+        lt::set_piece_hashes(ct, base, ec);
+
+        if (ec)
+        {
+            state.SkipWithError(ec.message().c_str());
+            break;
+        }
+    }
+
+    SetLabel(state);
+}
+
+static void HasherArgs(benchmark::internal::Benchmark* b)
+{
+    int const cores = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+
+    for (int ds = 0; ds < static_cast<int>(std::size(Sets)); ds++)
+    {
+        for (int mode = 0; mode < static_cast<int>(std::size(Modes)); mode++)
+        {
+            b->Args({ ds, mode, 1 });
+            if (cores > 1) { b->Args({ ds, mode, cores }); }
+        }
+    }
+}
+
+static void BaselineArgs(benchmark::internal::Benchmark* b)
+{
+    for (int ds = 0; ds < static_cast<int>(std::size(Sets)); ds++)
+    {
+        for (int mode = 0; mode < static_cast<int>(std::size(Modes)); mode++)
+        {
+            b->Args({ ds, mode });
+        }
+    }
+}
+
+BENCHMARK(BM_PieceHasher)->Apply(HasherArgs)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_PieceHasherCached)->Apply(BaselineArgs)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_SetPieceHashes)->Apply(BaselineArgs)->Unit(benchmark::kMillisecond)->UseRealTime();
@@ -0,0 +1,168 @@
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <iterator>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <libtorrent/bencode.hpp>
+#include <libtorrent/create_torrent.hpp>
+#include <libtorrent/file_storage.hpp>
+#include <libtorrent/torrent_info.hpp>
+
+#include "../picotorrent/bittorrent/filereader.hpp"
+#include "../picotorrent/bittorrent/piecehasher.hpp"
+#include "../picotorrent/bittorrent/scrubber.hpp"
+#include "tempdirectory.hpp"
+
+namespace fs = std::filesystem;
+namespace lt = libtorrent;
+using pt::BitTorrent::FileReader;
+using pt::BitTorrent::PieceHasher;
+using pt::BitTorrent::Scrubber;
+using pt::Tests::TempDirectory;
+
+namespace
+{
+    const int PieceLength = 64 * 1024;
+
+    struct File
+    {
+        std::string name;
+        std::int64_t size;
+    };
+
+    // writes the files and creates the torrent with libtorrent's own
+    // set_piece_hashes, which is what the PieceHasher has to agree with. v2
+    // torrents have their files sorted, so the data is kept by name
+    lt::torrent_info Create(TempDirectory& dir, std::vector<File> const& files, lt::create_flags_t flags, std::map<std::string, std::vector<char>>& data)
+    {
+        lt::file_storage storage;
+
+        for (size_t i = 0; i < files.size(); i++)
+        {
+            data[files[i].name] = dir.Write("set/" + files[i].name, files[i].size, static_cast<uint32_t>(i + 1));
+            storage.add_file("set/" + files[i].name, files[i].size);
+        }
+
+        lt::create_torrent ct(storage, PieceLength, flags);
+        lt::error_code ec;
+        lt::set_piece_hashes(ct, dir.Path().string(), ec);
+        EXPECT_FALSE(ec) << ec.message();
+
+        std::vector<char> buffer;
+        lt::bencode(std::back_inserter(buffer), ct.generate());
+
+        return lt::torrent_info(buffer, lt::from_span);
+    }
+}
+
+TEST(PieceHasherTest, PieceRootMatchesSetPieceHashes)
+{
+    // smaller than a block, a single block, not a whole number of blocks,
+    // exactly one piece, and several pieces with and without a tail
+    std::vector<File> files =
+    {
+        { "tiny", 1000 },
+        { "block", 16 * 1024 },
+        { "blocks", 40000 },
+        { "piece", PieceLength },
+        { "tail", PieceLength * 3 + 5000 },
+        { "pieces", PieceLength * 4 },
+    };
+
+    TempDirectory dir;
+    std::map<std::string, std::vector<char>> data;
+    lt::torrent_info ti = Create(dir, files, lt::create_torrent::v2_only, data);
+    lt::file_storage const& storage = ti.files();
+
+    for (lt::file_index_t index : storage.file_range())
+    {
+        if (storage.pad_file_at(index))
+        {
+            continue;
+        }
+
+        std::string const name = storage.file_name(index).to_string();
+        std::vector<char> const& content = data.at(name);
+        std::int64_t const size = storage.file_size(index);
+        SCOPED_TRACE(name);
+
+        if (size <= PieceLength)
+        {
+            EXPECT_EQ(storage.root(index), PieceHasher::PieceRoot(content.data(), static_cast<int>(size), size, PieceLength));
+            continue;
+        }
+
+        auto layer = ti.piece_layer(index);
+        ASSERT_EQ((size + PieceLength - 1) / PieceLength * lt::sha256_hash::size(), static_cast<size_t>(layer.size()));
+
+        for (std::int64_t offset = 0, piece = 0; offset < size; offset += PieceLength, piece++)
+        {
+            int const pieceSize = static_cast<int>(std::min<std::int64_t>(PieceLength, size - offset));
+            lt::sha256_hash const root = PieceHasher::PieceRoot(content.data() + offset, pieceSize, size, PieceLength);
+
+            EXPECT_EQ(0, std::memcmp(layer.data() + piece * lt::sha256_hash::size(), root.data(), root.size()))
+                << "piece " << piece;
+        }
+    }
+}
+
+TEST(PieceHasherTest, ReadPieceSpansFiles)
+{
+    std::vector<File> files =
+    {
+        { "a", PieceLength / 2 + 100 },
+        { "b", 300 },
+        { "c", PieceLength * 2 },
+    };
+
+    TempDirectory dir;
+    std::map<std::string, std::vector<char>> data;
+    lt::torrent_info ti = Create(dir, files, lt::create_torrent::v1_only, data);
+
+    // v1 torrents keep the files in the order they were added
+    std::vector<char> expected;
+    for (File const& f : files) { expected.insert(expected.end(), data[f.name].begin(), data[f.name].end()); }
+
+    FileReader file;
+    std::vector<char> buffer;
+
+    for (lt::piece_index_t piece : ti.piece_range())
+    {
+        lt::error_code ec;
+        ASSERT_TRUE(Scrubber::ReadPiece(ti.files(), dir.Path().string(), piece, buffer, file, ec)) << ec.message();
+
+        std::int64_t const offset = static_cast<std::int64_t>(static_cast<int>(piece)) * PieceLength;
+        ASSERT_EQ(static_cast<size_t>(ti.piece_size(piece)), buffer.size());
+        EXPECT_TRUE(std::equal(buffer.begin(), buffer.end(), expected.begin() + offset));
+    }
+}
+
+TEST(PieceHasherTest, ReadPieceReportsMissingAndShortFiles)
+{
+    std::vector<File> files =
+    {
+        { "a", PieceLength },
+        { "b", PieceLength },
+    };
+
+    TempDirectory dir;
+    std::map<std::string, std::vector<char>> data;
+    lt::torrent_info ti = Create(dir, files, lt::create_torrent::v1_only, data);
+
+    FileReader file;
+    std::vector<char> buffer;
+    lt::error_code ec;
+
+    fs::remove(dir.Path() / "set" / "a");
+    EXPECT_FALSE(Scrubber::ReadPiece(ti.files(), dir.Path().string(), lt::piece_index_t(0), buffer, file, ec));
+    EXPECT_TRUE(ec);
+
+    ec.clear();
+    fs::resize_file(dir.Path() / "set" / "b", PieceLength / 2);
+    EXPECT_FALSE(Scrubber::ReadPiece(ti.files(), dir.Path().string(), lt::piece_index_t(1), buffer, file, ec));
+    EXPECT_TRUE(ec);
+}
@@ -0,0 +1,143 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <libtorrent/performance_counters.hpp>
+#include <libtorrent/time.hpp>
+
+#include "../picotorrent/bittorrent/sessionmetrics.hpp"
+
+namespace lt = libtorrent;
+using pt::BitTorrent::SessionMetrics;
+
+namespace
+{
+    // the counters of a session_stats_alert with one metric set
+    std::vector<std::int64_t> Counters(SessionMetrics const& metrics, int metric, std::int64_t value)
+    {
+        std::vector<std::int64_t> counters(lt::counters::num_counters, 0);
+        counters[metrics.Metrics()[metric].valueIndex] = value;
+        return counters;
+    }
+}
+
+TEST(SessionMetricsTest, FindResolvesNames)
+{
+    SessionMetrics metrics(10);
+
+    int const recv = metrics.Find("net.recv_bytes");
+    ASSERT_GE(recv, 0);
+    EXPECT_EQ("net.recv_bytes", metrics.Metrics()[recv].name);
+    EXPECT_EQ(SessionMetrics::Type::Counter, metrics.Metrics()[recv].type);
+
+    int const peers = metrics.Find("peer.num_peers_connected");
+    ASSERT_GE(peers, 0);
+    EXPECT_EQ(SessionMetrics::Type::Gauge, metrics.Metrics()[peers].type);
+
+    EXPECT_EQ(-1, metrics.Find("no.such_metric"));
+}
+
+TEST(SessionMetricsTest, EmptyHasNothing)
+{
+    SessionMetrics metrics(10);
+    int const recv = metrics.Find("net.recv_bytes");
+
+    EXPECT_EQ(0u, metrics.Size());
+    EXPECT_EQ(0, metrics.Value(recv));
+    EXPECT_EQ(0, metrics.Rate(recv));
+    EXPECT_TRUE(metrics.History(recv).empty());
+}
+
+TEST(SessionMetricsTest, InvalidMetricIsZero)
+{
+    SessionMetrics metrics(10);
+    int const recv = metrics.Find("net.recv_bytes");
+    lt::time_point const start = lt::clock_type::now();
+
+    metrics.Push(start, Counters(metrics, recv, 1));
+    metrics.Push(start + std::chrono::seconds(1), Counters(metrics, recv, 2));
+
+    for (int metric : { -1, static_cast<int>(metrics.Metrics().size()) })
+    {
+        EXPECT_EQ(0, metrics.Value(metric));
+        EXPECT_EQ(0, metrics.Rate(metric));
+        EXPECT_TRUE(metrics.History(metric).empty());
+    }
+}
+
+TEST(SessionMetricsTest, RateBetweenLatestSnapshots)
+{
+    SessionMetrics metrics(10);
+    int const recv = metrics.Find("net.recv_bytes");
+    lt::time_point const start = lt::clock_type::now();
+
+    metrics.Push(start, Counters(metrics, recv, 1000));
+    EXPECT_EQ(1000, metrics.Value(recv));
+    EXPECT_EQ(0, metrics.Rate(recv));
+
+    metrics.Push(start + std::chrono::seconds(2), Counters(metrics, recv, 5000));
+    EXPECT_EQ(5000, metrics.Value(recv));
+    EXPECT_DOUBLE_EQ(2000, metrics.Rate(recv));
+
+    // only the two latest count
+    metrics.Push(start + std::chrono::milliseconds(2500), Counters(metrics, recv, 5100));
+    EXPECT_DOUBLE_EQ(200, metrics.Rate(recv));
+}
+
+TEST(SessionMetricsTest, RateWithoutElapsedTimeIsZero)
+{
+    SessionMetrics metrics(10);
+    int const recv = metrics.Find("net.recv_bytes");
+    lt::time_point const start = lt::clock_type::now();
+
+    metrics.Push(start, Counters(metrics, recv, 1000));
+    metrics.Push(start, Counters(metrics, recv, 2000));
+
+    EXPECT_EQ(0, metrics.Rate(recv));
+}
+
+TEST(SessionMetricsTest, RingBufferKeepsTheLatest)
+{
+    SessionMetrics metrics(3);
+    int const recv = metrics.Find("net.recv_bytes");
+    lt::time_point const start = lt::clock_type::now();
+
+    for (int i = 1; i <= 5; i++)
+    {
+        metrics.Push(start + std::chrono::seconds(i), Counters(metrics, recv, i * 10));
+        EXPECT_EQ(static_cast<std::size_t>(std::min(i, 3)), metrics.Size());
+    }
+
+    EXPECT_EQ((std::vector<std::int64_t>{ 30, 40, 50 }), metrics.History(recv));
+    EXPECT_EQ(50, metrics.Value(recv));
+    EXPECT_DOUBLE_EQ(10, metrics.Rate(recv));
+}
+
+TEST(SessionMetricsTest, CapacityIsAtLeastTwo)
+{
+    SessionMetrics metrics(0);
+    int const recv = metrics.Find("net.recv_bytes");
+    lt::time_point const start = lt::clock_type::now();
+
+    for (int i = 1; i <= 3; i++)
+    {
+        metrics.Push(start + std::chrono::seconds(i), Counters(metrics, recv, i * 100));
+    }
+
+    EXPECT_EQ(2u, metrics.Size());
+    EXPECT_EQ((std::vector<std::int64_t>{ 200, 300 }), metrics.History(recv));
+    EXPECT_DOUBLE_EQ(100, metrics.Rate(recv));
+}
+
+TEST(SessionMetricsTest, MissingCountersReadAsZero)
+{
+    SessionMetrics metrics(10);
+    int const recv = metrics.Find("net.recv_bytes");
+    std::vector<std::int64_t> counters(static_cast<std::size_t>(metrics.Metrics()[recv].valueIndex), 7);
+
+    metrics.Push(lt::clock_type::now(), counters);
+
+    EXPECT_EQ(0, metrics.Value(recv));
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace pt::Tests
+{
+    // A directory under the system temp directory which is removed again
+    // with everything in it when the test is done.
+    class TempDirectory
+    {
+    public:
+        TempDirectory()
+        {
+            std::random_device rd;
+            m_path = std::filesystem::temp_directory_path() / ("picotorrent-tests-" + std::to_string(rd()));
+            std::filesystem::create_directories(m_path);
+        }
+
+        ~TempDirectory()
+        {
+            std::error_code ec;
+            std::filesystem::remove_all(m_path, ec);
+        }
+
+        TempDirectory(TempDirectory const&) = delete;
+        TempDirectory& operator=(TempDirectory const&) = delete;
+
+        std::filesystem::path const& Path() const { return m_path; }
+
+        // writes size bytes of random data, the same for the same seed
+        std::vector<char> Write(std::string const& name, std::int64_t size, uint32_t seed)
+        {
+            std::mt19937 rng(seed);
+            std::vector<char> data(static_cast<size_t>(size));
+
+            for (char& c : data)
+            {
+                c = static_cast<char>(rng());
+            }
+
+            std::filesystem::path file = m_path / std::filesystem::u8path(name);
+            std::filesystem::create_directories(file.parent_path());
+
+            std::ofstream out(file, std::ios::binary | std::ios::trunc);
+            out.write(data.data(), static_cast<std::streamsize>(data.size()));
+
+            return data;
+        }
+
+    private:
+        std::filesystem::path m_path;
+    };
+}